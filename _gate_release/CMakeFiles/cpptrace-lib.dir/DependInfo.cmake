@@ -0,0 +1,80 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/src/binary/elf.cpp" "CMakeFiles/cpptrace-lib.dir/src/binary/elf.cpp.o" "gcc" "CMakeFiles/cpptrace-lib.dir/src/binary/elf.cpp.o.d"
+  "/root/repo/src/binary/mach-o.cpp" "CMakeFiles/cpptrace-lib.dir/src/binary/mach-o.cpp.o" "gcc" "CMakeFiles/cpptrace-lib.dir/src/binary/mach-o.cpp.o.d"
+  "/root/repo/src/binary/module_base.cpp" "CMakeFiles/cpptrace-lib.dir/src/binary/module_base.cpp.o" "gcc" "CMakeFiles/cpptrace-lib.dir/src/binary/module_base.cpp.o.d"
+  "/root/repo/src/binary/object.cpp" "CMakeFiles/cpptrace-lib.dir/src/binary/object.cpp.o" "gcc" "CMakeFiles/cpptrace-lib.dir/src/binary/object.cpp.o.d"
+  "/root/repo/src/binary/pe.cpp" "CMakeFiles/cpptrace-lib.dir/src/binary/pe.cpp.o" "gcc" "CMakeFiles/cpptrace-lib.dir/src/binary/pe.cpp.o.d"
+  "/root/repo/src/binary/safe_dl.cpp" "CMakeFiles/cpptrace-lib.dir/src/binary/safe_dl.cpp.o" "gcc" "CMakeFiles/cpptrace-lib.dir/src/binary/safe_dl.cpp.o.d"
+  "/root/repo/src/binary/safe_symbol_table.cpp" "CMakeFiles/cpptrace-lib.dir/src/binary/safe_symbol_table.cpp.o" "gcc" "CMakeFiles/cpptrace-lib.dir/src/binary/safe_symbol_table.cpp.o.d"
+  "/root/repo/src/cpptrace.cpp" "CMakeFiles/cpptrace-lib.dir/src/cpptrace.cpp.o" "gcc" "CMakeFiles/cpptrace-lib.dir/src/cpptrace.cpp.o.d"
+  "/root/repo/src/crash_reporting.cpp" "CMakeFiles/cpptrace-lib.dir/src/crash_reporting.cpp.o" "gcc" "CMakeFiles/cpptrace-lib.dir/src/crash_reporting.cpp.o.d"
+  "/root/repo/src/ctrace.cpp" "CMakeFiles/cpptrace-lib.dir/src/ctrace.cpp.o" "gcc" "CMakeFiles/cpptrace-lib.dir/src/ctrace.cpp.o.d"
+  "/root/repo/src/demangle/demangle.cpp" "CMakeFiles/cpptrace-lib.dir/src/demangle/demangle.cpp.o" "gcc" "CMakeFiles/cpptrace-lib.dir/src/demangle/demangle.cpp.o.d"
+  "/root/repo/src/demangle/demangle_with_builtin.cpp" "CMakeFiles/cpptrace-lib.dir/src/demangle/demangle_with_builtin.cpp.o" "gcc" "CMakeFiles/cpptrace-lib.dir/src/demangle/demangle_with_builtin.cpp.o.d"
+  "/root/repo/src/demangle/demangle_with_cxxabi.cpp" "CMakeFiles/cpptrace-lib.dir/src/demangle/demangle_with_cxxabi.cpp.o" "gcc" "CMakeFiles/cpptrace-lib.dir/src/demangle/demangle_with_cxxabi.cpp.o.d"
+  "/root/repo/src/demangle/demangle_with_nothing.cpp" "CMakeFiles/cpptrace-lib.dir/src/demangle/demangle_with_nothing.cpp.o" "gcc" "CMakeFiles/cpptrace-lib.dir/src/demangle/demangle_with_nothing.cpp.o.d"
+  "/root/repo/src/demangle/demangle_with_winapi.cpp" "CMakeFiles/cpptrace-lib.dir/src/demangle/demangle_with_winapi.cpp.o" "gcc" "CMakeFiles/cpptrace-lib.dir/src/demangle/demangle_with_winapi.cpp.o.d"
+  "/root/repo/src/demangle/itanium.cpp" "CMakeFiles/cpptrace-lib.dir/src/demangle/itanium.cpp.o" "gcc" "CMakeFiles/cpptrace-lib.dir/src/demangle/itanium.cpp.o.d"
+  "/root/repo/src/exceptions.cpp" "CMakeFiles/cpptrace-lib.dir/src/exceptions.cpp.o" "gcc" "CMakeFiles/cpptrace-lib.dir/src/exceptions.cpp.o.d"
+  "/root/repo/src/formatting.cpp" "CMakeFiles/cpptrace-lib.dir/src/formatting.cpp.o" "gcc" "CMakeFiles/cpptrace-lib.dir/src/formatting.cpp.o.d"
+  "/root/repo/src/from_current.cpp" "CMakeFiles/cpptrace-lib.dir/src/from_current.cpp.o" "gcc" "CMakeFiles/cpptrace-lib.dir/src/from_current.cpp.o.d"
+  "/root/repo/src/jit/jit_objects.cpp" "CMakeFiles/cpptrace-lib.dir/src/jit/jit_objects.cpp.o" "gcc" "CMakeFiles/cpptrace-lib.dir/src/jit/jit_objects.cpp.o.d"
+  "/root/repo/src/lazy_trace.cpp" "CMakeFiles/cpptrace-lib.dir/src/lazy_trace.cpp.o" "gcc" "CMakeFiles/cpptrace-lib.dir/src/lazy_trace.cpp.o.d"
+  "/root/repo/src/logging.cpp" "CMakeFiles/cpptrace-lib.dir/src/logging.cpp.o" "gcc" "CMakeFiles/cpptrace-lib.dir/src/logging.cpp.o.d"
+  "/root/repo/src/options.cpp" "CMakeFiles/cpptrace-lib.dir/src/options.cpp.o" "gcc" "CMakeFiles/cpptrace-lib.dir/src/options.cpp.o.d"
+  "/root/repo/src/platform/dbghelp_utils.cpp" "CMakeFiles/cpptrace-lib.dir/src/platform/dbghelp_utils.cpp.o" "gcc" "CMakeFiles/cpptrace-lib.dir/src/platform/dbghelp_utils.cpp.o.d"
+  "/root/repo/src/platform/memory_mapping.cpp" "CMakeFiles/cpptrace-lib.dir/src/platform/memory_mapping.cpp.o" "gcc" "CMakeFiles/cpptrace-lib.dir/src/platform/memory_mapping.cpp.o.d"
+  "/root/repo/src/platform/thread_capture.cpp" "CMakeFiles/cpptrace-lib.dir/src/platform/thread_capture.cpp.o" "gcc" "CMakeFiles/cpptrace-lib.dir/src/platform/thread_capture.cpp.o.d"
+  "/root/repo/src/profiling/allocation_profiler.cpp" "CMakeFiles/cpptrace-lib.dir/src/profiling/allocation_profiler.cpp.o" "gcc" "CMakeFiles/cpptrace-lib.dir/src/profiling/allocation_profiler.cpp.o.d"
+  "/root/repo/src/profiling/sampling_profiler.cpp" "CMakeFiles/cpptrace-lib.dir/src/profiling/sampling_profiler.cpp.o" "gcc" "CMakeFiles/cpptrace-lib.dir/src/profiling/sampling_profiler.cpp.o.d"
+  "/root/repo/src/prune_symbol.cpp" "CMakeFiles/cpptrace-lib.dir/src/prune_symbol.cpp.o" "gcc" "CMakeFiles/cpptrace-lib.dir/src/prune_symbol.cpp.o.d"
+  "/root/repo/src/safe_formatting.cpp" "CMakeFiles/cpptrace-lib.dir/src/safe_formatting.cpp.o" "gcc" "CMakeFiles/cpptrace-lib.dir/src/safe_formatting.cpp.o.d"
+  "/root/repo/src/serialization.cpp" "CMakeFiles/cpptrace-lib.dir/src/serialization.cpp.o" "gcc" "CMakeFiles/cpptrace-lib.dir/src/serialization.cpp.o.d"
+  "/root/repo/src/snippets/snippet.cpp" "CMakeFiles/cpptrace-lib.dir/src/snippets/snippet.cpp.o" "gcc" "CMakeFiles/cpptrace-lib.dir/src/snippets/snippet.cpp.o.d"
+  "/root/repo/src/stats.cpp" "CMakeFiles/cpptrace-lib.dir/src/stats.cpp.o" "gcc" "CMakeFiles/cpptrace-lib.dir/src/stats.cpp.o.d"
+  "/root/repo/src/symbolication/client.cpp" "CMakeFiles/cpptrace-lib.dir/src/symbolication/client.cpp.o" "gcc" "CMakeFiles/cpptrace-lib.dir/src/symbolication/client.cpp.o.d"
+  "/root/repo/src/symbolication/protocol.cpp" "CMakeFiles/cpptrace-lib.dir/src/symbolication/protocol.cpp.o" "gcc" "CMakeFiles/cpptrace-lib.dir/src/symbolication/protocol.cpp.o.d"
+  "/root/repo/src/symbolication/server.cpp" "CMakeFiles/cpptrace-lib.dir/src/symbolication/server.cpp.o" "gcc" "CMakeFiles/cpptrace-lib.dir/src/symbolication/server.cpp.o.d"
+  "/root/repo/src/symbols/dwarf/debug_map_resolver.cpp" "CMakeFiles/cpptrace-lib.dir/src/symbols/dwarf/debug_map_resolver.cpp.o" "gcc" "CMakeFiles/cpptrace-lib.dir/src/symbols/dwarf/debug_map_resolver.cpp.o.d"
+  "/root/repo/src/symbols/dwarf/dwarf_options.cpp" "CMakeFiles/cpptrace-lib.dir/src/symbols/dwarf/dwarf_options.cpp.o" "gcc" "CMakeFiles/cpptrace-lib.dir/src/symbols/dwarf/dwarf_options.cpp.o.d"
+  "/root/repo/src/symbols/dwarf/dwarf_resolver.cpp" "CMakeFiles/cpptrace-lib.dir/src/symbols/dwarf/dwarf_resolver.cpp.o" "gcc" "CMakeFiles/cpptrace-lib.dir/src/symbols/dwarf/dwarf_resolver.cpp.o.d"
+  "/root/repo/src/symbols/symbol_chain.cpp" "CMakeFiles/cpptrace-lib.dir/src/symbols/symbol_chain.cpp.o" "gcc" "CMakeFiles/cpptrace-lib.dir/src/symbols/symbol_chain.cpp.o.d"
+  "/root/repo/src/symbols/symbols_core.cpp" "CMakeFiles/cpptrace-lib.dir/src/symbols/symbols_core.cpp.o" "gcc" "CMakeFiles/cpptrace-lib.dir/src/symbols/symbols_core.cpp.o.d"
+  "/root/repo/src/symbols/symbols_with_addr2line.cpp" "CMakeFiles/cpptrace-lib.dir/src/symbols/symbols_with_addr2line.cpp.o" "gcc" "CMakeFiles/cpptrace-lib.dir/src/symbols/symbols_with_addr2line.cpp.o.d"
+  "/root/repo/src/symbols/symbols_with_dbghelp.cpp" "CMakeFiles/cpptrace-lib.dir/src/symbols/symbols_with_dbghelp.cpp.o" "gcc" "CMakeFiles/cpptrace-lib.dir/src/symbols/symbols_with_dbghelp.cpp.o.d"
+  "/root/repo/src/symbols/symbols_with_dl.cpp" "CMakeFiles/cpptrace-lib.dir/src/symbols/symbols_with_dl.cpp.o" "gcc" "CMakeFiles/cpptrace-lib.dir/src/symbols/symbols_with_dl.cpp.o.d"
+  "/root/repo/src/symbols/symbols_with_libbacktrace.cpp" "CMakeFiles/cpptrace-lib.dir/src/symbols/symbols_with_libbacktrace.cpp.o" "gcc" "CMakeFiles/cpptrace-lib.dir/src/symbols/symbols_with_libbacktrace.cpp.o.d"
+  "/root/repo/src/symbols/symbols_with_libdwarf.cpp" "CMakeFiles/cpptrace-lib.dir/src/symbols/symbols_with_libdwarf.cpp.o" "gcc" "CMakeFiles/cpptrace-lib.dir/src/symbols/symbols_with_libdwarf.cpp.o.d"
+  "/root/repo/src/symbols/symbols_with_nothing.cpp" "CMakeFiles/cpptrace-lib.dir/src/symbols/symbols_with_nothing.cpp.o" "gcc" "CMakeFiles/cpptrace-lib.dir/src/symbols/symbols_with_nothing.cpp.o.d"
+  "/root/repo/src/thread_dump.cpp" "CMakeFiles/cpptrace-lib.dir/src/thread_dump.cpp.o" "gcc" "CMakeFiles/cpptrace-lib.dir/src/thread_dump.cpp.o.d"
+  "/root/repo/src/trace_table.cpp" "CMakeFiles/cpptrace-lib.dir/src/trace_table.cpp.o" "gcc" "CMakeFiles/cpptrace-lib.dir/src/trace_table.cpp.o.d"
+  "/root/repo/src/unwind/unwind_with_dbghelp.cpp" "CMakeFiles/cpptrace-lib.dir/src/unwind/unwind_with_dbghelp.cpp.o" "gcc" "CMakeFiles/cpptrace-lib.dir/src/unwind/unwind_with_dbghelp.cpp.o.d"
+  "/root/repo/src/unwind/unwind_with_execinfo.cpp" "CMakeFiles/cpptrace-lib.dir/src/unwind/unwind_with_execinfo.cpp.o" "gcc" "CMakeFiles/cpptrace-lib.dir/src/unwind/unwind_with_execinfo.cpp.o.d"
+  "/root/repo/src/unwind/unwind_with_libunwind.cpp" "CMakeFiles/cpptrace-lib.dir/src/unwind/unwind_with_libunwind.cpp.o" "gcc" "CMakeFiles/cpptrace-lib.dir/src/unwind/unwind_with_libunwind.cpp.o.d"
+  "/root/repo/src/unwind/unwind_with_nothing.cpp" "CMakeFiles/cpptrace-lib.dir/src/unwind/unwind_with_nothing.cpp.o" "gcc" "CMakeFiles/cpptrace-lib.dir/src/unwind/unwind_with_nothing.cpp.o.d"
+  "/root/repo/src/unwind/unwind_with_unwind.cpp" "CMakeFiles/cpptrace-lib.dir/src/unwind/unwind_with_unwind.cpp.o" "gcc" "CMakeFiles/cpptrace-lib.dir/src/unwind/unwind_with_unwind.cpp.o.d"
+  "/root/repo/src/unwind/unwind_with_winapi.cpp" "CMakeFiles/cpptrace-lib.dir/src/unwind/unwind_with_winapi.cpp.o" "gcc" "CMakeFiles/cpptrace-lib.dir/src/unwind/unwind_with_winapi.cpp.o.d"
+  "/root/repo/src/utils.cpp" "CMakeFiles/cpptrace-lib.dir/src/utils.cpp.o" "gcc" "CMakeFiles/cpptrace-lib.dir/src/utils.cpp.o.d"
+  "/root/repo/src/utils/error.cpp" "CMakeFiles/cpptrace-lib.dir/src/utils/error.cpp.o" "gcc" "CMakeFiles/cpptrace-lib.dir/src/utils/error.cpp.o.d"
+  "/root/repo/src/utils/io/file.cpp" "CMakeFiles/cpptrace-lib.dir/src/utils/io/file.cpp.o" "gcc" "CMakeFiles/cpptrace-lib.dir/src/utils/io/file.cpp.o.d"
+  "/root/repo/src/utils/io/memory_file_view.cpp" "CMakeFiles/cpptrace-lib.dir/src/utils/io/memory_file_view.cpp.o" "gcc" "CMakeFiles/cpptrace-lib.dir/src/utils/io/memory_file_view.cpp.o.d"
+  "/root/repo/src/utils/microfmt.cpp" "CMakeFiles/cpptrace-lib.dir/src/utils/microfmt.cpp.o" "gcc" "CMakeFiles/cpptrace-lib.dir/src/utils/microfmt.cpp.o.d"
+  "/root/repo/src/utils/string_view.cpp" "CMakeFiles/cpptrace-lib.dir/src/utils/string_view.cpp.o" "gcc" "CMakeFiles/cpptrace-lib.dir/src/utils/string_view.cpp.o.d"
+  "/root/repo/src/utils/utils.cpp" "CMakeFiles/cpptrace-lib.dir/src/utils/utils.cpp.o" "gcc" "CMakeFiles/cpptrace-lib.dir/src/utils/utils.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
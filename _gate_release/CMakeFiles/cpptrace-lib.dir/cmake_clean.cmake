@@ -0,0 +1,133 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/cpptrace-lib.dir/src/binary/elf.cpp.o"
+  "CMakeFiles/cpptrace-lib.dir/src/binary/elf.cpp.o.d"
+  "CMakeFiles/cpptrace-lib.dir/src/binary/mach-o.cpp.o"
+  "CMakeFiles/cpptrace-lib.dir/src/binary/mach-o.cpp.o.d"
+  "CMakeFiles/cpptrace-lib.dir/src/binary/module_base.cpp.o"
+  "CMakeFiles/cpptrace-lib.dir/src/binary/module_base.cpp.o.d"
+  "CMakeFiles/cpptrace-lib.dir/src/binary/object.cpp.o"
+  "CMakeFiles/cpptrace-lib.dir/src/binary/object.cpp.o.d"
+  "CMakeFiles/cpptrace-lib.dir/src/binary/pe.cpp.o"
+  "CMakeFiles/cpptrace-lib.dir/src/binary/pe.cpp.o.d"
+  "CMakeFiles/cpptrace-lib.dir/src/binary/safe_dl.cpp.o"
+  "CMakeFiles/cpptrace-lib.dir/src/binary/safe_dl.cpp.o.d"
+  "CMakeFiles/cpptrace-lib.dir/src/binary/safe_symbol_table.cpp.o"
+  "CMakeFiles/cpptrace-lib.dir/src/binary/safe_symbol_table.cpp.o.d"
+  "CMakeFiles/cpptrace-lib.dir/src/cpptrace.cpp.o"
+  "CMakeFiles/cpptrace-lib.dir/src/cpptrace.cpp.o.d"
+  "CMakeFiles/cpptrace-lib.dir/src/crash_reporting.cpp.o"
+  "CMakeFiles/cpptrace-lib.dir/src/crash_reporting.cpp.o.d"
+  "CMakeFiles/cpptrace-lib.dir/src/ctrace.cpp.o"
+  "CMakeFiles/cpptrace-lib.dir/src/ctrace.cpp.o.d"
+  "CMakeFiles/cpptrace-lib.dir/src/demangle/demangle.cpp.o"
+  "CMakeFiles/cpptrace-lib.dir/src/demangle/demangle.cpp.o.d"
+  "CMakeFiles/cpptrace-lib.dir/src/demangle/demangle_with_builtin.cpp.o"
+  "CMakeFiles/cpptrace-lib.dir/src/demangle/demangle_with_builtin.cpp.o.d"
+  "CMakeFiles/cpptrace-lib.dir/src/demangle/demangle_with_cxxabi.cpp.o"
+  "CMakeFiles/cpptrace-lib.dir/src/demangle/demangle_with_cxxabi.cpp.o.d"
+  "CMakeFiles/cpptrace-lib.dir/src/demangle/demangle_with_nothing.cpp.o"
+  "CMakeFiles/cpptrace-lib.dir/src/demangle/demangle_with_nothing.cpp.o.d"
+  "CMakeFiles/cpptrace-lib.dir/src/demangle/demangle_with_winapi.cpp.o"
+  "CMakeFiles/cpptrace-lib.dir/src/demangle/demangle_with_winapi.cpp.o.d"
+  "CMakeFiles/cpptrace-lib.dir/src/demangle/itanium.cpp.o"
+  "CMakeFiles/cpptrace-lib.dir/src/demangle/itanium.cpp.o.d"
+  "CMakeFiles/cpptrace-lib.dir/src/exceptions.cpp.o"
+  "CMakeFiles/cpptrace-lib.dir/src/exceptions.cpp.o.d"
+  "CMakeFiles/cpptrace-lib.dir/src/formatting.cpp.o"
+  "CMakeFiles/cpptrace-lib.dir/src/formatting.cpp.o.d"
+  "CMakeFiles/cpptrace-lib.dir/src/from_current.cpp.o"
+  "CMakeFiles/cpptrace-lib.dir/src/from_current.cpp.o.d"
+  "CMakeFiles/cpptrace-lib.dir/src/jit/jit_objects.cpp.o"
+  "CMakeFiles/cpptrace-lib.dir/src/jit/jit_objects.cpp.o.d"
+  "CMakeFiles/cpptrace-lib.dir/src/lazy_trace.cpp.o"
+  "CMakeFiles/cpptrace-lib.dir/src/lazy_trace.cpp.o.d"
+  "CMakeFiles/cpptrace-lib.dir/src/logging.cpp.o"
+  "CMakeFiles/cpptrace-lib.dir/src/logging.cpp.o.d"
+  "CMakeFiles/cpptrace-lib.dir/src/options.cpp.o"
+  "CMakeFiles/cpptrace-lib.dir/src/options.cpp.o.d"
+  "CMakeFiles/cpptrace-lib.dir/src/platform/dbghelp_utils.cpp.o"
+  "CMakeFiles/cpptrace-lib.dir/src/platform/dbghelp_utils.cpp.o.d"
+  "CMakeFiles/cpptrace-lib.dir/src/platform/memory_mapping.cpp.o"
+  "CMakeFiles/cpptrace-lib.dir/src/platform/memory_mapping.cpp.o.d"
+  "CMakeFiles/cpptrace-lib.dir/src/platform/thread_capture.cpp.o"
+  "CMakeFiles/cpptrace-lib.dir/src/platform/thread_capture.cpp.o.d"
+  "CMakeFiles/cpptrace-lib.dir/src/profiling/allocation_profiler.cpp.o"
+  "CMakeFiles/cpptrace-lib.dir/src/profiling/allocation_profiler.cpp.o.d"
+  "CMakeFiles/cpptrace-lib.dir/src/profiling/sampling_profiler.cpp.o"
+  "CMakeFiles/cpptrace-lib.dir/src/profiling/sampling_profiler.cpp.o.d"
+  "CMakeFiles/cpptrace-lib.dir/src/prune_symbol.cpp.o"
+  "CMakeFiles/cpptrace-lib.dir/src/prune_symbol.cpp.o.d"
+  "CMakeFiles/cpptrace-lib.dir/src/safe_formatting.cpp.o"
+  "CMakeFiles/cpptrace-lib.dir/src/safe_formatting.cpp.o.d"
+  "CMakeFiles/cpptrace-lib.dir/src/serialization.cpp.o"
+  "CMakeFiles/cpptrace-lib.dir/src/serialization.cpp.o.d"
+  "CMakeFiles/cpptrace-lib.dir/src/snippets/snippet.cpp.o"
+  "CMakeFiles/cpptrace-lib.dir/src/snippets/snippet.cpp.o.d"
+  "CMakeFiles/cpptrace-lib.dir/src/stats.cpp.o"
+  "CMakeFiles/cpptrace-lib.dir/src/stats.cpp.o.d"
+  "CMakeFiles/cpptrace-lib.dir/src/symbolication/client.cpp.o"
+  "CMakeFiles/cpptrace-lib.dir/src/symbolication/client.cpp.o.d"
+  "CMakeFiles/cpptrace-lib.dir/src/symbolication/protocol.cpp.o"
+  "CMakeFiles/cpptrace-lib.dir/src/symbolication/protocol.cpp.o.d"
+  "CMakeFiles/cpptrace-lib.dir/src/symbolication/server.cpp.o"
+  "CMakeFiles/cpptrace-lib.dir/src/symbolication/server.cpp.o.d"
+  "CMakeFiles/cpptrace-lib.dir/src/symbols/dwarf/debug_map_resolver.cpp.o"
+  "CMakeFiles/cpptrace-lib.dir/src/symbols/dwarf/debug_map_resolver.cpp.o.d"
+  "CMakeFiles/cpptrace-lib.dir/src/symbols/dwarf/dwarf_options.cpp.o"
+  "CMakeFiles/cpptrace-lib.dir/src/symbols/dwarf/dwarf_options.cpp.o.d"
+  "CMakeFiles/cpptrace-lib.dir/src/symbols/dwarf/dwarf_resolver.cpp.o"
+  "CMakeFiles/cpptrace-lib.dir/src/symbols/dwarf/dwarf_resolver.cpp.o.d"
+  "CMakeFiles/cpptrace-lib.dir/src/symbols/symbol_chain.cpp.o"
+  "CMakeFiles/cpptrace-lib.dir/src/symbols/symbol_chain.cpp.o.d"
+  "CMakeFiles/cpptrace-lib.dir/src/symbols/symbols_core.cpp.o"
+  "CMakeFiles/cpptrace-lib.dir/src/symbols/symbols_core.cpp.o.d"
+  "CMakeFiles/cpptrace-lib.dir/src/symbols/symbols_with_addr2line.cpp.o"
+  "CMakeFiles/cpptrace-lib.dir/src/symbols/symbols_with_addr2line.cpp.o.d"
+  "CMakeFiles/cpptrace-lib.dir/src/symbols/symbols_with_dbghelp.cpp.o"
+  "CMakeFiles/cpptrace-lib.dir/src/symbols/symbols_with_dbghelp.cpp.o.d"
+  "CMakeFiles/cpptrace-lib.dir/src/symbols/symbols_with_dl.cpp.o"
+  "CMakeFiles/cpptrace-lib.dir/src/symbols/symbols_with_dl.cpp.o.d"
+  "CMakeFiles/cpptrace-lib.dir/src/symbols/symbols_with_libbacktrace.cpp.o"
+  "CMakeFiles/cpptrace-lib.dir/src/symbols/symbols_with_libbacktrace.cpp.o.d"
+  "CMakeFiles/cpptrace-lib.dir/src/symbols/symbols_with_libdwarf.cpp.o"
+  "CMakeFiles/cpptrace-lib.dir/src/symbols/symbols_with_libdwarf.cpp.o.d"
+  "CMakeFiles/cpptrace-lib.dir/src/symbols/symbols_with_nothing.cpp.o"
+  "CMakeFiles/cpptrace-lib.dir/src/symbols/symbols_with_nothing.cpp.o.d"
+  "CMakeFiles/cpptrace-lib.dir/src/thread_dump.cpp.o"
+  "CMakeFiles/cpptrace-lib.dir/src/thread_dump.cpp.o.d"
+  "CMakeFiles/cpptrace-lib.dir/src/trace_table.cpp.o"
+  "CMakeFiles/cpptrace-lib.dir/src/trace_table.cpp.o.d"
+  "CMakeFiles/cpptrace-lib.dir/src/unwind/unwind_with_dbghelp.cpp.o"
+  "CMakeFiles/cpptrace-lib.dir/src/unwind/unwind_with_dbghelp.cpp.o.d"
+  "CMakeFiles/cpptrace-lib.dir/src/unwind/unwind_with_execinfo.cpp.o"
+  "CMakeFiles/cpptrace-lib.dir/src/unwind/unwind_with_execinfo.cpp.o.d"
+  "CMakeFiles/cpptrace-lib.dir/src/unwind/unwind_with_libunwind.cpp.o"
+  "CMakeFiles/cpptrace-lib.dir/src/unwind/unwind_with_libunwind.cpp.o.d"
+  "CMakeFiles/cpptrace-lib.dir/src/unwind/unwind_with_nothing.cpp.o"
+  "CMakeFiles/cpptrace-lib.dir/src/unwind/unwind_with_nothing.cpp.o.d"
+  "CMakeFiles/cpptrace-lib.dir/src/unwind/unwind_with_unwind.cpp.o"
+  "CMakeFiles/cpptrace-lib.dir/src/unwind/unwind_with_unwind.cpp.o.d"
+  "CMakeFiles/cpptrace-lib.dir/src/unwind/unwind_with_winapi.cpp.o"
+  "CMakeFiles/cpptrace-lib.dir/src/unwind/unwind_with_winapi.cpp.o.d"
+  "CMakeFiles/cpptrace-lib.dir/src/utils.cpp.o"
+  "CMakeFiles/cpptrace-lib.dir/src/utils.cpp.o.d"
+  "CMakeFiles/cpptrace-lib.dir/src/utils/error.cpp.o"
+  "CMakeFiles/cpptrace-lib.dir/src/utils/error.cpp.o.d"
+  "CMakeFiles/cpptrace-lib.dir/src/utils/io/file.cpp.o"
+  "CMakeFiles/cpptrace-lib.dir/src/utils/io/file.cpp.o.d"
+  "CMakeFiles/cpptrace-lib.dir/src/utils/io/memory_file_view.cpp.o"
+  "CMakeFiles/cpptrace-lib.dir/src/utils/io/memory_file_view.cpp.o.d"
+  "CMakeFiles/cpptrace-lib.dir/src/utils/microfmt.cpp.o"
+  "CMakeFiles/cpptrace-lib.dir/src/utils/microfmt.cpp.o.d"
+  "CMakeFiles/cpptrace-lib.dir/src/utils/string_view.cpp.o"
+  "CMakeFiles/cpptrace-lib.dir/src/utils/string_view.cpp.o.d"
+  "CMakeFiles/cpptrace-lib.dir/src/utils/utils.cpp.o"
+  "CMakeFiles/cpptrace-lib.dir/src/utils/utils.cpp.o.d"
+  "libcpptrace.a"
+  "libcpptrace.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/cpptrace-lib.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "../c_demo"
+  "../c_demo.pdb"
+  "CMakeFiles/c_demo.dir/ctrace_demo.c.o"
+  "CMakeFiles/c_demo.dir/ctrace_demo.c.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/c_demo.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
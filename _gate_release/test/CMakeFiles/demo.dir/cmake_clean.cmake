@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "../demo"
+  "../demo.pdb"
+  "CMakeFiles/demo.dir/demo.cpp.o"
+  "CMakeFiles/demo.dir/demo.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/demo.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
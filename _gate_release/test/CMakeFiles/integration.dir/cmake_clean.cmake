@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "../integration"
+  "../integration.pdb"
+  "CMakeFiles/integration.dir/integration.cpp.o"
+  "CMakeFiles/integration.dir/integration.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/integration.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "../signal_demo"
+  "../signal_demo.pdb"
+  "CMakeFiles/signal_demo.dir/signal_demo.cpp.o"
+  "CMakeFiles/signal_demo.dir/signal_demo.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/signal_demo.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "../signal_tracer"
+  "../signal_tracer.pdb"
+  "CMakeFiles/signal_tracer.dir/signal_tracer.cpp.o"
+  "CMakeFiles/signal_tracer.dir/signal_tracer.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/signal_tracer.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
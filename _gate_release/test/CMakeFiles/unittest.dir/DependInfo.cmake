@@ -0,0 +1,52 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/test/unit/internals/general.cpp" "test/CMakeFiles/unittest.dir/unit/internals/general.cpp.o" "gcc" "test/CMakeFiles/unittest.dir/unit/internals/general.cpp.o.d"
+  "/root/repo/test/unit/internals/lru_cache.cpp" "test/CMakeFiles/unittest.dir/unit/internals/lru_cache.cpp.o" "gcc" "test/CMakeFiles/unittest.dir/unit/internals/lru_cache.cpp.o.d"
+  "/root/repo/test/unit/internals/memory_mapping.cpp" "test/CMakeFiles/unittest.dir/unit/internals/memory_mapping.cpp.o" "gcc" "test/CMakeFiles/unittest.dir/unit/internals/memory_mapping.cpp.o.d"
+  "/root/repo/test/unit/internals/optional.cpp" "test/CMakeFiles/unittest.dir/unit/internals/optional.cpp.o" "gcc" "test/CMakeFiles/unittest.dir/unit/internals/optional.cpp.o.d"
+  "/root/repo/test/unit/internals/result.cpp" "test/CMakeFiles/unittest.dir/unit/internals/result.cpp.o" "gcc" "test/CMakeFiles/unittest.dir/unit/internals/result.cpp.o.d"
+  "/root/repo/test/unit/internals/span.cpp" "test/CMakeFiles/unittest.dir/unit/internals/span.cpp.o" "gcc" "test/CMakeFiles/unittest.dir/unit/internals/span.cpp.o.d"
+  "/root/repo/test/unit/internals/string_utils.cpp" "test/CMakeFiles/unittest.dir/unit/internals/string_utils.cpp.o" "gcc" "test/CMakeFiles/unittest.dir/unit/internals/string_utils.cpp.o.d"
+  "/root/repo/test/unit/internals/string_view.cpp" "test/CMakeFiles/unittest.dir/unit/internals/string_view.cpp.o" "gcc" "test/CMakeFiles/unittest.dir/unit/internals/string_view.cpp.o.d"
+  "/root/repo/test/unit/lib/demangle.cpp" "test/CMakeFiles/unittest.dir/unit/lib/demangle.cpp.o" "gcc" "test/CMakeFiles/unittest.dir/unit/lib/demangle.cpp.o.d"
+  "/root/repo/test/unit/lib/demangle_corpus.cpp" "test/CMakeFiles/unittest.dir/unit/lib/demangle_corpus.cpp.o" "gcc" "test/CMakeFiles/unittest.dir/unit/lib/demangle_corpus.cpp.o.d"
+  "/root/repo/test/unit/lib/formatting.cpp" "test/CMakeFiles/unittest.dir/unit/lib/formatting.cpp.o" "gcc" "test/CMakeFiles/unittest.dir/unit/lib/formatting.cpp.o.d"
+  "/root/repo/test/unit/lib/nullable.cpp" "test/CMakeFiles/unittest.dir/unit/lib/nullable.cpp.o" "gcc" "test/CMakeFiles/unittest.dir/unit/lib/nullable.cpp.o.d"
+  "/root/repo/test/unit/lib/prune_symbol.cpp" "test/CMakeFiles/unittest.dir/unit/lib/prune_symbol.cpp.o" "gcc" "test/CMakeFiles/unittest.dir/unit/lib/prune_symbol.cpp.o.d"
+  "/root/repo/test/unit/main.cpp" "test/CMakeFiles/unittest.dir/unit/main.cpp.o" "gcc" "test/CMakeFiles/unittest.dir/unit/main.cpp.o.d"
+  "/root/repo/test/unit/tracing/addr2line.cpp" "test/CMakeFiles/unittest.dir/unit/tracing/addr2line.cpp.o" "gcc" "test/CMakeFiles/unittest.dir/unit/tracing/addr2line.cpp.o.d"
+  "/root/repo/test/unit/tracing/crash_reporting.cpp" "test/CMakeFiles/unittest.dir/unit/tracing/crash_reporting.cpp.o" "gcc" "test/CMakeFiles/unittest.dir/unit/tracing/crash_reporting.cpp.o.d"
+  "/root/repo/test/unit/tracing/from_current.cpp" "test/CMakeFiles/unittest.dir/unit/tracing/from_current.cpp.o" "gcc" "test/CMakeFiles/unittest.dir/unit/tracing/from_current.cpp.o.d"
+  "/root/repo/test/unit/tracing/from_current_try_catch.cpp" "test/CMakeFiles/unittest.dir/unit/tracing/from_current_try_catch.cpp.o" "gcc" "test/CMakeFiles/unittest.dir/unit/tracing/from_current_try_catch.cpp.o.d"
+  "/root/repo/test/unit/tracing/lazy_trace.cpp" "test/CMakeFiles/unittest.dir/unit/tracing/lazy_trace.cpp.o" "gcc" "test/CMakeFiles/unittest.dir/unit/tracing/lazy_trace.cpp.o.d"
+  "/root/repo/test/unit/tracing/object_trace.cpp" "test/CMakeFiles/unittest.dir/unit/tracing/object_trace.cpp.o" "gcc" "test/CMakeFiles/unittest.dir/unit/tracing/object_trace.cpp.o.d"
+  "/root/repo/test/unit/tracing/profiling.cpp" "test/CMakeFiles/unittest.dir/unit/tracing/profiling.cpp.o" "gcc" "test/CMakeFiles/unittest.dir/unit/tracing/profiling.cpp.o.d"
+  "/root/repo/test/unit/tracing/raw_trace.cpp" "test/CMakeFiles/unittest.dir/unit/tracing/raw_trace.cpp.o" "gcc" "test/CMakeFiles/unittest.dir/unit/tracing/raw_trace.cpp.o.d"
+  "/root/repo/test/unit/tracing/rethrow.cpp" "test/CMakeFiles/unittest.dir/unit/tracing/rethrow.cpp.o" "gcc" "test/CMakeFiles/unittest.dir/unit/tracing/rethrow.cpp.o.d"
+  "/root/repo/test/unit/tracing/safe_formatting.cpp" "test/CMakeFiles/unittest.dir/unit/tracing/safe_formatting.cpp.o" "gcc" "test/CMakeFiles/unittest.dir/unit/tracing/safe_formatting.cpp.o.d"
+  "/root/repo/test/unit/tracing/serialization.cpp" "test/CMakeFiles/unittest.dir/unit/tracing/serialization.cpp.o" "gcc" "test/CMakeFiles/unittest.dir/unit/tracing/serialization.cpp.o.d"
+  "/root/repo/test/unit/tracing/stacktrace.cpp" "test/CMakeFiles/unittest.dir/unit/tracing/stacktrace.cpp.o" "gcc" "test/CMakeFiles/unittest.dir/unit/tracing/stacktrace.cpp.o.d"
+  "/root/repo/test/unit/tracing/stats.cpp" "test/CMakeFiles/unittest.dir/unit/tracing/stats.cpp.o" "gcc" "test/CMakeFiles/unittest.dir/unit/tracing/stats.cpp.o.d"
+  "/root/repo/test/unit/tracing/symbol_chain.cpp" "test/CMakeFiles/unittest.dir/unit/tracing/symbol_chain.cpp.o" "gcc" "test/CMakeFiles/unittest.dir/unit/tracing/symbol_chain.cpp.o.d"
+  "/root/repo/test/unit/tracing/symbolication.cpp" "test/CMakeFiles/unittest.dir/unit/tracing/symbolication.cpp.o" "gcc" "test/CMakeFiles/unittest.dir/unit/tracing/symbolication.cpp.o.d"
+  "/root/repo/test/unit/tracing/thread_dump.cpp" "test/CMakeFiles/unittest.dir/unit/tracing/thread_dump.cpp.o" "gcc" "test/CMakeFiles/unittest.dir/unit/tracing/thread_dump.cpp.o.d"
+  "/root/repo/test/unit/tracing/trace_table.cpp" "test/CMakeFiles/unittest.dir/unit/tracing/trace_table.cpp.o" "gcc" "test/CMakeFiles/unittest.dir/unit/tracing/trace_table.cpp.o.d"
+  "/root/repo/test/unit/tracing/traced_exception.cpp" "test/CMakeFiles/unittest.dir/unit/tracing/traced_exception.cpp.o" "gcc" "test/CMakeFiles/unittest.dir/unit/tracing/traced_exception.cpp.o.d"
+  "/root/repo/test/unit/tracing/try_catch.cpp" "test/CMakeFiles/unittest.dir/unit/tracing/try_catch.cpp.o" "gcc" "test/CMakeFiles/unittest.dir/unit/tracing/try_catch.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_gate_release/CMakeFiles/cpptrace-lib.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
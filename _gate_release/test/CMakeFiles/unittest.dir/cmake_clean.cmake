@@ -0,0 +1,75 @@
+file(REMOVE_RECURSE
+  "../unittest"
+  "../unittest.pdb"
+  "CMakeFiles/unittest.dir/unit/internals/general.cpp.o"
+  "CMakeFiles/unittest.dir/unit/internals/general.cpp.o.d"
+  "CMakeFiles/unittest.dir/unit/internals/lru_cache.cpp.o"
+  "CMakeFiles/unittest.dir/unit/internals/lru_cache.cpp.o.d"
+  "CMakeFiles/unittest.dir/unit/internals/memory_mapping.cpp.o"
+  "CMakeFiles/unittest.dir/unit/internals/memory_mapping.cpp.o.d"
+  "CMakeFiles/unittest.dir/unit/internals/optional.cpp.o"
+  "CMakeFiles/unittest.dir/unit/internals/optional.cpp.o.d"
+  "CMakeFiles/unittest.dir/unit/internals/result.cpp.o"
+  "CMakeFiles/unittest.dir/unit/internals/result.cpp.o.d"
+  "CMakeFiles/unittest.dir/unit/internals/span.cpp.o"
+  "CMakeFiles/unittest.dir/unit/internals/span.cpp.o.d"
+  "CMakeFiles/unittest.dir/unit/internals/string_utils.cpp.o"
+  "CMakeFiles/unittest.dir/unit/internals/string_utils.cpp.o.d"
+  "CMakeFiles/unittest.dir/unit/internals/string_view.cpp.o"
+  "CMakeFiles/unittest.dir/unit/internals/string_view.cpp.o.d"
+  "CMakeFiles/unittest.dir/unit/lib/demangle.cpp.o"
+  "CMakeFiles/unittest.dir/unit/lib/demangle.cpp.o.d"
+  "CMakeFiles/unittest.dir/unit/lib/demangle_corpus.cpp.o"
+  "CMakeFiles/unittest.dir/unit/lib/demangle_corpus.cpp.o.d"
+  "CMakeFiles/unittest.dir/unit/lib/formatting.cpp.o"
+  "CMakeFiles/unittest.dir/unit/lib/formatting.cpp.o.d"
+  "CMakeFiles/unittest.dir/unit/lib/nullable.cpp.o"
+  "CMakeFiles/unittest.dir/unit/lib/nullable.cpp.o.d"
+  "CMakeFiles/unittest.dir/unit/lib/prune_symbol.cpp.o"
+  "CMakeFiles/unittest.dir/unit/lib/prune_symbol.cpp.o.d"
+  "CMakeFiles/unittest.dir/unit/main.cpp.o"
+  "CMakeFiles/unittest.dir/unit/main.cpp.o.d"
+  "CMakeFiles/unittest.dir/unit/tracing/addr2line.cpp.o"
+  "CMakeFiles/unittest.dir/unit/tracing/addr2line.cpp.o.d"
+  "CMakeFiles/unittest.dir/unit/tracing/crash_reporting.cpp.o"
+  "CMakeFiles/unittest.dir/unit/tracing/crash_reporting.cpp.o.d"
+  "CMakeFiles/unittest.dir/unit/tracing/from_current.cpp.o"
+  "CMakeFiles/unittest.dir/unit/tracing/from_current.cpp.o.d"
+  "CMakeFiles/unittest.dir/unit/tracing/from_current_try_catch.cpp.o"
+  "CMakeFiles/unittest.dir/unit/tracing/from_current_try_catch.cpp.o.d"
+  "CMakeFiles/unittest.dir/unit/tracing/lazy_trace.cpp.o"
+  "CMakeFiles/unittest.dir/unit/tracing/lazy_trace.cpp.o.d"
+  "CMakeFiles/unittest.dir/unit/tracing/object_trace.cpp.o"
+  "CMakeFiles/unittest.dir/unit/tracing/object_trace.cpp.o.d"
+  "CMakeFiles/unittest.dir/unit/tracing/profiling.cpp.o"
+  "CMakeFiles/unittest.dir/unit/tracing/profiling.cpp.o.d"
+  "CMakeFiles/unittest.dir/unit/tracing/raw_trace.cpp.o"
+  "CMakeFiles/unittest.dir/unit/tracing/raw_trace.cpp.o.d"
+  "CMakeFiles/unittest.dir/unit/tracing/rethrow.cpp.o"
+  "CMakeFiles/unittest.dir/unit/tracing/rethrow.cpp.o.d"
+  "CMakeFiles/unittest.dir/unit/tracing/safe_formatting.cpp.o"
+  "CMakeFiles/unittest.dir/unit/tracing/safe_formatting.cpp.o.d"
+  "CMakeFiles/unittest.dir/unit/tracing/serialization.cpp.o"
+  "CMakeFiles/unittest.dir/unit/tracing/serialization.cpp.o.d"
+  "CMakeFiles/unittest.dir/unit/tracing/stacktrace.cpp.o"
+  "CMakeFiles/unittest.dir/unit/tracing/stacktrace.cpp.o.d"
+  "CMakeFiles/unittest.dir/unit/tracing/stats.cpp.o"
+  "CMakeFiles/unittest.dir/unit/tracing/stats.cpp.o.d"
+  "CMakeFiles/unittest.dir/unit/tracing/symbol_chain.cpp.o"
+  "CMakeFiles/unittest.dir/unit/tracing/symbol_chain.cpp.o.d"
+  "CMakeFiles/unittest.dir/unit/tracing/symbolication.cpp.o"
+  "CMakeFiles/unittest.dir/unit/tracing/symbolication.cpp.o.d"
+  "CMakeFiles/unittest.dir/unit/tracing/thread_dump.cpp.o"
+  "CMakeFiles/unittest.dir/unit/tracing/thread_dump.cpp.o.d"
+  "CMakeFiles/unittest.dir/unit/tracing/trace_table.cpp.o"
+  "CMakeFiles/unittest.dir/unit/tracing/trace_table.cpp.o.d"
+  "CMakeFiles/unittest.dir/unit/tracing/traced_exception.cpp.o"
+  "CMakeFiles/unittest.dir/unit/tracing/traced_exception.cpp.o.d"
+  "CMakeFiles/unittest.dir/unit/tracing/try_catch.cpp.o"
+  "CMakeFiles/unittest.dir/unit/tracing/try_catch.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/unittest.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
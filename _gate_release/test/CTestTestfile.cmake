@@ -0,0 +1,8 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/test
+# Build directory: /root/repo/_gate_release/test
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test([=[unittest]=] "/root/repo/_gate_release/unittest")
+set_tests_properties([=[unittest]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/test/CMakeLists.txt;138;add_test;/root/repo/test/CMakeLists.txt;157;test_cpptrace;/root/repo/test/CMakeLists.txt;0;")
@@ -0,0 +1,79 @@
+#include <cpptrace/cpptrace.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Symbol processing throughput in symbols per second: demangling with and without the demangle cache, the signal-safe
+// demangler, and the prune_symbol and prettify_symbol passes formatters run over demangled names.
+
+static const char* const mangled_symbols[] = {
+    "_Z3fooiPKc",
+    "_ZN2ns9to_stringB5cxx11ERKNS_5pointE",
+    "_ZN12_GLOBAL__N_16worker3runERKSt10shared_ptrI4taskE",
+    "_ZNSt6vectorIiSaIiEE12emplace_backIJiEEERiDpOT_",
+    "_ZNSt10unique_ptrIN2ns5pointESt14default_deleteIS1_EED2Ev",
+    "_ZNSt17_Function_handlerIFvvEZ4mainEUlvE_E9_M_invokeERKSt9_Any_data",
+    "_ZNSt6vectorIiSaIiEE17_M_realloc_insertIJiEEEvN9__gnu_cxx17__normal_iteratorIPiS1_EEDpOT_",
+    "_ZNSt3mapINSt7__cxx1112basic_stringIcSt11char_traitsIcESaIcEEEiSt4lessIS5_ESaISt4pairIKS5_iEEEixEOS5_",
+};
+
+static std::vector<std::string> symbols(bool demangled) {
+    std::vector<std::string> out;
+    for(const auto symbol : mangled_symbols) {
+        out.push_back(demangled ? cpptrace::demangle(symbol) : symbol);
+    }
+    return out;
+}
+
+template<typename F>
+static void run_over_symbols(benchmark::State& state, const std::vector<std::string>& input, F f) {
+    for(auto _ : state) {
+        for(const auto& symbol : input) {
+            benchmark::DoNotOptimize(f(symbol));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<long long>(input.size()));
+}
+
+static void demangle_uncached(benchmark::State& state) {
+    cpptrace::experimental::set_demangle_cache_size(0);
+    run_over_symbols(state, symbols(false), [] (const std::string& symbol) { return cpptrace::demangle(symbol); });
+    cpptrace::experimental::set_demangle_cache_size(cpptrace::experimental::default_demangle_cache_size);
+}
+BENCHMARK(demangle_uncached);
+
+static void demangle_cached(benchmark::State& state) {
+    run_over_symbols(state, symbols(false), [] (const std::string& symbol) { return cpptrace::demangle(symbol); });
+}
+BENCHMARK(demangle_cached);
+
+// The cache is sharded so threads looking up different names shouldn't serialize
+static void demangle_cached_contended(benchmark::State& state) {
+    run_over_symbols(state, symbols(false), [] (const std::string& symbol) { return cpptrace::demangle(symbol); });
+}
+BENCHMARK(demangle_cached_contended)->ThreadRange(1, 8)->UseRealTime();
+
+static void demangle_signal_safe(benchmark::State& state) {
+    run_over_symbols(state, symbols(false), [] (const std::string& symbol) {
+        char buffer[1024];
+        return cpptrace::experimental::demangle_signal_safe(symbol.c_str(), buffer, sizeof(buffer));
+    });
+}
+BENCHMARK(demangle_signal_safe);
+
+static void prune_symbol(benchmark::State& state) {
+    run_over_symbols(state, symbols(true), [] (const std::string& symbol) { return cpptrace::prune_symbol(symbol); });
+}
+BENCHMARK(prune_symbol);
+
+static void prettify_symbol(benchmark::State& state) {
+    run_over_symbols(state, symbols(true), [] (const std::string& symbol) {
+        return cpptrace::prettify_symbol(symbol);
+    });
+}
+BENCHMARK(prettify_symbol);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,126 @@
+#include <cpptrace/cpptrace.hpp>
+#include <cpptrace/formatting.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Formatting throughput in frames per second. The trace is synthetic so the numbers don't depend on the symbol
+// back-end, the symbols are the sort of heavily templated names libstdc++ and msvc stack traces are full of.
+
+static const char* const symbols[] = {
+    "main",
+    "foo(int, char const*)",
+    "std::vector<int, std::allocator<int> >::_M_realloc_insert<int const&>(__gnu_cxx::__normal_iterator<int*, "
+        "std::vector<int, std::allocator<int> > >, int const&)",
+    "std::_Function_handler<void (), main::{lambda()#1}>::_M_invoke(std::_Any_data const&)",
+    "std::map<std::__cxx11::basic_string<char, std::char_traits<char>, std::allocator<char> >, int, "
+        "std::less<std::__cxx11::basic_string<char, std::char_traits<char>, std::allocator<char> > >, "
+        "std::allocator<std::pair<std::__cxx11::basic_string<char, std::char_traits<char>, std::allocator<char> > "
+        "const, int> > >::operator[](std::__cxx11::basic_string<char, std::char_traits<char>, "
+        "std::allocator<char> > const&)",
+    "std::unique_ptr<foo::bar, std::default_delete<foo::bar> >::~unique_ptr()",
+    "(anonymous namespace)::worker::run(std::shared_ptr<task> const&)",
+    "void __cdecl `anonymous namespace'::process(class std::vector<int,class std::allocator<int> > const &)",
+    "class std::basic_string<char,struct std::char_traits<char>,class std::allocator<char> > __cdecl "
+        "ns::to_string(struct ns::point const &)",
+    "std::thread::_State_impl<std::thread::_Invoker<std::tuple<void (*)(int), int> > >::_M_run()",
+};
+
+static cpptrace::stacktrace synthetic_trace() {
+    cpptrace::stacktrace trace;
+    std::uint32_t line = 10;
+    for(int i = 0; i < 4; i++) {
+        for(const auto symbol : symbols) {
+            trace.frames.push_back({
+                0x401000u + line,
+                0x1000u + line,
+                line,
+                line % 80,
+                "/home/user/project/src/some/deeply/nested/directory/file.cpp",
+                symbol,
+                false
+            });
+            line += 17;
+        }
+    }
+    return trace;
+}
+
+static void run_format(benchmark::State& state, const cpptrace::formatter& formatter) {
+    auto trace = synthetic_trace();
+    for(auto _ : state) {
+        benchmark::DoNotOptimize(formatter.format(trace));
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<long long>(trace.frames.size()));
+}
+
+static void format_full_symbols(benchmark::State& state) {
+    run_format(state, cpptrace::formatter{});
+}
+BENCHMARK(format_full_symbols);
+
+static void format_pretty_symbols(benchmark::State& state) {
+    run_format(state, cpptrace::formatter{}.symbols(cpptrace::formatter::symbol_mode::pretty));
+}
+BENCHMARK(format_pretty_symbols);
+
+static void format_pruned_symbols(benchmark::State& state) {
+    run_format(state, cpptrace::formatter{}.symbols(cpptrace::formatter::symbol_mode::pruned));
+}
+BENCHMARK(format_pruned_symbols);
+
+static void format_pretty_symbols_with_color(benchmark::State& state) {
+    run_format(
+        state,
+        cpptrace::formatter{}
+            .symbols(cpptrace::formatter::symbol_mode::pretty)
+            .colors(cpptrace::formatter::color_mode::always)
+    );
+}
+BENCHMARK(format_pretty_symbols_with_color);
+
+// Snippets read source files, point the frames at lines in this file
+static void format_with_snippets(benchmark::State& state) {
+    auto trace = synthetic_trace();
+    std::uint32_t line = 1;
+    for(auto& frame : trace.frames) {
+        frame.filename = __FILE__;
+        frame.line = line;
+        line = line % 90 + 7;
+    }
+    auto formatter = cpptrace::formatter{}.symbols(cpptrace::formatter::symbol_mode::pretty).snippets(true);
+    for(auto _ : state) {
+        benchmark::DoNotOptimize(formatter.format(trace));
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<long long>(trace.frames.size()));
+}
+BENCHMARK(format_with_snippets);
+
+static void print_pretty_symbols_to_file(benchmark::State& state) {
+    auto formatter = cpptrace::formatter{}.symbols(cpptrace::formatter::symbol_mode::pretty);
+    auto trace = synthetic_trace();
+    std::FILE* file = std::fopen(
+        #ifdef _WIN32
+         "NUL",
+        #else
+         "/dev/null",
+        #endif
+        "w"
+    );
+    if(!file) {
+        state.SkipWithError("failed to open the null device");
+        return;
+    }
+    for(auto _ : state) {
+        formatter.print(file, trace);
+    }
+    std::fclose(file);
+    state.SetItemsProcessed(state.iterations() * static_cast<long long>(trace.frames.size()));
+}
+BENCHMARK(print_pretty_symbols_to_file);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,146 @@
+#include <cpptrace/basic.hpp>
+#include <cpptrace/from_current.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cstddef>
+#include <utility>
+
+// The cost from_current support adds before any exception is thrown. Off MSVC every CPPTRACE_CATCH type gets an unwind
+// interceptor, set up during dynamic initialization of whatever object contains the try block: its type_info's vtable
+// is copied to a new page and the type_info page is made writable and restored, which needs the page's protections from
+// /proc/self/maps on Linux. That's paid once per distinct type, so a program or library with thousands of try sites
+// pays it thousands of times at load.
+// The throw benchmarks measure throughput when exceptions are used for control flow: every throw through a matching
+// CPPTRACE_CATCH captures a trace, in full, bounded to a few frames, or not at all, compared with plain try/catch.
+
+#ifndef _MSC_VER
+// Each try site's catch type, interceptors for these are only prepared when the benchmark asks
+template<std::size_t I>
+struct site {};
+
+constexpr std::size_t site_count = 1024;
+
+template<std::size_t... I>
+constexpr std::array<int(*)(), sizeof...(I)> make_site_preparers(std::index_sequence<I...>) {
+    return {{&cpptrace::detail::prepare_unwind_interceptor<site<I>>...}};
+}
+
+static constexpr auto site_preparers = make_site_preparers(std::make_index_sequence<site_count>{});
+static std::size_t next_site = 0;
+
+// What dynamic initialization does for each new try site, the first iteration also includes the first read of
+// /proc/self/maps. Each site can only be prepared once per process.
+static void try_first_entry(benchmark::State& state) {
+    for(auto _ : state) {
+        if(next_site == site_count) {
+            state.SkipWithError("Ran out of try sites");
+            break;
+        }
+        benchmark::DoNotOptimize(site_preparers[next_site++]());
+    }
+}
+BENCHMARK(try_first_entry)->Iterations(site_count);
+
+struct warm_site {};
+
+// For comparison against first entry, and against try_plain: entering a try block after setup
+static void try_warm_entry(benchmark::State& state) {
+    for(auto _ : state) {
+        CPPTRACE_TRY {
+            benchmark::ClobberMemory();
+        } CPPTRACE_CATCH(const warm_site&) {
+            state.SkipWithError("Unexpected exception");
+        }
+    }
+}
+BENCHMARK(try_warm_entry);
+#endif
+
+static void try_plain(benchmark::State& state) {
+    for(auto _ : state) {
+        try {
+            benchmark::ClobberMemory();
+        } catch(const int&) {
+            state.SkipWithError("Unexpected exception");
+        }
+    }
+}
+BENCHMARK(try_plain);
+
+using cpptrace::experimental::current_exception_trace_mode;
+using cpptrace::experimental::set_current_exception_trace_mode;
+
+struct control_flow {};
+
+// Below the try block
+CPPTRACE_FORCE_NO_INLINE static void throw_at_depth(int depth) {
+    if(depth == 0) {
+        throw control_flow{};
+    }
+    throw_at_depth(depth - 1);
+    benchmark::ClobberMemory(); // not a tail call
+}
+
+// Above the try block, about as deep as a service's request handling. A full capture unwinds all of it.
+template<typename F>
+CPPTRACE_FORCE_NO_INLINE static void at_stack_depth(int depth, F f) {
+    if(depth == 0) {
+        f();
+    } else {
+        at_stack_depth(depth - 1, f);
+    }
+    benchmark::ClobberMemory();
+}
+
+constexpr int throw_depth = 4;
+constexpr int caller_depth = 32;
+
+static void throw_plain(benchmark::State& state) {
+    at_stack_depth(caller_depth, [&] {
+        for(auto _ : state) {
+            try {
+                throw_at_depth(throw_depth);
+            } catch(const control_flow&) {
+                benchmark::ClobberMemory();
+            }
+        }
+    });
+}
+BENCHMARK(throw_plain);
+
+static void throw_cpptrace_try(benchmark::State& state, current_exception_trace_mode mode, std::size_t max_depth) {
+    set_current_exception_trace_mode(mode, max_depth);
+    at_stack_depth(caller_depth, [&] {
+        for(auto _ : state) {
+            CPPTRACE_TRY {
+                throw_at_depth(throw_depth);
+            } CPPTRACE_CATCH(const control_flow&) {
+                benchmark::ClobberMemory();
+            }
+        }
+    });
+    set_current_exception_trace_mode(current_exception_trace_mode::full);
+}
+BENCHMARK_CAPTURE(throw_cpptrace_try, full, current_exception_trace_mode::full, 0);
+BENCHMARK_CAPTURE(throw_cpptrace_try, bounded_16, current_exception_trace_mode::bounded, 16);
+BENCHMARK_CAPTURE(throw_cpptrace_try, bounded_0, current_exception_trace_mode::bounded, 0);
+
+// What a deferred trace costs when the catch block does read it
+static void throw_cpptrace_try_read_trace(benchmark::State& state) {
+    set_current_exception_trace_mode(current_exception_trace_mode::bounded, 16);
+    at_stack_depth(caller_depth, [&] {
+        for(auto _ : state) {
+            CPPTRACE_TRY {
+                throw_at_depth(throw_depth);
+            } CPPTRACE_CATCH(const control_flow&) {
+                benchmark::DoNotOptimize(cpptrace::raw_trace_from_current_exception().frames.size());
+            }
+        }
+    });
+    set_current_exception_trace_mode(current_exception_trace_mode::full);
+}
+BENCHMARK(throw_cpptrace_try_read_trace);
+
+BENCHMARK_MAIN();
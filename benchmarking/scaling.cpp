@@ -0,0 +1,116 @@
+#include <cpptrace/cpptrace.hpp>
+#include <cpptrace/stats.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <fstream>
+#include <string>
+
+#include <dlfcn.h>
+#include <unistd.h>
+
+#include "synthetic/synthetic.hpp"
+
+// How the cost of resolution scales with the size of a binary's debug info. For each synthetic library, setup measures
+// the first resolution, which is when back-ends load and index debug info, and how much resident memory that took.
+// lookup measures steady state resolution afterwards. Setup can only be measured once per process, so it's registered
+// with a single iteration and all setups run before any lookups. Build with CPPTRACE_STATS=On to also get the time
+// spent constructing resolvers.
+
+struct scaling_binary {
+    const char* name;
+    const char* path;
+    std::size_t compile_units;
+    std::size_t functions_per_unit;
+};
+
+static const scaling_binary scaling_binaries[] = {
+    #include "scaling_binaries.inc"
+};
+
+constexpr std::size_t sampled_frames = 64;
+
+static long long resident_bytes() {
+    #ifdef __linux__
+     std::ifstream statm("/proc/self/statm");
+     long long size;
+     long long resident;
+     if(statm >> size >> resident) {
+         return resident * sysconf(_SC_PAGESIZE);
+     }
+    #endif
+    return 0;
+}
+
+static bool load_binary(const scaling_binary& info, synthetic_binary& binary) {
+    void* handle = dlopen(info.path, RTLD_NOW | RTLD_LOCAL);
+    if(!handle) {
+        return false;
+    }
+    auto function_count = dlsym(handle, (std::string(info.name) + "_function_count").c_str());
+    auto call = dlsym(handle, (std::string(info.name) + "_call").c_str());
+    if(!function_count || !call) {
+        return false;
+    }
+    binary.function_count = reinterpret_cast<decltype(binary.function_count)>(function_count);
+    binary.call = reinterpret_cast<decltype(binary.call)>(call);
+    return true;
+}
+
+static void set_binary_counters(benchmark::State& state, const scaling_binary& info) {
+    state.SetLabel(CPPTRACE_BENCHMARK_SYMBOLS_BACKEND);
+    state.counters["compile_units"] = static_cast<double>(info.compile_units);
+    state.counters["functions"] = static_cast<double>(info.compile_units * info.functions_per_unit);
+}
+
+static void setup(benchmark::State& state, const scaling_binary& info) {
+    synthetic_binary binary;
+    if(!load_binary(info, binary)) {
+        state.SkipWithError(dlerror());
+        return;
+    }
+    auto trace = sample_synthetic_frames(binary, sampled_frames);
+    cpptrace::experimental::reset_stats();
+    auto resident_before = resident_bytes();
+    for(auto _ : state) {
+        benchmark::DoNotOptimize(trace.resolve());
+    }
+    set_binary_counters(state, info);
+    state.counters["resident_bytes"] = static_cast<double>(resident_bytes() - resident_before);
+    auto stats = cpptrace::experimental::get_stats();
+    if(stats.enabled) {
+        state.counters["resolver_construction_ns"] = static_cast<double>(stats.resolver_construction.nanoseconds);
+    }
+}
+
+static void lookup(benchmark::State& state, const scaling_binary& info) {
+    synthetic_binary binary;
+    if(!load_binary(info, binary)) {
+        state.SkipWithError(dlerror());
+        return;
+    }
+    auto trace = sample_synthetic_frames(binary, sampled_frames);
+    benchmark::DoNotOptimize(trace.resolve());
+    for(auto _ : state) {
+        benchmark::DoNotOptimize(trace.resolve());
+    }
+    set_binary_counters(state, info);
+    state.SetItemsProcessed(state.iterations() * static_cast<long long>(trace.frames.size()));
+}
+
+int main(int argc, char** argv) {
+    for(const auto& info : scaling_binaries) {
+        benchmark::RegisterBenchmark((std::string("setup/") + info.name).c_str(), setup, info)->Iterations(1);
+    }
+    for(const auto& info : scaling_binaries) {
+        benchmark::RegisterBenchmark((std::string("lookup/") + info.name).c_str(), lookup, info);
+    }
+    benchmark::Initialize(&argc, argv);
+    if(benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,181 @@
+#include <cpptrace/cpptrace.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <vector>
+
+#include "synthetic/synthetic.hpp"
+#include "synthetic_cold.hpp"
+#include "synthetic_no_aranges.hpp"
+#include "synthetic_warm.hpp"
+#ifdef CPPTRACE_BENCHMARK_SPLIT_DWARF
+ #include "synthetic_split_dwarf.hpp"
+#endif
+
+// Resolution cost depends on the symbol back-end cpptrace was configured with. To compare back-ends build this
+// benchmark once per back-end on the same machine, e.g. with -DCPPTRACE_GET_SYMBOLS_WITH_LIBDWARF=On and
+// -DCPPTRACE_GET_SYMBOLS_WITH_LIBBACKTRACE=On, and compare the results with google benchmark's compare.py. The
+// back-end is reported in each benchmark's label.
+
+#if defined(__GNUC__) || defined(__clang__)
+ #define RESOLUTION_NOINLINE __attribute__((noinline))
+ #define RESOLUTION_ALWAYS_INLINE __attribute__((always_inline)) inline
+#else
+ #define RESOLUTION_NOINLINE __declspec(noinline)
+ #define RESOLUTION_ALWAYS_INLINE __forceinline
+#endif
+
+template<int N>
+struct call_chain {
+    RESOLUTION_NOINLINE static cpptrace::raw_trace capture() {
+        auto trace = call_chain<N - 1>::capture();
+        benchmark::DoNotOptimize(trace);
+        return trace;
+    }
+};
+
+template<>
+struct call_chain<0> {
+    // inlined frames exercise the back-ends' inline chain handling
+    RESOLUTION_ALWAYS_INLINE static cpptrace::raw_trace inlined() {
+        return cpptrace::generate_raw_trace();
+    }
+    RESOLUTION_NOINLINE static cpptrace::raw_trace capture() {
+        return inlined();
+    }
+};
+
+// A handful of distinct traces with overlapping frames, as a process would see from different call sites
+std::vector<cpptrace::raw_trace> distinct_traces() {
+    return {
+        call_chain<5>::capture(),
+        call_chain<10>::capture(),
+        call_chain<20>::capture(),
+        call_chain<40>::capture(),
+    };
+}
+
+static void resolve_single_trace(benchmark::State& state) {
+    state.SetLabel(CPPTRACE_BENCHMARK_SYMBOLS_BACKEND);
+    auto trace = call_chain<10>::capture();
+    // the first resolution loads debug info, measure steady state lookups
+    benchmark::DoNotOptimize(trace.resolve());
+    for(auto _ : state) {
+        benchmark::DoNotOptimize(trace.resolve());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<long long>(trace.frames.size()));
+}
+BENCHMARK(resolve_single_trace);
+
+static void resolve_distinct_traces(benchmark::State& state) {
+    state.SetLabel(CPPTRACE_BENCHMARK_SYMBOLS_BACKEND);
+    auto traces = distinct_traces();
+    long long frames = 0;
+    for(const auto& trace : traces) {
+        benchmark::DoNotOptimize(trace.resolve());
+        frames += static_cast<long long>(trace.frames.size());
+    }
+    for(auto _ : state) {
+        for(const auto& trace : traces) {
+            benchmark::DoNotOptimize(trace.resolve());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * frames);
+}
+BENCHMARK(resolve_distinct_traces);
+
+// Frames sampled from the synthetic libraries, each one in a different function
+constexpr std::size_t synthetic_frames = 64;
+
+static void set_synthetic_counters(benchmark::State& state, const cpptrace::raw_trace& trace) {
+    state.SetLabel(CPPTRACE_BENCHMARK_SYMBOLS_BACKEND);
+    state.SetItemsProcessed(state.iterations() * static_cast<long long>(trace.frames.size()));
+}
+
+// Steady state resolution of frames spread over a library's compile units
+static void run_warm_resolution(benchmark::State& state, const cpptrace::raw_trace& trace) {
+    benchmark::DoNotOptimize(trace.resolve());
+    for(auto _ : state) {
+        benchmark::DoNotOptimize(trace.resolve());
+    }
+    set_synthetic_counters(state, trace);
+}
+
+// The first resolution in a library, which loads and indexes its debug info. This can only be measured once per process
+// since cpptrace keeps what it loads, nothing else uses synthetic_cold.
+static void resolve_cold(benchmark::State& state) {
+    auto trace = sample_synthetic_frames(SYNTHETIC_BINARY(synthetic_cold), synthetic_frames);
+    for(auto _ : state) {
+        benchmark::DoNotOptimize(trace.resolve());
+    }
+    set_synthetic_counters(state, trace);
+}
+BENCHMARK(resolve_cold)->Iterations(1);
+
+static void resolve_warm(benchmark::State& state) {
+    run_warm_resolution(state, sample_synthetic_frames(SYNTHETIC_BINARY(synthetic_warm), synthetic_frames));
+}
+BENCHMARK(resolve_warm);
+
+static void resolve_warm_without_inlines(benchmark::State& state) {
+    cpptrace::enable_inlined_call_resolution(false);
+    run_warm_resolution(state, sample_synthetic_frames(SYNTHETIC_BINARY(synthetic_warm), synthetic_frames));
+    cpptrace::enable_inlined_call_resolution(true);
+}
+BENCHMARK(resolve_warm_without_inlines);
+
+#ifdef CPPTRACE_BENCHMARK_SPLIT_DWARF
+static void resolve_warm_split_dwarf(benchmark::State& state) {
+    run_warm_resolution(state, sample_synthetic_frames(SYNTHETIC_BINARY(synthetic_split_dwarf), synthetic_frames));
+}
+BENCHMARK(resolve_warm_split_dwarf);
+#endif
+
+// The aranges setting is read when a library's resolver is created, so the disabled case uses a library nothing else
+// resolves. resolve_warm covers the enabled case.
+static void resolve_warm_aranges_disabled(benchmark::State& state) {
+    cpptrace::experimental::set_dwarf_resolver_disable_aranges(true);
+    run_warm_resolution(state, sample_synthetic_frames(SYNTHETIC_BINARY(synthetic_no_aranges), synthetic_frames));
+    cpptrace::experimental::set_dwarf_resolver_disable_aranges(false);
+}
+BENCHMARK(resolve_warm_aranges_disabled);
+
+// With prioritize_memory back-ends keep as little as possible between resolutions, which approximates cold resolution
+// on every iteration
+static void resolve_cache_mode(benchmark::State& state, cpptrace::cache_mode mode) {
+    cpptrace::experimental::set_cache_mode(mode);
+    run_warm_resolution(state, sample_synthetic_frames(SYNTHETIC_BINARY(synthetic_warm), synthetic_frames));
+    cpptrace::experimental::set_cache_mode(cpptrace::cache_mode::prioritize_speed);
+}
+BENCHMARK_CAPTURE(resolve_cache_mode, prioritize_memory, cpptrace::cache_mode::prioritize_memory);
+BENCHMARK_CAPTURE(resolve_cache_mode, hybrid, cpptrace::cache_mode::hybrid);
+BENCHMARK_CAPTURE(resolve_cache_mode, prioritize_speed, cpptrace::cache_mode::prioritize_speed);
+
+static void resolve_aranges_prioritize_memory(benchmark::State& state, bool disable_aranges) {
+    cpptrace::experimental::set_cache_mode(cpptrace::cache_mode::prioritize_memory);
+    cpptrace::experimental::set_dwarf_resolver_disable_aranges(disable_aranges);
+    run_warm_resolution(state, sample_synthetic_frames(SYNTHETIC_BINARY(synthetic_warm), synthetic_frames));
+    cpptrace::experimental::set_dwarf_resolver_disable_aranges(false);
+    cpptrace::experimental::set_cache_mode(cpptrace::cache_mode::prioritize_speed);
+}
+BENCHMARK_CAPTURE(resolve_aranges_prioritize_memory, enabled, false);
+BENCHMARK_CAPTURE(resolve_aranges_prioritize_memory, disabled, true);
+
+// Raw trace to object trace, i.e. finding the object and object-relative address for each frame
+static void resolve_object_trace(benchmark::State& state) {
+    auto trace = sample_synthetic_frames(SYNTHETIC_BINARY(synthetic_warm), synthetic_frames);
+    for(auto _ : state) {
+        benchmark::DoNotOptimize(trace.resolve_object_trace());
+    }
+    set_synthetic_counters(state, trace);
+}
+BENCHMARK(resolve_object_trace);
+
+// Several threads resolving at once, back-ends serialize some or all of their work
+static void resolve_contended(benchmark::State& state) {
+    run_warm_resolution(state, sample_synthetic_frames(SYNTHETIC_BINARY(synthetic_warm), synthetic_frames));
+}
+BENCHMARK(resolve_contended)->ThreadRange(1, 8)->UseRealTime();
+
+BENCHMARK_MAIN();
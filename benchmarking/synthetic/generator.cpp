@@ -0,0 +1,187 @@
+// Writes the sources for a synthetic shared library with a controlled amount of code and debug info, for resolution
+// benchmarks. Usage:
+//   synthetic_generator <output directory> <name> <compile units> <functions per unit> <inline depth>
+// Produces <name>.hpp, <name>.cpp, and <name>_<i>.cpp for each compile unit. Each function calls a chain of
+// force-inlined function templates, instantiated with a few different types, which ends in a callback so the benchmark
+// can capture a trace from inside the inline chain. <name>.hpp declares:
+//   std::size_t <name>_function_count();
+//   void <name>_call(std::size_t index, void (*callback)(void*), void* context);
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+namespace {
+    const char* const value_types[] = { "int", "long", "unsigned", "double" };
+    constexpr std::size_t value_type_count = sizeof(value_types) / sizeof(value_types[0]);
+
+    const char* const attribute_macros =
+        "#if defined(_MSC_VER)\n"
+        " #define SYNTHETIC_NOINLINE __declspec(noinline)\n"
+        " #define SYNTHETIC_ALWAYS_INLINE __forceinline\n"
+        "#else\n"
+        " #define SYNTHETIC_NOINLINE __attribute__((noinline))\n"
+        " #define SYNTHETIC_ALWAYS_INLINE __attribute__((always_inline)) inline\n"
+        "#endif\n"
+        "\n";
+
+    bool parse_count(const char* str, std::size_t& out) {
+        errno = 0;
+        char* end;
+        auto value = std::strtoull(str, &end, 10);
+        if(errno != 0 || end == str || *end != 0) {
+            return false;
+        }
+        out = static_cast<std::size_t>(value);
+        return true;
+    }
+
+    // Only rewrites files whose contents changed so regenerating doesn't trigger a full rebuild
+    bool write_file(const std::string& path, const std::string& contents) {
+        {
+            std::ifstream existing(path, std::ios::binary);
+            if(existing) {
+                std::string current{std::istreambuf_iterator<char>(existing), std::istreambuf_iterator<char>()};
+                if(current == contents) {
+                    return true;
+                }
+            }
+        }
+        std::ofstream file(path, std::ios::binary);
+        file << contents;
+        if(!file) {
+            std::fprintf(stderr, "synthetic_generator: couldn't write %s\n", path.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    std::string unit_namespace(const std::string& name, std::size_t unit) {
+        return name + "_unit_" + std::to_string(unit);
+    }
+
+    std::string generate_unit(const std::string& name, std::size_t unit, std::size_t functions, std::size_t depth) {
+        std::string out = "// Generated by synthetic_generator, do not edit\n\n";
+        out += "#include \"" + name + ".hpp\"\n\n";
+        out += attribute_macros;
+        out += "namespace " + unit_namespace(name, unit) + " {\n";
+        // layer<0> runs the callback, each layer<n> is inlined into its caller
+        out += "    template<int N, typename T>\n";
+        out += "    struct layer {\n";
+        out += "        SYNTHETIC_ALWAYS_INLINE static void run(synthetic_callback callback, void* context, T value) {\n";
+        out += "            layer<N - 1, T>::run(callback, context, static_cast<T>(value + 1));\n";
+        out += "        }\n";
+        out += "    };\n\n";
+        out += "    template<typename T>\n";
+        out += "    struct layer<0, T> {\n";
+        out += "        SYNTHETIC_ALWAYS_INLINE static void run(synthetic_callback callback, void* context, T value) {\n";
+        out += "            volatile T before = value;\n";
+        out += "            callback(context);\n";
+        out += "            // keeps the callback from being a tail call\n";
+        out += "            volatile T after = before;\n";
+        out += "            (void)after;\n";
+        out += "        }\n";
+        out += "    };\n\n";
+        for(std::size_t i = 0; i < functions; i++) {
+            out += "    SYNTHETIC_NOINLINE void function_" + std::to_string(i)
+                + "(synthetic_callback callback, void* context) {\n";
+            out += "        layer<" + std::to_string(depth) + ", " + value_types[i % value_type_count]
+                + ">::run(callback, context, " + std::to_string(i) + ");\n";
+            out += "    }\n\n";
+        }
+        out += "    extern synthetic_function* const functions[] = {\n";
+        for(std::size_t i = 0; i < functions; i++) {
+            out += "        function_" + std::to_string(i) + ",\n";
+        }
+        out += "    };\n";
+        out += "}\n";
+        return out;
+    }
+
+    std::string generate_header(const std::string& name) {
+        std::string out = "// Generated by synthetic_generator, do not edit\n\n";
+        out += "#ifndef " + name + "_HPP\n";
+        out += "#define " + name + "_HPP\n\n";
+        out += "#include <cstddef>\n\n";
+        out += "#if defined(_WIN32)\n";
+        out += " #ifdef " + name + "_BUILDING\n";
+        out += "  #define " + name + "_EXPORT __declspec(dllexport)\n";
+        out += " #else\n";
+        out += "  #define " + name + "_EXPORT __declspec(dllimport)\n";
+        out += " #endif\n";
+        out += "#else\n";
+        out += " #define " + name + "_EXPORT __attribute__((visibility(\"default\")))\n";
+        out += "#endif\n\n";
+        out += "typedef void (*synthetic_callback)(void*);\n";
+        out += "typedef void synthetic_function(synthetic_callback, void*);\n\n";
+        out += "extern \"C\" " + name + "_EXPORT std::size_t " + name + "_function_count();\n";
+        out += "extern \"C\" " + name + "_EXPORT void " + name
+            + "_call(std::size_t index, synthetic_callback callback, void* context);\n\n";
+        out += "#endif\n";
+        return out;
+    }
+
+    std::string generate_entry(const std::string& name, std::size_t units, std::size_t functions) {
+        std::string out = "// Generated by synthetic_generator, do not edit\n\n";
+        out += "#include \"" + name + ".hpp\"\n\n";
+        for(std::size_t i = 0; i < units; i++) {
+            out += "namespace " + unit_namespace(name, i) + " { extern synthetic_function* const functions[]; }\n";
+        }
+        out += "\nnamespace {\n";
+        out += "    synthetic_function* const* const units[] = {\n";
+        for(std::size_t i = 0; i < units; i++) {
+            out += "        " + unit_namespace(name, i) + "::functions,\n";
+        }
+        out += "    };\n";
+        out += "}\n\n";
+        out += "std::size_t " + name + "_function_count() {\n";
+        out += "    return " + std::to_string(units * functions) + ";\n";
+        out += "}\n\n";
+        out += "void " + name + "_call(std::size_t index, synthetic_callback callback, void* context) {\n";
+        out += "    units[index / " + std::to_string(functions) + "][index % " + std::to_string(functions)
+            + "](callback, context);\n";
+        out += "}\n";
+        return out;
+    }
+}
+
+int main(int argc, char** argv) {
+    std::size_t units;
+    std::size_t functions;
+    std::size_t depth;
+    if(
+        argc != 6
+        || !parse_count(argv[3], units)
+        || !parse_count(argv[4], functions)
+        || !parse_count(argv[5], depth)
+        || units == 0
+        || functions == 0
+    ) {
+        std::fprintf(
+            stderr,
+            "Usage: %s <output directory> <name> <compile units> <functions per unit> <inline depth>\n",
+            argv[0]
+        );
+        return 1;
+    }
+    std::string directory = argv[1];
+    std::string name = argv[2];
+    if(!write_file(directory + "/" + name + ".hpp", generate_header(name))) {
+        return 1;
+    }
+    if(!write_file(directory + "/" + name + ".cpp", generate_entry(name, units, functions))) {
+        return 1;
+    }
+    for(std::size_t i = 0; i < units; i++) {
+        auto path = directory + "/" + name + "_" + std::to_string(i) + ".cpp";
+        if(!write_file(path, generate_unit(name, i, functions, depth))) {
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,34 @@
+#ifndef SYNTHETIC_HPP
+#define SYNTHETIC_HPP
+
+#include <cpptrace/cpptrace.hpp>
+
+#include <cstddef>
+
+// A library made by synthetic_generator, see add_synthetic_binary in benchmarking/CMakeLists.txt
+struct synthetic_binary {
+    std::size_t (*function_count)();
+    void (*call)(std::size_t index, void (*callback)(void*), void* context);
+};
+
+#define SYNTHETIC_BINARY(name) synthetic_binary{name##_function_count, name##_call}
+
+// Called from inside a synthetic function's inline chain
+inline void capture_synthetic_frame(void* trace) {
+    // skip this function, the next frame is the synthetic function
+    auto frame = cpptrace::generate_raw_trace(1, 1);
+    static_cast<cpptrace::raw_trace*>(trace)->frames.push_back(frame.frames.at(0));
+}
+
+// Captures a return address in each of count functions spread evenly over the library, so resolving the trace touches as
+// many compile units as possible. Each address is inside an inline chain.
+inline cpptrace::raw_trace sample_synthetic_frames(const synthetic_binary& binary, std::size_t count) {
+    cpptrace::raw_trace trace;
+    auto functions = binary.function_count();
+    for(std::size_t i = 0; i < count; i++) {
+        binary.call(i * functions / count, capture_synthetic_frame, &trace);
+    }
+    return trace;
+}
+
+#endif
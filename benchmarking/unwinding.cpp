@@ -7,13 +7,21 @@
 struct unwind_benchmark_info {
     benchmark::State& state;
     size_t& stack_depth;
+    // also look up the object for each frame
+    bool object_trace;
 };
 
 void unwind_loop(unwind_benchmark_info info) {
-    auto& [state, depth] = info;
+    auto& [state, depth, object_trace] = info;
     depth = cpptrace::generate_raw_trace().frames.size();
-    for(auto _ : state) {
-        benchmark::DoNotOptimize(cpptrace::generate_raw_trace());
+    if(object_trace) {
+        for(auto _ : state) {
+            benchmark::DoNotOptimize(cpptrace::generate_object_trace());
+        }
+    } else {
+        for(auto _ : state) {
+            benchmark::DoNotOptimize(cpptrace::generate_raw_trace());
+        }
     }
 }
 
@@ -40,7 +48,7 @@ void function_one(unwind_benchmark_info info, int) {
 
 static void unwinding(benchmark::State& state) {
     size_t stack_depth = 0;
-    function_one({state, stack_depth}, 0);
+    function_one({state, stack_depth, false}, 0);
     static bool did_print = false;
     if(!did_print) {
         did_print = true;
@@ -51,5 +59,11 @@ static void unwinding(benchmark::State& state) {
 // Register the function as a benchmark
 BENCHMARK(unwinding);
 
+static void object_trace_generation(benchmark::State& state) {
+    size_t stack_depth = 0;
+    function_one({state, stack_depth, true}, 0);
+}
+BENCHMARK(object_trace_generation);
+
 // Run the benchmark
 BENCHMARK_MAIN();
@@ -150,6 +150,7 @@ if(
   NOT (
     CPPTRACE_DEMANGLE_WITH_CXXABI OR
     CPPTRACE_DEMANGLE_WITH_WINAPI OR
+    CPPTRACE_DEMANGLE_WITH_BUILTIN OR
     CPPTRACE_DEMANGLE_WITH_NOTHING
   )
 )
@@ -144,6 +144,7 @@ option(CPPTRACE_UNWIND_WITH_NOTHING "" OFF)
 
 option(CPPTRACE_DEMANGLE_WITH_CXXABI "" OFF)
 option(CPPTRACE_DEMANGLE_WITH_WINAPI "" OFF)
+option(CPPTRACE_DEMANGLE_WITH_BUILTIN "" OFF)
 option(CPPTRACE_DEMANGLE_WITH_NOTHING "" OFF)
 
 # ---- Back-end configurations ----
@@ -159,6 +160,9 @@ if(PROJECT_IS_TOP_LEVEL)
   option(CPPTRACE_BUILD_TESTING "" OFF)
   option(CPPTRACE_BUILD_TOOLS "" OFF)
   option(CPPTRACE_BUILD_BENCHMARKING "" OFF)
+  option(CPPTRACE_BUILD_BENCHMARKING_SCALING "" OFF)
+  set(CPPTRACE_BENCHMARKING_SCALING_UNITS "16;128;1024" CACHE STRING "")
+  set(CPPTRACE_BENCHMARKING_SCALING_FUNCTIONS_PER_UNIT "64" CACHE STRING "")
   option(CPPTRACE_BUILD_NO_SYMBOLS "" OFF)
   option(CPPTRACE_BUILD_TESTING_SPLIT_DWARF "" OFF)
   set(CPPTRACE_BUILD_TESTING_DWARF_VERSION "0" CACHE STRING "")
@@ -167,6 +171,9 @@ if(PROJECT_IS_TOP_LEVEL)
     CPPTRACE_BUILD_TESTING
     CPPTRACE_BUILD_TOOLS
     CPPTRACE_BUILD_BENCHMARKING
+    CPPTRACE_BUILD_BENCHMARKING_SCALING
+    CPPTRACE_BENCHMARKING_SCALING_UNITS
+    CPPTRACE_BENCHMARKING_SCALING_FUNCTIONS_PER_UNIT
     CPPTRACE_BUILD_NO_SYMBOLS
     CPPTRACE_BUILD_TESTING_SPLIT_DWARF
     CPPTRACE_BUILD_TESTING_DWARF_VERSION
@@ -184,6 +191,7 @@ option(CPPTRACE_WERROR_BUILD "" OFF)
 option(CPPTRACE_POSITION_INDEPENDENT_CODE "" ON)
 option(CPPTRACE_SKIP_UNIT "" OFF)
 option(CPPTRACE_STD_FORMAT "" ON)
+option(CPPTRACE_STATS "" OFF)
 option(CPPTRACE_UNPREFIXED_TRY_CATCH "" OFF)
 option(CPPTRACE_USE_EXTERNAL_GTEST "" OFF)
 set(CPPTRACE_ZSTD_URL "https://github.com/facebook/zstd/releases/download/v1.5.7/zstd-1.5.7.tar.gz" CACHE STRING "")
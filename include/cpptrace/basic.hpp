@@ -3,6 +3,7 @@
 
 #include <cpptrace/forward.hpp>
 
+#include <cstdint>
 #include <limits>
 #include <string>
 #include <vector>
@@ -237,6 +238,72 @@ CPPTRACE_BEGIN_NAMESPACE
     CPPTRACE_EXPORT bool can_signal_safe_unwind();
     CPPTRACE_EXPORT bool can_get_safe_object_frame();
 
+    namespace experimental {
+        struct safe_module {
+            // Load bias, frames' object addresses are relative to it. Not unique, e.g. it's 0 for a non-PIE executable
+            // and for prelinked objects.
+            frame_ptr base;
+            // Null terminated. Owned by the dynamic loader, or by cpptrace for the main executable, and valid until the
+            // object is unloaded.
+            const char* path;
+            // Identifies the loaded object, the dynamic loader's link_map
+            const void* object;
+        };
+        constexpr std::uint32_t no_safe_module = std::numeric_limits<std::uint32_t>::max();
+        struct CPPTRACE_EXPORT safe_module_frame {
+            frame_ptr raw_address;
+            // Same as safe_object_frame::address_relative_to_object_start
+            frame_ptr object_address;
+            // Index into the module table, no_safe_module if the object is unknown or the module table was full
+            std::uint32_t module;
+            // To be called outside a signal handler. Not signal safe.
+            object_frame resolve(const safe_module* modules) const;
+        };
+        // signal-safe
+        // Batch version of get_safe_object_frame. Each distinct object is written to the module table once and frames
+        // refer to it by index. Returns the number of modules written. The main executable's path is read and cached
+        // when cpptrace is loaded.
+        CPPTRACE_EXPORT std::size_t get_safe_module_frames(
+            const frame_ptr* addresses,
+            std::size_t count,
+            safe_module_frame* frames,
+            safe_module* modules,
+            std::size_t max_modules
+        );
+        // Looks up the name of the symbol containing a frame for safe_print_object_trace, e.g. from a table built ahead
+        // of time. Must be signal-safe. Writes at most size - 1 characters and a null terminator and returns true if a
+        // symbol was found.
+        using safe_symbol_lookup = bool (*)(const safe_object_frame& frame, char* buffer, std::size_t size, void* context);
+        // signal-safe
+        // Writes a trace with write(2), one line per frame with the raw address, object path, object-relative address,
+        // and build id, along with the symbol name if a lookup is provided. Uses a small fixed buffer on the stack.
+        CPPTRACE_EXPORT void safe_print_object_trace(
+            int fd,
+            const safe_object_frame* frames,
+            std::size_t count,
+            safe_symbol_lookup lookup = nullptr,
+            void* context = nullptr
+        );
+
+        // Builds a read-only table of the symbols in all loaded objects' ELF symbol tables, with demangled names, so
+        // signal handlers can look up function names. Call it at startup and again after dlopen or dlclose, it does
+        // nothing if the set of loaded objects hasn't changed. Not signal-safe. Returns false if the table couldn't be
+        // built or isn't supported on this platform.
+        CPPTRACE_EXPORT bool build_safe_symbol_table();
+        CPPTRACE_EXPORT void clear_safe_symbol_table();
+        // signal-safe
+        // Writes at most size - 1 characters and a null terminator, returns false if the address isn't in a symbol
+        CPPTRACE_EXPORT bool lookup_safe_symbol(frame_ptr address, char* buffer, std::size_t size);
+        // signal-safe
+        // lookup_safe_symbol as a safe_symbol_lookup for safe_print_object_trace
+        CPPTRACE_EXPORT bool safe_symbol_table_lookup(
+            const safe_object_frame& frame,
+            char* buffer,
+            std::size_t size,
+            void* context
+        );
+    }
+
     // JIT API
     CPPTRACE_EXPORT void register_jit_object(const char*, std::size_t);
     CPPTRACE_EXPORT void unregister_jit_object(const char*);
@@ -0,0 +1,76 @@
+#ifndef CPPTRACE_CRASH_REPORTING_HPP
+#define CPPTRACE_CRASH_REPORTING_HPP
+
+#include <cpptrace/basic.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#ifdef _MSC_VER
+#pragma warning(push)
+// warning C4251: using non-dll-exported type in dll-exported type, firing on std::vector<frame_ptr> and others for some
+// reason
+// 4275 is the same thing but for base classes
+#pragma warning(disable: 4251; disable: 4275)
+#endif
+
+CPPTRACE_BEGIN_NAMESPACE
+namespace experimental {
+    // Crash reporter covering every thread. When the process receives SIGSEGV, SIGBUS, SIGILL, SIGFPE, or SIGABRT the
+    // crashing thread interrupts every other thread with tgkill and each one records its stack into storage allocated
+    // when the reporter was installed. The traces are written to a compact binary file along with the table of loaded
+    // objects and their build ids, then the signal is re-raised with the previously installed handler. Nothing is
+    // resolved in the crashing process, reports are symbolized later with parse_crash_report or the crash_symbolizer
+    // tool. The reporter is single-shot: after a crash the previous handlers are put back, if the process survives
+    // install_crash_reporter must be called again to report later crashes.
+    // Threads are interrupted with capture_signal (SIGRTMIN + 4 by default). Stacks other than the crashing thread's
+    // require signal-safe unwinding, see can_signal_safe_unwind(). Linux only.
+    struct crash_reporter_options {
+        // Threads beyond this are left out of the report
+        std::size_t max_threads = 256;
+        std::size_t max_depth = 128;
+        // How long the crashing thread waits for the others to record their stacks
+        long timeout_ms = 1000;
+        // Sent to the other threads to record their stacks, 0 for SIGRTMIN + 4. Installing fails if something else
+        // already handles it.
+        int capture_signal = 0;
+    };
+
+    // Returns false if crash reporting isn't supported or the capture signal is in use. Installing again replaces the
+    // previous configuration.
+    CPPTRACE_EXPORT bool install_crash_reporter(const std::string& path, const crash_reporter_options& options = {});
+    CPPTRACE_EXPORT void uninstall_crash_reporter();
+
+    struct crash_report_thread {
+        std::uint64_t thread_id;
+        std::string name;
+        // The thread that received the signal
+        bool crashed;
+        // The thread didn't record its stack in time, e.g. because it blocks signals, its trace is empty
+        bool missed;
+        object_trace trace;
+    };
+
+    struct crash_report {
+        int signal;
+        std::uint64_t process_id;
+        // The crashing thread comes first
+        std::vector<crash_report_thread> threads;
+        // Threads beyond crash_reporter_options::max_threads
+        std::size_t omitted_threads;
+    };
+
+    // Parses a report written by the crash reporter. Frames in objects whose local binary has a different build id than
+    // the one recorded get an empty object path so they aren't resolved against the wrong binary. Returns false if the
+    // buffer isn't a well-formed crash report of a supported version.
+    CPPTRACE_EXPORT bool parse_crash_report(const void* buffer, std::size_t length, crash_report& report);
+}
+CPPTRACE_END_NAMESPACE
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#endif
@@ -21,6 +21,11 @@ CPPTRACE_BEGIN_NAMESPACE
     struct object_frame;
     struct stacktrace_frame;
     struct safe_object_frame;
+
+    namespace experimental {
+        struct safe_module;
+        struct safe_module_frame;
+    }
 CPPTRACE_END_NAMESPACE
 
 #endif
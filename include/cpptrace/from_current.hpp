@@ -1,6 +1,7 @@
 #ifndef CPPTRACE_FROM_CURRENT_HPP
 #define CPPTRACE_FROM_CURRENT_HPP
 
+#include <cstddef>
 #include <exception>
 #include <typeinfo>
 #include <utility>
@@ -29,6 +30,22 @@ CPPTRACE_BEGIN_NAMESPACE
 
     CPPTRACE_EXPORT void clear_current_exception_traces();
 
+    namespace experimental {
+        enum class current_exception_trace_mode {
+            // Capture the whole stack for every exception thrown through a matching CPPTRACE_CATCH
+            full,
+            // Capture at most max_depth frames into a preallocated per-thread buffer. The trace is only assembled when
+            // it's requested. With signal-safe unwinding (see can_signal_safe_unwind) frames are unwound straight into
+            // the buffer and a throw doesn't allocate, other unwinders capture into a temporary vector first. A
+            // max_depth of 0 skips capturing altogether.
+            bounded
+        };
+        CPPTRACE_EXPORT void set_current_exception_trace_mode(
+            current_exception_trace_mode mode,
+            std::size_t max_depth = 16
+        );
+    }
+
     namespace detail {
         template<typename>
         struct argument;
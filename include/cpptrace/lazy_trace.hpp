@@ -0,0 +1,73 @@
+#ifndef CPPTRACE_LAZY_TRACE_HPP
+#define CPPTRACE_LAZY_TRACE_HPP
+
+#include <cpptrace/basic.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#ifdef _MSC_VER
+#pragma warning(push)
+// warning C4251: using non-dll-exported type in dll-exported type, firing on std::vector<frame_ptr> and others for some
+// reason
+// 4275 is the same thing but for base classes
+#pragma warning(disable: 4251; disable: 4275)
+#endif
+
+CPPTRACE_BEGIN_NAMESPACE
+namespace experimental {
+    // A trace whose frames are resolved piecemeal as they're accessed. Symbol names come from the objects' symbol
+    // tables and don't touch debug info, source locations and inlined frames are resolved per frame the first time
+    // they're asked for. Every stage is cached, so only the first access to each piece of information pays for it.
+    // Accessors are thread-safe and returned references are valid for the lifetime of the trace.
+    class CPPTRACE_EXPORT lazy_stacktrace {
+        class impl;
+        // can't be a std::unique_ptr due to msvc awfulness with dllimport/dllexport and https://stackoverflow.com/q/4145605/15675011
+        impl* pimpl;
+
+    public:
+        lazy_stacktrace();
+        explicit lazy_stacktrace(const raw_trace& trace);
+        explicit lazy_stacktrace(const object_trace& trace);
+        ~lazy_stacktrace();
+
+        lazy_stacktrace(const lazy_stacktrace&) = delete;
+        lazy_stacktrace& operator=(const lazy_stacktrace&) = delete;
+        // A moved-from trace may only be assigned to or destroyed
+        lazy_stacktrace(lazy_stacktrace&&) noexcept;
+        lazy_stacktrace& operator=(lazy_stacktrace&&) noexcept;
+
+        static lazy_stacktrace current(std::size_t skip = 0);
+        static lazy_stacktrace current(std::size_t skip, std::size_t max_depth);
+
+        std::size_t size() const;
+        bool empty() const;
+
+        frame_ptr raw_address(std::size_t index) const;
+        // Object information is resolved for the whole trace on first use
+        const object_frame& object_info(std::size_t index) const;
+        // Demangled name of the function containing the address. Falls back to full resolution of the frame only if
+        // the symbol tables don't cover it.
+        const std::string& symbol(std::size_t index) const;
+        // Source location of the address
+        const std::string& filename(std::size_t index) const;
+        nullable<std::uint32_t> line(std::size_t index) const;
+        nullable<std::uint32_t> column(std::size_t index) const;
+        // Calls inlined at the address, most recent first
+        const std::vector<stacktrace_frame>& inlines(std::size_t index) const;
+        // The fully resolved frame, as it would appear in stacktrace::frames after the frame's inlines
+        const stacktrace_frame& frame(std::size_t index) const;
+
+        // Resolves all frames not resolved yet in one batch
+        stacktrace resolve() const;
+    };
+}
+CPPTRACE_END_NAMESPACE
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#endif
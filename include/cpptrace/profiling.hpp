@@ -0,0 +1,120 @@
+#ifndef CPPTRACE_PROFILING_HPP
+#define CPPTRACE_PROFILING_HPP
+
+#include <cpptrace/basic.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#ifdef _MSC_VER
+#pragma warning(push)
+// warning C4251: using non-dll-exported type in dll-exported type, firing on std::vector<frame_ptr> and others for some
+// reason
+// 4275 is the same thing but for base classes
+#pragma warning(disable: 4251; disable: 4275)
+#endif
+
+CPPTRACE_BEGIN_NAMESPACE
+namespace experimental {
+    // Sampling CPU profiler. A SIGPROF timer interrupts the process at the configured frequency and the signal handler
+    // records a raw trace with the signal-safe unwinder into a preallocated lock-free sample buffer. A background thread
+    // drains the buffer, aggregates identical stacks, and resolves new addresses in batches.
+    // Only one profiler can be running at a time. Requires signal-safe unwinding, see can_signal_safe_unwind().
+    // Configuration changes take effect on the next call to start().
+    class CPPTRACE_EXPORT sampling_profiler {
+        class impl;
+        // can't be a std::unique_ptr due to msvc awfulness with dllimport/dllexport and https://stackoverflow.com/q/4145605/15675011
+        impl* pimpl;
+
+    public:
+        sampling_profiler();
+        ~sampling_profiler();
+
+        sampling_profiler(const sampling_profiler&) = delete;
+        sampling_profiler& operator=(const sampling_profiler&) = delete;
+
+        // Samples per second of consumed CPU time, default 100
+        sampling_profiler& frequency(unsigned hz);
+        // Maximum number of frames recorded per sample, default 64
+        sampling_profiler& max_depth(std::size_t depth);
+        // Number of samples that can be pending before the drain thread picks them up, default 1024
+        sampling_profiler& buffer_size(std::size_t samples);
+
+        // Returns false if profiling isn't supported or another profiler is already running
+        bool start();
+        void stop();
+        bool is_running() const;
+
+        std::size_t sample_count() const;
+        // Samples lost because the sample buffer was full
+        std::size_t dropped_samples() const;
+        void clear();
+
+        // Folded stack output, one line per unique stack: `root;caller;leaf count`. This is the input format for
+        // flamegraph.pl and most other flame graph tools.
+        std::string folded_stacks() const;
+        void write_folded_stacks(std::ostream& stream) const;
+    };
+
+    struct allocation_site {
+        // Identifies the allocating stack, see allocation_profiler::resolve
+        std::uint32_t stack_id;
+        // Number and total size of the allocations sampled at this site
+        std::size_t sampled_count;
+        std::size_t sampled_bytes;
+        // Estimate of the total number of bytes allocated at this site, including allocations that weren't sampled
+        std::size_t estimated_bytes;
+    };
+
+    // Sampling allocation profiler. Allocations are reported with record_allocation(), e.g. from a replacement
+    // operator new, and a raw trace is captured on average once every sample_interval bytes. Identical stacks are
+    // stored once and referred to by a compact id. Stacks are only resolved when reporting.
+    // Only one allocation profiler can be running at a time. Configuration changes take effect on the next call to
+    // start().
+    class CPPTRACE_EXPORT allocation_profiler {
+        class impl;
+        // can't be a std::unique_ptr due to msvc awfulness with dllimport/dllexport and https://stackoverflow.com/q/4145605/15675011
+        impl* pimpl;
+
+    public:
+        allocation_profiler();
+        ~allocation_profiler();
+
+        allocation_profiler(const allocation_profiler&) = delete;
+        allocation_profiler& operator=(const allocation_profiler&) = delete;
+
+        // Mean number of bytes between samples, default 512 KiB. 0 samples every allocation.
+        allocation_profiler& sample_interval(std::size_t bytes);
+        // Maximum number of frames recorded per sample, default 64
+        allocation_profiler& max_depth(std::size_t depth);
+
+        // Returns false if another allocation profiler is already running
+        bool start();
+        void stop();
+        bool is_running() const;
+        void clear();
+
+        // Sites ordered by estimated bytes, largest first
+        std::vector<allocation_site> sites() const;
+        // Resolved stacks are cached by id
+        stacktrace resolve(std::uint32_t stack_id) const;
+
+        // Folded stack output weighted by estimated bytes
+        std::string folded_stacks() const;
+        void write_folded_stacks(std::ostream& stream) const;
+    };
+
+    // Reports an allocation to the running allocation profiler, if any. This is cheap when no profiler is running or
+    // the allocation isn't sampled. Not signal-safe.
+    CPPTRACE_EXPORT void record_allocation(std::size_t size);
+}
+CPPTRACE_END_NAMESPACE
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#endif
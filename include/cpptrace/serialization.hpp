@@ -0,0 +1,104 @@
+#ifndef CPPTRACE_SERIALIZATION_HPP
+#define CPPTRACE_SERIALIZATION_HPP
+
+#include <cpptrace/basic.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#ifdef _MSC_VER
+#pragma warning(push)
+// warning C4251: using non-dll-exported type in dll-exported type, firing on std::vector<frame_ptr> and others for some
+// reason
+// 4275 is the same thing but for base classes
+#pragma warning(disable: 4251; disable: 4275)
+#endif
+
+CPPTRACE_BEGIN_NAMESPACE
+namespace experimental {
+    // Compact, versioned binary encoding for traces, intended for shipping traces to another process or machine for
+    // symbolication. A serialized trace contains a table of the objects involved, with their build ids and load biases,
+    // followed by object-relative addresses encoded as deltas.
+    constexpr std::uint8_t serialized_trace_version = 1;
+
+    CPPTRACE_EXPORT std::vector<std::uint8_t> serialize_trace(const raw_trace& trace);
+    CPPTRACE_EXPORT std::vector<std::uint8_t> serialize_trace(const object_trace& trace);
+
+    // Views into the serialized buffer, nothing is copied
+    struct serialized_module {
+        const char* path;
+        std::size_t path_length;
+        const std::uint8_t* build_id;
+        std::size_t build_id_length;
+        frame_ptr load_bias;
+
+        std::string get_path() const {
+            return std::string(path, path_length);
+        }
+    };
+
+    struct serialized_frame {
+        // null if the address couldn't be attributed to an object
+        nullable<std::uint32_t> module_index;
+        frame_ptr object_address;
+        frame_ptr raw_address;
+    };
+
+    class CPPTRACE_EXPORT serialized_trace_view {
+        const std::uint8_t* data = nullptr;
+        std::size_t size = 0;
+        std::size_t n_modules = 0;
+        std::size_t n_frames = 0;
+        // offset of each module table entry, recorded by parse() so module lookups don't rescan the table
+        std::vector<std::size_t> module_offsets;
+        std::size_t frames_offset = 0;
+
+    public:
+        // Validates the buffer. The buffer must outlive the view and anything obtained from it. Returns false if the
+        // buffer isn't a well-formed serialized trace of a supported version. Only the module table's offsets are
+        // stored, frames are decoded directly from the buffer.
+        bool parse(const void* buffer, std::size_t length);
+
+        std::size_t module_count() const;
+        // Constant time
+        serialized_module module(std::size_t index) const;
+        std::size_t frame_count() const;
+
+        class CPPTRACE_EXPORT frame_cursor {
+            const serialized_trace_view* view;
+            std::size_t offset;
+            std::size_t remaining;
+            std::uint64_t previous_module = 0;
+            std::uint64_t previous_address = 0;
+            frame_ptr previous_load_bias = 0;
+            friend class serialized_trace_view;
+            explicit frame_cursor(const serialized_trace_view* view);
+        public:
+            // Returns false once all frames have been read
+            bool next(serialized_frame& frame);
+        };
+        frame_cursor frames() const;
+
+        object_trace to_object_trace() const;
+    };
+
+    // Resolves a serialized trace against binaries available locally. By default the recorded paths are used, a
+    // locator can be provided to map modules to local paths, e.g. looking up build ids in a symbol store. Modules whose
+    // local binary has a different build id are not resolved.
+    CPPTRACE_EXPORT stacktrace resolve_serialized(const void* buffer, std::size_t length);
+    CPPTRACE_EXPORT stacktrace resolve_serialized(
+        const void* buffer,
+        std::size_t length,
+        const std::function<std::string(const serialized_module&)>& locate
+    );
+}
+CPPTRACE_END_NAMESPACE
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef CPPTRACE_STATS_HPP
+#define CPPTRACE_STATS_HPP
+
+#include <cpptrace/basic.hpp>
+
+#include <cstdint>
+
+CPPTRACE_BEGIN_NAMESPACE
+namespace experimental {
+    // Counters and timings for each stage of trace generation and resolution, for finding where time goes in an
+    // application that traces a lot. Statistics are only collected when cpptrace is built with CPPTRACE_STATS=On,
+    // otherwise everything is zero and there is no overhead. Counters are relaxed atomics, a snapshot taken while other
+    // threads are tracing may not be internally consistent.
+    struct stage_stats {
+        std::uint64_t count;
+        std::uint64_t nanoseconds;
+    };
+
+    struct cache_stats {
+        std::uint64_t hits;
+        std::uint64_t misses;
+    };
+
+    struct stats {
+        // Whether cpptrace was built with CPPTRACE_STATS
+        bool enabled;
+        // Stages can nest: formatting includes snippets, and the dwarf stages happen during resolution
+        stage_stats unwinding;
+        stage_stats object_lookup;
+        stage_stats resolver_construction;
+        stage_stats cu_lookup;
+        stage_stats line_tables;
+        stage_stats inline_walk;
+        stage_stats demangling;
+        stage_stats formatting;
+        stage_stats snippets;
+        // Demangled, pruned, and prettified symbols
+        cache_stats demangle_cache;
+        // Parsed object files
+        cache_stats object_cache;
+        // Per-object symbol resolvers
+        cache_stats resolver_cache;
+        // Dwarf line tables
+        cache_stats line_table_cache;
+        // Source files read for snippets
+        cache_stats snippet_cache;
+    };
+
+    CPPTRACE_EXPORT stats get_stats();
+    CPPTRACE_EXPORT void reset_stats();
+}
+CPPTRACE_END_NAMESPACE
+
+#endif
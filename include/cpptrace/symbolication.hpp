@@ -0,0 +1,58 @@
+#ifndef CPPTRACE_SYMBOLICATION_HPP
+#define CPPTRACE_SYMBOLICATION_HPP
+
+#include <cpptrace/basic.hpp>
+
+#include <cstddef>
+#include <string>
+
+#ifdef _MSC_VER
+#pragma warning(push)
+// warning C4251: using non-dll-exported type in dll-exported type, firing on std::vector<frame_ptr> and others for some
+// reason
+// 4275 is the same thing but for base classes
+#pragma warning(disable: 4251; disable: 4275)
+#endif
+
+CPPTRACE_BEGIN_NAMESPACE
+namespace experimental {
+    // Route symbol resolution through a symbolication server listening on the given unix domain socket. Object-relative
+    // addresses are sent to the server so only the server needs to load debug info. If the server can't be reached or
+    // fails, resolution falls back to the in-process backend. An empty path disables the client. Only supported on
+    // unix-like systems.
+    CPPTRACE_EXPORT void set_symbolication_server(const std::string& socket_path);
+
+    // Serves resolution requests on a unix domain socket with the in-process backend, so all clients share one set of
+    // caches. Each connection is served on its own thread. Used by the symbolication_server tool.
+    // Clients are trusted: a request names arbitrary object paths which the server opens and parses with its own
+    // privileges. The socket is created with mode 0600 so only processes running as the server's user can connect.
+    class CPPTRACE_EXPORT symbolication_server {
+        class impl;
+        // can't be a std::unique_ptr due to msvc awfulness with dllimport/dllexport and https://stackoverflow.com/q/4145605/15675011
+        impl* pimpl;
+
+    public:
+        explicit symbolication_server(const std::string& socket_path);
+        ~symbolication_server();
+
+        symbolication_server(const symbolication_server&) = delete;
+        symbolication_server& operator=(const symbolication_server&) = delete;
+
+        // Binds the socket, replacing a stale socket file at the path. Fails if another server is listening on the
+        // path. Returns false on failure.
+        bool listen();
+        // Accepts and serves connections until stop() is called, then closes all connections and removes the socket
+        void serve();
+        // Async-signal-safe, may be called from any thread or a signal handler
+        void stop();
+
+        std::size_t requests_served() const;
+    };
+}
+CPPTRACE_END_NAMESPACE
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef CPPTRACE_THREAD_DUMP_HPP
+#define CPPTRACE_THREAD_DUMP_HPP
+
+#include <cpptrace/basic.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#ifdef _MSC_VER
+#pragma warning(push)
+// warning C4251: using non-dll-exported type in dll-exported type, firing on std::vector<frame_ptr> and others for some
+// reason
+// 4275 is the same thing but for base classes
+#pragma warning(disable: 4251; disable: 4275)
+#endif
+
+CPPTRACE_BEGIN_NAMESPACE
+namespace experimental {
+    // Stacks of every thread in the running process, for diagnosing stalls and deadlocks. Each thread listed in
+    // /proc/self/task is interrupted with capture_signal (SIGRTMIN + 4 by default) and records its stack from a signal
+    // handler, the same way as the crash reporter. Addresses are resolved once for the whole dump, threads tend to
+    // share most of their frames. Stacks other than the calling thread's require signal-safe unwinding, see
+    // can_signal_safe_unwind(). Linux only.
+    struct thread_dump_options {
+        // Threads beyond this are left out
+        std::size_t max_threads = 1024;
+        std::size_t max_depth = 128;
+        // How long to wait for threads to record their stacks
+        long timeout_ms = 1000;
+        // Sent to the other threads to record their stacks, 0 for SIGRTMIN + 4. Nothing is captured if something else
+        // already handles it.
+        int capture_signal = 0;
+    };
+
+    struct thread_trace {
+        std::uint64_t thread_id;
+        std::string name;
+        // The thread didn't record its stack in time, e.g. because it blocks signals, its trace is empty
+        bool missed;
+        stacktrace trace;
+    };
+
+    // The calling thread comes first. Returns an empty vector if thread dumps aren't supported.
+    CPPTRACE_EXPORT std::vector<thread_trace> dump_all_threads(const thread_dump_options& options = {});
+    CPPTRACE_EXPORT std::string thread_dump_to_string(const std::vector<thread_trace>& threads, bool color = false);
+
+    // Writes a thread dump to fd whenever the process receives SIGQUIT, like a JVM. The dump is taken and written by a
+    // background thread, the signal handler only wakes it. Returns false if thread dumps aren't supported or the
+    // capture signal is in use.
+    CPPTRACE_EXPORT bool install_thread_dump_handler(int fd, const thread_dump_options& options = {});
+    CPPTRACE_EXPORT void uninstall_thread_dump_handler();
+}
+CPPTRACE_END_NAMESPACE
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#endif
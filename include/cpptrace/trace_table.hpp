@@ -0,0 +1,60 @@
+#ifndef CPPTRACE_TRACE_TABLE_HPP
+#define CPPTRACE_TRACE_TABLE_HPP
+
+#include <cpptrace/basic.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#ifdef _MSC_VER
+#pragma warning(push)
+// warning C4251: using non-dll-exported type in dll-exported type, firing on std::vector<frame_ptr> and others for some
+// reason
+// 4275 is the same thing but for base classes
+#pragma warning(disable: 4251; disable: 4275)
+#endif
+
+CPPTRACE_BEGIN_NAMESPACE
+namespace experimental {
+    using stack_id = std::uint32_t;
+
+    // Deduplicating storage for raw traces. Each unique frame sequence is stored once and identified by a dense id,
+    // starting at 0 in insertion order. Looking up a stack that's already in the table is lock-free and doesn't
+    // allocate. Resolution and formatting results are cached per id, so repeatedly logging the same stack only costs a
+    // hash. Entries live as long as the table.
+    class CPPTRACE_EXPORT trace_table {
+        class impl;
+        // can't be a std::unique_ptr due to msvc awfulness with dllimport/dllexport and https://stackoverflow.com/q/4145605/15675011
+        impl* pimpl;
+
+    public:
+        trace_table();
+        // The bucket count is rounded up to a power of two and is fixed for the lifetime of the table
+        explicit trace_table(std::size_t buckets);
+        ~trace_table();
+
+        trace_table(const trace_table&) = delete;
+        trace_table& operator=(const trace_table&) = delete;
+
+        // Returns nullable<stack_id>::null_value() if the stack couldn't be inserted
+        stack_id insert(const raw_trace& trace);
+        stack_id insert(const frame_ptr* frames, std::size_t count);
+        // Returns a null value if the stack isn't in the table
+        nullable<stack_id> find(const frame_ptr* frames, std::size_t count) const;
+
+        raw_trace get(stack_id id) const;
+        // The returned references are valid for the lifetime of the table
+        const stacktrace& resolve(stack_id id) const;
+        const std::string& to_string(stack_id id) const;
+
+        std::size_t size() const;
+    };
+}
+CPPTRACE_END_NAMESPACE
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#endif
@@ -4,6 +4,7 @@
 #include <cpptrace/basic.hpp>
 
 #include <functional>
+#include <vector>
 
 #ifdef _MSC_VER
 #pragma warning(push)
@@ -16,6 +17,44 @@
 CPPTRACE_BEGIN_NAMESPACE
     CPPTRACE_EXPORT std::string demangle(const std::string& name);
 
+    namespace experimental {
+        // Demangles into a caller-provided buffer, e.g. one allocated from an arena. At most size - 1 characters and a
+        // null terminator are written. Returns the length of the full demangled name, if it's size or more the output
+        // was truncated. Doesn't allocate for names already in the demangle cache.
+        CPPTRACE_EXPORT std::size_t demangle_into(const char* name, char* buffer, std::size_t size);
+        constexpr std::size_t default_demangle_cache_size = 4 * 1024 * 1024;
+        // Memory budget for the cache of demangled names used by symbol resolution and demangle, 4MiB by default. It
+        // also holds the pruned and pretty symbols printed by formatters. Zero disables the cache.
+        CPPTRACE_EXPORT void set_demangle_cache_size(std::size_t max_bytes);
+
+        enum class demangle_mode {
+            full,
+            // Drops template arguments, parameters, return types, and qualifiers, like prune_symbol
+            pruned
+        };
+        // Demangles an Itanium ABI name with cpptrace's built-in demangler, independent of the configured demangling
+        // backend. Never allocates or throws and is safe to call from a signal handler: all intermediate state is
+        // carved out of the scratch space. At most size - 1 characters and a null terminator are written. Returns the
+        // length of the full demangled name, if it's size or more the output was truncated. Returns 0 and writes an
+        // empty string if the name can't be demangled or the scratch space is too small, a few times the length of
+        // the mangled name times 64 bytes is plenty for most names.
+        CPPTRACE_EXPORT std::size_t demangle_signal_safe(
+            const char* name,
+            char* buffer,
+            std::size_t size,
+            void* scratch,
+            std::size_t scratch_size,
+            demangle_mode mode = demangle_mode::full
+        );
+        // Same as above with 16KiB of scratch space on the stack
+        CPPTRACE_EXPORT std::size_t demangle_signal_safe(
+            const char* name,
+            char* buffer,
+            std::size_t size,
+            demangle_mode mode = demangle_mode::full
+        );
+    }
+
     CPPTRACE_EXPORT std::string basename(const std::string& path);
     CPPTRACE_EXPORT std::string prettify_symbol(std::string symbol);
     CPPTRACE_EXPORT std::string prune_symbol(const std::string& symbol);
@@ -66,6 +105,31 @@ CPPTRACE_BEGIN_NAMESPACE
         CPPTRACE_EXPORT void set_cache_mode(cache_mode mode);
     }
 
+    // symbol resolution chain
+    namespace experimental {
+        enum class symbol_source {
+            // Results of earlier resolutions, filled with whatever the rest of the chain resolves
+            cache,
+            // The server configured with set_symbolication_server
+            server,
+            // Object file symbol tables, only provides symbol names
+            symbol_table,
+            libdwarf,
+            libbacktrace,
+            addr2line,
+            libdl,
+            dbghelp
+        };
+        // Resolve symbols by running the given stages in order. Each stage gets one batch with only the frames earlier
+        // stages left unresolved. A frame counts as resolved once it has a symbol and a line number, or just a symbol
+        // if require_line_info is false. Back-ends that weren't compiled in are skipped. An empty chain restores the
+        // default configured at compile time.
+        CPPTRACE_EXPORT void set_symbol_resolution_chain(
+            const std::vector<symbol_source>& chain,
+            bool require_line_info = true
+        );
+    }
+
     // dwarf options
     namespace experimental {
         CPPTRACE_EXPORT void set_dwarf_resolver_line_table_cache_size(nullable<std::size_t> max_entries);
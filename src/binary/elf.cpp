@@ -4,6 +4,7 @@
 #include "utils/io/base_file.hpp"
 #include "utils/io/memory_file_view.hpp"
 #include "utils/optional.hpp"
+#include "utils/stats.hpp"
 #include "utils/io/file.hpp"
 #include "utils/string_view.hpp"
 
@@ -105,6 +106,57 @@ namespace detail {
         return 0;
     }
 
+    Result<const std::vector<std::uint8_t>&, internal_error> elf::get_build_id() {
+        if(did_load_build_id) {
+            return build_id;
+        }
+        if(tried_to_load_build_id) {
+            return internal_error("previous build id load failed {}", file->path());
+        }
+        tried_to_load_build_id = true;
+        auto sections_ = get_sections();
+        if(sections_.is_error()) {
+            return std::move(sections_).unwrap_error();
+        }
+        for(const auto& section : sections_.unwrap_value()) {
+            if(section.sh_type != SHT_NOTE) {
+                continue;
+            }
+            std::vector<char> notes(section.sh_size);
+            auto read_res = file->read_bytes(span<char>{notes.data(), notes.size()}, section.sh_offset);
+            if(!read_res) {
+                return read_res.unwrap_error();
+            }
+            // note headers are three 4-byte words for both 32-bit and 64-bit objects, name and desc are 4-aligned
+            std::size_t offset = 0;
+            while(offset + 12 <= notes.size()) {
+                std::uint32_t header[3];
+                std::memcpy(header, notes.data() + offset, sizeof(header));
+                auto namesz = byteswap_if_needed(header[0]);
+                auto descsz = byteswap_if_needed(header[1]);
+                auto type = byteswap_if_needed(header[2]);
+                auto name_offset = offset + 12;
+                auto desc_offset = name_offset + ((std::size_t(namesz) + 3) & ~std::size_t(3));
+                auto next_offset = desc_offset + ((std::size_t(descsz) + 3) & ~std::size_t(3));
+                if(desc_offset + descsz > notes.size()) {
+                    break;
+                }
+                if(
+                    type == NT_GNU_BUILD_ID
+                    && namesz == 4
+                    && std::memcmp(notes.data() + name_offset, "GNU", 4) == 0
+                ) {
+                    build_id.assign(notes.data() + desc_offset, notes.data() + desc_offset + descsz);
+                    did_load_build_id = true;
+                    return build_id;
+                }
+                offset = next_offset;
+            }
+        }
+        did_load_build_id = true;
+        return build_id;
+    }
+
     optional<std::string> elf::lookup_symbol(frame_ptr pc) {
         if(auto symtab = get_symtab()) {
             if(auto symbol = lookup_symbol(pc, symtab.unwrap_value())) {
@@ -205,6 +257,7 @@ namespace detail {
         for(const auto& entry : info.entries) {
             res.push_back({
                 strtab.has_value() ? strtab.unwrap().data() + entry.st_name : "<strtab error>",
+                entry.st_info,
                 entry.st_shndx,
                 entry.st_value,
                 entry.st_size
@@ -466,6 +519,7 @@ namespace detail {
             return internal_error{"empty object_path"};
         }
         if(get_cache_mode() == cache_mode::prioritize_memory) {
+            record_cache_access(stat_cache::object, false);
             return elf::open(object_path)
                 .transform([](elf&& obj) { return maybe_owned<elf>{detail::make_unique<elf>(std::move(obj))}; });
         } else {
@@ -474,6 +528,7 @@ namespace detail {
             // TODO: Re-evaluate storing the error
             static std::unordered_map<std::string, Result<elf, internal_error>> cache;
             auto it = cache.find(object_path);
+            record_cache_access(stat_cache::object, it != cache.end());
             if(it == cache.end()) {
                 auto res = cache.emplace(object_path, elf::open(object_path));
                 VERIFY(res.second);
@@ -73,6 +73,10 @@ namespace detail {
         bool did_load_dynamic_symtab = false;
         optional<symtab_info> dynamic_symtab;
 
+        bool tried_to_load_build_id = false;
+        bool did_load_build_id = false;
+        std::vector<std::uint8_t> build_id;
+
         elf(std::unique_ptr<base_file> file, bool is_little_endian, bool is_64);
 
         static NODISCARD Result<elf, internal_error> open(std::unique_ptr<base_file> file);
@@ -90,6 +94,9 @@ namespace detail {
         Result<std::uintptr_t, internal_error> get_module_image_base_impl();
 
     public:
+        // Contents of the NT_GNU_BUILD_ID note, empty if the object doesn't have one
+        Result<const std::vector<std::uint8_t>&, internal_error> get_build_id();
+
         optional<std::string> lookup_symbol(frame_ptr pc);
     private:
         optional<std::string> lookup_symbol(frame_ptr pc, const optional<symtab_info>& maybe_symtab);
@@ -104,6 +111,7 @@ namespace detail {
 
         struct symbol_entry {
             std::string st_name;
+            unsigned char st_info;
             uint16_t st_shndx;
             uint64_t st_value;
             uint64_t st_size;
@@ -1,6 +1,7 @@
 #include "binary/mach-o.hpp"
 
 #include "utils/common.hpp"
+#include "utils/stats.hpp"
 #include "utils/utils.hpp"
 #include "utils/io/file.hpp"
 #include "utils/io/memory_file_view.hpp"
@@ -704,6 +705,7 @@ namespace detail {
             return internal_error{"empty object_path"};
         }
         if(get_cache_mode() == cache_mode::prioritize_memory) {
+            record_cache_access(stat_cache::object, false);
             return mach_o::open(object_path)
                 .transform([](mach_o&& obj) {
                     return maybe_owned<mach_o>{detail::make_unique<mach_o>(std::move(obj))};
@@ -714,6 +716,7 @@ namespace detail {
             // TODO: Re-evaluate storing the error
             static std::unordered_map<std::string, Result<mach_o, internal_error>> cache;
             auto it = cache.find(object_path);
+            record_cache_access(stat_cache::object, it != cache.end());
             if(it == cache.end()) {
                 auto res = cache.insert({ object_path, mach_o::open(object_path) });
                 VERIFY(res.second);
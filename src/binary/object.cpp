@@ -1,6 +1,7 @@
 #include "binary/object.hpp"
 
 #include "platform/platform.hpp"
+#include "utils/stats.hpp"
 #include "utils/utils.hpp"
 #include "binary/module_base.hpp"
 #include "logging.hpp"
@@ -163,6 +164,7 @@ namespace detail {
     #endif
 
     std::vector<object_frame> get_frames_object_info(const std::vector<frame_ptr>& addresses) {
+        stage_timer timer(stat_stage::object_lookup);
         std::vector<object_frame> frames;
         frames.reserve(addresses.size());
         for(const frame_ptr address : addresses) {
@@ -186,5 +188,15 @@ namespace detail {
             std::move(object_path)
         };
     }
+
+    object_frame resolve_safe_module_frame(
+        const experimental::safe_module_frame& frame,
+        const experimental::safe_module* modules
+    ) {
+        if(frame.module == experimental::no_safe_module) {
+            return {frame.raw_address, 0, ""};
+        }
+        return {frame.raw_address, frame.object_address, modules[frame.module].path};
+    }
 }
 CPPTRACE_END_NAMESPACE
@@ -13,6 +13,11 @@ namespace detail {
     std::vector<object_frame> get_frames_object_info(const std::vector<frame_ptr>& addresses);
 
     object_frame resolve_safe_object_frame(const safe_object_frame& frame);
+
+    object_frame resolve_safe_module_frame(
+        const experimental::safe_module_frame& frame,
+        const experimental::safe_module* modules
+    );
 }
 CPPTRACE_END_NAMESPACE
 
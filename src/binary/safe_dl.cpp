@@ -7,6 +7,9 @@
 #include <string>
 #include <vector>
 #include <unordered_map>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <cstring>
 #include <iostream>
 
@@ -16,30 +19,86 @@
  #include <dlfcn.h>
  #include <link.h>
 #endif
+#if IS_LINUX
+ #include <elf.h>
+#endif
 
 CPPTRACE_BEGIN_NAMESPACE
 namespace detail {
+    // The main executable's path, read from /proc/self/exe when cpptrace is loaded. If that didn't work, or a frame
+    // is needed during static initialization, the first signal-safe lookup reads it instead. Each reader claims its own
+    // slot so a reader never has to wait for, or give up because of, another one that may be stopped mid-read (e.g. a
+    // thread interrupted by a signal whose handler looks up frames). Slots are never reused, paths handed out stay
+    // valid. Everything is constant initialized so using it from a signal handler is fine.
+    constexpr std::size_t executable_path_slots = 4;
+    char cached_executable_paths[executable_path_slots][CPPTRACE_PATH_MAX + 1];
+    enum class cache_state : int { empty, filling, ready };
+    std::atomic<cache_state> executable_path_states[executable_path_slots];
+    constexpr std::size_t no_executable_path_slot = executable_path_slots;
+    std::atomic<std::size_t> ready_executable_path_slot{no_executable_path_slot};
+
+    // signal-safe, returns nullptr if the path can't be read
+    const char* get_cached_executable_path() {
+        auto ready = ready_executable_path_slot.load(std::memory_order_acquire);
+        if(ready != no_executable_path_slot) {
+            return cached_executable_paths[ready];
+        }
+        for(std::size_t i = 0; i < executable_path_slots; i++) {
+            auto expected = cache_state::empty;
+            if(!executable_path_states[i].compare_exchange_strong(expected, cache_state::filling)) {
+                continue;
+            }
+            // TODO: Special handling for /proc/pid/exe unlink edge case
+            auto res = readlink("/proc/self/exe", cached_executable_paths[i], CPPTRACE_PATH_MAX); // signal-safe
+            if(res <= 0) {
+                executable_path_states[i].store(cache_state::empty, std::memory_order_release);
+                return nullptr;
+            }
+            cached_executable_paths[i][res] = 0;
+            executable_path_states[i].store(cache_state::ready, std::memory_order_release);
+            // the first reader to finish is the one everyone uses from now on
+            ready_executable_path_slot.compare_exchange_strong(ready, i, std::memory_order_acq_rel);
+            return cached_executable_paths[i];
+        }
+        // more readers racing on the first lookup than there are slots
+        ready = ready_executable_path_slot.load(std::memory_order_acquire);
+        return ready != no_executable_path_slot ? cached_executable_paths[ready] : nullptr;
+    }
+
+    // fill the cache now, outside of any signal handler
+    const char* const initial_executable_path = get_cached_executable_path();
+
+    void reset_cached_executable_path(std::size_t stalled_readers) {
+        ready_executable_path_slot.store(no_executable_path_slot);
+        for(std::size_t i = 0; i < executable_path_slots; i++) {
+            executable_path_states[i].store(i < stalled_readers ? cache_state::filling : cache_state::empty);
+        }
+    }
+
+    const char* get_object_path(const link_map* map) {
+        if(map->l_name != nullptr && map->l_name[0] != 0) {
+            return map->l_name;
+        }
+        // empty l_name, this means it's the currently running executable
+        return get_cached_executable_path();
+    }
+
     void get_safe_object_frame(frame_ptr address, safe_object_frame* out) {
         out->raw_address = address;
         dl_find_object result;
         if(_dl_find_object(reinterpret_cast<void*>(address), &result) == 0) { // thread-safe, signal-safe
             out->address_relative_to_object_start = address - to_frame_ptr(result.dlfo_link_map->l_addr);
-            if(result.dlfo_link_map->l_name != nullptr && result.dlfo_link_map->l_name[0] != 0) {
-                std::size_t path_length = std::strlen(result.dlfo_link_map->l_name);
+            auto path = get_object_path(result.dlfo_link_map);
+            if(path) {
+                std::size_t path_length = std::strlen(path);
                 std::memcpy(
                     out->object_path,
-                    result.dlfo_link_map->l_name,
+                    path,
                     std::min(path_length + 1, std::size_t(CPPTRACE_PATH_MAX + 1))
                 );
+                out->object_path[CPPTRACE_PATH_MAX] = 0;
             } else {
-                // empty l_name, this means it's the currently running executable
-                memset(out->object_path, 0, CPPTRACE_PATH_MAX + 1);
-                // signal-safe
-                auto res = readlink("/proc/self/exe", out->object_path, CPPTRACE_PATH_MAX);
-                if(res == -1) {
-                    // error handling?
-                }
-                // TODO: Special handling for /proc/pid/exe unlink edge case
+                out->object_path[0] = 0;
             }
         } else {
             out->address_relative_to_object_start = 0;
@@ -52,9 +111,116 @@ namespace detail {
         // implementing the function), or fail to find any object at all.
     }
 
+    std::size_t get_safe_module_frames(
+        const frame_ptr* addresses,
+        std::size_t count,
+        experimental::safe_module_frame* frames,
+        experimental::safe_module* modules,
+        std::size_t module_count,
+        std::size_t max_modules
+    ) {
+        for(std::size_t i = 0; i < count; i++) {
+            auto& frame = frames[i];
+            frame.raw_address = addresses[i];
+            frame.object_address = 0;
+            frame.module = experimental::no_safe_module;
+            dl_find_object result;
+            if(_dl_find_object(reinterpret_cast<void*>(addresses[i]), &result) != 0) { // thread-safe, signal-safe
+                continue;
+            }
+            auto base = to_frame_ptr(result.dlfo_link_map->l_addr);
+            frame.object_address = addresses[i] - base;
+            // traces touch a handful of objects, a linear scan is fine. Objects can share a load bias, e.g. a non-PIE
+            // executable and prelinked libraries all have 0, so they're told apart by their link_map.
+            const void* object = result.dlfo_link_map;
+            std::size_t index = 0;
+            while(index < module_count && modules[index].object != object) {
+                index++;
+            }
+            if(index == module_count) {
+                auto path = get_object_path(result.dlfo_link_map);
+                if(module_count == max_modules || path == nullptr) {
+                    continue;
+                }
+                modules[module_count++] = {base, path, object};
+            }
+            frame.module = static_cast<std::uint32_t>(index);
+        }
+        return module_count;
+    }
+
     bool has_get_safe_object_frame() {
         return true;
     }
+
+    #if IS_LINUX
+    bool in_mapping(const dl_find_object& object, std::uintptr_t start, std::uintptr_t size) {
+        auto map_start = reinterpret_cast<std::uintptr_t>(object.dlfo_map_start);
+        auto map_end = reinterpret_cast<std::uintptr_t>(object.dlfo_map_end);
+        return start >= map_start && start <= map_end && size <= map_end - start;
+    }
+
+    std::size_t get_safe_build_id(frame_ptr address, unsigned char* buffer, std::size_t size) {
+        dl_find_object result;
+        if(_dl_find_object(reinterpret_cast<void*>(address), &result) != 0) {
+            return 0;
+        }
+        // The ELF header and program headers are part of the first loaded segment. Everything is read from memory
+        // that's already mapped, after checking it's inside the object's mapping.
+        auto base = reinterpret_cast<std::uintptr_t>(result.dlfo_map_start);
+        if(!in_mapping(result, base, sizeof(ElfW(Ehdr)))) {
+            return 0;
+        }
+        const auto* ehdr = reinterpret_cast<const ElfW(Ehdr)*>(base);
+        if(std::memcmp(ehdr->e_ident, ELFMAG, SELFMAG) != 0 || ehdr->e_phentsize != sizeof(ElfW(Phdr))) {
+            return 0;
+        }
+        if(!in_mapping(result, base + ehdr->e_phoff, std::uintptr_t(ehdr->e_phnum) * sizeof(ElfW(Phdr)))) {
+            return 0;
+        }
+        const auto* phdrs = reinterpret_cast<const ElfW(Phdr)*>(base + ehdr->e_phoff);
+        for(std::size_t i = 0; i < ehdr->e_phnum; i++) {
+            if(phdrs[i].p_type != PT_NOTE) {
+                continue;
+            }
+            auto notes = result.dlfo_link_map->l_addr + phdrs[i].p_vaddr;
+            auto notes_size = phdrs[i].p_memsz;
+            if(!in_mapping(result, notes, notes_size)) {
+                continue;
+            }
+            // note entries are padded to the segment's alignment, 4 or 8
+            std::uintptr_t align = phdrs[i].p_align == 8 ? 8 : 4;
+            std::uintptr_t offset = 0;
+            while(notes_size - offset >= sizeof(ElfW(Nhdr))) {
+                const auto* nhdr = reinterpret_cast<const ElfW(Nhdr)*>(notes + offset);
+                auto name_offset = offset + sizeof(ElfW(Nhdr));
+                auto desc_offset = name_offset + ((nhdr->n_namesz + align - 1) & ~(align - 1));
+                auto next = desc_offset + ((nhdr->n_descsz + align - 1) & ~(align - 1));
+                if(next > notes_size || next <= offset) {
+                    break;
+                }
+                if(
+                    nhdr->n_type == NT_GNU_BUILD_ID
+                    && nhdr->n_namesz == 4
+                    && std::memcmp(reinterpret_cast<const char*>(notes + name_offset), "GNU", 4) == 0
+                ) {
+                    std::memcpy(
+                        buffer,
+                        reinterpret_cast<const void*>(notes + desc_offset),
+                        std::min(std::size_t(nhdr->n_descsz), size)
+                    );
+                    return nhdr->n_descsz;
+                }
+                offset = next;
+            }
+        }
+        return 0;
+    }
+    #else
+    std::size_t get_safe_build_id(frame_ptr, unsigned char*, std::size_t) {
+        return 0;
+    }
+    #endif
 }
 CPPTRACE_END_NAMESPACE
 #else
@@ -66,9 +232,43 @@ namespace detail {
         out->object_path[0] = 0;
     }
 
+    std::size_t get_safe_module_frames(
+        const frame_ptr* addresses,
+        std::size_t count,
+        experimental::safe_module_frame* frames,
+        experimental::safe_module*,
+        std::size_t module_count,
+        std::size_t
+    ) {
+        for(std::size_t i = 0; i < count; i++) {
+            frames[i] = {addresses[i], 0, experimental::no_safe_module};
+        }
+        return module_count;
+    }
+
     bool has_get_safe_object_frame() {
         return false;
     }
+
+    void reset_cached_executable_path(std::size_t) {}
+
+    std::size_t get_safe_build_id(frame_ptr, unsigned char*, std::size_t) {
+        return 0;
+    }
 }
 CPPTRACE_END_NAMESPACE
 #endif
+
+CPPTRACE_BEGIN_NAMESPACE
+namespace detail {
+    std::size_t get_safe_module_frames(
+        const frame_ptr* addresses,
+        std::size_t count,
+        experimental::safe_module_frame* frames,
+        experimental::safe_module* modules,
+        std::size_t max_modules
+    ) {
+        return get_safe_module_frames(addresses, count, frames, modules, 0, max_modules);
+    }
+}
+CPPTRACE_END_NAMESPACE
@@ -3,11 +3,40 @@
 
 #include "utils/common.hpp"
 
+#include <cstddef>
+
 CPPTRACE_BEGIN_NAMESPACE
 namespace detail {
     void get_safe_object_frame(frame_ptr address, safe_object_frame* out);
 
+    std::size_t get_safe_module_frames(
+        const frame_ptr* addresses,
+        std::size_t count,
+        experimental::safe_module_frame* frames,
+        experimental::safe_module* modules,
+        std::size_t max_modules
+    );
+
+    // Same as above but appends to a module table that already holds module_count entries, returns the new count
+    std::size_t get_safe_module_frames(
+        const frame_ptr* addresses,
+        std::size_t count,
+        experimental::safe_module_frame* frames,
+        experimental::safe_module* modules,
+        std::size_t module_count,
+        std::size_t max_modules
+    );
+
     bool has_get_safe_object_frame();
+
+    // Forgets the main executable's path so the next safe frame reads it again, as though stalled_readers other readers
+    // had started reading it and been stopped part way. Not thread-safe, paths handed out before may be overwritten.
+    // Exported for test purposes.
+    CPPTRACE_EXPORT void reset_cached_executable_path(std::size_t stalled_readers);
+
+    // Signal-safe, reads the GNU build id note from the loaded image of the object containing the address. Copies at
+    // most size bytes and returns the full length of the build id, or 0 if there isn't one.
+    std::size_t get_safe_build_id(frame_ptr address, unsigned char* buffer, std::size_t size);
 }
 CPPTRACE_END_NAMESPACE
 
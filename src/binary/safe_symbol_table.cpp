@@ -0,0 +1,292 @@
+#include <cpptrace/basic.hpp>
+
+#include "binary/elf.hpp"
+#include "demangle/demangle.hpp"
+#include "logging.hpp"
+#include "platform/load_counts.hpp"
+#include "platform/program_name.hpp"
+#include "utils/common.hpp"
+#include "utils/utils.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if IS_LINUX
+ #include <elf.h>
+ #include <link.h>
+ #include <sys/mman.h>
+#endif
+
+CPPTRACE_BEGIN_NAMESPACE
+namespace detail {
+#if IS_LINUX
+    // The table is one read-only anonymous mapping: a header, symbols sorted by runtime address, then the demangled
+    // names. Signal handlers only ever read it.
+    struct safe_table_header {
+        std::size_t mapping_size;
+        std::size_t symbol_count;
+        // dl_iterate_phdr's load and unload counters when the table was built
+        unsigned long long adds;
+        unsigned long long subs;
+    };
+
+    struct safe_table_symbol {
+        std::uintptr_t address;
+        std::uintptr_t size;
+        std::uint32_t name_offset;
+        std::uint32_t name_length;
+    };
+
+    const safe_table_symbol* table_symbols(const safe_table_header* header) {
+        return reinterpret_cast<const safe_table_symbol*>(header + 1);
+    }
+
+    const char* table_strings(const safe_table_header* header) {
+        return reinterpret_cast<const char*>(table_symbols(header) + header->symbol_count);
+    }
+
+    // Tables are published alternately into two slots, each with a count of the lookups using it. A replaced table is
+    // only unmapped once the lookups of its own slot have finished, lookups that start meanwhile use the other slot so
+    // a steady stream of them can't hold up a publish. A thread stopped in the middle of a lookup (e.g. by a debugger)
+    // still blocks the publish that replaces the table it is reading.
+    struct safe_table_slot {
+        std::atomic<const safe_table_header*> table{nullptr};
+        std::atomic<std::size_t> readers{0};
+    };
+    safe_table_slot safe_table_slots[2];
+    std::atomic<unsigned> current_safe_table_slot{0};
+    std::mutex safe_table_build_mutex;
+
+    struct loaded_object {
+        std::string path;
+        std::uintptr_t base;
+    };
+
+    std::vector<loaded_object> get_loaded_objects() {
+        std::vector<loaded_object> objects;
+        dl_iterate_phdr(
+            [] (dl_phdr_info* info, std::size_t, void* data) {
+                auto& objects = *static_cast<std::vector<loaded_object>*>(data);
+                // the main program has an empty name
+                std::string path = info->dlpi_name && info->dlpi_name[0] ? info->dlpi_name : "";
+                if(path.empty() && objects.empty() && program_name()) {
+                    path = program_name();
+                }
+                if(!path.empty()) {
+                    objects.push_back({std::move(path), info->dlpi_addr});
+                }
+                return 0;
+            },
+            &objects
+        );
+        return objects;
+    }
+
+    struct pending_symbol {
+        std::uintptr_t address;
+        std::uintptr_t size;
+        std::string name;
+    };
+
+    void add_object_symbols(const loaded_object& object, std::vector<pending_symbol>& symbols) {
+        auto elf = open_elf_cached(object.path);
+        if(!elf) {
+            // e.g. the vdso, which doesn't exist on disk
+            return;
+        }
+        auto entries = elf.unwrap_value()->get_symtab_entries();
+        if(!entries || !entries.unwrap_value()) {
+            entries = elf.unwrap_value()->get_dynamic_symtab_entries();
+        }
+        if(!entries || !entries.unwrap_value()) {
+            return;
+        }
+        for(const auto& entry : entries.unwrap_value().unwrap()) {
+            if(entry.st_shndx == SHN_UNDEF || entry.st_value == 0 || entry.st_size == 0 || entry.st_name.empty()) {
+                continue;
+            }
+            // data symbols aren't useful for frames, and STT_TLS values are offsets into the TLS block which would
+            // make for bogus ranges
+            auto type = ELF64_ST_TYPE(entry.st_info);
+            if(type != STT_FUNC && type != STT_GNU_IFUNC) {
+                continue;
+            }
+            symbols.push_back({
+                object.base + static_cast<std::uintptr_t>(entry.st_value),
+                static_cast<std::uintptr_t>(entry.st_size),
+                // bypass the demangle cache, these would just evict everything in it
+                demangle_uncached(entry.st_name, true)
+            });
+        }
+    }
+
+    const safe_table_header* create_safe_table(std::vector<pending_symbol>& symbols, load_counts counts) {
+        std::stable_sort(
+            symbols.begin(),
+            symbols.end(),
+            [] (const pending_symbol& a, const pending_symbol& b) { return a.address < b.address; }
+        );
+        // aliases share an address, keep the first
+        symbols.erase(
+            std::unique(
+                symbols.begin(),
+                symbols.end(),
+                [] (const pending_symbol& a, const pending_symbol& b) { return a.address == b.address; }
+            ),
+            symbols.end()
+        );
+        std::size_t strings_size = 0;
+        for(const auto& symbol : symbols) {
+            strings_size += symbol.name.size() + 1;
+        }
+        auto size = sizeof(safe_table_header) + symbols.size() * sizeof(safe_table_symbol) + strings_size;
+        void* mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if(mapping == MAP_FAILED) {
+            return nullptr;
+        }
+        auto header = static_cast<safe_table_header*>(mapping);
+        *header = {size, symbols.size(), counts.adds, counts.subs};
+        auto out_symbols = reinterpret_cast<safe_table_symbol*>(header + 1);
+        auto out_strings = reinterpret_cast<char*>(out_symbols + symbols.size());
+        std::uint32_t offset = 0;
+        for(std::size_t i = 0; i < symbols.size(); i++) {
+            const auto& name = symbols[i].name;
+            out_symbols[i] = {symbols[i].address, symbols[i].size, offset, static_cast<std::uint32_t>(name.size())};
+            std::memcpy(out_strings + offset, name.c_str(), name.size() + 1);
+            offset += static_cast<std::uint32_t>(name.size() + 1);
+        }
+        mprotect(mapping, size, PROT_READ);
+        return header;
+    }
+
+    void destroy_safe_table(const safe_table_header* header) {
+        if(header) {
+            munmap(const_cast<safe_table_header*>(header), header->mapping_size);
+        }
+    }
+
+    const safe_table_header* current_safe_table() {
+        return safe_table_slots[current_safe_table_slot.load()].table.load();
+    }
+
+    // called with safe_table_build_mutex held
+    void publish_safe_table(const safe_table_header* header) {
+        auto old_slot = current_safe_table_slot.load();
+        auto new_slot = old_slot ^ 1;
+        // the previous publish waited for this slot's lookups and unmapped its table
+        safe_table_slots[new_slot].table.store(header);
+        current_safe_table_slot.store(new_slot);
+        // signal handlers may still be reading the old table
+        auto& old = safe_table_slots[old_slot];
+        while(old.readers.load() != 0) {
+            std::this_thread::yield();
+        }
+        destroy_safe_table(old.table.exchange(nullptr));
+    }
+
+    bool build_safe_symbol_table() {
+        std::lock_guard<std::mutex> lock(safe_table_build_mutex);
+        auto counts = get_load_counts();
+        auto current = current_safe_table();
+        if(current && current->adds == counts.adds && current->subs == counts.subs) {
+            return true;
+        }
+        std::vector<pending_symbol> symbols;
+        for(const auto& object : get_loaded_objects()) {
+            add_object_symbols(object, symbols);
+        }
+        auto table = create_safe_table(symbols, counts);
+        if(!table) {
+            log::error("Failed to map the signal-safe symbol table");
+            return false;
+        }
+        publish_safe_table(table);
+        return true;
+    }
+
+    void clear_safe_symbol_table() {
+        std::lock_guard<std::mutex> lock(safe_table_build_mutex);
+        publish_safe_table(nullptr);
+    }
+
+    // signal-safe, the atomics involved are lock-free
+    bool lookup_safe_symbol(frame_ptr address, char* buffer, std::size_t size) {
+        unsigned slot;
+        while(true) {
+            slot = current_safe_table_slot.load();
+            safe_table_slots[slot].readers.fetch_add(1);
+            // if the slot is still current the publisher replacing it will see this reader
+            if(current_safe_table_slot.load() == slot) {
+                break;
+            }
+            safe_table_slots[slot].readers.fetch_sub(1);
+        }
+        bool found = false;
+        const auto* table = safe_table_slots[slot].table.load();
+        if(table) {
+            const auto* begin = table_symbols(table);
+            const auto* end = begin + table->symbol_count;
+            const auto* it = std::upper_bound(
+                begin,
+                end,
+                address,
+                [] (frame_ptr address, const safe_table_symbol& symbol) { return address < symbol.address; }
+            );
+            if(it != begin) {
+                --it;
+                if(address - it->address < it->size) {
+                    found = true;
+                    if(size != 0) {
+                        auto n = std::min(std::size_t(it->name_length), size - 1);
+                        std::memcpy(buffer, table_strings(table) + it->name_offset, n);
+                        buffer[n] = 0;
+                    }
+                }
+            }
+        }
+        safe_table_slots[slot].readers.fetch_sub(1);
+        return found;
+    }
+#else
+    bool build_safe_symbol_table() {
+        return false;
+    }
+
+    void clear_safe_symbol_table() {}
+
+    bool lookup_safe_symbol(frame_ptr, char*, std::size_t) {
+        return false;
+    }
+#endif
+}
+
+namespace experimental {
+    bool build_safe_symbol_table() {
+        try {
+            return detail::build_safe_symbol_table();
+        } catch(...) {
+            detail::log_and_maybe_propagate_exception(std::current_exception());
+            return false;
+        }
+    }
+
+    void clear_safe_symbol_table() {
+        detail::clear_safe_symbol_table();
+    }
+
+    bool lookup_safe_symbol(frame_ptr address, char* buffer, std::size_t size) {
+        return detail::lookup_safe_symbol(address, buffer, size);
+    }
+
+    bool safe_symbol_table_lookup(const safe_object_frame& frame, char* buffer, std::size_t size, void*) {
+        return detail::lookup_safe_symbol(frame.raw_address, buffer, size);
+    }
+}
+CPPTRACE_END_NAMESPACE
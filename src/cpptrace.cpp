@@ -299,6 +299,22 @@ CPPTRACE_BEGIN_NAMESPACE
         detail::get_safe_object_frame(address, out);
     }
 
+    namespace experimental {
+        object_frame safe_module_frame::resolve(const safe_module* modules) const {
+            return detail::resolve_safe_module_frame(*this, modules);
+        }
+
+        std::size_t get_safe_module_frames(
+            const frame_ptr* addresses,
+            std::size_t count,
+            safe_module_frame* frames,
+            safe_module* modules,
+            std::size_t max_modules
+        ) {
+            return detail::get_safe_module_frames(addresses, count, frames, modules, max_modules);
+        }
+    }
+
     bool can_signal_safe_unwind() {
         return detail::has_safe_unwind();
     }
@@ -1,10 +1,18 @@
 module;
 #include <cpptrace/basic.hpp>
 #include <cpptrace/cpptrace.hpp>
+#include <cpptrace/crash_reporting.hpp>
 #include <cpptrace/exceptions.hpp>
 #include <cpptrace/formatting.hpp>
 #include <cpptrace/forward.hpp>
 #include <cpptrace/from_current.hpp>
+#include <cpptrace/lazy_trace.hpp>
+#include <cpptrace/profiling.hpp>
+#include <cpptrace/serialization.hpp>
+#include <cpptrace/stats.hpp>
+#include <cpptrace/symbolication.hpp>
+#include <cpptrace/thread_dump.hpp>
+#include <cpptrace/trace_table.hpp>
 
 export module cpptrace;
 
@@ -24,6 +32,18 @@ CPPTRACE_BEGIN_NAMESPACE
     export using cpptrace::can_get_safe_object_frame;
     export using cpptrace::can_signal_safe_unwind;
     export using cpptrace::can_get_safe_object_frame;
+    namespace experimental {
+        export using cpptrace::experimental::safe_module;
+        export using cpptrace::experimental::no_safe_module;
+        export using cpptrace::experimental::safe_module_frame;
+        export using cpptrace::experimental::get_safe_module_frames;
+        export using cpptrace::experimental::safe_symbol_lookup;
+        export using cpptrace::experimental::safe_print_object_trace;
+        export using cpptrace::experimental::build_safe_symbol_table;
+        export using cpptrace::experimental::clear_safe_symbol_table;
+        export using cpptrace::experimental::lookup_safe_symbol;
+        export using cpptrace::experimental::safe_symbol_table_lookup;
+    }
     export using cpptrace::register_jit_object;
     export using cpptrace::unregister_jit_object;
     export using cpptrace::clear_all_jit_objects;
@@ -63,6 +83,10 @@ CPPTRACE_BEGIN_NAMESPACE
     export using cpptrace::rethrow;
     export using cpptrace::clear_current_exception_traces;
     export using cpptrace::try_catch;
+    namespace experimental {
+        export using cpptrace::experimental::current_exception_trace_mode;
+        export using cpptrace::experimental::set_current_exception_trace_mode;
+    }
 
     namespace detail {
         #ifdef _MSC_VER
@@ -78,8 +102,79 @@ CPPTRACE_BEGIN_NAMESPACE
     // cpptrace/io
     export using cpptrace::operator<<; // FIXME: make hidden friend
 
+    // cpptrace/lazy_trace
+    namespace experimental {
+        export using cpptrace::experimental::lazy_stacktrace;
+    }
+
+    // cpptrace/crash_reporting
+    namespace experimental {
+        export using cpptrace::experimental::crash_reporter_options;
+        export using cpptrace::experimental::install_crash_reporter;
+        export using cpptrace::experimental::uninstall_crash_reporter;
+        export using cpptrace::experimental::crash_report_thread;
+        export using cpptrace::experimental::crash_report;
+        export using cpptrace::experimental::parse_crash_report;
+    }
+
+    // cpptrace/profiling
+    namespace experimental {
+        export using cpptrace::experimental::sampling_profiler;
+        export using cpptrace::experimental::allocation_site;
+        export using cpptrace::experimental::allocation_profiler;
+        export using cpptrace::experimental::record_allocation;
+    }
+
+    // cpptrace/serialization
+    namespace experimental {
+        export using cpptrace::experimental::serialized_trace_version;
+        export using cpptrace::experimental::serialize_trace;
+        export using cpptrace::experimental::serialized_module;
+        export using cpptrace::experimental::serialized_frame;
+        export using cpptrace::experimental::serialized_trace_view;
+        export using cpptrace::experimental::resolve_serialized;
+    }
+
+    // cpptrace/stats
+    namespace experimental {
+        export using cpptrace::experimental::stage_stats;
+        export using cpptrace::experimental::cache_stats;
+        export using cpptrace::experimental::stats;
+        export using cpptrace::experimental::get_stats;
+        export using cpptrace::experimental::reset_stats;
+    }
+
+    // cpptrace/symbolication
+    namespace experimental {
+        export using cpptrace::experimental::set_symbolication_server;
+        export using cpptrace::experimental::symbolication_server;
+    }
+
+    // cpptrace/thread_dump
+    namespace experimental {
+        export using cpptrace::experimental::thread_dump_options;
+        export using cpptrace::experimental::thread_trace;
+        export using cpptrace::experimental::dump_all_threads;
+        export using cpptrace::experimental::thread_dump_to_string;
+        export using cpptrace::experimental::install_thread_dump_handler;
+        export using cpptrace::experimental::uninstall_thread_dump_handler;
+    }
+
+    // cpptrace/trace_table
+    namespace experimental {
+        export using cpptrace::experimental::stack_id;
+        export using cpptrace::experimental::trace_table;
+    }
+
     // cpptrace/utils
     export using cpptrace::demangle;
+    namespace experimental {
+        export using cpptrace::experimental::demangle_into;
+        export using cpptrace::experimental::default_demangle_cache_size;
+        export using cpptrace::experimental::set_demangle_cache_size;
+        export using cpptrace::experimental::demangle_mode;
+        export using cpptrace::experimental::demangle_signal_safe;
+    }
     export using cpptrace::prune_symbol;
     export using cpptrace::get_snippet;
     export using cpptrace::isatty;
@@ -99,6 +194,8 @@ CPPTRACE_BEGIN_NAMESPACE
 
     namespace experimental {
         export using cpptrace::experimental::set_cache_mode;
+        export using cpptrace::experimental::symbol_source;
+        export using cpptrace::experimental::set_symbol_resolution_chain;
         export using cpptrace::experimental::set_dwarf_resolver_line_table_cache_size;
         export using cpptrace::experimental::set_dwarf_resolver_disable_aranges;
     }
@@ -0,0 +1,509 @@
+#include <cpptrace/crash_reporting.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "binary/safe_dl.hpp"
+#include "platform/platform.hpp"
+#include "platform/thread_capture.hpp"
+#include "serialization.hpp"
+#include "logging.hpp"
+#include "unwind/unwind.hpp"
+#include "utils/error.hpp"
+#include "utils/safe_writer.hpp"
+#include "utils/utils.hpp"
+#include "utils/varint.hpp"
+
+#if IS_LINUX
+ #include <csignal>
+ #include <ctime>
+ #include <fcntl.h>
+ #include <unistd.h>
+#endif
+
+CPPTRACE_BEGIN_NAMESPACE
+namespace detail {
+    // A report is a header followed by the module table and then each thread's frames. Modules and frames are encoded
+    // as in serialized traces, frame addresses are deltas within a thread.
+    constexpr char crash_report_magic[4] = {'C', 'P', 'C', 'R'};
+    constexpr std::uint8_t crash_report_version = 1;
+    constexpr std::size_t crash_report_header_size = sizeof(crash_report_magic) + 1;
+    constexpr std::uint64_t crashed_thread_flag = 1;
+    constexpr std::uint64_t missed_thread_flag = 2;
+
+#if IS_LINUX
+    constexpr std::size_t max_crash_report_modules = 512;
+    constexpr std::size_t max_build_id_size = 64;
+
+    struct crash_reporter_state {
+        std::string path;
+        long timeout_ms;
+        thread_capture capture;
+        std::unique_ptr<experimental::safe_module_frame[]> frames;
+        experimental::safe_module modules[max_crash_report_modules];
+        // an address in each module, for finding its build id
+        frame_ptr module_addresses[max_crash_report_modules];
+
+        crash_reporter_state(
+            std::string path,
+            std::size_t max_threads,
+            std::size_t max_depth,
+            long timeout_ms,
+            int capture_signal
+        )
+            : path(std::move(path)),
+              timeout_ms(timeout_ms),
+              capture(max_threads, max_depth, capture_signal),
+              frames(new experimental::safe_module_frame[max_threads * max_depth]) {}
+    };
+
+    constexpr int crash_signals[] = {SIGSEGV, SIGBUS, SIGILL, SIGFPE, SIGABRT};
+    constexpr std::size_t crash_signal_count = sizeof(crash_signals) / sizeof(crash_signals[0]);
+
+    std::atomic<crash_reporter_state*> active_crash_reporter{nullptr};
+    // number of crash handlers currently running, so the state isn't freed out from under one of them
+    std::atomic<std::size_t> active_crash_handlers{0};
+    std::atomic<long> crashing_thread{0};
+    std::mutex crash_reporter_mutex;
+    bool crash_handlers_installed = false;
+    struct sigaction previous_crash_actions[crash_signal_count];
+
+    void write_varint(safe_writer& writer, std::uint64_t value) {
+        std::uint8_t buffer[max_varint_size];
+        writer.write(reinterpret_cast<const char*>(buffer), encode_varint(value, buffer));
+    }
+
+    void write_crash_report_frames(
+        safe_writer& writer,
+        const experimental::safe_module_frame* frames,
+        std::size_t count
+    ) {
+        write_varint(writer, count);
+        std::uint64_t previous_module = 0;
+        std::uint64_t previous_address = 0;
+        for(std::size_t i = 0; i < count; i++) {
+            std::uint64_t module = frames[i].module == experimental::no_safe_module ? 0 : frames[i].module + 1;
+            write_varint(writer, module);
+            if(module == 0) {
+                write_varint(writer, frames[i].raw_address);
+            } else {
+                std::uint64_t address = frames[i].object_address;
+                if(module == previous_module) {
+                    write_varint(writer, zigzag_encode(static_cast<std::int64_t>(address - previous_address)));
+                } else {
+                    write_varint(writer, address);
+                }
+                previous_address = address;
+            }
+            previous_module = module;
+        }
+    }
+
+    // Signal-safe
+    CPPTRACE_FORCE_NO_INLINE void write_crash_report(crash_reporter_state& state, int signo) {
+        auto& capture = state.capture;
+        // skip this function, the crash handler, and the signal trampoline
+        if(!capture.capture(3, state.timeout_ms)) {
+            // another capture is in progress, e.g. dump_all_threads, the crashing thread is the one that matters most
+            if(!capture.capture_calling_thread(3)) {
+                return;
+            }
+        }
+        std::size_t module_count = 0;
+        std::size_t frame_count = 0;
+        for(std::size_t i = 0; i < capture.size(); i++) {
+            const auto& thread = capture[i];
+            module_count = detail::get_safe_module_frames(
+                thread.frames,
+                thread.depth,
+                &state.frames[frame_count],
+                state.modules,
+                module_count,
+                max_crash_report_modules
+            );
+            frame_count += thread.depth;
+        }
+        for(std::size_t i = 0; i < module_count; i++) {
+            state.module_addresses[i] = 0;
+        }
+        for(std::size_t i = 0; i < frame_count; i++) {
+            const auto& frame = state.frames[i];
+            if(frame.module != experimental::no_safe_module && state.module_addresses[frame.module] == 0) {
+                state.module_addresses[frame.module] = frame.raw_address;
+            }
+        }
+        int fd = open(state.path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if(fd < 0) {
+            return;
+        }
+        {
+            safe_writer writer(fd);
+            writer.write(crash_report_magic, sizeof(crash_report_magic));
+            writer.put(static_cast<char>(crash_report_version));
+            write_varint(writer, static_cast<std::uint64_t>(signo));
+            write_varint(writer, static_cast<std::uint64_t>(getpid()));
+            write_varint(writer, capture.omitted_threads());
+            write_varint(writer, module_count);
+            for(std::size_t i = 0; i < module_count; i++) {
+                const auto& module = state.modules[i];
+                auto path_length = std::strlen(module.path);
+                write_varint(writer, path_length);
+                writer.write(module.path, path_length);
+                unsigned char build_id[max_build_id_size];
+                auto build_id_size = get_safe_build_id(state.module_addresses[i], build_id, sizeof(build_id));
+                if(build_id_size > sizeof(build_id)) {
+                    build_id_size = 0;
+                }
+                write_varint(writer, build_id_size);
+                writer.write(reinterpret_cast<const char*>(build_id), build_id_size);
+                write_varint(writer, module.base);
+            }
+            write_varint(writer, capture.size());
+            std::size_t offset = 0;
+            for(std::size_t i = 0; i < capture.size(); i++) {
+                const auto& thread = capture[i];
+                write_varint(writer, static_cast<std::uint64_t>(thread.thread_id));
+                auto name_length = strnlen(thread.name, sizeof(thread.name));
+                write_varint(writer, name_length);
+                writer.write(thread.name, name_length);
+                std::uint64_t flags = 0;
+                if(i == 0) {
+                    flags |= crashed_thread_flag;
+                }
+                if(thread.state.load() == captured_thread::missed) {
+                    flags |= missed_thread_flag;
+                }
+                write_varint(writer, flags);
+                write_crash_report_frames(writer, &state.frames[offset], thread.depth);
+                offset += thread.depth;
+            }
+        }
+        close(fd);
+    }
+
+    void restore_previous_crash_actions() {
+        for(std::size_t i = 0; i < crash_signal_count; i++) {
+            sigaction(crash_signals[i], &previous_crash_actions[i], nullptr);
+        }
+    }
+
+    void crash_signal_handler(int signo, siginfo_t*, void*) {
+        int saved_errno = errno;
+        auto self = current_thread_id();
+        long expected = 0;
+        if(crashing_thread.compare_exchange_strong(expected, self)) {
+            active_crash_handlers.fetch_add(1);
+            auto state = active_crash_reporter.load();
+            if(state) {
+                write_crash_report(*state, signo);
+            }
+            active_crash_handlers.fetch_sub(1);
+        } else if(expected != self) {
+            // Another thread is writing the report and will most likely take the process down. The capture signal
+            // isn't blocked here so this thread's stack is still recorded. If the previous handler lets the process
+            // continue this thread's signal goes to the previous handler too.
+            while(crashing_thread.load() == expected) {
+                timespec duration{0, 1000000};
+                nanosleep(&duration, nullptr);
+            }
+            raise(signo);
+            errno = saved_errno;
+            return;
+        }
+        // Either the report has been written or writing it crashed. The signal is blocked until this handler
+        // returns, at which point it's delivered to the previous handler or takes the default action. The reporter
+        // is single-shot: the previous handlers stay installed until install_crash_reporter is called again.
+        restore_previous_crash_actions();
+        raise(signo);
+        crashing_thread.store(0);
+        errno = saved_errno;
+    }
+
+    // The crash handler puts the previous handlers back after reporting a crash, called with crash_reporter_mutex held
+    bool crash_handlers_still_installed() {
+        if(!crash_handlers_installed) {
+            return false;
+        }
+        for(auto signo : crash_signals) {
+            struct sigaction current;
+            if(
+                sigaction(signo, nullptr, &current) != 0
+                || !(current.sa_flags & SA_SIGINFO)
+                || current.sa_sigaction != crash_signal_handler
+            ) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool install_crash_reporter(const std::string& path, const experimental::crash_reporter_options& options) {
+        std::lock_guard<std::mutex> lock(crash_reporter_mutex);
+        auto capture_signal = get_capture_signal(options.capture_signal);
+        if(options.max_depth == 0 || !install_thread_capture_handler(capture_signal)) {
+            return false;
+        }
+        // resolve the unwinder and _dl_find_object's lazy bindings now rather than at crash time
+        auto frames = capture_frames(0, hard_max_frames);
+        std::vector<experimental::safe_module_frame> module_frames(frames.size());
+        std::vector<experimental::safe_module> modules(frames.size());
+        detail::get_safe_module_frames(
+            frames.data(),
+            frames.size(),
+            module_frames.data(),
+            modules.data(),
+            modules.size()
+        );
+        std::unique_ptr<crash_reporter_state> state(
+            new crash_reporter_state(
+                path,
+                std::max<std::size_t>(1, options.max_threads),
+                std::min(options.max_depth, hard_max_frames),
+                options.timeout_ms,
+                capture_signal
+            )
+        );
+        if(!crash_handlers_still_installed()) {
+            struct sigaction action{};
+            action.sa_sigaction = crash_signal_handler;
+            action.sa_flags = SA_SIGINFO | SA_ONSTACK;
+            sigemptyset(&action.sa_mask);
+            for(std::size_t i = 0; i < crash_signal_count; i++) {
+                struct sigaction previous;
+                if(sigaction(crash_signals[i], &action, &previous) != 0) {
+                    for(std::size_t j = 0; j < i; j++) {
+                        sigaction(crash_signals[j], &previous_crash_actions[j], nullptr);
+                    }
+                    return false;
+                }
+                // a signal whose handler is still ours keeps the handler it replaced
+                if(!(previous.sa_flags & SA_SIGINFO) || previous.sa_sigaction != crash_signal_handler) {
+                    previous_crash_actions[i] = previous;
+                }
+            }
+            crash_handlers_installed = true;
+        }
+        delete active_crash_reporter.exchange(state.release());
+        return true;
+    }
+
+    void uninstall_crash_reporter() {
+        std::lock_guard<std::mutex> lock(crash_reporter_mutex);
+        if(!crash_handlers_installed) {
+            return;
+        }
+        restore_previous_crash_actions();
+        crash_handlers_installed = false;
+        auto state = active_crash_reporter.exchange(nullptr);
+        while(active_crash_handlers.load() != 0) {
+            std::this_thread::yield();
+        }
+        delete state;
+    }
+#else
+    bool install_crash_reporter(const std::string&, const experimental::crash_reporter_options&) {
+        return false;
+    }
+
+    void uninstall_crash_reporter() {}
+#endif
+
+    class crash_report_reader {
+        const std::uint8_t* data;
+        std::size_t size;
+        std::size_t offset;
+
+    public:
+        crash_report_reader(const std::uint8_t* data, std::size_t size, std::size_t offset)
+            : data(data), size(size), offset(offset) {}
+
+        bool read_varint(std::uint64_t& value) {
+            return decode_varint(data, size, offset, value);
+        }
+
+        bool read_bytes(const std::uint8_t*& bytes, std::size_t& length) {
+            std::uint64_t value;
+            if(!read_varint(value) || value > size - offset) {
+                return false;
+            }
+            bytes = data + offset;
+            length = to<std::size_t>(value);
+            offset += length;
+            return true;
+        }
+
+        bool at_end() const {
+            return offset == size;
+        }
+    };
+
+    struct crash_report_module {
+        std::string path;
+        frame_ptr load_bias;
+    };
+
+    bool read_crash_report_modules(crash_report_reader& reader, std::vector<crash_report_module>& modules) {
+        std::uint64_t module_count;
+        if(!reader.read_varint(module_count)) {
+            return false;
+        }
+        for(std::uint64_t i = 0; i < module_count; i++) {
+            const std::uint8_t* path;
+            std::size_t path_length;
+            const std::uint8_t* build_id;
+            std::size_t build_id_length;
+            std::uint64_t load_bias;
+            if(
+                !reader.read_bytes(path, path_length)
+                || !reader.read_bytes(build_id, build_id_length)
+                || !reader.read_varint(load_bias)
+            ) {
+                return false;
+            }
+            crash_report_module module{
+                std::string(reinterpret_cast<const char*>(path), path_length),
+                to<frame_ptr>(load_bias)
+            };
+            if(build_id_length != 0) {
+                auto local_build_id = get_build_id(module.path);
+                if(
+                    !local_build_id.empty()
+                    && (
+                        local_build_id.size() != build_id_length
+                        || !std::equal(local_build_id.begin(), local_build_id.end(), build_id)
+                    )
+                ) {
+                    log::warn("Build id mismatch for {}, not resolving its frames", module.path);
+                    module.path.clear();
+                }
+            }
+            modules.push_back(std::move(module));
+        }
+        return true;
+    }
+
+    bool read_crash_report_frames(
+        crash_report_reader& reader,
+        const std::vector<crash_report_module>& modules,
+        std::vector<object_frame>& frames
+    ) {
+        std::uint64_t frame_count;
+        if(!reader.read_varint(frame_count)) {
+            return false;
+        }
+        std::uint64_t previous_module = 0;
+        std::uint64_t previous_address = 0;
+        for(std::uint64_t i = 0; i < frame_count; i++) {
+            std::uint64_t module;
+            std::uint64_t value;
+            if(!reader.read_varint(module) || module > modules.size() || !reader.read_varint(value)) {
+                return false;
+            }
+            if(module == 0) {
+                frames.push_back({to<frame_ptr>(value), 0, ""});
+            } else {
+                if(module == previous_module) {
+                    value = previous_address + static_cast<std::uint64_t>(zigzag_decode(value));
+                }
+                const auto& object = modules[to<std::size_t>(module - 1)];
+                auto object_address = to<frame_ptr>(value);
+                frames.push_back({object_address + object.load_bias, object_address, object.path});
+                previous_address = value;
+            }
+            previous_module = module;
+        }
+        return true;
+    }
+
+    bool parse_crash_report(const void* buffer, std::size_t length, experimental::crash_report& report) {
+        auto bytes = static_cast<const std::uint8_t*>(buffer);
+        if(
+            length < crash_report_header_size
+            || std::memcmp(bytes, crash_report_magic, sizeof(crash_report_magic)) != 0
+            || bytes[sizeof(crash_report_magic)] != crash_report_version
+        ) {
+            return false;
+        }
+        crash_report_reader reader(bytes, length, crash_report_header_size);
+        experimental::crash_report result{};
+        std::uint64_t signo;
+        std::uint64_t process_id;
+        std::uint64_t omitted;
+        if(!reader.read_varint(signo) || !reader.read_varint(process_id) || !reader.read_varint(omitted)) {
+            return false;
+        }
+        result.signal = static_cast<int>(signo);
+        result.process_id = process_id;
+        result.omitted_threads = to<std::size_t>(omitted);
+        std::vector<crash_report_module> modules;
+        if(!read_crash_report_modules(reader, modules)) {
+            return false;
+        }
+        std::uint64_t thread_count;
+        if(!reader.read_varint(thread_count)) {
+            return false;
+        }
+        for(std::uint64_t i = 0; i < thread_count; i++) {
+            experimental::crash_report_thread thread{};
+            const std::uint8_t* name;
+            std::size_t name_length;
+            std::uint64_t flags;
+            if(
+                !reader.read_varint(thread.thread_id)
+                || !reader.read_bytes(name, name_length)
+                || !reader.read_varint(flags)
+                || !read_crash_report_frames(reader, modules, thread.trace.frames)
+            ) {
+                return false;
+            }
+            thread.name.assign(reinterpret_cast<const char*>(name), name_length);
+            thread.crashed = (flags & crashed_thread_flag) != 0;
+            thread.missed = (flags & missed_thread_flag) != 0;
+            result.threads.push_back(std::move(thread));
+        }
+        if(!reader.at_end()) {
+            return false;
+        }
+        report = std::move(result);
+        return true;
+    }
+}
+
+namespace experimental {
+    bool install_crash_reporter(const std::string& path, const crash_reporter_options& options) {
+        try {
+            return detail::install_crash_reporter(path, options);
+        } catch(...) {
+            detail::log_and_maybe_propagate_exception(std::current_exception());
+            return false;
+        }
+    }
+
+    void uninstall_crash_reporter() {
+        try {
+            detail::uninstall_crash_reporter();
+        } catch(...) {
+            detail::log_and_maybe_propagate_exception(std::current_exception());
+        }
+    }
+
+    bool parse_crash_report(const void* buffer, std::size_t length, crash_report& report) {
+        try {
+            return detail::parse_crash_report(buffer, length, report);
+        } catch(...) {
+            detail::log_and_maybe_propagate_exception(std::current_exception());
+            return false;
+        }
+    }
+}
+CPPTRACE_END_NAMESPACE
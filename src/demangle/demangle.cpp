@@ -0,0 +1,276 @@
+#include "demangle/demangle.hpp"
+
+#include <cpptrace/utils.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "logging.hpp"
+#include "utils/error.hpp"
+#include "utils/stats.hpp"
+
+CPPTRACE_BEGIN_NAMESPACE
+namespace detail {
+    std::atomic<std::size_t> demangle_cache_bytes{experimental::default_demangle_cache_size};
+    std::atomic<std::size_t> demangle_cache_miss_count{0};
+
+    // Cache entries are keyed by a symbol and what was computed from it
+    enum class symbol_form : std::uint8_t {
+        demangled,
+        demangled_checked_prefix,
+        pruned,
+        pretty
+    };
+
+    symbol_form demangled_form(bool check_prefix) {
+        return check_prefix ? symbol_form::demangled_checked_prefix : symbol_form::demangled;
+    }
+
+    std::uint64_t hash_symbol(const char* name, std::size_t length, symbol_form form) {
+        // fnv-1a
+        std::uint64_t hash = 0xcbf29ce484222325;
+        for(std::size_t i = 0; i < length; i++) {
+            hash ^= static_cast<unsigned char>(name[i]);
+            hash *= 0x100000001b3;
+        }
+        return hash ^ (static_cast<std::uint64_t>(form) * 0x9e3779b97f4a7c15);
+    }
+
+    // Demangled names keyed by the hash of their mangled name, along with the pruned and pretty forms the formatter
+    // prints. The cache is split into independently locked shards so concurrent resolution doesn't serialize on one
+    // mutex, each shard evicts least recently used names once it exceeds its share of the memory budget. Names that
+    // demangle to themselves aren't stored.
+    class demangle_cache {
+        static constexpr std::size_t n_shards = 16;
+        // rough per-entry bookkeeping cost on top of the strings themselves
+        static constexpr std::size_t entry_overhead = 128;
+
+        struct entry {
+            std::uint64_t hash;
+            symbol_form form;
+            std::string symbol;
+            std::string value;
+
+            std::size_t cost() const {
+                return symbol.size() + value.size() + entry_overhead;
+            }
+        };
+
+        struct shard {
+            std::mutex mutex;
+            std::list<entry> lru;
+            std::unordered_map<std::uint64_t, std::list<entry>::iterator> map;
+            std::size_t bytes = 0;
+
+            void trim(std::size_t budget) {
+                while(bytes > budget && !lru.empty()) {
+                    bytes -= lru.back().cost();
+                    map.erase(lru.back().hash);
+                    lru.pop_back();
+                }
+            }
+        };
+
+        shard shards[n_shards];
+
+        shard& get_shard(std::uint64_t hash) {
+            return shards[(hash >> 32) % n_shards];
+        }
+
+        static std::size_t shard_budget() {
+            return demangle_cache_bytes.load(std::memory_order_relaxed) / n_shards;
+        }
+
+    public:
+        // Calls fn with the cached value under the shard's lock, returns false if the name isn't cached
+        template<typename F>
+        bool lookup(std::uint64_t hash, const char* name, std::size_t length, symbol_form form, F fn) {
+            auto& s = get_shard(hash);
+            std::lock_guard<std::mutex> lock(s.mutex);
+            auto it = s.map.find(hash);
+            if(it == s.map.end()) {
+                return false;
+            }
+            const auto& cached = *it->second;
+            if(
+                cached.form != form
+                || cached.symbol.size() != length
+                || std::memcmp(cached.symbol.data(), name, length) != 0
+            ) {
+                return false;
+            }
+            s.lru.splice(s.lru.begin(), s.lru, it->second);
+            fn(cached.value);
+            return true;
+        }
+
+        void insert(
+            std::uint64_t hash,
+            symbol_form form,
+            const char* name,
+            std::size_t length,
+            const std::string& value
+        ) {
+            auto budget = shard_budget();
+            entry new_entry{hash, form, std::string(name, length), value};
+            if(new_entry.cost() > budget) {
+                return;
+            }
+            auto& s = get_shard(hash);
+            std::lock_guard<std::mutex> lock(s.mutex);
+            auto it = s.map.find(hash);
+            if(it != s.map.end()) {
+                // either another thread got here first or this is a hash collision, the newer name wins
+                s.bytes -= it->second->cost();
+                s.lru.erase(it->second);
+                s.map.erase(it);
+            }
+            s.bytes += new_entry.cost();
+            s.lru.push_front(std::move(new_entry));
+            s.map.emplace(hash, s.lru.begin());
+            s.trim(budget);
+        }
+
+        void trim() {
+            auto budget = shard_budget();
+            for(auto& s : shards) {
+                std::lock_guard<std::mutex> lock(s.mutex);
+                s.trim(budget);
+            }
+        }
+    };
+
+    demangle_cache& get_demangle_cache() {
+        static demangle_cache cache;
+        return cache;
+    }
+
+    bool demangle_cache_enabled() {
+        return demangle_cache_bytes.load(std::memory_order_relaxed) != 0;
+    }
+
+    // Looks the symbol up in the cache and passes the cached value to on_hit. On a miss the value is computed, cached,
+    // and passed to on_hit. Values equal to the symbol are only cached if cache_unchanged is set.
+    template<typename R, typename H, typename C>
+    R get_or_compute(
+        const char* name,
+        std::size_t length,
+        symbol_form form,
+        bool cache_unchanged,
+        H on_hit,
+        C compute
+    ) {
+        if(!demangle_cache_enabled()) {
+            return on_hit(compute());
+        }
+        auto hash = hash_symbol(name, length, form);
+        R result{};
+        if(
+            get_demangle_cache().lookup(
+                hash,
+                name,
+                length,
+                form,
+                [&] (const std::string& value) { result = on_hit(value); }
+            )
+        ) {
+            record_cache_access(stat_cache::demangle, true);
+            return result;
+        }
+        record_cache_access(stat_cache::demangle, false);
+        demangle_cache_miss_count.fetch_add(1, std::memory_order_relaxed);
+        std::string value = compute();
+        if(cache_unchanged || value.size() != length || std::memcmp(value.data(), name, length) != 0) {
+            get_demangle_cache().insert(hash, form, name, length, value);
+        }
+        return on_hit(value);
+    }
+
+    template<typename C>
+    std::string get_or_compute(const std::string& symbol, symbol_form form, bool cache_unchanged, C compute) {
+        return get_or_compute<std::string>(
+            symbol.data(),
+            symbol.size(),
+            form,
+            cache_unchanged,
+            [] (const std::string& value) { return value; },
+            compute
+        );
+    }
+
+    std::string demangle(const std::string& name, bool check_prefix) {
+        stage_timer timer(stat_stage::demangling);
+        // names that demangle to themselves aren't worth storing
+        return get_or_compute(
+            name,
+            demangled_form(check_prefix),
+            false,
+            [&] { return demangle_uncached(name, check_prefix); }
+        );
+    }
+
+    std::string prune_symbol_cached(const std::string& symbol) {
+        return get_or_compute(symbol, symbol_form::pruned, true, [&symbol] { return prune_symbol(symbol); });
+    }
+
+    std::string prettify_symbol_cached(const std::string& symbol) {
+        return get_or_compute(symbol, symbol_form::pretty, true, [&symbol] { return prettify_symbol(symbol); });
+    }
+
+    std::size_t demangle_cache_misses() {
+        return demangle_cache_miss_count.load(std::memory_order_relaxed);
+    }
+
+    std::size_t copy_to_buffer(const std::string& str, char* buffer, std::size_t size) {
+        if(size != 0) {
+            auto n = std::min(str.size(), size - 1);
+            std::memcpy(buffer, str.data(), n);
+            buffer[n] = 0;
+        }
+        return str.size();
+    }
+
+    std::size_t demangle_into(
+        const char* name,
+        std::size_t length,
+        bool check_prefix,
+        char* buffer,
+        std::size_t size
+    ) {
+        stage_timer timer(stat_stage::demangling);
+        return get_or_compute<std::size_t>(
+            name,
+            length,
+            demangled_form(check_prefix),
+            false,
+            [&] (const std::string& demangled) { return copy_to_buffer(demangled, buffer, size); },
+            [&] { return demangle_uncached(std::string(name, length), check_prefix); }
+        );
+    }
+}
+CPPTRACE_END_NAMESPACE
+
+CPPTRACE_BEGIN_NAMESPACE
+namespace experimental {
+    std::size_t demangle_into(const char* name, char* buffer, std::size_t size) {
+        try {
+            return detail::demangle_into(name, std::strlen(name), false, buffer, size);
+        } catch(...) {
+            detail::log_and_maybe_propagate_exception(std::current_exception());
+            return detail::copy_to_buffer(name, buffer, size);
+        }
+    }
+
+    void set_demangle_cache_size(std::size_t max_bytes) {
+        detail::demangle_cache_bytes.store(max_bytes);
+        detail::get_demangle_cache().trim();
+    }
+}
+CPPTRACE_END_NAMESPACE
@@ -1,13 +1,31 @@
 #ifndef DEMANGLE_HPP
 #define DEMANGLE_HPP
 
-#include <cpptrace/forward.hpp>
+#include <cpptrace/basic.hpp>
 
+#include <cstddef>
 #include <string>
 
 CPPTRACE_BEGIN_NAMESPACE
 namespace detail {
+    // Goes through the demangle cache
     std::string demangle(const std::string& name, bool check_prefix);
+    // Writes at most size - 1 characters and a null terminator, returns the full length of the demangled name. Doesn't
+    // allocate if the name is cached.
+    std::size_t demangle_into(
+        const char* name,
+        std::size_t length,
+        bool check_prefix,
+        char* buffer,
+        std::size_t size
+    );
+    // prune_symbol and prettify_symbol through the demangle cache, so recurring symbols are only rewritten once
+    std::string prune_symbol_cached(const std::string& symbol);
+    std::string prettify_symbol_cached(const std::string& symbol);
+    // Number of demangle cache lookups that had to compute their value, exported for test purposes
+    CPPTRACE_EXPORT std::size_t demangle_cache_misses();
+    // Provided by the demangling back-end
+    std::string demangle_uncached(const std::string& name, bool check_prefix);
 }
 CPPTRACE_END_NAMESPACE
 
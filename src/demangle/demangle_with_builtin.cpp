@@ -0,0 +1,59 @@
+#ifdef CPPTRACE_DEMANGLE_WITH_BUILTIN
+
+#include "demangle/demangle.hpp"
+#include "demangle/itanium.hpp"
+
+#include "utils/utils.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+CPPTRACE_BEGIN_NAMESPACE
+namespace detail {
+    // Upper bound on scratch space, names that need more than this aren't worth demangling
+    constexpr std::size_t max_demangle_scratch = 64 * 1024 * 1024;
+
+    std::string demangle_uncached(const std::string& name, bool check_prefix) {
+        // Check both _Z and __Z, apple prefixes all symbols with an underscore
+        if(check_prefix && !(starts_with(name, "_Z") || starts_with(name, "__Z"))) {
+            return name;
+        }
+        // Mangled names don't have spaces, we might add a space and some extra info somewhere but we still want it to
+        // be demanglable
+        auto length = std::min(name.find(' '), name.size());
+        // Both buffers are reused across calls and grown when a name doesn't fit
+        static thread_local std::vector<std::max_align_t> scratch(1024);
+        static thread_local std::string output(256, '\0');
+        while(true) {
+            auto scratch_size = scratch.size() * sizeof(std::max_align_t);
+            auto result = itanium::demangle(
+                name.data(),
+                length,
+                &output[0],
+                output.size(),
+                experimental::demangle_mode::full,
+                scratch.data(),
+                scratch_size
+            );
+            if(result.status == itanium::demangle_status::out_of_memory) {
+                if(scratch_size >= max_demangle_scratch) {
+                    return name;
+                }
+                scratch.resize(scratch.size() * 4);
+            } else if(result.status == itanium::demangle_status::invalid_name) {
+                return name;
+            } else if(result.length >= output.size()) {
+                output.resize(result.length + 1);
+            } else {
+                std::string str(output.data(), result.length);
+                str.append(name, length, std::string::npos);
+                return str;
+            }
+        }
+    }
+}
+CPPTRACE_END_NAMESPACE
+
+#endif
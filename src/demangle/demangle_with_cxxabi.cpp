@@ -7,13 +7,22 @@
 
 #include <cxxabi.h>
 
+#include <cstddef>
 #include <cstdlib>
 #include <functional>
 #include <string>
 
 CPPTRACE_BEGIN_NAMESPACE
 namespace detail {
-    std::string demangle(const std::string& name, bool check_prefix) {
+    struct demangle_buffer {
+        char* data = nullptr;
+        std::size_t size = 0;
+        ~demangle_buffer() {
+            std::free(data);
+        }
+    };
+
+    std::string demangle_uncached(const std::string& name, bool check_prefix) {
         // https://itanium-cxx-abi.github.io/cxx-abi/abi.html#demangler
         // Check both _Z and __Z, apple prefixes all symbols with an underscore
         if(check_prefix && !(starts_with(name, "_Z") || starts_with(name, "__Z"))) {
@@ -39,14 +48,15 @@ namespace detail {
         // it appears safe to pass nullptr for status however the docs don't explicitly say it's safe so I don't
         // want to rely on it
         int status;
-        auto demangled = raii_wrap(
-            abi::__cxa_demangle(to_demangle.get().c_str() + offset, nullptr, nullptr, &status),
-            [] (char* str) { std::free(str); }
-        );
+        // __cxa_demangle reuses the output buffer when it's large enough and reallocates it otherwise, updating the
+        // size
+        static thread_local demangle_buffer buffer;
+        auto demangled = abi::__cxa_demangle(to_demangle.get().c_str() + offset, buffer.data, &buffer.size, &status);
         // demangled will always be nullptr on non-zero status, and if __cxa_demangle ever fails for any reason
         // we'll just quietly return the mangled name
-        if(demangled.get()) {
-            std::string str = demangled.get();
+        if(demangled) {
+            buffer.data = demangled;
+            std::string str = demangled;
             if(!rest.empty()) {
                 str += rest;
             }
@@ -6,7 +6,7 @@
 
 CPPTRACE_BEGIN_NAMESPACE
 namespace detail {
-    std::string demangle(const std::string& name, bool) {
+    std::string demangle_uncached(const std::string& name, bool) {
         return name;
     }
 }
@@ -13,7 +13,7 @@
 
 CPPTRACE_BEGIN_NAMESPACE
 namespace detail {
-    std::string demangle(const std::string& name, bool) {
+    std::string demangle_uncached(const std::string& name, bool) {
         // Dbghelp is is single-threaded, so acquire a lock.
         auto lock = get_dbghelp_lock();
         char buffer[500];
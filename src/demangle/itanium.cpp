@@ -0,0 +1,3810 @@
+#include "demangle/itanium.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+
+#include "utils/string_view.hpp"
+
+// Grammar: https://itanium-cxx-abi.github.io/cxx-abi/abi.html#mangling
+// The parser and the node types closely follow LLVM's demangler so that output is identical to llvm-cxxfilt:
+// https://github.com/llvm/llvm-project/blob/main/libcxxabi/src/demangle/ItaniumDemangle.h
+// Nothing here may allocate, throw, or use locale-dependent functions, this code runs in signal handlers.
+
+CPPTRACE_BEGIN_NAMESPACE
+namespace detail {
+namespace itanium {
+    using experimental::demangle_mode;
+
+    constexpr std::size_t max_parse_depth = 256;
+    constexpr std::size_t max_print_depth = 1024;
+    // Substitutions can make the output exponentially larger than the input, give up past this
+    constexpr std::size_t max_output_length = std::size_t(1) << 22;
+    constexpr std::size_t max_template_levels = 8;
+    constexpr unsigned no_pack = static_cast<unsigned>(-1);
+
+    bool is_digit(char c) {
+        return c >= '0' && c <= '9';
+    }
+
+    class node;
+
+    class printer {
+        char* buffer;
+        std::size_t capacity;
+        std::size_t pos = 0;
+        char last = 0;
+        std::size_t depth = 0;
+        bool failed = false;
+
+    public:
+        const bool pruned;
+        // state for expanding parameter packs, see parameter_pack_expansion
+        unsigned pack_index = no_pack;
+        unsigned pack_max = no_pack;
+
+        struct mark {
+            std::size_t pos;
+            char last;
+        };
+
+        printer(char* buffer, std::size_t size, bool pruned)
+            : buffer(buffer), capacity(size == 0 ? 0 : size - 1), pruned(pruned) {}
+
+        printer& operator+=(char c) {
+            if(pos < capacity) {
+                buffer[pos] = c;
+            }
+            pos++;
+            last = c;
+            return *this;
+        }
+
+        printer& operator+=(string_view str) {
+            for(char c : str) {
+                *this += c;
+            }
+            return *this;
+        }
+
+        void print_number(std::size_t value) {
+            char digits[20];
+            int n = 0;
+            do {
+                digits[n++] = static_cast<char>('0' + value % 10);
+                value /= 10;
+            } while(value != 0);
+            while(n > 0) {
+                *this += digits[--n];
+            }
+        }
+
+        char back() const {
+            return last;
+        }
+
+        std::size_t position() const {
+            return pos;
+        }
+
+        mark get_mark() const {
+            return {pos, last};
+        }
+
+        void rewind(mark m) {
+            pos = m.pos;
+            last = m.last;
+        }
+
+        void left(const node* n);
+        void right(const node* n);
+        void print(const node* n);
+
+        bool ok() const {
+            return !failed && pos <= max_output_length;
+        }
+
+        std::size_t finish() {
+            if(capacity + 1 != 1 || buffer != nullptr) {
+                buffer[pos < capacity ? pos : capacity] = 0;
+            }
+            return pos;
+        }
+    };
+
+    enum class node_kind : std::uint8_t {
+        other,
+        special_substitution,
+        reference_type,
+        template_argument_pack,
+        closure_type_name
+    };
+
+    // Whether a node has a component printed after the name, e.g. the parameters of a function type. Known up front
+    // for most nodes, parameter packs and forward references only know once printing is underway.
+    enum class cache : std::uint8_t {
+        yes,
+        no,
+        unknown
+    };
+
+    class node {
+    public:
+        const node_kind kind;
+        cache rhs_cache;
+        cache array_cache;
+        cache function_cache;
+
+        explicit node(
+            node_kind kind = node_kind::other,
+            cache rhs_cache = cache::no,
+            cache array_cache = cache::no,
+            cache function_cache = cache::no
+        ) : kind(kind), rhs_cache(rhs_cache), array_cache(array_cache), function_cache(function_cache) {}
+
+        bool has_rhs(printer& p) const {
+            return rhs_cache == cache::unknown ? has_rhs_slow(p) : rhs_cache == cache::yes;
+        }
+        bool has_array(printer& p) const {
+            return array_cache == cache::unknown ? has_array_slow(p) : array_cache == cache::yes;
+        }
+        bool has_function(printer& p) const {
+            return function_cache == cache::unknown ? has_function_slow(p) : function_cache == cache::yes;
+        }
+
+        virtual void print_left(printer& p) const = 0;
+        virtual void print_right(printer&) const {}
+        virtual bool has_rhs_slow(printer&) const {
+            return false;
+        }
+        virtual bool has_array_slow(printer&) const {
+            return false;
+        }
+        virtual bool has_function_slow(printer&) const {
+            return false;
+        }
+        // The node that determines how this one is printed, only differs for packs and forward references
+        virtual const node* syntax_node(printer&) const {
+            return this;
+        }
+        // The unqualified name without template arguments, used for constructor and destructor names
+        virtual string_view base_name() const {
+            return {};
+        }
+    };
+
+    void printer::left(const node* n) {
+        if(depth >= max_print_depth || pos > max_output_length) {
+            failed = true;
+            return;
+        }
+        depth++;
+        n->print_left(*this);
+        depth--;
+    }
+
+    void printer::right(const node* n) {
+        if(depth >= max_print_depth || pos > max_output_length) {
+            failed = true;
+            return;
+        }
+        depth++;
+        n->print_right(*this);
+        depth--;
+    }
+
+    void printer::print(const node* n) {
+        left(n);
+        if(n->rhs_cache != cache::no) {
+            right(n);
+        }
+    }
+
+    struct node_array {
+        node** elements = nullptr;
+        std::size_t count = 0;
+
+        bool empty() const {
+            return count == 0;
+        }
+
+        void print_with_comma(printer& p) const {
+            bool first_element = true;
+            for(std::size_t i = 0; i < count; i++) {
+                auto before_comma = p.get_mark();
+                if(!first_element) {
+                    p += ", ";
+                }
+                auto after_comma = p.position();
+                p.print(elements[i]);
+                // an empty pack expansion prints nothing, drop its comma too
+                if(p.position() == after_comma) {
+                    p.rewind(before_comma);
+                    continue;
+                }
+                first_element = false;
+            }
+        }
+    };
+
+    enum qualifiers : std::uint8_t {
+        qual_none = 0,
+        qual_const = 1,
+        qual_volatile = 2,
+        qual_restrict = 4
+    };
+
+    enum class ref_qualifier : std::uint8_t {
+        none,
+        lvalue,
+        rvalue
+    };
+
+    void print_qualifiers(printer& p, unsigned quals) {
+        if(quals & qual_const) {
+            p += " const";
+        }
+        if(quals & qual_volatile) {
+            p += " volatile";
+        }
+        if(quals & qual_restrict) {
+            p += " restrict";
+        }
+    }
+
+    void print_ref_qualifier(printer& p, ref_qualifier ref) {
+        if(ref == ref_qualifier::lvalue) {
+            p += " &";
+        } else if(ref == ref_qualifier::rvalue) {
+            p += " &&";
+        }
+    }
+
+    //
+    // Names
+    //
+
+    class name_type : public node {
+        string_view name;
+    public:
+        explicit name_type(string_view name) : name(name) {}
+        void print_left(printer& p) const override {
+            p += name;
+        }
+        string_view base_name() const override {
+            return name;
+        }
+    };
+
+    class nested_name : public node {
+        const node* qualifier;
+        const node* name;
+    public:
+        nested_name(const node* qualifier, const node* name) : qualifier(qualifier), name(name) {}
+        void print_left(printer& p) const override {
+            p.print(qualifier);
+            p += "::";
+            p.print(name);
+        }
+        string_view base_name() const override {
+            return name->base_name();
+        }
+    };
+
+    class local_name : public node {
+        const node* encoding;
+        const node* entity;
+    public:
+        local_name(const node* encoding, const node* entity) : encoding(encoding), entity(entity) {}
+        void print_left(printer& p) const override {
+            p.print(encoding);
+            p += "::";
+            p.print(entity);
+        }
+    };
+
+    class std_qualified_name : public node {
+        const node* child;
+    public:
+        explicit std_qualified_name(const node* child) : child(child) {}
+        void print_left(printer& p) const override {
+            p += "std::";
+            p.print(child);
+        }
+        string_view base_name() const override {
+            return child->base_name();
+        }
+    };
+
+    // Qualified names in expressions
+    class qualified_name : public node {
+        const node* qualifier;
+        const node* name;
+    public:
+        qualified_name(const node* qualifier, const node* name) : qualifier(qualifier), name(name) {}
+        void print_left(printer& p) const override {
+            p.print(qualifier);
+            p += "::";
+            p.print(name);
+        }
+        string_view base_name() const override {
+            return name->base_name();
+        }
+    };
+
+    class global_qualified_name : public node {
+        const node* child;
+    public:
+        explicit global_qualified_name(const node* child) : child(child) {}
+        void print_left(printer& p) const override {
+            p += "::";
+            p.print(child);
+        }
+        string_view base_name() const override {
+            return child->base_name();
+        }
+    };
+
+    enum class special_sub_kind : std::uint8_t {
+        allocator,
+        basic_string,
+        string,
+        istream,
+        ostream,
+        iostream
+    };
+
+    // Sa, Sb, Ss, Si, So, Sd. These print abbreviated except when naming a constructor or destructor, then they're
+    // expanded to the full class template.
+    class special_substitution : public node {
+    public:
+        const special_sub_kind sub;
+        const bool expanded;
+
+        explicit special_substitution(special_sub_kind sub, bool expanded = false)
+            : node(node_kind::special_substitution), sub(sub), expanded(expanded) {}
+
+        string_view base_name() const override {
+            switch(sub) {
+                case special_sub_kind::allocator:
+                    return "allocator";
+                case special_sub_kind::basic_string:
+                    return "basic_string";
+                case special_sub_kind::string:
+                    return expanded ? "basic_string" : "string";
+                case special_sub_kind::istream:
+                    return expanded ? "basic_istream" : "istream";
+                case special_sub_kind::ostream:
+                    return expanded ? "basic_ostream" : "ostream";
+                case special_sub_kind::iostream:
+                    return expanded ? "basic_iostream" : "iostream";
+            }
+            return {};
+        }
+
+        void print_left(printer& p) const override {
+            p += "std::";
+            p += base_name();
+            if(!expanded || p.pruned) {
+                return;
+            }
+            if(sub == special_sub_kind::string) {
+                p += "<char, std::char_traits<char>, std::allocator<char> >";
+            } else if(sub != special_sub_kind::allocator && sub != special_sub_kind::basic_string) {
+                p += "<char, std::char_traits<char> >";
+            }
+        }
+    };
+
+    class ctor_dtor_name : public node {
+        const node* basename;
+        bool is_dtor;
+    public:
+        ctor_dtor_name(const node* basename, bool is_dtor) : basename(basename), is_dtor(is_dtor) {}
+        void print_left(printer& p) const override {
+            if(is_dtor) {
+                p += '~';
+            }
+            p += basename->base_name();
+        }
+    };
+
+    class dtor_name : public node {
+        const node* base;
+    public:
+        explicit dtor_name(const node* base) : base(base) {}
+        void print_left(printer& p) const override {
+            p += '~';
+            p.left(base);
+        }
+    };
+
+    class template_args : public node {
+        node_array params;
+    public:
+        explicit template_args(node_array params) : params(params) {}
+        void print_left(printer& p) const override {
+            p += '<';
+            params.print_with_comma(p);
+            if(p.back() == '>') {
+                p += ' ';
+            }
+            p += '>';
+        }
+    };
+
+    class name_with_template_args : public node {
+        const node* name;
+        const node* args;
+    public:
+        name_with_template_args(const node* name, const node* args) : name(name), args(args) {}
+        void print_left(printer& p) const override {
+            p.print(name);
+            if(!p.pruned) {
+                p.print(args);
+            }
+        }
+        string_view base_name() const override {
+            return name->base_name();
+        }
+    };
+
+    class abi_tag_attr : public node {
+        const node* base;
+        string_view tag;
+    public:
+        abi_tag_attr(const node* base, string_view tag)
+            : node(node_kind::other, base->rhs_cache, base->array_cache, base->function_cache), base(base), tag(tag) {}
+        void print_left(printer& p) const override {
+            p.left(base);
+            if(!p.pruned) {
+                p += "[abi:";
+                p += tag;
+                p += ']';
+            }
+        }
+        string_view base_name() const override {
+            return base->base_name();
+        }
+    };
+
+    class literal_operator : public node {
+        const node* name;
+    public:
+        explicit literal_operator(const node* name) : name(name) {}
+        void print_left(printer& p) const override {
+            p += p.pruned ? "operator\"\"" : "operator\"\" ";
+            p.print(name);
+        }
+    };
+
+    class conversion_operator_type : public node {
+        const node* type;
+    public:
+        explicit conversion_operator_type(const node* type) : type(type) {}
+        void print_left(printer& p) const override {
+            p += "operator ";
+            p.print(type);
+        }
+    };
+
+    class unnamed_type_name : public node {
+        string_view count;
+    public:
+        explicit unnamed_type_name(string_view count) : count(count) {}
+        void print_left(printer& p) const override {
+            p += p.pruned ? '<' : '\'';
+            p += "unnamed";
+            p += count;
+            p += p.pruned ? '>' : '\'';
+        }
+    };
+
+    class closure_type_name : public node {
+        node_array template_params;
+        node_array params;
+        string_view count;
+    public:
+        closure_type_name(node_array template_params, node_array params, string_view count)
+            : node(node_kind::closure_type_name), template_params(template_params), params(params), count(count) {}
+
+        void print_declarator(printer& p) const {
+            if(!template_params.empty()) {
+                p += '<';
+                template_params.print_with_comma(p);
+                p += '>';
+            }
+            p += '(';
+            params.print_with_comma(p);
+            p += ')';
+        }
+
+        void print_left(printer& p) const override {
+            p += p.pruned ? '<' : '\'';
+            p += "lambda";
+            p += count;
+            p += p.pruned ? '>' : '\'';
+            if(!p.pruned) {
+                print_declarator(p);
+            }
+        }
+    };
+
+    class structured_binding_name : public node {
+        node_array bindings;
+    public:
+        explicit structured_binding_name(node_array bindings) : bindings(bindings) {}
+        void print_left(printer& p) const override {
+            p += '[';
+            bindings.print_with_comma(p);
+            p += ']';
+        }
+    };
+
+    //
+    // Encodings
+    //
+
+    class special_name : public node {
+        string_view special;
+        const node* child;
+    public:
+        special_name(string_view special, const node* child) : special(special), child(child) {}
+        void print_left(printer& p) const override {
+            if(!p.pruned) {
+                p += special;
+            }
+            p.print(child);
+        }
+    };
+
+    class ctor_vtable_special_name : public node {
+        const node* first_type;
+        const node* second_type;
+    public:
+        ctor_vtable_special_name(const node* first_type, const node* second_type)
+            : first_type(first_type), second_type(second_type) {}
+        void print_left(printer& p) const override {
+            if(!p.pruned) {
+                p += "construction vtable for ";
+            }
+            p.print(first_type);
+            p += "-in-";
+            p.print(second_type);
+        }
+    };
+
+    // Suffixes added to clones by the compiler, e.g. .cold or .constprop.0
+    class dot_suffix : public node {
+        const node* prefix;
+        string_view suffix;
+    public:
+        dot_suffix(const node* prefix, string_view suffix) : prefix(prefix), suffix(suffix) {}
+        void print_left(printer& p) const override {
+            p.print(prefix);
+            if(!p.pruned) {
+                p += " (";
+                p += suffix;
+                p += ')';
+            }
+        }
+    };
+
+    class enable_if_attr : public node {
+        node_array conditions;
+    public:
+        explicit enable_if_attr(node_array conditions) : conditions(conditions) {}
+        void print_left(printer& p) const override {
+            p += " [enable_if:";
+            conditions.print_with_comma(p);
+            p += ']';
+        }
+    };
+
+    class function_encoding : public node {
+        const node* ret;
+        const node* name;
+        node_array params;
+        const node* attrs;
+        unsigned cv;
+        ref_qualifier ref;
+    public:
+        function_encoding(
+            const node* ret,
+            const node* name,
+            node_array params,
+            const node* attrs,
+            unsigned cv,
+            ref_qualifier ref
+        ) : node(node_kind::other, cache::yes, cache::no, cache::yes),
+            ret(ret), name(name), params(params), attrs(attrs), cv(cv), ref(ref) {}
+
+        void print_left(printer& p) const override {
+            if(p.pruned) {
+                p.print(name);
+                return;
+            }
+            if(ret) {
+                p.left(ret);
+                if(!ret->has_rhs(p)) {
+                    p += ' ';
+                }
+            }
+            p.print(name);
+        }
+
+        void print_right(printer& p) const override {
+            if(p.pruned) {
+                return;
+            }
+            p += '(';
+            params.print_with_comma(p);
+            p += ')';
+            if(ret) {
+                p.right(ret);
+            }
+            print_qualifiers(p, cv);
+            print_ref_qualifier(p, ref);
+            if(attrs) {
+                p.print(attrs);
+            }
+        }
+    };
+
+    //
+    // Types
+    //
+
+    class qual_type : public node {
+        const node* child;
+        unsigned quals;
+    public:
+        qual_type(const node* child, unsigned quals)
+            : node(node_kind::other, child->rhs_cache, child->array_cache, child->function_cache),
+              child(child), quals(quals) {}
+        bool has_rhs_slow(printer& p) const override {
+            return child->has_rhs(p);
+        }
+        bool has_array_slow(printer& p) const override {
+            return child->has_array(p);
+        }
+        bool has_function_slow(printer& p) const override {
+            return child->has_function(p);
+        }
+        void print_left(printer& p) const override {
+            p.left(child);
+            print_qualifiers(p, quals);
+        }
+        void print_right(printer& p) const override {
+            p.right(child);
+        }
+    };
+
+    class postfix_qualified_type : public node {
+        const node* type;
+        string_view postfix;
+    public:
+        postfix_qualified_type(const node* type, string_view postfix) : type(type), postfix(postfix) {}
+        void print_left(printer& p) const override {
+            p.left(type);
+            p += postfix;
+        }
+    };
+
+    class elaborated_type_spef_type : public node {
+        string_view spef;
+        const node* child;
+    public:
+        elaborated_type_spef_type(string_view spef, const node* child) : spef(spef), child(child) {}
+        void print_left(printer& p) const override {
+            p += spef;
+            p += ' ';
+            p.print(child);
+        }
+    };
+
+    class vendor_ext_qual_type : public node {
+        const node* type;
+        string_view ext;
+        const node* args;
+    public:
+        vendor_ext_qual_type(const node* type, string_view ext, const node* args) : type(type), ext(ext), args(args) {}
+        void print_left(printer& p) const override {
+            p.print(type);
+            p += ' ';
+            p += ext;
+            if(args) {
+                p.print(args);
+            }
+        }
+    };
+
+    class pointer_type : public node {
+        const node* pointee;
+    public:
+        explicit pointer_type(const node* pointee) : node(node_kind::other, pointee->rhs_cache), pointee(pointee) {}
+        bool has_rhs_slow(printer& p) const override {
+            return pointee->has_rhs(p);
+        }
+        void print_left(printer& p) const override {
+            p.left(pointee);
+            if(pointee->has_array(p)) {
+                p += ' ';
+            }
+            if(pointee->has_array(p) || pointee->has_function(p)) {
+                p += '(';
+            }
+            p += '*';
+        }
+        void print_right(printer& p) const override {
+            if(pointee->has_array(p) || pointee->has_function(p)) {
+                p += ')';
+            }
+            p.right(pointee);
+        }
+    };
+
+    class reference_type : public node {
+        const node* pointee;
+        bool rvalue;
+        // guards against cycles through forward template references
+        mutable bool printing = false;
+
+        // References to references collapse: && && is &&, any other combination is &
+        bool collapse(printer& p, bool& collapsed_rvalue, const node*& collapsed) const {
+            collapsed_rvalue = rvalue;
+            collapsed = pointee;
+            for(std::size_t steps = 0; ; steps++) {
+                const node* syntax = collapsed->syntax_node(p);
+                if(syntax->kind != node_kind::reference_type) {
+                    return true;
+                }
+                auto inner = static_cast<const reference_type*>(syntax);
+                collapsed = inner->pointee;
+                collapsed_rvalue = collapsed_rvalue && inner->rvalue;
+                if(steps > max_print_depth) {
+                    return false;
+                }
+            }
+        }
+
+    public:
+        reference_type(const node* pointee, bool rvalue)
+            : node(node_kind::reference_type, pointee->rhs_cache), pointee(pointee), rvalue(rvalue) {}
+
+        bool has_rhs_slow(printer& p) const override {
+            return pointee->has_rhs(p);
+        }
+
+        void print_left(printer& p) const override {
+            bool collapsed_rvalue;
+            const node* collapsed;
+            if(printing || !collapse(p, collapsed_rvalue, collapsed)) {
+                return;
+            }
+            printing = true;
+            p.left(collapsed);
+            if(collapsed->has_array(p)) {
+                p += ' ';
+            }
+            if(collapsed->has_array(p) || collapsed->has_function(p)) {
+                p += '(';
+            }
+            p += collapsed_rvalue ? "&&" : "&";
+            printing = false;
+        }
+
+        void print_right(printer& p) const override {
+            bool collapsed_rvalue;
+            const node* collapsed;
+            if(printing || !collapse(p, collapsed_rvalue, collapsed)) {
+                return;
+            }
+            printing = true;
+            if(collapsed->has_array(p) || collapsed->has_function(p)) {
+                p += ')';
+            }
+            p.right(collapsed);
+            printing = false;
+        }
+    };
+
+    class pointer_to_member_type : public node {
+        const node* class_type;
+        const node* member_type;
+    public:
+        pointer_to_member_type(const node* class_type, const node* member_type)
+            : node(node_kind::other, member_type->rhs_cache), class_type(class_type), member_type(member_type) {}
+        bool has_rhs_slow(printer& p) const override {
+            return member_type->has_rhs(p);
+        }
+        void print_left(printer& p) const override {
+            p.left(member_type);
+            if(member_type->has_array(p) || member_type->has_function(p)) {
+                p += '(';
+            } else {
+                p += ' ';
+            }
+            p.print(class_type);
+            p += "::*";
+        }
+        void print_right(printer& p) const override {
+            if(member_type->has_array(p) || member_type->has_function(p)) {
+                p += ')';
+            }
+            p.right(member_type);
+        }
+    };
+
+    class array_type : public node {
+        const node* base;
+        const node* dimension;
+    public:
+        array_type(const node* base, const node* dimension)
+            : node(node_kind::other, cache::yes, cache::yes), base(base), dimension(dimension) {}
+        void print_left(printer& p) const override {
+            p.left(base);
+        }
+        void print_right(printer& p) const override {
+            if(p.back() != ']') {
+                p += ' ';
+            }
+            p += '[';
+            if(dimension) {
+                p.print(dimension);
+            }
+            p += ']';
+            p.right(base);
+        }
+    };
+
+    class function_type : public node {
+        const node* ret;
+        node_array params;
+        unsigned cv;
+        ref_qualifier ref;
+        const node* exception_spec;
+    public:
+        function_type(const node* ret, node_array params, unsigned cv, ref_qualifier ref, const node* exception_spec)
+            : node(node_kind::other, cache::yes, cache::no, cache::yes),
+              ret(ret), params(params), cv(cv), ref(ref), exception_spec(exception_spec) {}
+        // The return type's left part goes before the declarator and its right part after the parameters, e.g.
+        // void (*(*)(int))(char)
+        void print_left(printer& p) const override {
+            p.left(ret);
+            p += ' ';
+        }
+        void print_right(printer& p) const override {
+            p += '(';
+            params.print_with_comma(p);
+            p += ')';
+            p.right(ret);
+            print_qualifiers(p, cv);
+            print_ref_qualifier(p, ref);
+            if(exception_spec) {
+                p += ' ';
+                p.print(exception_spec);
+            }
+        }
+    };
+
+    class noexcept_spec : public node {
+        const node* expr;
+    public:
+        explicit noexcept_spec(const node* expr) : expr(expr) {}
+        void print_left(printer& p) const override {
+            p += "noexcept(";
+            p.print(expr);
+            p += ')';
+        }
+    };
+
+    class dynamic_exception_spec : public node {
+        node_array types;
+    public:
+        explicit dynamic_exception_spec(node_array types) : types(types) {}
+        void print_left(printer& p) const override {
+            p += "throw(";
+            types.print_with_comma(p);
+            p += ')';
+        }
+    };
+
+    class vector_type : public node {
+        const node* base;
+        const node* dimension;
+    public:
+        vector_type(const node* base, const node* dimension) : base(base), dimension(dimension) {}
+        void print_left(printer& p) const override {
+            p.print(base);
+            p += " vector[";
+            if(dimension) {
+                p.print(dimension);
+            }
+            p += ']';
+        }
+    };
+
+    class pixel_vector_type : public node {
+        const node* dimension;
+    public:
+        explicit pixel_vector_type(const node* dimension) : dimension(dimension) {}
+        void print_left(printer& p) const override {
+            p += "pixel vector[";
+            p.print(dimension);
+            p += ']';
+        }
+    };
+
+    class binary_fp_type : public node {
+        const node* dimension;
+    public:
+        explicit binary_fp_type(const node* dimension) : dimension(dimension) {}
+        void print_left(printer& p) const override {
+            p += "_Float";
+            p.print(dimension);
+        }
+    };
+
+    //
+    // Templates
+    //
+
+    enum class template_param_kind : std::uint8_t {
+        type,
+        non_type,
+        template_template
+    };
+
+    // Names invented for the template parameters of lambdas, which aren't mangled
+    class synthetic_template_param_name : public node {
+        template_param_kind param_kind;
+        unsigned index;
+    public:
+        synthetic_template_param_name(template_param_kind param_kind, unsigned index)
+            : param_kind(param_kind), index(index) {}
+        void print_left(printer& p) const override {
+            switch(param_kind) {
+                case template_param_kind::type:
+                    p += "$T";
+                    break;
+                case template_param_kind::non_type:
+                    p += "$N";
+                    break;
+                case template_param_kind::template_template:
+                    p += "$TT";
+                    break;
+            }
+            if(index > 0) {
+                p.print_number(index - 1);
+            }
+        }
+    };
+
+    class type_template_param_decl : public node {
+        const node* name;
+    public:
+        explicit type_template_param_decl(const node* name) : node(node_kind::other, cache::yes), name(name) {}
+        void print_left(printer& p) const override {
+            p += "typename ";
+        }
+        void print_right(printer& p) const override {
+            p.print(name);
+        }
+    };
+
+    class non_type_template_param_decl : public node {
+        const node* name;
+        const node* type;
+    public:
+        non_type_template_param_decl(const node* name, const node* type)
+            : node(node_kind::other, cache::yes), name(name), type(type) {}
+        void print_left(printer& p) const override {
+            p.left(type);
+            if(!type->has_rhs(p)) {
+                p += ' ';
+            }
+        }
+        void print_right(printer& p) const override {
+            p.print(name);
+            p.right(type);
+        }
+    };
+
+    class template_template_param_decl : public node {
+        const node* name;
+        node_array params;
+    public:
+        template_template_param_decl(const node* name, node_array params)
+            : node(node_kind::other, cache::yes), name(name), params(params) {}
+        void print_left(printer& p) const override {
+            p += "template<";
+            params.print_with_comma(p);
+            p += "> typename ";
+        }
+        void print_right(printer& p) const override {
+            p.print(name);
+        }
+    };
+
+    class template_param_pack_decl : public node {
+        const node* param;
+    public:
+        explicit template_param_pack_decl(const node* param) : node(node_kind::other, cache::yes), param(param) {}
+        void print_left(printer& p) const override {
+            p.left(param);
+            p += "...";
+        }
+        void print_right(printer& p) const override {
+            p.right(param);
+        }
+    };
+
+    // A template argument pack as it appears in template arguments, J ... E
+    class template_argument_pack : public node {
+    public:
+        const node_array elements;
+        explicit template_argument_pack(node_array elements)
+            : node(node_kind::template_argument_pack), elements(elements) {}
+        void print_left(printer& p) const override {
+            elements.print_with_comma(p);
+        }
+    };
+
+    // A template argument pack referenced through a template parameter. Prints the element selected by the enclosing
+    // pack expansion.
+    class parameter_pack : public node {
+        node_array data;
+
+        void initialize_expansion(printer& p) const {
+            if(p.pack_max == no_pack) {
+                p.pack_max = static_cast<unsigned>(data.count);
+                p.pack_index = 0;
+            }
+        }
+
+        const node* current(printer& p) const {
+            initialize_expansion(p);
+            return p.pack_index < data.count ? data.elements[p.pack_index] : nullptr;
+        }
+
+        static cache combine(node_array data, cache node::* member) {
+            for(std::size_t i = 0; i < data.count; i++) {
+                if(data.elements[i]->*member != cache::no) {
+                    return cache::unknown;
+                }
+            }
+            return cache::no;
+        }
+
+    public:
+        explicit parameter_pack(node_array data)
+            : node(
+                node_kind::other,
+                combine(data, &node::rhs_cache),
+                combine(data, &node::array_cache),
+                combine(data, &node::function_cache)
+            ),
+            data(data) {}
+
+        bool has_rhs_slow(printer& p) const override {
+            const node* element = current(p);
+            return element && element->has_rhs(p);
+        }
+        bool has_array_slow(printer& p) const override {
+            const node* element = current(p);
+            return element && element->has_array(p);
+        }
+        bool has_function_slow(printer& p) const override {
+            const node* element = current(p);
+            return element && element->has_function(p);
+        }
+        const node* syntax_node(printer& p) const override {
+            const node* element = current(p);
+            return element ? element->syntax_node(p) : this;
+        }
+        void print_left(printer& p) const override {
+            const node* element = current(p);
+            if(element) {
+                p.left(element);
+            }
+        }
+        void print_right(printer& p) const override {
+            const node* element = current(p);
+            if(element) {
+                p.right(element);
+            }
+        }
+    };
+
+    // Dp <type> and sp <expression>: prints the child once for every element of the packs it refers to
+    class parameter_pack_expansion : public node {
+        const node* child;
+    public:
+        explicit parameter_pack_expansion(const node* child) : child(child) {}
+        void print_left(printer& p) const override {
+            auto saved_index = p.pack_index;
+            auto saved_max = p.pack_max;
+            p.pack_index = no_pack;
+            p.pack_max = no_pack;
+            auto start = p.get_mark();
+            p.print(child);
+            if(p.pack_max == no_pack) {
+                // no pack found in the child, e.g. an expansion of a function parameter pack
+                p += "...";
+            } else if(p.pack_max == 0) {
+                // empty pack, erase whatever was printed
+                p.rewind(start);
+            } else {
+                for(unsigned i = 1, end = p.pack_max; i < end; i++) {
+                    p += ", ";
+                    p.pack_index = i;
+                    p.print(child);
+                }
+            }
+            p.pack_index = saved_index;
+            p.pack_max = saved_max;
+        }
+    };
+
+    // A template parameter used before the template arguments it refers to are parsed, only happens in conversion
+    // operator types
+    class forward_template_reference : public node {
+        mutable bool printing = false;
+    public:
+        const std::size_t index;
+        const node* ref = nullptr;
+
+        explicit forward_template_reference(std::size_t index)
+            : node(node_kind::other, cache::unknown, cache::unknown, cache::unknown), index(index) {}
+
+        bool has_rhs_slow(printer& p) const override {
+            if(printing) {
+                return false;
+            }
+            printing = true;
+            bool result = ref->has_rhs(p);
+            printing = false;
+            return result;
+        }
+        bool has_array_slow(printer& p) const override {
+            if(printing) {
+                return false;
+            }
+            printing = true;
+            bool result = ref->has_array(p);
+            printing = false;
+            return result;
+        }
+        bool has_function_slow(printer& p) const override {
+            if(printing) {
+                return false;
+            }
+            printing = true;
+            bool result = ref->has_function(p);
+            printing = false;
+            return result;
+        }
+        const node* syntax_node(printer& p) const override {
+            if(printing) {
+                return this;
+            }
+            printing = true;
+            const node* result = ref->syntax_node(p);
+            printing = false;
+            return result;
+        }
+        void print_left(printer& p) const override {
+            if(printing) {
+                return;
+            }
+            printing = true;
+            p.left(ref);
+            printing = false;
+        }
+        void print_right(printer& p) const override {
+            if(printing) {
+                return;
+            }
+            printing = true;
+            p.right(ref);
+            printing = false;
+        }
+    };
+
+    //
+    // Expressions
+    //
+
+    class binary_expr : public node {
+        const node* lhs;
+        string_view op;
+        const node* rhs;
+    public:
+        binary_expr(const node* lhs, string_view op, const node* rhs) : lhs(lhs), op(op), rhs(rhs) {}
+        void print_left(printer& p) const override {
+            // an unparenthesized > would end a template argument list
+            bool is_greater = op == ">";
+            if(is_greater) {
+                p += '(';
+            }
+            p += '(';
+            p.print(lhs);
+            p += ") ";
+            p += op;
+            p += " (";
+            p.print(rhs);
+            p += ')';
+            if(is_greater) {
+                p += ')';
+            }
+        }
+    };
+
+    class prefix_expr : public node {
+        string_view prefix;
+        const node* child;
+    public:
+        prefix_expr(string_view prefix, const node* child) : prefix(prefix), child(child) {}
+        void print_left(printer& p) const override {
+            p += prefix;
+            p += '(';
+            p.print(child);
+            p += ')';
+        }
+    };
+
+    class postfix_expr : public node {
+        const node* child;
+        string_view op;
+    public:
+        postfix_expr(const node* child, string_view op) : child(child), op(op) {}
+        void print_left(printer& p) const override {
+            p += '(';
+            p.print(child);
+            p += ')';
+            p += op;
+        }
+    };
+
+    class conditional_expr : public node {
+        const node* condition;
+        const node* then_expr;
+        const node* else_expr;
+    public:
+        conditional_expr(const node* condition, const node* then_expr, const node* else_expr)
+            : condition(condition), then_expr(then_expr), else_expr(else_expr) {}
+        void print_left(printer& p) const override {
+            p += '(';
+            p.print(condition);
+            p += ") ? (";
+            p.print(then_expr);
+            p += ") : (";
+            p.print(else_expr);
+            p += ')';
+        }
+    };
+
+    class member_expr : public node {
+        const node* lhs;
+        string_view op;
+        const node* rhs;
+    public:
+        member_expr(const node* lhs, string_view op, const node* rhs) : lhs(lhs), op(op), rhs(rhs) {}
+        void print_left(printer& p) const override {
+            p.print(lhs);
+            p += op;
+            p.print(rhs);
+        }
+    };
+
+    class array_subscript_expr : public node {
+        const node* base;
+        const node* index;
+    public:
+        array_subscript_expr(const node* base, const node* index) : base(base), index(index) {}
+        void print_left(printer& p) const override {
+            p += '(';
+            p.print(base);
+            p += ")[";
+            p.print(index);
+            p += ']';
+        }
+    };
+
+    class call_expr : public node {
+        const node* callee;
+        node_array args;
+    public:
+        call_expr(const node* callee, node_array args) : callee(callee), args(args) {}
+        void print_left(printer& p) const override {
+            p.print(callee);
+            p += '(';
+            args.print_with_comma(p);
+            p += ')';
+        }
+    };
+
+    class cast_expr : public node {
+        string_view cast;
+        const node* to;
+        const node* from;
+    public:
+        cast_expr(string_view cast, const node* to, const node* from) : cast(cast), to(to), from(from) {}
+        void print_left(printer& p) const override {
+            p += cast;
+            p += '<';
+            p.print(to);
+            p += ">(";
+            p.print(from);
+            p += ')';
+        }
+    };
+
+    class conversion_expr : public node {
+        const node* type;
+        node_array exprs;
+    public:
+        conversion_expr(const node* type, node_array exprs) : type(type), exprs(exprs) {}
+        void print_left(printer& p) const override {
+            p += '(';
+            p.print(type);
+            p += ")(";
+            exprs.print_with_comma(p);
+            p += ')';
+        }
+    };
+
+    class enclosing_expr : public node {
+        string_view prefix;
+        const node* infix;
+        string_view postfix;
+    public:
+        enclosing_expr(string_view prefix, const node* infix, string_view postfix)
+            : prefix(prefix), infix(infix), postfix(postfix) {}
+        void print_left(printer& p) const override {
+            p += prefix;
+            p.print(infix);
+            p += postfix;
+        }
+    };
+
+    class sizeof_param_pack_expr : public node {
+        const node* pack;
+    public:
+        explicit sizeof_param_pack_expr(const node* pack) : pack(pack) {}
+        void print_left(printer& p) const override {
+            p += "sizeof...(";
+            parameter_pack_expansion expansion(pack);
+            expansion.print_left(p);
+            p += ')';
+        }
+    };
+
+    class throw_expr : public node {
+        const node* operand;
+    public:
+        explicit throw_expr(const node* operand) : operand(operand) {}
+        void print_left(printer& p) const override {
+            p += "throw ";
+            p.print(operand);
+        }
+    };
+
+    class init_list_expr : public node {
+        const node* type;
+        node_array inits;
+    public:
+        init_list_expr(const node* type, node_array inits) : type(type), inits(inits) {}
+        void print_left(printer& p) const override {
+            if(type) {
+                p.print(type);
+            }
+            p += '{';
+            inits.print_with_comma(p);
+            p += '}';
+        }
+    };
+
+    class node_array_node : public node {
+        node_array array;
+    public:
+        explicit node_array_node(node_array array) : array(array) {}
+        void print_left(printer& p) const override {
+            array.print_with_comma(p);
+        }
+    };
+
+    class function_param : public node {
+        string_view number;
+    public:
+        explicit function_param(string_view number) : number(number) {}
+        void print_left(printer& p) const override {
+            p += "fp";
+            p += number;
+        }
+    };
+
+    class integer_literal : public node {
+        string_view type;
+        string_view value;
+    public:
+        integer_literal(string_view type, string_view value) : type(type), value(value) {}
+        void print_left(printer& p) const override {
+            // short suffixes like u or ll are appended, anything longer is printed as a cast
+            if(type.size() > 3) {
+                p += '(';
+                p += type;
+                p += ')';
+            }
+            if(*value.begin() == 'n') {
+                p += '-';
+                p += value.substr(1);
+            } else {
+                p += value;
+            }
+            if(type.size() <= 3) {
+                p += type;
+            }
+        }
+    };
+
+    class bool_expr : public node {
+        bool value;
+    public:
+        explicit bool_expr(bool value) : value(value) {}
+        void print_left(printer& p) const override {
+            p += value ? "true" : "false";
+        }
+    };
+
+    class enum_literal : public node {
+        const node* type;
+        string_view value;
+    public:
+        enum_literal(const node* type, string_view value) : type(type), value(value) {}
+        void print_left(printer& p) const override {
+            p += '(';
+            p.print(type);
+            p += ')';
+            if(*value.begin() == 'n') {
+                p += '-';
+                p += value.substr(1);
+            } else {
+                p += value;
+            }
+        }
+    };
+
+    class string_literal : public node {
+        const node* type;
+    public:
+        explicit string_literal(const node* type) : type(type) {}
+        void print_left(printer& p) const override {
+            p += "\"<";
+            p.print(type);
+            p += ">\"";
+        }
+    };
+
+    class lambda_expr : public node {
+        const node* type;
+    public:
+        explicit lambda_expr(const node* type) : type(type) {}
+        void print_left(printer& p) const override {
+            p += "[]";
+            if(type->kind == node_kind::closure_type_name) {
+                static_cast<const closure_type_name*>(type)->print_declarator(p);
+            }
+            p += "{...}";
+        }
+    };
+
+    //
+    // Parsing
+    //
+
+    // Bump allocator over the caller's scratch space
+    class arena {
+        char* cursor;
+        char* end;
+    public:
+        arena(void* scratch, std::size_t size)
+            : cursor(static_cast<char*>(scratch)), end(static_cast<char*>(scratch) + size) {}
+
+        void* allocate(std::size_t size, std::size_t alignment) {
+            auto address = reinterpret_cast<std::uintptr_t>(cursor);
+            auto padding = (alignment - address % alignment) % alignment;
+            if(padding > static_cast<std::size_t>(end - cursor) || size > static_cast<std::size_t>(end - cursor) - padding) {
+                return nullptr;
+            }
+            char* result = cursor + padding;
+            cursor = result + size;
+            return result;
+        }
+    };
+
+    template<typename T>
+    class bounded_stack {
+        T* data = nullptr;
+        std::size_t count = 0;
+        std::size_t capacity = 0;
+    public:
+        bool init(arena& memory, std::size_t max_size) {
+            data = static_cast<T*>(memory.allocate(sizeof(T) * max_size, alignof(T)));
+            capacity = data ? max_size : 0;
+            return data != nullptr;
+        }
+        bool push_back(T value) {
+            if(count == capacity) {
+                return false;
+            }
+            data[count++] = value;
+            return true;
+        }
+        std::size_t size() const {
+            return count;
+        }
+        bool empty() const {
+            return count == 0;
+        }
+        T& operator[](std::size_t i) {
+            return data[i];
+        }
+        void shrink(std::size_t new_size) {
+            count = new_size;
+        }
+        const T* begin() const {
+            return data;
+        }
+    };
+
+    // Template parameters visible to <template-param>s. Level 0 is the innermost template argument list of the name
+    // being parsed, generic lambdas introduce further levels. All levels are stored back to back in one table.
+    struct template_param_levels {
+        std::size_t count = 0;
+        std::size_t begin[max_template_levels] = {};
+        bool null_level[max_template_levels] = {};
+        // end of the last level
+        std::size_t top = 0;
+        // start of the current encoding's parameters, everything before belongs to enclosing encodings
+        std::size_t base = 0;
+    };
+
+    struct name_state {
+        unsigned cv = qual_none;
+        ref_qualifier ref = ref_qualifier::none;
+        bool ctor_dtor_conversion = false;
+        bool ends_with_template_args = false;
+        std::size_t forward_refs_begin;
+
+        explicit name_state(std::size_t forward_refs_begin) : forward_refs_begin(forward_refs_begin) {}
+    };
+
+    struct operator_info {
+        char code[2];
+        const char* name;
+    };
+
+    const operator_info operators[] = {
+        {{'a', 'a'}, "operator&&"},
+        {{'a', 'd'}, "operator&"},
+        {{'a', 'n'}, "operator&"},
+        {{'a', 'N'}, "operator&="},
+        {{'a', 'S'}, "operator="},
+        {{'a', 'w'}, "operator co_await"},
+        {{'c', 'l'}, "operator()"},
+        {{'c', 'm'}, "operator,"},
+        {{'c', 'o'}, "operator~"},
+        {{'d', 'a'}, "operator delete[]"},
+        {{'d', 'e'}, "operator*"},
+        {{'d', 'l'}, "operator delete"},
+        {{'d', 'v'}, "operator/"},
+        {{'d', 'V'}, "operator/="},
+        {{'e', 'o'}, "operator^"},
+        {{'e', 'O'}, "operator^="},
+        {{'e', 'q'}, "operator=="},
+        {{'g', 'e'}, "operator>="},
+        {{'g', 't'}, "operator>"},
+        {{'i', 'x'}, "operator[]"},
+        {{'l', 'e'}, "operator<="},
+        {{'l', 's'}, "operator<<"},
+        {{'l', 'S'}, "operator<<="},
+        {{'l', 't'}, "operator<"},
+        {{'m', 'i'}, "operator-"},
+        {{'m', 'I'}, "operator-="},
+        {{'m', 'l'}, "operator*"},
+        {{'m', 'L'}, "operator*="},
+        {{'m', 'm'}, "operator--"},
+        {{'n', 'a'}, "operator new[]"},
+        {{'n', 'e'}, "operator!="},
+        {{'n', 'g'}, "operator-"},
+        {{'n', 't'}, "operator!"},
+        {{'n', 'w'}, "operator new"},
+        {{'o', 'o'}, "operator||"},
+        {{'o', 'r'}, "operator|"},
+        {{'o', 'R'}, "operator|="},
+        {{'p', 'm'}, "operator->*"},
+        {{'p', 'l'}, "operator+"},
+        {{'p', 'L'}, "operator+="},
+        {{'p', 'p'}, "operator++"},
+        {{'p', 's'}, "operator+"},
+        {{'p', 't'}, "operator->"},
+        {{'q', 'u'}, "operator?"},
+        {{'r', 'm'}, "operator%"},
+        {{'r', 'M'}, "operator%="},
+        {{'r', 's'}, "operator>>"},
+        {{'r', 'S'}, "operator>>="},
+        {{'s', 's'}, "operator<=>"},
+    };
+
+    // Binary operators in expressions
+    const operator_info binary_operators[] = {
+        {{'a', 'a'}, "&&"},
+        {{'a', 'n'}, "&"},
+        {{'a', 'N'}, "&="},
+        {{'a', 'S'}, "="},
+        {{'c', 'm'}, ","},
+        {{'d', 'v'}, "/"},
+        {{'d', 'V'}, "/="},
+        {{'e', 'o'}, "^"},
+        {{'e', 'O'}, "^="},
+        {{'e', 'q'}, "=="},
+        {{'g', 'e'}, ">="},
+        {{'g', 't'}, ">"},
+        {{'l', 'e'}, "<="},
+        {{'l', 's'}, "<<"},
+        {{'l', 'S'}, "<<="},
+        {{'l', 't'}, "<"},
+        {{'m', 'i'}, "-"},
+        {{'m', 'I'}, "-="},
+        {{'m', 'l'}, "*"},
+        {{'m', 'L'}, "*="},
+        {{'n', 'e'}, "!="},
+        {{'o', 'o'}, "||"},
+        {{'o', 'r'}, "|"},
+        {{'o', 'R'}, "|="},
+        {{'p', 'm'}, "->*"},
+        {{'p', 'l'}, "+"},
+        {{'p', 'L'}, "+="},
+        {{'r', 'm'}, "%"},
+        {{'r', 'M'}, "%="},
+        {{'r', 's'}, ">>"},
+        {{'r', 'S'}, ">>="},
+        {{'s', 's'}, "<=>"},
+    };
+
+    // Unary prefix operators in expressions
+    const operator_info prefix_operators[] = {
+        {{'a', 'd'}, "&"},
+        {{'c', 'o'}, "~"},
+        {{'d', 'e'}, "*"},
+        {{'n', 'g'}, "-"},
+        {{'n', 't'}, "!"},
+        {{'p', 's'}, "+"},
+    };
+
+    struct builtin_type {
+        char code;
+        const char* name;
+    };
+
+    const builtin_type builtin_types[] = {
+        {'v', "void"},
+        {'w', "wchar_t"},
+        {'b', "bool"},
+        {'c', "char"},
+        {'a', "signed char"},
+        {'h', "unsigned char"},
+        {'s', "short"},
+        {'t', "unsigned short"},
+        {'i', "int"},
+        {'j', "unsigned int"},
+        {'l', "long"},
+        {'m', "unsigned long"},
+        {'x', "long long"},
+        {'y', "unsigned long long"},
+        {'n', "__int128"},
+        {'o', "unsigned __int128"},
+        {'f', "float"},
+        {'d', "double"},
+        {'e', "long double"},
+        {'g', "__float128"},
+        {'z', "..."},
+    };
+
+    const builtin_type d_builtin_types[] = {
+        {'d', "decimal64"},
+        {'e', "decimal128"},
+        {'f', "decimal32"},
+        {'h', "half"},
+        {'i', "char32_t"},
+        {'s', "char16_t"},
+        {'u', "char8_t"},
+        {'a', "auto"},
+        {'c', "decltype(auto)"},
+        {'n', "std::nullptr_t"},
+    };
+
+    class parser {
+        const char* first;
+        const char* last;
+        arena& memory;
+        bool out_of_memory = false;
+        std::size_t depth = 0;
+
+        // substitution candidates, referenced with S_, S0_, ...
+        bounded_stack<node*> subs;
+        // scratch stack for building node arrays
+        bounded_stack<node*> names;
+        bounded_stack<node*> template_params;
+        template_param_levels levels;
+        bounded_stack<forward_template_reference*> forward_refs;
+
+        bool try_to_parse_template_args = true;
+        bool permit_forward_template_references = false;
+        std::size_t parsing_lambda_params_at_level = static_cast<std::size_t>(-1);
+        unsigned synthetic_template_params[3] = {0, 0, 0};
+
+        class recursion_guard {
+            parser& p;
+        public:
+            explicit recursion_guard(parser& p) : p(p) {
+                p.depth++;
+            }
+            ~recursion_guard() {
+                p.depth--;
+            }
+            recursion_guard(const recursion_guard&) = delete;
+            recursion_guard& operator=(const recursion_guard&) = delete;
+            bool ok() const {
+                return p.depth <= max_parse_depth;
+            }
+        };
+
+        template<typename T, typename... Args>
+        T* make(Args&&... args) {
+            void* storage = memory.allocate(sizeof(T), alignof(T));
+            if(!storage) {
+                out_of_memory = true;
+                return nullptr;
+            }
+            return new (storage) T(std::forward<Args>(args)...);
+        }
+
+        bool push(bounded_stack<node*>& stack, node* value) {
+            if(!stack.push_back(value)) {
+                out_of_memory = true;
+                return false;
+            }
+            return true;
+        }
+
+        // Moves names[begin, end) into the arena
+        bool pop_trailing(std::size_t begin, node_array& array) {
+            array.count = names.size() - begin;
+            array.elements = nullptr;
+            if(array.count != 0) {
+                array.elements = static_cast<node**>(memory.allocate(sizeof(node*) * array.count, alignof(node*)));
+                if(!array.elements) {
+                    out_of_memory = true;
+                    return false;
+                }
+                for(std::size_t i = 0; i < array.count; i++) {
+                    array.elements[i] = names[begin + i];
+                }
+            }
+            names.shrink(begin);
+            return true;
+        }
+
+        //
+        // Template parameter levels
+        //
+
+        void clear_levels() {
+            levels.count = 0;
+            levels.top = levels.base;
+        }
+
+        bool push_level(bool null_level = false) {
+            if(levels.count == max_template_levels) {
+                return false;
+            }
+            levels.begin[levels.count] = levels.top;
+            levels.null_level[levels.count] = null_level;
+            levels.count++;
+            return true;
+        }
+
+        void pop_levels(std::size_t count) {
+            if(count < levels.count) {
+                levels.top = levels.begin[count];
+                levels.count = count;
+            }
+        }
+
+        bool append_to_last_level(node* param) {
+            if(levels.count == 0 || levels.null_level[levels.count - 1]) {
+                return false;
+            }
+            template_params.shrink(levels.top);
+            if(!push(template_params, param)) {
+                return false;
+            }
+            levels.top++;
+            return true;
+        }
+
+        node* lookup_template_param(std::size_t level, std::size_t index) {
+            if(level >= levels.count || levels.null_level[level]) {
+                return nullptr;
+            }
+            auto begin = levels.begin[level];
+            auto end = level + 1 < levels.count ? levels.begin[level + 1] : levels.top;
+            if(index >= end - begin) {
+                return nullptr;
+            }
+            return template_params[begin + index];
+        }
+
+        //
+        // Lexing
+        //
+
+        std::size_t num_left() const {
+            return static_cast<std::size_t>(last - first);
+        }
+
+        char look(std::size_t offset = 0) const {
+            return offset < num_left() ? first[offset] : '\0';
+        }
+
+        bool consume(char c) {
+            if(look() == c) {
+                first++;
+                return true;
+            }
+            return false;
+        }
+
+        bool consume(const char* str) {
+            std::size_t length = 0;
+            while(str[length] != 0) {
+                if(look(length) != str[length]) {
+                    return false;
+                }
+                length++;
+            }
+            first += length;
+            return true;
+        }
+
+        string_view parse_number(bool allow_negative = false) {
+            const char* start = first;
+            if(allow_negative) {
+                consume('n');
+            }
+            if(num_left() == 0 || !is_digit(look())) {
+                first = start;
+                return {};
+            }
+            while(num_left() != 0 && is_digit(look())) {
+                first++;
+            }
+            return string_view(start, first);
+        }
+
+        bool parse_positive_integer(std::size_t& value) {
+            value = 0;
+            if(!is_digit(look())) {
+                return false;
+            }
+            while(is_digit(look())) {
+                if(value > (std::size_t(1) << 30)) {
+                    return false;
+                }
+                value = value * 10 + static_cast<std::size_t>(*first - '0');
+                first++;
+            }
+            return true;
+        }
+
+        bool parse_seq_id(std::size_t& value) {
+            if(!(is_digit(look()) || (look() >= 'A' && look() <= 'Z'))) {
+                return false;
+            }
+            value = 0;
+            while(true) {
+                char c = look();
+                std::size_t digit;
+                if(is_digit(c)) {
+                    digit = static_cast<std::size_t>(c - '0');
+                } else if(c >= 'A' && c <= 'Z') {
+                    digit = static_cast<std::size_t>(c - 'A') + 10;
+                } else {
+                    return true;
+                }
+                if(value > (std::size_t(1) << 30)) {
+                    return false;
+                }
+                value = value * 36 + digit;
+                first++;
+            }
+        }
+
+        string_view parse_bare_source_name() {
+            std::size_t length;
+            if(!parse_positive_integer(length) || length == 0 || num_left() < length) {
+                return {};
+            }
+            string_view name(first, length);
+            first += length;
+            return name;
+        }
+
+        // <discriminator> := _ <digit> | __ <number> _, ignored
+        void parse_discriminator() {
+            if(look() == '_') {
+                if(is_digit(look(1))) {
+                    first += 2;
+                } else if(look(1) == '_') {
+                    std::size_t i = 2;
+                    while(is_digit(look(i))) {
+                        i++;
+                    }
+                    if(look(i) == '_') {
+                        first += i + 1;
+                    }
+                }
+            } else if(is_digit(look())) {
+                // extension: trailing digits at the end of the name
+                std::size_t i = 1;
+                while(is_digit(look(i))) {
+                    i++;
+                }
+                if(i == num_left()) {
+                    first = last;
+                }
+            }
+        }
+
+        // <call-offset> ::= h <nv-offset> _ | v <v-offset> _
+        bool parse_call_offset() {
+            if(consume('h')) {
+                return !parse_number(true).empty() && consume('_');
+            }
+            if(consume('v')) {
+                return !parse_number(true).empty() && consume('_') && !parse_number(true).empty() && consume('_');
+            }
+            return false;
+        }
+
+        bool is_end_of_encoding() const {
+            // none of these can start a <type>
+            return num_left() == 0 || look() == 'E' || look() == '.' || look() == '_';
+        }
+
+        //
+        // Encodings and names
+        //
+
+        node* parse_encoding() {
+            recursion_guard guard(*this);
+            if(!guard.ok()) {
+                return nullptr;
+            }
+            // the template parameters of an encoding are unrelated to those of the enclosing context
+            auto saved_levels = levels;
+            levels.count = 0;
+            levels.base = levels.top;
+            node* result = parse_encoding_inner();
+            levels = saved_levels;
+            return result;
+        }
+
+        node* parse_encoding_inner() {
+            if(look() == 'G' || look() == 'T') {
+                return parse_special_name();
+            }
+            name_state state(forward_refs.size());
+            node* name = parse_name(&state);
+            if(!name || !resolve_forward_template_refs(state)) {
+                return nullptr;
+            }
+            if(is_end_of_encoding()) {
+                return name;
+            }
+            node* attrs = nullptr;
+            if(consume("Ua9enable_ifI")) {
+                auto begin = names.size();
+                while(!consume('E')) {
+                    node* arg = parse_template_arg();
+                    if(!arg || !push(names, arg)) {
+                        return nullptr;
+                    }
+                }
+                node_array conditions;
+                if(!pop_trailing(begin, conditions) || !(attrs = make<enable_if_attr>(conditions))) {
+                    return nullptr;
+                }
+            }
+            node* ret = nullptr;
+            if(!state.ctor_dtor_conversion && state.ends_with_template_args) {
+                ret = parse_type();
+                if(!ret) {
+                    return nullptr;
+                }
+            }
+            if(consume('v')) {
+                return make<function_encoding>(ret, name, node_array{}, attrs, state.cv, state.ref);
+            }
+            auto begin = names.size();
+            do {
+                node* param = parse_type();
+                if(!param || !push(names, param)) {
+                    return nullptr;
+                }
+            } while(!is_end_of_encoding());
+            node_array params;
+            if(!pop_trailing(begin, params)) {
+                return nullptr;
+            }
+            return make<function_encoding>(ret, name, params, attrs, state.cv, state.ref);
+        }
+
+        bool resolve_forward_template_refs(name_state& state) {
+            for(std::size_t i = state.forward_refs_begin; i < forward_refs.size(); i++) {
+                node* param = lookup_template_param(0, forward_refs[i]->index);
+                if(!param) {
+                    return false;
+                }
+                forward_refs[i]->ref = param;
+            }
+            forward_refs.shrink(state.forward_refs_begin);
+            return true;
+        }
+
+        node* parse_special_name() {
+            if(consume('T')) {
+                const char* special = nullptr;
+                switch(look()) {
+                    case 'A': {
+                        first++;
+                        node* arg = parse_template_arg();
+                        return arg ? make<special_name>("template parameter object for ", arg) : nullptr;
+                    }
+                    case 'V':
+                        special = "vtable for ";
+                        break;
+                    case 'T':
+                        special = "VTT for ";
+                        break;
+                    case 'I':
+                        special = "typeinfo for ";
+                        break;
+                    case 'S':
+                        special = "typeinfo name for ";
+                        break;
+                    case 'c': {
+                        first++;
+                        if(!parse_call_offset() || !parse_call_offset()) {
+                            return nullptr;
+                        }
+                        node* encoding = parse_encoding();
+                        return encoding ? make<special_name>("covariant return thunk to ", encoding) : nullptr;
+                    }
+                    case 'C': {
+                        first++;
+                        node* first_type = parse_type();
+                        if(!first_type || parse_number(true).empty() || !consume('_')) {
+                            return nullptr;
+                        }
+                        node* second_type = parse_type();
+                        return second_type ? make<ctor_vtable_special_name>(second_type, first_type) : nullptr;
+                    }
+                    case 'W': {
+                        first++;
+                        node* name = parse_name();
+                        return name ? make<special_name>("thread-local wrapper routine for ", name) : nullptr;
+                    }
+                    case 'H': {
+                        first++;
+                        node* name = parse_name();
+                        return name ? make<special_name>("thread-local initialization routine for ", name) : nullptr;
+                    }
+                    default: {
+                        bool is_virtual = look() == 'v';
+                        if(!parse_call_offset()) {
+                            return nullptr;
+                        }
+                        node* encoding = parse_encoding();
+                        if(!encoding) {
+                            return nullptr;
+                        }
+                        return make<special_name>(is_virtual ? "virtual thunk to " : "non-virtual thunk to ", encoding);
+                    }
+                }
+                first++;
+                node* type = parse_type();
+                return type ? make<special_name>(special, type) : nullptr;
+            }
+            if(consume("GV")) {
+                node* name = parse_name();
+                return name ? make<special_name>("guard variable for ", name) : nullptr;
+            }
+            if(consume("GR")) {
+                node* name = parse_name();
+                if(!name) {
+                    return nullptr;
+                }
+                std::size_t seq_id;
+                bool parsed_seq_id = parse_seq_id(seq_id);
+                if(!consume('_') && parsed_seq_id) {
+                    return nullptr;
+                }
+                return make<special_name>("reference temporary for ", name);
+            }
+            return nullptr;
+        }
+
+        node* parse_name(name_state* state = nullptr) {
+            recursion_guard guard(*this);
+            if(!guard.ok()) {
+                return nullptr;
+            }
+            consume('L');
+            if(look() == 'N') {
+                return parse_nested_name(state);
+            }
+            if(look() == 'Z') {
+                return parse_local_name(state);
+            }
+            bool is_substitution = look() == 'S' && look(1) != 't';
+            node* result = is_substitution ? parse_substitution() : parse_unscoped_name(state);
+            if(!result) {
+                return nullptr;
+            }
+            if(look() == 'I') {
+                // an unscoped template name is substitutable
+                if(!is_substitution && !push(subs, result)) {
+                    return nullptr;
+                }
+                node* args = parse_template_args(state != nullptr);
+                if(!args) {
+                    return nullptr;
+                }
+                if(state) {
+                    state->ends_with_template_args = true;
+                }
+                return make<name_with_template_args>(result, args);
+            }
+            // a substitution here must be a template name followed by arguments
+            return is_substitution ? nullptr : result;
+        }
+
+        // <local-name> := Z <function encoding> E <entity name> [<discriminator>]
+        //              := Z <function encoding> E s [<discriminator>]
+        //              := Z <function encoding> Ed [ <parameter number> ] _ <entity name>
+        node* parse_local_name(name_state* state) {
+            if(!consume('Z')) {
+                return nullptr;
+            }
+            node* encoding = parse_encoding();
+            if(!encoding || !consume('E')) {
+                return nullptr;
+            }
+            if(consume('s')) {
+                parse_discriminator();
+                node* literal = make<name_type>("string literal");
+                return literal ? make<local_name>(encoding, literal) : nullptr;
+            }
+            if(consume('d')) {
+                parse_number(true);
+                if(!consume('_')) {
+                    return nullptr;
+                }
+                node* entity = parse_name(state);
+                return entity ? make<local_name>(encoding, entity) : nullptr;
+            }
+            node* entity = parse_name(state);
+            if(!entity) {
+                return nullptr;
+            }
+            parse_discriminator();
+            return make<local_name>(encoding, entity);
+        }
+
+        node* parse_unscoped_name(name_state* state) {
+            if(consume("StL") || consume("St")) {
+                node* name = parse_unqualified_name(state);
+                return name ? make<std_qualified_name>(name) : nullptr;
+            }
+            return parse_unqualified_name(state);
+        }
+
+        node* parse_unqualified_name(name_state* state) {
+            node* result;
+            if(look() == 'U') {
+                result = parse_unnamed_type_name(state);
+            } else if(look() >= '1' && look() <= '9') {
+                result = parse_source_name();
+            } else if(consume("DC")) {
+                // structured binding declaration
+                auto begin = names.size();
+                do {
+                    node* binding = parse_source_name();
+                    if(!binding || !push(names, binding)) {
+                        return nullptr;
+                    }
+                } while(!consume('E'));
+                node_array bindings;
+                if(!pop_trailing(begin, bindings)) {
+                    return nullptr;
+                }
+                result = make<structured_binding_name>(bindings);
+            } else {
+                result = parse_operator_name(state);
+            }
+            return result ? parse_abi_tags(result) : nullptr;
+        }
+
+        node* parse_source_name() {
+            string_view name = parse_bare_source_name();
+            if(name.empty()) {
+                return nullptr;
+            }
+            if(name.starts_with("_GLOBAL__N")) {
+                return make<name_type>("(anonymous namespace)");
+            }
+            return make<name_type>(name);
+        }
+
+        node* parse_abi_tags(node* result) {
+            while(consume('B')) {
+                string_view tag = parse_bare_source_name();
+                if(tag.empty()) {
+                    return nullptr;
+                }
+                result = make<abi_tag_attr>(result, tag);
+                if(!result) {
+                    return nullptr;
+                }
+            }
+            return result;
+        }
+
+        // <unnamed-type-name> ::= Ut [<nonnegative number>] _
+        //                     ::= Ul <lambda-sig> E [<nonnegative number>] _
+        node* parse_unnamed_type_name(name_state* state) {
+            // template parameters refer to the innermost template arguments, clear out any outer ones
+            if(state) {
+                clear_levels();
+            }
+            if(consume("Ut")) {
+                string_view count = parse_number();
+                return consume('_') ? make<unnamed_type_name>(count) : nullptr;
+            }
+            if(consume("Ul")) {
+                auto saved_lambda_level = parsing_lambda_params_at_level;
+                auto saved_level_count = levels.count;
+                parsing_lambda_params_at_level = levels.count;
+                if(!push_level()) {
+                    return nullptr;
+                }
+                node* result = parse_closure_type_name();
+                pop_levels(saved_level_count);
+                parsing_lambda_params_at_level = saved_lambda_level;
+                return result;
+            }
+            if(consume("Ub")) {
+                parse_number();
+                return consume('_') ? make<name_type>("'block-literal'") : nullptr;
+            }
+            return nullptr;
+        }
+
+        node* parse_closure_type_name() {
+            auto begin = names.size();
+            while(
+                look() == 'T' && (look(1) == 'y' || look(1) == 'p' || look(1) == 't' || look(1) == 'n')
+            ) {
+                node* param = parse_template_param_decl();
+                if(!param || !push(names, param)) {
+                    return nullptr;
+                }
+            }
+            node_array template_params_decls;
+            if(!pop_trailing(begin, template_params_decls)) {
+                return nullptr;
+            }
+            // Without explicit template parameters the lambda's level only exists once an auto parameter refers to
+            // it
+            if(template_params_decls.empty()) {
+                pop_levels(levels.count - 1);
+            }
+            if(!consume("vE")) {
+                do {
+                    node* param = parse_type();
+                    if(!param || !push(names, param)) {
+                        return nullptr;
+                    }
+                } while(!consume('E'));
+            }
+            node_array params;
+            if(!pop_trailing(begin, params)) {
+                return nullptr;
+            }
+            string_view count = parse_number();
+            if(!consume('_')) {
+                return nullptr;
+            }
+            return make<closure_type_name>(template_params_decls, params, count);
+        }
+
+        node* invent_template_param_name(template_param_kind param_kind) {
+            unsigned index = synthetic_template_params[static_cast<int>(param_kind)]++;
+            node* name = make<synthetic_template_param_name>(param_kind, index);
+            if(!name || !append_to_last_level(name)) {
+                return nullptr;
+            }
+            return name;
+        }
+
+        node* parse_template_param_decl() {
+            if(consume("Ty")) {
+                node* name = invent_template_param_name(template_param_kind::type);
+                return name ? make<type_template_param_decl>(name) : nullptr;
+            }
+            if(consume("Tn")) {
+                node* name = invent_template_param_name(template_param_kind::non_type);
+                if(!name) {
+                    return nullptr;
+                }
+                node* type = parse_type();
+                return type ? make<non_type_template_param_decl>(name, type) : nullptr;
+            }
+            if(consume("Tt")) {
+                node* name = invent_template_param_name(template_param_kind::template_template);
+                if(!name) {
+                    return nullptr;
+                }
+                auto begin = names.size();
+                auto saved_level_count = levels.count;
+                if(!push_level()) {
+                    return nullptr;
+                }
+                while(!consume('E')) {
+                    node* param = parse_template_param_decl();
+                    if(!param || !push(names, param)) {
+                        return nullptr;
+                    }
+                }
+                pop_levels(saved_level_count);
+                node_array params;
+                if(!pop_trailing(begin, params)) {
+                    return nullptr;
+                }
+                return make<template_template_param_decl>(name, params);
+            }
+            if(consume("Tp")) {
+                node* param = parse_template_param_decl();
+                return param ? make<template_param_pack_decl>(param) : nullptr;
+            }
+            return nullptr;
+        }
+
+        node* parse_operator_name(name_state* state) {
+            if(consume("cv")) {
+                // The conversion type can refer to template arguments that haven't been parsed yet, and can't itself
+                // take template arguments since those belong to the operator
+                auto saved_try_to_parse_template_args = try_to_parse_template_args;
+                auto saved_permit_forward_references = permit_forward_template_references;
+                try_to_parse_template_args = false;
+                permit_forward_template_references = permit_forward_template_references || state != nullptr;
+                node* type = parse_type();
+                try_to_parse_template_args = saved_try_to_parse_template_args;
+                permit_forward_template_references = saved_permit_forward_references;
+                if(!type) {
+                    return nullptr;
+                }
+                if(state) {
+                    state->ctor_dtor_conversion = true;
+                }
+                return make<conversion_operator_type>(type);
+            }
+            if(consume("li")) {
+                node* name = parse_source_name();
+                return name ? make<literal_operator>(name) : nullptr;
+            }
+            if(look() == 'v' && is_digit(look(1))) {
+                // vendor extended operator
+                first += 2;
+                node* name = parse_source_name();
+                return name ? make<conversion_operator_type>(name) : nullptr;
+            }
+            for(const auto& op : operators) {
+                if(look() == op.code[0] && look(1) == op.code[1]) {
+                    first += 2;
+                    return make<name_type>(op.name);
+                }
+            }
+            return nullptr;
+        }
+
+        // <nested-name> ::= N [<CV-qualifiers>] [<ref-qualifier>] <prefix> <unqualified-name> E
+        //               ::= N [<CV-qualifiers>] [<ref-qualifier>] <template-prefix> <template-args> E
+        node* parse_nested_name(name_state* state) {
+            if(!consume('N')) {
+                return nullptr;
+            }
+            unsigned cv = parse_cv_qualifiers();
+            ref_qualifier ref = ref_qualifier::none;
+            if(consume('O')) {
+                ref = ref_qualifier::rvalue;
+            } else if(consume('R')) {
+                ref = ref_qualifier::lvalue;
+            }
+            if(state) {
+                state->cv = cv;
+                state->ref = ref;
+            }
+
+            node* so_far = nullptr;
+            auto push_component = [&](node* component) {
+                if(!component) {
+                    return false;
+                }
+                so_far = so_far ? make<nested_name>(so_far, component) : component;
+                if(state) {
+                    state->ends_with_template_args = false;
+                }
+                return so_far != nullptr;
+            };
+
+            if(consume("St")) {
+                so_far = make<name_type>("std");
+                if(!so_far) {
+                    return nullptr;
+                }
+            }
+
+            while(!consume('E')) {
+                consume('L');
+                if(consume('M')) {
+                    // <data-member-prefix> := <member source-name> [<template-args>] M
+                    if(!so_far) {
+                        return nullptr;
+                    }
+                    continue;
+                }
+                if(look() == 'T') {
+                    if(!push_component(parse_template_param()) || !push(subs, so_far)) {
+                        return nullptr;
+                    }
+                    continue;
+                }
+                if(look() == 'I') {
+                    node* args = parse_template_args(state != nullptr);
+                    if(!args || !so_far) {
+                        return nullptr;
+                    }
+                    so_far = make<name_with_template_args>(so_far, args);
+                    if(!so_far) {
+                        return nullptr;
+                    }
+                    if(state) {
+                        state->ends_with_template_args = true;
+                    }
+                    if(!push(subs, so_far)) {
+                        return nullptr;
+                    }
+                    continue;
+                }
+                if(look() == 'D' && (look(1) == 't' || look(1) == 'T')) {
+                    if(!push_component(parse_decltype()) || !push(subs, so_far)) {
+                        return nullptr;
+                    }
+                    continue;
+                }
+                if(look() == 'S' && look(1) != 't') {
+                    node* substitution = parse_substitution();
+                    if(!push_component(substitution)) {
+                        return nullptr;
+                    }
+                    if(so_far != substitution && !push(subs, so_far)) {
+                        return nullptr;
+                    }
+                    continue;
+                }
+                if(look() == 'C' || (look() == 'D' && look(1) != 'C')) {
+                    if(!so_far) {
+                        return nullptr;
+                    }
+                    node* name = parse_ctor_dtor_name(so_far, state);
+                    if(!push_component(name)) {
+                        return nullptr;
+                    }
+                    so_far = parse_abi_tags(so_far);
+                    if(!so_far || !push(subs, so_far)) {
+                        return nullptr;
+                    }
+                    continue;
+                }
+                if(!push_component(parse_unqualified_name(state)) || !push(subs, so_far)) {
+                    return nullptr;
+                }
+            }
+
+            if(!so_far || subs.empty()) {
+                return nullptr;
+            }
+            // the full name isn't a substitution candidate
+            subs.shrink(subs.size() - 1);
+            return so_far;
+        }
+
+        node* parse_ctor_dtor_name(node*& so_far, name_state* state) {
+            if(so_far->kind == node_kind::special_substitution) {
+                auto sub = static_cast<special_substitution*>(so_far)->sub;
+                if(sub != special_sub_kind::allocator && sub != special_sub_kind::basic_string) {
+                    so_far = make<special_substitution>(sub, true);
+                    if(!so_far) {
+                        return nullptr;
+                    }
+                }
+            }
+            if(consume('C')) {
+                bool inheriting = consume('I');
+                if(look() < '1' || look() > '5') {
+                    return nullptr;
+                }
+                first++;
+                if(state) {
+                    state->ctor_dtor_conversion = true;
+                }
+                if(inheriting && !parse_name(state)) {
+                    return nullptr;
+                }
+                return make<ctor_dtor_name>(so_far, false);
+            }
+            if(look() == 'D' && (look(1) == '0' || look(1) == '1' || look(1) == '2' || look(1) == '4' || look(1) == '5')) {
+                first += 2;
+                if(state) {
+                    state->ctor_dtor_conversion = true;
+                }
+                return make<ctor_dtor_name>(so_far, true);
+            }
+            return nullptr;
+        }
+
+        // <substitution> ::= S <seq-id> _ | S_ | Sa | Sb | Ss | Si | So | Sd
+        node* parse_substitution() {
+            if(!consume('S')) {
+                return nullptr;
+            }
+            if(look() >= 'a' && look() <= 'z') {
+                special_sub_kind sub;
+                switch(look()) {
+                    case 'a':
+                        sub = special_sub_kind::allocator;
+                        break;
+                    case 'b':
+                        sub = special_sub_kind::basic_string;
+                        break;
+                    case 'd':
+                        sub = special_sub_kind::iostream;
+                        break;
+                    case 'i':
+                        sub = special_sub_kind::istream;
+                        break;
+                    case 'o':
+                        sub = special_sub_kind::ostream;
+                        break;
+                    case 's':
+                        sub = special_sub_kind::string;
+                        break;
+                    default:
+                        return nullptr;
+                }
+                first++;
+                node* result = make<special_substitution>(sub);
+                if(!result) {
+                    return nullptr;
+                }
+                // abi tags on a built-in substitution make a new substitution candidate
+                node* with_tags = parse_abi_tags(result);
+                if(with_tags != result) {
+                    if(!with_tags || !push(subs, with_tags)) {
+                        return nullptr;
+                    }
+                    result = with_tags;
+                }
+                return result;
+            }
+            if(consume('_')) {
+                return subs.empty() ? nullptr : subs[0];
+            }
+            std::size_t index;
+            if(!parse_seq_id(index) || !consume('_') || index + 1 >= subs.size()) {
+                return nullptr;
+            }
+            return subs[index + 1];
+        }
+
+        // <template-param> ::= T_ | T <number> _ | TL <level> __ | TL <level> _ <number> _
+        node* parse_template_param() {
+            if(!consume('T')) {
+                return nullptr;
+            }
+            std::size_t level = 0;
+            if(consume('L')) {
+                if(!parse_positive_integer(level) || !consume('_')) {
+                    return nullptr;
+                }
+                level++;
+            }
+            std::size_t index = 0;
+            if(!consume('_')) {
+                if(!parse_positive_integer(index) || !consume('_')) {
+                    return nullptr;
+                }
+                index++;
+            }
+            if(permit_forward_template_references && level == 0) {
+                auto ref = make<forward_template_reference>(index);
+                if(!ref) {
+                    return nullptr;
+                }
+                if(!forward_refs.push_back(ref)) {
+                    out_of_memory = true;
+                    return nullptr;
+                }
+                return ref;
+            }
+            node* param = lookup_template_param(level, index);
+            if(!param) {
+                // In a generic lambda's signature, auto parameters are mangled as references to the lambda's
+                // invented template parameters
+                if(parsing_lambda_params_at_level == level && level <= levels.count) {
+                    if(level == levels.count && !push_level(true)) {
+                        return nullptr;
+                    }
+                    return make<name_type>("auto");
+                }
+                return nullptr;
+            }
+            return param;
+        }
+
+        // <template-args> ::= I <template-arg>* E
+        node* parse_template_args(bool tag_templates = false) {
+            if(!consume('I')) {
+                return nullptr;
+            }
+            if(tag_templates) {
+                // these become the template parameters for the rest of the encoding
+                clear_levels();
+                if(!push_level()) {
+                    return nullptr;
+                }
+            }
+            auto begin = names.size();
+            while(!consume('E')) {
+                if(tag_templates) {
+                    auto saved_levels = levels;
+                    levels.count = 0;
+                    node* arg = parse_template_arg();
+                    levels = saved_levels;
+                    if(!arg || !push(names, arg)) {
+                        return nullptr;
+                    }
+                    node* entry = arg;
+                    if(arg->kind == node_kind::template_argument_pack) {
+                        entry = make<parameter_pack>(static_cast<template_argument_pack*>(arg)->elements);
+                        if(!entry) {
+                            return nullptr;
+                        }
+                    }
+                    if(!append_to_last_level(entry)) {
+                        return nullptr;
+                    }
+                } else {
+                    node* arg = parse_template_arg();
+                    if(!arg || !push(names, arg)) {
+                        return nullptr;
+                    }
+                }
+            }
+            node_array args;
+            if(!pop_trailing(begin, args)) {
+                return nullptr;
+            }
+            return make<template_args>(args);
+        }
+
+        // <template-arg> ::= <type> | X <expression> E | <expr-primary> | J <template-arg>* E | LZ <encoding> E
+        node* parse_template_arg() {
+            recursion_guard guard(*this);
+            if(!guard.ok()) {
+                return nullptr;
+            }
+            switch(look()) {
+                case 'X': {
+                    first++;
+                    node* expr = parse_expr();
+                    return expr && consume('E') ? expr : nullptr;
+                }
+                case 'J': {
+                    first++;
+                    auto begin = names.size();
+                    while(!consume('E')) {
+                        node* arg = parse_template_arg();
+                        if(!arg || !push(names, arg)) {
+                            return nullptr;
+                        }
+                    }
+                    node_array args;
+                    if(!pop_trailing(begin, args)) {
+                        return nullptr;
+                    }
+                    return make<template_argument_pack>(args);
+                }
+                case 'L': {
+                    if(look(1) == 'Z') {
+                        first += 2;
+                        node* encoding = parse_encoding();
+                        return encoding && consume('E') ? encoding : nullptr;
+                    }
+                    return parse_expr_primary();
+                }
+                default:
+                    return parse_type();
+            }
+        }
+
+        //
+        // Types
+        //
+
+        unsigned parse_cv_qualifiers() {
+            unsigned quals = qual_none;
+            if(consume('r')) {
+                quals |= qual_restrict;
+            }
+            if(consume('V')) {
+                quals |= qual_volatile;
+            }
+            if(consume('K')) {
+                quals |= qual_const;
+            }
+            return quals;
+        }
+
+        node* parse_type() {
+            recursion_guard guard(*this);
+            if(!guard.ok()) {
+                return nullptr;
+            }
+            node* result = nullptr;
+            switch(look()) {
+                case 'r':
+                case 'V':
+                case 'K': {
+                    std::size_t after_quals = 0;
+                    if(look(after_quals) == 'r') {
+                        after_quals++;
+                    }
+                    if(look(after_quals) == 'V') {
+                        after_quals++;
+                    }
+                    if(look(after_quals) == 'K') {
+                        after_quals++;
+                    }
+                    char next = look(after_quals + 1);
+                    if(
+                        look(after_quals) == 'F'
+                        || (
+                            look(after_quals) == 'D'
+                            && (next == 'o' || next == 'O' || next == 'w' || next == 'x')
+                        )
+                    ) {
+                        result = parse_function_type();
+                    } else {
+                        result = parse_qualified_type();
+                    }
+                    break;
+                }
+                case 'U':
+                    result = parse_qualified_type();
+                    break;
+                case 'u': {
+                    // vendor extended types are substitution candidates, unlike other builtins
+                    first++;
+                    string_view name = parse_bare_source_name();
+                    if(name.empty()) {
+                        return nullptr;
+                    }
+                    result = make<name_type>(name);
+                    break;
+                }
+                case 'D':
+                    switch(look(1)) {
+                        case 'F': {
+                            first += 2;
+                            string_view bits = parse_number();
+                            if(bits.empty() || !consume('_')) {
+                                return nullptr;
+                            }
+                            node* dimension = make<name_type>(bits);
+                            return dimension ? make<binary_fp_type>(dimension) : nullptr;
+                        }
+                        case 't':
+                        case 'T':
+                            result = parse_decltype();
+                            break;
+                        case 'v':
+                            result = parse_vector_type();
+                            break;
+                        case 'p': {
+                            first += 2;
+                            node* child = parse_type();
+                            if(!child) {
+                                return nullptr;
+                            }
+                            result = make<parameter_pack_expansion>(child);
+                            break;
+                        }
+                        case 'o':
+                        case 'O':
+                        case 'w':
+                        case 'x':
+                            result = parse_function_type();
+                            break;
+                        default:
+                            for(const auto& builtin : d_builtin_types) {
+                                if(look(1) == builtin.code) {
+                                    first += 2;
+                                    return make<name_type>(builtin.name);
+                                }
+                            }
+                            return nullptr;
+                    }
+                    break;
+                case 'F':
+                    result = parse_function_type();
+                    break;
+                case 'A':
+                    result = parse_array_type();
+                    break;
+                case 'M':
+                    result = parse_pointer_to_member_type();
+                    break;
+                case 'T': {
+                    // could be an elaborated type specifier on a <class-enum-type>
+                    if(look(1) == 's' || look(1) == 'u' || look(1) == 'e') {
+                        result = parse_class_enum_type();
+                        break;
+                    }
+                    result = parse_template_param();
+                    if(!result) {
+                        return nullptr;
+                    }
+                    // <template-template-param> <template-args>
+                    if(try_to_parse_template_args && look() == 'I') {
+                        node* args = parse_template_args();
+                        if(!args) {
+                            return nullptr;
+                        }
+                        result = make<name_with_template_args>(result, args);
+                    }
+                    break;
+                }
+                case 'P': {
+                    first++;
+                    node* pointee = parse_type();
+                    if(!pointee) {
+                        return nullptr;
+                    }
+                    result = make<pointer_type>(pointee);
+                    break;
+                }
+                case 'R':
+                case 'O': {
+                    bool rvalue = look() == 'O';
+                    first++;
+                    node* pointee = parse_type();
+                    if(!pointee) {
+                        return nullptr;
+                    }
+                    result = make<reference_type>(pointee, rvalue);
+                    break;
+                }
+                case 'C':
+                case 'G': {
+                    const char* postfix = look() == 'C' ? " complex" : " imaginary";
+                    first++;
+                    node* type = parse_type();
+                    if(!type) {
+                        return nullptr;
+                    }
+                    result = make<postfix_qualified_type>(type, postfix);
+                    break;
+                }
+                case 'S': {
+                    if(look(1) != 't') {
+                        node* substitution = parse_substitution();
+                        if(!substitution) {
+                            return nullptr;
+                        }
+                        // <template-template-param> <template-args>
+                        if(try_to_parse_template_args && look() == 'I') {
+                            node* args = parse_template_args();
+                            if(!args) {
+                                return nullptr;
+                            }
+                            result = make<name_with_template_args>(substitution, args);
+                            break;
+                        }
+                        // a plain substitution isn't re-inserted into the table
+                        return substitution;
+                    }
+                    result = parse_class_enum_type();
+                    break;
+                }
+                default:
+                    for(const auto& builtin : builtin_types) {
+                        if(look() == builtin.code) {
+                            first++;
+                            return make<name_type>(builtin.name);
+                        }
+                    }
+                    result = parse_class_enum_type();
+                    break;
+            }
+            // builtins and plain substitutions returned early, everything else is a substitution candidate
+            if(result && !push(subs, result)) {
+                return nullptr;
+            }
+            return result;
+        }
+
+        // <qualified-type> ::= <qualifiers> <type>
+        // <extended-qualifier> ::= U <source-name> [<template-args>]
+        node* parse_qualified_type() {
+            if(consume('U')) {
+                string_view qualifier = parse_bare_source_name();
+                if(qualifier.empty()) {
+                    return nullptr;
+                }
+                node* args = nullptr;
+                if(look() == 'I') {
+                    args = parse_template_args();
+                    if(!args) {
+                        return nullptr;
+                    }
+                }
+                node* child = parse_qualified_type();
+                return child ? make<vendor_ext_qual_type>(child, qualifier, args) : nullptr;
+            }
+            unsigned quals = parse_cv_qualifiers();
+            node* type = parse_type();
+            if(!type) {
+                return nullptr;
+            }
+            return quals != qual_none ? make<qual_type>(type, quals) : type;
+        }
+
+        // <function-type> ::= [<CV-qualifiers>] [<exception-spec>] [Dx] F [Y] <bare-function-type> [<ref-qualifier>] E
+        node* parse_function_type() {
+            unsigned cv = parse_cv_qualifiers();
+            node* exception_spec = nullptr;
+            if(consume("Do")) {
+                exception_spec = make<name_type>("noexcept");
+                if(!exception_spec) {
+                    return nullptr;
+                }
+            } else if(consume("DO")) {
+                node* expr = parse_expr();
+                if(!expr || !consume('E')) {
+                    return nullptr;
+                }
+                exception_spec = make<noexcept_spec>(expr);
+                if(!exception_spec) {
+                    return nullptr;
+                }
+            } else if(consume("Dw")) {
+                auto begin = names.size();
+                while(!consume('E')) {
+                    node* type = parse_type();
+                    if(!type || !push(names, type)) {
+                        return nullptr;
+                    }
+                }
+                node_array types;
+                if(!pop_trailing(begin, types) || !(exception_spec = make<dynamic_exception_spec>(types))) {
+                    return nullptr;
+                }
+            }
+            consume("Dx"); // transaction safe
+            if(!consume('F')) {
+                return nullptr;
+            }
+            consume('Y'); // extern "C"
+            node* ret = parse_type();
+            if(!ret) {
+                return nullptr;
+            }
+            ref_qualifier ref = ref_qualifier::none;
+            auto begin = names.size();
+            while(true) {
+                if(consume('E')) {
+                    break;
+                }
+                if(consume('v')) {
+                    continue;
+                }
+                if(consume("RE")) {
+                    ref = ref_qualifier::lvalue;
+                    break;
+                }
+                if(consume("OE")) {
+                    ref = ref_qualifier::rvalue;
+                    break;
+                }
+                node* param = parse_type();
+                if(!param || !push(names, param)) {
+                    return nullptr;
+                }
+            }
+            node_array params;
+            if(!pop_trailing(begin, params)) {
+                return nullptr;
+            }
+            return make<function_type>(ret, params, cv, ref, exception_spec);
+        }
+
+        // <array-type> ::= A <positive dimension number> _ <element type>
+        //              ::= A [<dimension expression>] _ <element type>
+        node* parse_array_type() {
+            if(!consume('A')) {
+                return nullptr;
+            }
+            node* dimension = nullptr;
+            if(is_digit(look())) {
+                dimension = make<name_type>(parse_number());
+                if(!dimension || !consume('_')) {
+                    return nullptr;
+                }
+            } else if(!consume('_')) {
+                dimension = parse_expr();
+                if(!dimension || !consume('_')) {
+                    return nullptr;
+                }
+            }
+            node* element = parse_type();
+            return element ? make<array_type>(element, dimension) : nullptr;
+        }
+
+        // <pointer-to-member-type> ::= M <class type> <member type>
+        node* parse_pointer_to_member_type() {
+            if(!consume('M')) {
+                return nullptr;
+            }
+            node* class_type = parse_type();
+            if(!class_type) {
+                return nullptr;
+            }
+            node* member_type = parse_type();
+            return member_type ? make<pointer_to_member_type>(class_type, member_type) : nullptr;
+        }
+
+        // <class-enum-type> ::= <name> | Ts <name> | Tu <name> | Te <name>
+        node* parse_class_enum_type() {
+            const char* spef = nullptr;
+            if(consume("Ts")) {
+                spef = "struct";
+            } else if(consume("Tu")) {
+                spef = "union";
+            } else if(consume("Te")) {
+                spef = "enum";
+            }
+            node* name = parse_name();
+            if(!name) {
+                return nullptr;
+            }
+            return spef ? make<elaborated_type_spef_type>(spef, name) : name;
+        }
+
+        // <decltype> ::= Dt <expression> E | DT <expression> E
+        node* parse_decltype() {
+            if(!consume('D') || !(consume('t') || consume('T'))) {
+                return nullptr;
+            }
+            node* expr = parse_expr();
+            if(!expr || !consume('E')) {
+                return nullptr;
+            }
+            return make<enclosing_expr>("decltype(", expr, ")");
+        }
+
+        // <vector-type> ::= Dv <positive dimension number> _ <extended element type>
+        //               ::= Dv [<dimension expression>] _ <element type>
+        node* parse_vector_type() {
+            if(!consume("Dv")) {
+                return nullptr;
+            }
+            node* dimension = nullptr;
+            if(look() >= '1' && look() <= '9') {
+                dimension = make<name_type>(parse_number());
+                if(!dimension || !consume('_')) {
+                    return nullptr;
+                }
+                if(consume('p')) {
+                    return make<pixel_vector_type>(dimension);
+                }
+            } else if(!consume('_')) {
+                dimension = parse_expr();
+                if(!dimension || !consume('_')) {
+                    return nullptr;
+                }
+            }
+            node* element = parse_type();
+            return element ? make<vector_type>(element, dimension) : nullptr;
+        }
+
+        //
+        // Expressions
+        //
+
+        node* parse_integer_literal(string_view type) {
+            string_view value = parse_number(true);
+            if(value.empty() || !consume('E')) {
+                return nullptr;
+            }
+            return make<integer_literal>(type, value);
+        }
+
+        // <expr-primary> ::= L <type> <value number> E | L <string type> E | L <nullptr type> E
+        //                ::= L <lambda type> E | L <mangled-name> E
+        node* parse_expr_primary() {
+            if(!consume('L')) {
+                return nullptr;
+            }
+            switch(look()) {
+                case 'w':
+                    first++;
+                    return parse_integer_literal("wchar_t");
+                case 'b':
+                    if(consume("b0E")) {
+                        return make<bool_expr>(false);
+                    }
+                    if(consume("b1E")) {
+                        return make<bool_expr>(true);
+                    }
+                    return nullptr;
+                case 'c':
+                    first++;
+                    return parse_integer_literal("char");
+                case 'a':
+                    first++;
+                    return parse_integer_literal("signed char");
+                case 'h':
+                    first++;
+                    return parse_integer_literal("unsigned char");
+                case 's':
+                    first++;
+                    return parse_integer_literal("short");
+                case 't':
+                    first++;
+                    return parse_integer_literal("unsigned short");
+                case 'i':
+                    first++;
+                    return parse_integer_literal("");
+                case 'j':
+                    first++;
+                    return parse_integer_literal("u");
+                case 'l':
+                    first++;
+                    return parse_integer_literal("l");
+                case 'm':
+                    first++;
+                    return parse_integer_literal("ul");
+                case 'x':
+                    first++;
+                    return parse_integer_literal("ll");
+                case 'y':
+                    first++;
+                    return parse_integer_literal("ull");
+                case 'n':
+                    first++;
+                    return parse_integer_literal("__int128");
+                case 'o':
+                    first++;
+                    return parse_integer_literal("unsigned __int128");
+                case 'f':
+                case 'd':
+                case 'e':
+                    // Floating point literals are mangled as their hex representation and printing them needs
+                    // printf, which isn't signal safe
+                    return nullptr;
+                case '_':
+                    if(consume("_Z")) {
+                        node* encoding = parse_encoding();
+                        if(encoding && consume('E')) {
+                            return encoding;
+                        }
+                    }
+                    return nullptr;
+                case 'A': {
+                    node* type = parse_type();
+                    return type && consume('E') ? make<string_literal>(type) : nullptr;
+                }
+                case 'D':
+                    if(consume("Dn")) {
+                        consume('0');
+                        if(consume('E')) {
+                            return make<name_type>("nullptr");
+                        }
+                    }
+                    return nullptr;
+                case 'T':
+                    return nullptr;
+                case 'U': {
+                    if(look(1) != 'l') {
+                        return nullptr;
+                    }
+                    node* type = parse_unnamed_type_name(nullptr);
+                    return type && consume('E') ? make<lambda_expr>(type) : nullptr;
+                }
+                default: {
+                    // might be an enumerator
+                    node* type = parse_type();
+                    if(!type) {
+                        return nullptr;
+                    }
+                    string_view value = parse_number(true);
+                    if(value.empty() || !consume('E')) {
+                        return nullptr;
+                    }
+                    return make<enum_literal>(type, value);
+                }
+            }
+        }
+
+        // <function-param> ::= fp <CV-qualifiers> [<number>] _ | fL <number> p <CV-qualifiers> [<number>] _ | fpT
+        node* parse_function_param() {
+            if(consume("fpT")) {
+                return make<name_type>("this");
+            }
+            if(consume("fp")) {
+                parse_cv_qualifiers();
+                string_view number = parse_number();
+                return consume('_') ? make<function_param>(number) : nullptr;
+            }
+            if(consume("fL")) {
+                if(parse_number().empty() || !consume('p')) {
+                    return nullptr;
+                }
+                parse_cv_qualifiers();
+                string_view number = parse_number();
+                return consume('_') ? make<function_param>(number) : nullptr;
+            }
+            return nullptr;
+        }
+
+        node* parse_binary_expr(string_view op) {
+            node* lhs = parse_expr();
+            if(!lhs) {
+                return nullptr;
+            }
+            node* rhs = parse_expr();
+            return rhs ? make<binary_expr>(lhs, op, rhs) : nullptr;
+        }
+
+        node* parse_prefix_expr(string_view op) {
+            node* child = parse_expr();
+            return child ? make<prefix_expr>(op, child) : nullptr;
+        }
+
+        node* parse_cast_expr(string_view cast) {
+            node* type = parse_type();
+            if(!type) {
+                return nullptr;
+            }
+            node* expr = parse_expr();
+            return expr ? make<cast_expr>(cast, type, expr) : nullptr;
+        }
+
+        node* parse_member_expr(string_view op) {
+            node* lhs = parse_expr();
+            if(!lhs) {
+                return nullptr;
+            }
+            node* rhs = parse_expr();
+            return rhs ? make<member_expr>(lhs, op, rhs) : nullptr;
+        }
+
+        // cv <type> <expression> | cv <type> _ <expression>* E
+        node* parse_conversion_expr() {
+            if(!consume("cv")) {
+                return nullptr;
+            }
+            auto saved_try_to_parse_template_args = try_to_parse_template_args;
+            try_to_parse_template_args = false;
+            node* type = parse_type();
+            try_to_parse_template_args = saved_try_to_parse_template_args;
+            if(!type) {
+                return nullptr;
+            }
+            auto begin = names.size();
+            if(consume('_')) {
+                while(!consume('E')) {
+                    node* expr = parse_expr();
+                    if(!expr || !push(names, expr)) {
+                        return nullptr;
+                    }
+                }
+            } else {
+                node* expr = parse_expr();
+                if(!expr || !push(names, expr)) {
+                    return nullptr;
+                }
+            }
+            node_array exprs;
+            if(!pop_trailing(begin, exprs)) {
+                return nullptr;
+            }
+            return make<conversion_expr>(type, exprs);
+        }
+
+        bool parse_expr_list_until_end(node_array& exprs) {
+            auto begin = names.size();
+            while(!consume('E')) {
+                node* expr = parse_expr();
+                if(!expr || !push(names, expr)) {
+                    return false;
+                }
+            }
+            return pop_trailing(begin, exprs);
+        }
+
+        // <unresolved-type> ::= <template-param> | <decltype> | <substitution>
+        node* parse_unresolved_type() {
+            if(look() == 'T') {
+                node* param = parse_template_param();
+                return param && push(subs, param) ? param : nullptr;
+            }
+            if(look() == 'D') {
+                node* type = parse_decltype();
+                return type && push(subs, type) ? type : nullptr;
+            }
+            return parse_substitution();
+        }
+
+        // <simple-id> ::= <source-name> [<template-args>]
+        node* parse_simple_id() {
+            node* name = parse_source_name();
+            if(!name) {
+                return nullptr;
+            }
+            if(look() == 'I') {
+                node* args = parse_template_args();
+                return args ? make<name_with_template_args>(name, args) : nullptr;
+            }
+            return name;
+        }
+
+        // <base-unresolved-name> ::= <simple-id> | [on] <operator-name> [<template-args>] | dn <destructor-name>
+        node* parse_base_unresolved_name() {
+            if(is_digit(look())) {
+                return parse_simple_id();
+            }
+            if(consume("dn")) {
+                node* base = is_digit(look()) ? parse_simple_id() : parse_unresolved_type();
+                return base ? make<dtor_name>(base) : nullptr;
+            }
+            consume("on");
+            node* op = parse_operator_name(nullptr);
+            if(!op) {
+                return nullptr;
+            }
+            if(look() == 'I') {
+                node* args = parse_template_args();
+                return args ? make<name_with_template_args>(op, args) : nullptr;
+            }
+            return op;
+        }
+
+        // <unresolved-name> ::= [gs] <base-unresolved-name>
+        //                   ::= sr <unresolved-type> [<template-args>] <base-unresolved-name>
+        //                   ::= srN <unresolved-type> [<template-args>] <unresolved-qualifier-level>* E
+        //                       <base-unresolved-name>
+        //                   ::= [gs] sr <unresolved-qualifier-level>+ E <base-unresolved-name>
+        node* parse_unresolved_name() {
+            node* so_far = nullptr;
+            if(consume("srN")) {
+                so_far = parse_unresolved_type();
+                if(!so_far) {
+                    return nullptr;
+                }
+                if(look() == 'I') {
+                    node* args = parse_template_args();
+                    if(!args || !(so_far = make<name_with_template_args>(so_far, args))) {
+                        return nullptr;
+                    }
+                }
+                while(!consume('E')) {
+                    node* qualifier = parse_simple_id();
+                    if(!qualifier || !(so_far = make<qualified_name>(so_far, qualifier))) {
+                        return nullptr;
+                    }
+                }
+                node* base = parse_base_unresolved_name();
+                return base ? make<qualified_name>(so_far, base) : nullptr;
+            }
+            bool global = consume("gs");
+            if(!consume("sr")) {
+                so_far = parse_base_unresolved_name();
+                if(so_far && global) {
+                    so_far = make<global_qualified_name>(so_far);
+                }
+                return so_far;
+            }
+            if(is_digit(look())) {
+                do {
+                    node* qualifier = parse_simple_id();
+                    if(!qualifier) {
+                        return nullptr;
+                    }
+                    if(so_far) {
+                        so_far = make<qualified_name>(so_far, qualifier);
+                    } else if(global) {
+                        so_far = make<global_qualified_name>(qualifier);
+                    } else {
+                        so_far = qualifier;
+                    }
+                    if(!so_far) {
+                        return nullptr;
+                    }
+                } while(!consume('E'));
+            } else {
+                so_far = parse_unresolved_type();
+                if(!so_far) {
+                    return nullptr;
+                }
+                if(look() == 'I') {
+                    node* args = parse_template_args();
+                    if(!args || !(so_far = make<name_with_template_args>(so_far, args))) {
+                        return nullptr;
+                    }
+                }
+            }
+            node* base = parse_base_unresolved_name();
+            return base ? make<qualified_name>(so_far, base) : nullptr;
+        }
+
+        node* parse_expr() {
+            recursion_guard guard(*this);
+            if(!guard.ok()) {
+                return nullptr;
+            }
+            bool global = consume("gs");
+            if(num_left() < 2) {
+                return nullptr;
+            }
+            char c0 = look();
+            char c1 = look(1);
+            switch(c0) {
+                case 'L':
+                    return parse_expr_primary();
+                case 'T':
+                    return parse_template_param();
+                case 'f':
+                    if(c1 == 'p' || (c1 == 'L' && is_digit(look(2)))) {
+                        return parse_function_param();
+                    }
+                    // fold expressions aren't supported
+                    return nullptr;
+                default:
+                    break;
+            }
+            if(is_digit(c0) || (c0 == 's' && c1 == 'r') || (c0 == 'd' && c1 == 'n') || (c0 == 'o' && c1 == 'n')) {
+                if(global) {
+                    // the unresolved name parser handles a leading gs itself
+                    first -= 2;
+                }
+                return parse_unresolved_name();
+            }
+            for(const auto& op : binary_operators) {
+                if(c0 == op.code[0] && c1 == op.code[1]) {
+                    first += 2;
+                    return parse_binary_expr(op.name);
+                }
+            }
+            for(const auto& op : prefix_operators) {
+                if(c0 == op.code[0] && c1 == op.code[1]) {
+                    first += 2;
+                    return parse_prefix_expr(op.name);
+                }
+            }
+            if((c0 == 'p' && c1 == 'p') || (c0 == 'm' && c1 == 'm')) {
+                // pp_ <expression> is prefix, pp <expression> postfix
+                const char* op = c0 == 'p' ? "++" : "--";
+                first += 2;
+                if(consume('_')) {
+                    return parse_prefix_expr(op);
+                }
+                node* child = parse_expr();
+                return child ? make<postfix_expr>(child, op) : nullptr;
+            }
+            if(c0 == 'c' && c1 == 'v') {
+                return parse_conversion_expr();
+            }
+            first += 2;
+            switch(c0) {
+                case 'a':
+                    if(c1 == 't' || c1 == 'z') {
+                        node* operand = c1 == 't' ? parse_type() : parse_expr();
+                        return operand ? make<enclosing_expr>("alignof (", operand, ")") : nullptr;
+                    }
+                    break;
+                case 'c':
+                    if(c1 == 'c') {
+                        return parse_cast_expr("const_cast");
+                    }
+                    if(c1 == 'l') {
+                        node* callee = parse_expr();
+                        if(!callee) {
+                            return nullptr;
+                        }
+                        node_array args;
+                        if(!parse_expr_list_until_end(args)) {
+                            return nullptr;
+                        }
+                        return make<call_expr>(callee, args);
+                    }
+                    break;
+                case 'd':
+                    if(c1 == 'c') {
+                        return parse_cast_expr("dynamic_cast");
+                    }
+                    if(c1 == 's') {
+                        return parse_member_expr(".*");
+                    }
+                    if(c1 == 't') {
+                        return parse_member_expr(".");
+                    }
+                    break;
+                case 'i':
+                    if(c1 == 'x') {
+                        node* base = parse_expr();
+                        if(!base) {
+                            return nullptr;
+                        }
+                        node* index = parse_expr();
+                        return index ? make<array_subscript_expr>(base, index) : nullptr;
+                    }
+                    if(c1 == 'l') {
+                        node_array inits;
+                        if(!parse_expr_list_until_end(inits)) {
+                            return nullptr;
+                        }
+                        return make<init_list_expr>(nullptr, inits);
+                    }
+                    break;
+                case 'n':
+                    if(c1 == 'x') {
+                        node* operand = parse_expr();
+                        return operand ? make<enclosing_expr>("noexcept (", operand, ")") : nullptr;
+                    }
+                    break;
+                case 'p':
+                    if(c1 == 't') {
+                        return parse_member_expr("->");
+                    }
+                    break;
+                case 'q':
+                    if(c1 == 'u') {
+                        node* condition = parse_expr();
+                        if(!condition) {
+                            return nullptr;
+                        }
+                        node* then_expr = parse_expr();
+                        if(!then_expr) {
+                            return nullptr;
+                        }
+                        node* else_expr = parse_expr();
+                        return else_expr ? make<conditional_expr>(condition, then_expr, else_expr) : nullptr;
+                    }
+                    break;
+                case 'r':
+                    if(c1 == 'c') {
+                        return parse_cast_expr("reinterpret_cast");
+                    }
+                    break;
+                case 's':
+                    switch(c1) {
+                        case 'c':
+                            return parse_cast_expr("static_cast");
+                        case 'p': {
+                            node* child = parse_expr();
+                            return child ? make<parameter_pack_expansion>(child) : nullptr;
+                        }
+                        case 't': {
+                            node* type = parse_type();
+                            return type ? make<enclosing_expr>("sizeof (", type, ")") : nullptr;
+                        }
+                        case 'z': {
+                            node* expr = parse_expr();
+                            return expr ? make<enclosing_expr>("sizeof (", expr, ")") : nullptr;
+                        }
+                        case 'Z':
+                            if(look() == 'T') {
+                                node* pack = parse_template_param();
+                                return pack ? make<sizeof_param_pack_expr>(pack) : nullptr;
+                            }
+                            if(look() == 'f') {
+                                node* param = parse_function_param();
+                                return param ? make<enclosing_expr>("sizeof... (", param, ")") : nullptr;
+                            }
+                            return nullptr;
+                        case 'P': {
+                            auto begin = names.size();
+                            while(!consume('E')) {
+                                node* arg = parse_template_arg();
+                                if(!arg || !push(names, arg)) {
+                                    return nullptr;
+                                }
+                            }
+                            node_array args;
+                            if(!pop_trailing(begin, args)) {
+                                return nullptr;
+                            }
+                            node* pack = make<node_array_node>(args);
+                            return pack ? make<enclosing_expr>("sizeof... (", pack, ")") : nullptr;
+                        }
+                        default:
+                            break;
+                    }
+                    break;
+                case 't':
+                    switch(c1) {
+                        case 'e': {
+                            node* expr = parse_expr();
+                            return expr ? make<enclosing_expr>("typeid (", expr, ")") : nullptr;
+                        }
+                        case 'i': {
+                            node* type = parse_type();
+                            return type ? make<enclosing_expr>("typeid (", type, ")") : nullptr;
+                        }
+                        case 'l': {
+                            node* type = parse_type();
+                            if(!type) {
+                                return nullptr;
+                            }
+                            node_array inits;
+                            if(!parse_expr_list_until_end(inits)) {
+                                return nullptr;
+                            }
+                            return make<init_list_expr>(type, inits);
+                        }
+                        case 'r':
+                            return make<name_type>("throw");
+                        case 'w': {
+                            node* operand = parse_expr();
+                            return operand ? make<throw_expr>(operand) : nullptr;
+                        }
+                        default:
+                            break;
+                    }
+                    break;
+                default:
+                    break;
+            }
+            // new, delete, fold expressions, designated initializers, and vendor extensions aren't supported
+            return nullptr;
+        }
+
+    public:
+        parser(const char* first, const char* last, arena& memory) : first(first), last(last), memory(memory) {}
+
+        bool init(std::size_t scratch_size) {
+            // Every table entry consumes at least one character of input, don't let the tables take more than half
+            // of the scratch space though
+            std::size_t capacity = num_left() + 1;
+            std::size_t max_capacity = scratch_size / (8 * sizeof(node*));
+            if(capacity > max_capacity) {
+                capacity = max_capacity < 16 ? 16 : max_capacity;
+            }
+            return subs.init(memory, capacity)
+                && names.init(memory, capacity)
+                && template_params.init(memory, capacity)
+                && forward_refs.init(memory, capacity);
+        }
+
+        bool ran_out_of_memory() const {
+            return out_of_memory;
+        }
+
+        // <mangled-name> ::= _Z <encoding> [.<clone suffix>] | <type>
+        node* parse() {
+            if(consume("_Z") || consume("__Z")) {
+                node* encoding = parse_encoding();
+                if(!encoding) {
+                    return nullptr;
+                }
+                if(look() == '.') {
+                    encoding = make<dot_suffix>(encoding, string_view(first, last));
+                    first = last;
+                }
+                return encoding && num_left() == 0 ? encoding : nullptr;
+            }
+            node* type = parse_type();
+            return type && num_left() == 0 ? type : nullptr;
+        }
+    };
+
+    demangle_result demangle(
+        const char* name,
+        std::size_t length,
+        char* buffer,
+        std::size_t size,
+        demangle_mode mode,
+        void* scratch,
+        std::size_t scratch_size
+    ) {
+        if(size != 0) {
+            buffer[0] = 0;
+        }
+        arena memory(scratch, scratch_size);
+        parser parser(name, name + length, memory);
+        if(!parser.init(scratch_size)) {
+            return {demangle_status::out_of_memory, 0};
+        }
+        node* root = parser.parse();
+        if(!root) {
+            return {
+                parser.ran_out_of_memory() ? demangle_status::out_of_memory : demangle_status::invalid_name,
+                0
+            };
+        }
+        printer out(buffer, size, mode == demangle_mode::pruned);
+        out.print(root);
+        if(!out.ok()) {
+            if(size != 0) {
+                buffer[0] = 0;
+            }
+            return {demangle_status::invalid_name, 0};
+        }
+        return {demangle_status::success, out.finish()};
+    }
+}
+}
+CPPTRACE_END_NAMESPACE
+
+CPPTRACE_BEGIN_NAMESPACE
+namespace experimental {
+    std::size_t demangle_signal_safe(
+        const char* name,
+        char* buffer,
+        std::size_t size,
+        void* scratch,
+        std::size_t scratch_size,
+        demangle_mode mode
+    ) {
+        std::size_t length = 0;
+        while(name[length] != 0) {
+            length++;
+        }
+        auto result = detail::itanium::demangle(name, length, buffer, size, mode, scratch, scratch_size);
+        return result.status == detail::itanium::demangle_status::success ? result.length : 0;
+    }
+
+    std::size_t demangle_signal_safe(const char* name, char* buffer, std::size_t size, demangle_mode mode) {
+        alignas(std::max_align_t) char scratch[16 * 1024];
+        return demangle_signal_safe(name, buffer, size, scratch, sizeof(scratch), mode);
+    }
+}
+CPPTRACE_END_NAMESPACE
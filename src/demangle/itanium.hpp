@@ -0,0 +1,42 @@
+#ifndef ITANIUM_HPP
+#define ITANIUM_HPP
+
+#include <cpptrace/utils.hpp>
+
+#include <cstddef>
+
+CPPTRACE_BEGIN_NAMESPACE
+namespace detail {
+namespace itanium {
+    enum class demangle_status {
+        success,
+        // Not a mangled name, or one using a construct the demangler doesn't support
+        invalid_name,
+        // The scratch space wasn't large enough for the name
+        out_of_memory
+    };
+
+    struct demangle_result {
+        demangle_status status;
+        // Length of the full demangled name, the output was truncated if this is size or more
+        std::size_t length;
+    };
+
+    // Built-in Itanium ABI demangler. Everything it needs is carved out of the scratch space, it never allocates,
+    // throws, or touches global state so it's safe to call from a signal handler. Accepts _Z / __Z prefixed names and
+    // bare types. At most size - 1 characters and a null terminator are written to buffer, on failure the buffer holds
+    // an empty string. Output matches LLVM's demangler, in pruned mode it matches prune_symbol applied to that output.
+    demangle_result demangle(
+        const char* name,
+        std::size_t length,
+        char* buffer,
+        std::size_t size,
+        experimental::demangle_mode mode,
+        void* scratch,
+        std::size_t scratch_size
+    );
+}
+}
+CPPTRACE_END_NAMESPACE
+
+#endif
@@ -1,61 +1,238 @@
 #include <cpptrace/formatting.hpp>
 #include <cpptrace/utils.hpp>
 
+#include "demangle/demangle.hpp"
+#include "symbol_tokenizer.hpp"
 #include "utils/optional.hpp"
+#include "utils/output_sink.hpp"
+#include "utils/stats.hpp"
 #include "utils/utils.hpp"
-#include "utils/replace_all.hpp"
 #include "snippets/snippet.hpp"
 
 #include <algorithm>
+#include <cctype>
 #include <cstdio>
 #include <string>
 #include <functional>
 #include <iostream>
-#include <sstream>
-#include <regex>
+#include <vector>
 
 CPPTRACE_BEGIN_NAMESPACE
     std::string basename(const std::string& path) {
         return detail::basename(path, true);
     }
 
-    std::string prettify_symbol(std::string symbol) {
-        // > > -> >> replacement
-        // could put in analysis:: but the replacement is basic and this is more convenient for
-        // using in the stringifier too
-        detail::replace_all_dynamic(symbol, "> >", ">>");
-        // "," -> ", " and " ," -> ", "
-        static const std::regex comma_re(R"(\s*,\s*)");
-        detail::replace_all(symbol, comma_re, ", ");
-        // class C -> C for msvc
-        static const std::regex class_re(R"(\b(class|struct)\s+)");
-        detail::replace_all(symbol, class_re, "");
-        // `anonymous namespace' -> (anonymous namespace) for msvc
-        // this brings it in-line with other compilers and prevents any tokenization/highlighting issues
-        static const std::regex msvc_anonymous_namespace("`anonymous namespace'");
-        detail::replace_all(symbol, msvc_anonymous_namespace, "(anonymous namespace)");
-        // rules to replace std::basic_string -> std::string and std::basic_string_view -> std::string
-        // rule to replace ", std::allocator<whatever>"
-        static const std::pair<std::regex, std::string> basic_string = {
-            std::regex(R"(std(::[a-zA-Z0-9_]+)?::basic_string<char)"), "std::string"
-        };
-        detail::replace_all_template(symbol, basic_string);
-        static const std::pair<std::regex, std::string> basic_string_view = {
-            std::regex(R"(std(::[a-zA-Z0-9_]+)?::basic_string_view<char)"), "std::string_view"
-        };
-        detail::replace_all_template(symbol, basic_string_view);
-        static const std::pair<std::regex, std::string> allocator = {
-            std::regex(R"(,\s*std(::[a-zA-Z0-9_]+)?::allocator<)"), ""
-        };
-        detail::replace_all_template(symbol, allocator);
-        static const std::pair<std::regex, std::string> default_delete = {
-            std::regex(R"(,\s*std(::[a-zA-Z0-9_]+)?::default_delete<)"), ""
+    namespace detail {
+        // Cleans up a demangled symbol in a single pass over its tokens, e.g. turning
+        // std::__cxx11::basic_string<char, std::char_traits<char>, std::allocator<char> > into std::string
+        class symbol_prettifier {
+            string_view symbol;
+            std::vector<token> tokens;
+            // whitespace before each token, the last entry is trailing whitespace
+            std::vector<string_view> whitespace;
+            std::string out;
+
+            void push_token(const token& next) {
+                const char* begin = tokens.empty() ? symbol.begin() : tokens.back().str.end();
+                string_view before{begin, next.str.begin()};
+                // "> >" -> ">>"
+                if(before == " " && !tokens.empty() && tokens.back().str.end()[-1] == '>' && next.str.begin()[0] == '>') {
+                    before = {};
+                }
+                whitespace.push_back(before);
+                tokens.push_back(next);
+            }
+
+            void tokenize() {
+                symbol_tokenizer tokenizer(symbol);
+                while(true) {
+                    auto next = tokenizer.advance();
+                    if(next.is_error()) {
+                        // unbalanced quotes, keep the rest of the symbol as-is
+                        const char* rest = tokens.empty() ? symbol.begin() : tokens.back().str.end();
+                        while(rest != symbol.end() && std::isspace(static_cast<unsigned char>(*rest))) {
+                            rest++;
+                        }
+                        if(rest != symbol.end()) {
+                            push_token({token_type::literal, {rest, symbol.end()}});
+                        }
+                        break;
+                    }
+                    const auto& maybe_token = next.unwrap_value();
+                    if(!maybe_token) {
+                        break;
+                    }
+                    push_token(maybe_token.unwrap());
+                }
+                whitespace.push_back({tokens.empty() ? symbol.begin() : tokens.back().str.end(), symbol.end()});
+            }
+
+            bool is(std::size_t i, string_view str) const {
+                return i < tokens.size() && tokens[i].str == str;
+            }
+
+            // token i directly follows the previous token
+            bool adjacent(std::size_t i) const {
+                return i < tokens.size() && whitespace[i].empty();
+            }
+
+            bool is_adjacent(std::size_t i, string_view str) const {
+                return is(i, str) && adjacent(i);
+            }
+
+            // class or struct followed by whitespace, msvc includes these in type names
+            bool is_class_key(std::size_t i) const {
+                return i < tokens.size()
+                    && tokens[i].type == token_type::identifier
+                    && is_any(tokens[i].str, "class", "struct")
+                    && !whitespace[i + 1].empty();
+            }
+
+            // Matches std[::ns]::name< starting at token i, returning the index of the token after the <
+            optional<std::size_t> match_std_template(std::size_t i, string_view name) const {
+                if(!is(i, "std") || !is_adjacent(i + 1, "::")) {
+                    return nullopt;
+                }
+                i += 2;
+                if(
+                    i < tokens.size()
+                    && tokens[i].type == token_type::identifier
+                    && adjacent(i)
+                    && is_adjacent(i + 1, "::")
+                ) {
+                    i += 2;
+                }
+                if(!is_adjacent(i, name) || !is_adjacent(i + 1, "<")) {
+                    return nullopt;
+                }
+                return i + 2;
+            }
+
+            // Skips to the > closing a template argument list whose arguments start at token i. The > can be part of
+            // a >> token, in which case the token is shortened to what follows the >. Returns the index of the token
+            // to resume at.
+            std::size_t skip_template_arguments(std::size_t i) {
+                int depth = 1;
+                for(; i < tokens.size(); i++) {
+                    auto& str = tokens[i].str;
+                    for(auto it = str.begin(); it != str.end(); it++) {
+                        if(*it == '<') {
+                            depth++;
+                        } else if(*it == '>' && --depth == 0) {
+                            if(it + 1 == str.end()) {
+                                return i + 1;
+                            }
+                            str = {it + 1, str.end()};
+                            whitespace[i] = {};
+                            return i;
+                        }
+                    }
+                }
+                return i;
+            }
+
+            // std::basic_string<char, ...> -> std::string, same for std::basic_string_view
+            optional<std::size_t> try_basic_string(std::size_t i) {
+                static const string_view replacements[][2] = {
+                    {"basic_string", "std::string"},
+                    {"basic_string_view", "std::string_view"}
+                };
+                for(const auto& replacement : replacements) {
+                    auto args = match_std_template(i, replacement[0]);
+                    if(args && is_adjacent(args.unwrap(), "char")) {
+                        out.append(replacement[1].begin(), replacement[1].end());
+                        return skip_template_arguments(args.unwrap());
+                    }
+                }
+                return nullopt;
+            }
+
+            // , std::allocator<...> and , std::default_delete<...> are dropped
+            optional<std::size_t> try_defaulted_argument(std::size_t comma) {
+                auto start = comma + 1;
+                if(is_class_key(start)) {
+                    start++;
+                }
+                for(const auto name : {"allocator", "default_delete"}) {
+                    auto args = match_std_template(start, name);
+                    if(args) {
+                        return skip_template_arguments(args.unwrap());
+                    }
+                }
+                return nullopt;
+            }
+
+        public:
+            explicit symbol_prettifier(string_view symbol) : symbol(symbol) {}
+
+            std::string prettify() {
+                tokenize();
+                out.reserve(symbol.size());
+                bool skip_whitespace = false;
+                std::size_t i = 0;
+                while(i < tokens.size()) {
+                    const auto& current = tokens[i];
+                    if(current.str == ",") {
+                        // whitespace around commas is normalized to ", "
+                        auto resume = try_defaulted_argument(i);
+                        if(resume) {
+                            i = resume.unwrap();
+                            skip_whitespace = false;
+                        } else {
+                            out += ", ";
+                            i++;
+                            skip_whitespace = true;
+                        }
+                        continue;
+                    }
+                    if(!skip_whitespace) {
+                        out.append(whitespace[i].begin(), whitespace[i].end());
+                    }
+                    skip_whitespace = false;
+                    if(current.type == token_type::identifier) {
+                        // class C -> C and struct C -> C for msvc
+                        if(is_class_key(i)) {
+                            skip_whitespace = true;
+                            i++;
+                            continue;
+                        }
+                        auto resume = try_basic_string(i);
+                        if(resume) {
+                            i = resume.unwrap();
+                            continue;
+                        }
+                        // std::__cxx11:: -> std:: for the gcc dual abi
+                        // https://gcc.gnu.org/onlinedocs/libstdc++/manual/using_dual_abi.html
+                        if(
+                            current.str == "std"
+                            && is_adjacent(i + 1, "::")
+                            && is_adjacent(i + 2, "__cxx11")
+                            && is_adjacent(i + 3, "::")
+                        ) {
+                            out += "std";
+                            i += 3;
+                            continue;
+                        }
+                    } else if(current.type == token_type::anonymous_namespace && current.str.starts_with("`")) {
+                        // `anonymous namespace' -> (anonymous namespace) for msvc, this brings it in-line with other
+                        // compilers and prevents any tokenization/highlighting issues
+                        out += "(anonymous namespace)";
+                        i++;
+                        continue;
+                    }
+                    out.append(current.str.begin(), current.str.end());
+                    i++;
+                }
+                if(!skip_whitespace) {
+                    out.append(whitespace.back().begin(), whitespace.back().end());
+                }
+                return std::move(out);
+            }
         };
-        detail::replace_all_template(symbol, default_delete);
-        // replace std::__cxx11 -> std:: for gcc dual abi
-        // https://gcc.gnu.org/onlinedocs/libstdc++/manual/using_dual_abi.html
-        detail::replace_all_dynamic(symbol, "std::__cxx11::", "std::");
-        return symbol;
+    }
+
+    std::string prettify_symbol(std::string symbol) {
+        return detail::symbol_prettifier(symbol).prettify();
     }
 
     class formatter::impl {
@@ -121,15 +298,21 @@ CPPTRACE_BEGIN_NAMESPACE
             detail::optional<bool> color_override = detail::nullopt,
             size_t filename_indent = 0
         ) const {
-            std::ostringstream oss;
-            print_internal(oss, frame, color_override.value_or(options.color == color_mode::always), filename_indent);
-            return std::move(oss).str();
+            std::string str;
+            {
+                detail::string_sink sink(str);
+                write_frame(sink, frame, color_override.value_or(options.color == color_mode::always), filename_indent);
+            }
+            return str;
         }
 
         std::string format(const stacktrace& trace, detail::optional<bool> color_override = detail::nullopt) const {
-            std::ostringstream oss;
-            print_internal(oss, trace, color_override.value_or(options.color == color_mode::always));
-            return std::move(oss).str();
+            std::string str;
+            {
+                detail::string_sink sink(str);
+                write_trace(sink, trace, color_override.value_or(options.color == color_mode::always));
+            }
+            return str;
         }
 
         void print(const stacktrace_frame& frame, detail::optional<bool> color_override = detail::nullopt) const {
@@ -141,8 +324,11 @@ CPPTRACE_BEGIN_NAMESPACE
             detail::optional<bool> color_override = detail::nullopt,
             size_t filename_indent = 0
         ) const {
-            print_internal(stream, frame, color_override, filename_indent);
-            stream << "\n";
+            bool color = should_do_color(stream, color_override);
+            maybe_ensure_virtual_terminal_processing(stream, color);
+            detail::ostream_sink sink(stream);
+            write_frame(sink, frame, color, filename_indent);
+            sink.put('\n');
         }
         void print(
             std::FILE* file,
@@ -150,9 +336,9 @@ CPPTRACE_BEGIN_NAMESPACE
             detail::optional<bool> color_override = detail::nullopt,
             size_t filename_indent = 0
         ) const {
-            auto str = format(frame, color_override, filename_indent);
-            str += "\n";
-            std::fwrite(str.data(), 1, str.size(), file);
+            detail::file_sink sink(file);
+            write_frame(sink, frame, color_override.value_or(options.color == color_mode::always), filename_indent);
+            sink.put('\n');
         }
 
         void print(const stacktrace& trace, detail::optional<bool> color_override = detail::nullopt) const {
@@ -163,17 +349,20 @@ CPPTRACE_BEGIN_NAMESPACE
             const stacktrace& trace,
             detail::optional<bool> color_override = detail::nullopt
         ) const {
-            print_internal(stream, trace, color_override);
-            stream << "\n";
+            bool color = should_do_color(stream, color_override);
+            maybe_ensure_virtual_terminal_processing(stream, color);
+            detail::ostream_sink sink(stream);
+            write_trace(sink, trace, color);
+            sink.put('\n');
         }
         void print(
             std::FILE* file,
             const stacktrace& trace,
             detail::optional<bool> color_override = detail::nullopt
         ) const {
-            auto str = format(trace, color_override);
-            str += "\n";
-            std::fwrite(str.data(), 1, str.size(), file);
+            detail::file_sink sink(file);
+            write_trace(sink, trace, color_override.value_or(options.color == color_mode::always));
+            sink.put('\n');
         }
 
     private:
@@ -237,31 +426,25 @@ CPPTRACE_BEGIN_NAMESPACE
             return it == trace.end() ? 0 : it - trace.begin() + 1;
         }
 
-        void print_internal(std::ostream& stream, const stacktrace_frame& input_frame, detail::optional<bool> color_override, size_t col_indent) const {
-            bool color = should_do_color(stream, color_override);
-            maybe_ensure_virtual_terminal_processing(stream, color);
+        void write_frame(detail::output_sink& sink, const stacktrace_frame& input_frame, bool color, size_t col_indent) const {
+            detail::stage_timer timer(detail::stat_stage::formatting);
             detail::optional<stacktrace_frame> transformed_frame;
             if(options.transform) {
                 transformed_frame = options.transform(input_frame);
             }
             const stacktrace_frame& frame = options.transform ? transformed_frame.unwrap() : input_frame;
-            write_frame(stream, frame, color, col_indent);
-        }
-
-        void print_internal(std::ostream& stream, const stacktrace& trace, detail::optional<bool> color_override) const {
-            bool color = should_do_color(stream, color_override);
-            maybe_ensure_virtual_terminal_processing(stream, color);
-            write_trace(stream, trace, color);
+            write_frame_body(sink, frame, color, col_indent);
         }
 
-
-        void write_trace(std::ostream& stream, const stacktrace& trace, bool color) const {
+        void write_trace(detail::output_sink& sink, const stacktrace& trace, bool color) const {
+            detail::stage_timer timer(detail::stat_stage::formatting);
             if(!options.header.empty()) {
-                stream << options.header << '\n';
+                sink.write(options.header);
+                sink.put('\n');
             }
             const auto& frames = trace.frames;
             if(frames.empty()) {
-                stream << "<empty trace>";
+                sink.write("<empty trace>");
                 return;
             }
             const auto frame_number_width = detail::n_digits(static_cast<int>(frames.size()) - 1);
@@ -278,11 +461,11 @@ CPPTRACE_BEGIN_NAMESPACE
                     continue;
                 }
 
-                size_t filename_indent = write_frame_number(stream, frame_number_width, counter);
+                size_t filename_indent = write_frame_number(sink, frame_number_width, counter);
                 if(filter_out_frame) {
-                    microfmt::print(stream, "(filtered)");
+                    sink.write("(filtered)");
                 } else {
-                    write_frame(stream, frame, color, filename_indent);
+                    write_frame_body(sink, frame, color, filename_indent);
                     if(frame.line.has_value() && !frame.filename.empty() && options.snippets) {
                         auto snippet = detail::get_snippet(
                             frame.filename,
@@ -292,60 +475,65 @@ CPPTRACE_BEGIN_NAMESPACE
                             color
                         );
                         if(!snippet.empty()) {
-                            stream << '\n';
-                            stream << snippet;
+                            sink.put('\n');
+                            sink.write(snippet);
                         }
                     }
                 }
                 if(i + 1 != frames.size()) {
-                    stream << '\n';
+                    sink.put('\n');
                 }
                 counter++;
             }
         }
 
         /// Write the frame number, and return the number of characters written
-        size_t write_frame_number(std::ostream& stream, unsigned int frame_number_width, size_t counter) const
+        size_t write_frame_number(detail::output_sink& sink, unsigned int frame_number_width, size_t counter) const
         {
-            microfmt::print(stream, "#{<{}} ", frame_number_width, counter);
+            microfmt::print(sink, "#{<{}} ", frame_number_width, counter);
             return 2 + frame_number_width;
         }
 
-        void write_frame(std::ostream& stream, const stacktrace_frame& frame, color_setting color, size_t col) const {
-            col += write_address(stream, frame, color);
+        void write_frame_body(
+            detail::output_sink& sink,
+            const stacktrace_frame& frame,
+            color_setting color,
+            size_t col
+        ) const {
+            col += write_address(sink, frame, color);
             if(frame.is_inline || options.addresses != address_mode::none) {
-                stream << ' ';
+                sink.put(' ');
                 col += 1;
             }
             if(!frame.symbol.empty()) {
-                write_symbol(stream, frame, color);
+                write_symbol(sink, frame, color);
             }
             if(!frame.symbol.empty() && !frame.filename.empty()) {
                 if(options.break_before_filename) {
-                    microfmt::print(stream, "\n{<{}}", col, "");
+                    microfmt::print(sink, "\n{<{}}", col, "");
                 } else {
-                    stream << ' ';
+                    sink.put(' ');
                 }
             }
             if(!frame.filename.empty()) {
-                write_source_location(stream, frame, color);
+                write_source_location(sink, frame, color);
             }
         }
 
         /// Write the address of the frame, return the number of characters written
-        size_t write_address(std::ostream& stream, const stacktrace_frame& frame, color_setting color) const {
+        size_t write_address(detail::output_sink& sink, const stacktrace_frame& frame, color_setting color) const {
             if(frame.is_inline) {
-                microfmt::print(stream, "{<{}}", 2 * sizeof(frame_ptr) + 2, "(inlined)");
+                microfmt::print(sink, "{<{}}", 2 * sizeof(frame_ptr) + 2, "(inlined)");
                 return 2 * sizeof(frame_ptr) + 2;
             } else if(options.addresses != address_mode::none) {
                 auto address = options.addresses == address_mode::raw ? frame.raw_address : frame.object_address;
-                microfmt::print(stream, "{}0x{>{}:0h}{}", color.blue(), 2 * sizeof(frame_ptr), address, color.reset());
+                microfmt::print(sink, "{}0x{>{}:0h}{}", color.blue(), 2 * sizeof(frame_ptr), address, color.reset());
                 return 2 * sizeof(frame_ptr) + 2;
             }
             return 0;
         }
 
-        void write_symbol(std::ostream& stream, const stacktrace_frame& frame, color_setting color) const {
+        void write_symbol(detail::output_sink& sink, const stacktrace_frame& frame, color_setting color) const {
             detail::optional<std::string> maybe_stored_string;
             detail::string_view symbol;
             switch(options.symbols) {
@@ -353,31 +541,31 @@ CPPTRACE_BEGIN_NAMESPACE
                     symbol = frame.symbol;
                     break;
                 case symbol_mode::pruned:
-                    maybe_stored_string = prune_symbol(frame.symbol);
+                    maybe_stored_string = detail::prune_symbol_cached(frame.symbol);
                     symbol = maybe_stored_string.unwrap();
                     break;
                 case symbol_mode::pretty:
-                    maybe_stored_string = prettify_symbol(frame.symbol);
+                    maybe_stored_string = detail::prettify_symbol_cached(frame.symbol);
                     symbol = maybe_stored_string.unwrap();
                     break;
                 default:
                     PANIC("Unhandled symbol mode");
             }
-            microfmt::print(stream, "in {}{}{}", color.yellow(), symbol, color.reset());
+            microfmt::print(sink, "in {}{}{}", color.yellow(), symbol, color.reset());
         }
 
-        void write_source_location(std::ostream& stream, const stacktrace_frame& frame, color_setting color) const {
+        void write_source_location(detail::output_sink& sink, const stacktrace_frame& frame, color_setting color) const {
             microfmt::print(
-                stream,
+                sink,
                 "at {}{}{}",
                 color.green(),
                 options.paths == path_mode::full ? frame.filename : detail::basename(frame.filename, true),
                 color.reset()
             );
             if(frame.line.has_value()) {
-                microfmt::print(stream, ":{}{}{}", color.blue(), frame.line.value(), color.reset());
+                microfmt::print(sink, ":{}{}{}", color.blue(), frame.line.value(), color.reset());
                 if(frame.column.has_value() && options.columns) {
-                    microfmt::print(stream, ":{}{}{}", color.blue(), frame.column.value(), color.reset());
+                    microfmt::print(sink, ":{}{}{}", color.blue(), frame.column.value(), color.reset());
                 }
             }
         }
@@ -1,10 +1,13 @@
 #include <cpptrace/cpptrace.hpp>
 #include <cpptrace/from_current.hpp>
 
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <exception>
 #include <system_error>
 #include <typeinfo>
+#include <vector>
 
 #include "platform/platform.hpp"
 #include "platform/memory_mapping.hpp"
@@ -12,6 +15,7 @@
 #include "utils/microfmt.hpp"
 #include "utils/utils.hpp"
 #include "logging.hpp"
+#include "options.hpp"
 #include "unwind/unwind.hpp"
 
 #if IS_WINDOWS
@@ -35,26 +39,92 @@ namespace detail {
         return rethrow_switch;
     }
 
+    // In bounded mode frames are captured into a per-thread buffer and a lazy_trace_holder is only made from them when
+    // the trace is requested, so a throw doesn't touch the holders. Only the safe unwinder captures into the buffer
+    // directly, the others return a vector that's copied in.
+    struct deferred_trace {
+        // sized to the max depth once and then reused
+        std::vector<frame_ptr> frames;
+        std::size_t count = 0;
+        // frames hold a newer trace than the corresponding lazy_trace_holder
+        bool pending = false;
+    };
+    thread_local deferred_trace deferred_current_trace;
+    thread_local deferred_trace deferred_rethrow_trace;
+
     void save_current_trace(raw_trace trace) {
         if(get_rethrow_switch()) {
             saved_rethrow_trace = lazy_trace_holder(std::move(trace));
+            deferred_rethrow_trace.pending = false;
         } else {
             current_exception_trace = lazy_trace_holder(std::move(trace));
             saved_rethrow_trace = lazy_trace_holder();
+            deferred_current_trace.pending = false;
+            deferred_rethrow_trace.pending = false;
+        }
+    }
+
+    // returns the buffer to capture into, mirroring save_current_trace
+    deferred_trace& prepare_deferred_trace(std::size_t max_depth) {
+        auto& deferred = get_rethrow_switch() ? deferred_rethrow_trace : deferred_current_trace;
+        if(!get_rethrow_switch()) {
+            // the rethrow trace is cleared, which an empty pending trace does lazily
+            deferred_rethrow_trace.count = 0;
+            deferred_rethrow_trace.pending = true;
+        }
+        if(deferred.frames.size() < max_depth) {
+            deferred.frames.resize(max_depth);
+        }
+        deferred.count = 0;
+        deferred.pending = true;
+        return deferred;
+    }
+
+    lazy_trace_holder& get_trace_holder(deferred_trace& deferred, lazy_trace_holder& holder) {
+        if(deferred.pending) {
+            holder = lazy_trace_holder(
+                raw_trace{{deferred.frames.begin(), deferred.frames.begin() + deferred.count}}
+            );
+            deferred.pending = false;
         }
+        return holder;
+    }
+
+    lazy_trace_holder& get_current_exception_trace() {
+        return get_trace_holder(deferred_current_trace, current_exception_trace);
+    }
+
+    lazy_trace_holder& get_saved_rethrow_trace() {
+        return get_trace_holder(deferred_rethrow_trace, saved_rethrow_trace);
+    }
+
+    void save_deferred_frames(const std::vector<frame_ptr>& frames, std::size_t max_depth) {
+        auto& deferred = prepare_deferred_trace(max_depth);
+        deferred.count = std::min(frames.size(), max_depth);
+        std::copy(frames.begin(), frames.begin() + deferred.count, deferred.frames.begin());
+    }
+
+    bool should_capture_bounded_trace() {
+        return get_current_exception_trace_mode() == experimental::current_exception_trace_mode::bounded;
     }
 
     #if defined(_MSC_VER) && defined(CPPTRACE_UNWIND_WITH_DBGHELP)
      CPPTRACE_FORCE_NO_INLINE void collect_current_trace(std::size_t skip, EXCEPTION_POINTERS* exception_ptrs) {
          try {
+             auto bounded = should_capture_bounded_trace();
+             auto max_depth = bounded ? get_current_exception_trace_max_depth() : SIZE_MAX;
              #if defined(_M_IX86) || defined(__i386__)
               (void)skip; // don't skip any frames, the context record is at the throw point
-              auto trace = raw_trace{detail::capture_frames(0, SIZE_MAX, exception_ptrs)};
+              auto frames = detail::capture_frames(0, max_depth, exception_ptrs);
              #else
               (void)exception_ptrs;
-              auto trace = raw_trace{detail::capture_frames(skip + 1, SIZE_MAX)};
+              auto frames = detail::capture_frames(skip + 1, max_depth);
              #endif
-             save_current_trace(std::move(trace));
+             if(bounded) {
+                 save_deferred_frames(frames, max_depth);
+             } else {
+                 save_current_trace(raw_trace{std::move(frames)});
+             }
          } catch(...) {
              detail::log_and_maybe_propagate_exception(std::current_exception());
          }
@@ -62,6 +132,20 @@ namespace detail {
     #else
      CPPTRACE_FORCE_NO_INLINE void collect_current_trace(std::size_t skip) {
          try {
+             if(should_capture_bounded_trace()) {
+                 auto max_depth = get_current_exception_trace_max_depth();
+                 if(max_depth != 0 && has_safe_unwind()) {
+                     // straight into the preallocated buffer
+                     auto& deferred = prepare_deferred_trace(max_depth);
+                     deferred.count = safe_capture_frames(deferred.frames.data(), max_depth, skip + 1, max_depth);
+                 } else {
+                     save_deferred_frames(
+                         max_depth == 0 ? std::vector<frame_ptr>{} : detail::capture_frames(skip + 1, max_depth),
+                         max_depth
+                     );
+                 }
+                 return;
+             }
              auto trace = raw_trace{detail::capture_frames(skip + 1, SIZE_MAX)};
              save_current_trace(std::move(trace));
          } catch(...) {
@@ -417,26 +501,27 @@ CPPTRACE_BEGIN_NAMESPACE
     }
 
     const raw_trace& raw_trace_from_current_exception() {
-        return detail::current_exception_trace.get_raw_trace();
+        return detail::get_current_exception_trace().get_raw_trace();
     }
 
     const stacktrace& from_current_exception() {
-        return detail::current_exception_trace.get_resolved_trace();
+        return detail::get_current_exception_trace().get_resolved_trace();
     }
 
     const raw_trace& raw_trace_from_current_exception_rethrow() {
-        return detail::saved_rethrow_trace.get_raw_trace();
+        return detail::get_saved_rethrow_trace().get_raw_trace();
     }
 
     const stacktrace& from_current_exception_rethrow() {
-        return detail::saved_rethrow_trace.get_resolved_trace();
+        return detail::get_saved_rethrow_trace().get_resolved_trace();
     }
 
     bool current_exception_was_rethrown() {
-        if(detail::saved_rethrow_trace.is_resolved()) {
-            return !detail::saved_rethrow_trace.get_resolved_trace().empty();
+        auto& saved_rethrow_trace = detail::get_saved_rethrow_trace();
+        if(saved_rethrow_trace.is_resolved()) {
+            return !saved_rethrow_trace.get_resolved_trace().empty();
         } else {
-            return !detail::saved_rethrow_trace.get_raw_trace().empty();
+            return !saved_rethrow_trace.get_raw_trace().empty();
         }
     }
 
@@ -454,5 +539,7 @@ CPPTRACE_BEGIN_NAMESPACE
     void clear_current_exception_traces() {
         detail::current_exception_trace = detail::lazy_trace_holder{raw_trace{}};
         detail::saved_rethrow_trace = detail::lazy_trace_holder{raw_trace{}};
+        detail::deferred_current_trace.pending = false;
+        detail::deferred_rethrow_trace.pending = false;
     }
 CPPTRACE_END_NAMESPACE
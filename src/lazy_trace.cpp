@@ -0,0 +1,287 @@
+#include <cpptrace/lazy_trace.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "binary/object.hpp"
+#include "demangle/demangle.hpp"
+#include "logging.hpp"
+#include "symbols/symbols.hpp"
+#include "utils/common.hpp"
+#include "utils/error.hpp"
+#include "utils/utils.hpp"
+
+CPPTRACE_BEGIN_NAMESPACE
+namespace experimental {
+    class lazy_stacktrace::impl {
+        struct lazy_frame {
+            bool has_symbol = false;
+            std::string symbol;
+            bool resolved = false;
+            // most recent first
+            std::vector<stacktrace_frame> inlines;
+            stacktrace_frame frame = detail::null_frame();
+        };
+
+        std::vector<frame_ptr> addresses;
+        bool has_objects = false;
+        std::vector<object_frame> objects;
+        std::vector<lazy_frame> frames;
+        // guards all of the lazily computed state above, entries are written once and never modified afterwards
+        std::mutex mutex;
+
+        void check_index(std::size_t index) const {
+            if(index >= addresses.size()) {
+                throw detail::internal_error(
+                    "Frame index {} out of range for a trace of {} frames",
+                    index,
+                    addresses.size()
+                );
+            }
+        }
+
+        const std::vector<object_frame>& get_objects() {
+            if(!has_objects) {
+                objects = detail::get_frames_object_info(addresses);
+                has_objects = true;
+            }
+            return objects;
+        }
+
+        // group is the frame's inlined calls, most recent first, followed by the frame for the address
+        static void store(lazy_frame& entry, std::vector<stacktrace_frame>&& group) {
+            for(auto& frame : group) {
+                frame.symbol = detail::demangle(frame.symbol, true);
+            }
+            entry.frame = std::move(group.back());
+            group.pop_back();
+            entry.inlines = std::move(group);
+            entry.resolved = true;
+        }
+
+        lazy_frame& get_resolved(std::size_t index) {
+            auto& entry = frames[index];
+            if(!entry.resolved) {
+                const auto& object = get_objects()[index];
+                auto trace = detail::resolve_frames(std::vector<object_frame>{object});
+                if(trace.empty()) {
+                    trace.push_back(detail::null_frame());
+                    trace.back().raw_address = object.raw_address;
+                    trace.back().object_address = object.object_address;
+                    trace.back().filename = object.object_path;
+                }
+                store(entry, std::move(trace));
+            }
+            return entry;
+        }
+
+    public:
+        impl() = default;
+
+        explicit impl(std::vector<frame_ptr> raw_frames)
+            : addresses(std::move(raw_frames)), frames(addresses.size()) {}
+
+        explicit impl(const std::vector<object_frame>& object_frames)
+            : has_objects(true), objects(object_frames), frames(object_frames.size()) {
+            addresses.reserve(objects.size());
+            for(const auto& frame : objects) {
+                addresses.push_back(frame.raw_address);
+            }
+        }
+
+        std::size_t size() const {
+            return addresses.size();
+        }
+
+        frame_ptr raw_address(std::size_t index) const {
+            check_index(index);
+            return addresses[index];
+        }
+
+        const object_frame& object_info(std::size_t index) {
+            check_index(index);
+            std::lock_guard<std::mutex> lock(mutex);
+            return get_objects()[index];
+        }
+
+        const std::string& symbol(std::size_t index) {
+            check_index(index);
+            std::lock_guard<std::mutex> lock(mutex);
+            auto& entry = frames[index];
+            if(!entry.has_symbol) {
+                // Always prefer the symbol table so a frame's symbol doesn't depend on what else was accessed first
+                auto names = detail::lookup_symbol_table_names(std::vector<object_frame>{get_objects()[index]});
+                if(!names[0].empty()) {
+                    entry.symbol = detail::demangle(names[0], true);
+                } else {
+                    entry.symbol = get_resolved(index).frame.symbol;
+                }
+                entry.has_symbol = true;
+            }
+            return entry.symbol;
+        }
+
+        const lazy_frame& resolved(std::size_t index) {
+            check_index(index);
+            std::lock_guard<std::mutex> lock(mutex);
+            return get_resolved(index);
+        }
+
+        stacktrace resolve() {
+            std::lock_guard<std::mutex> lock(mutex);
+            const auto& object_frames = get_objects();
+            std::vector<std::size_t> pending;
+            std::vector<object_frame> batch;
+            for(std::size_t i = 0; i < frames.size(); i++) {
+                if(!frames[i].resolved) {
+                    pending.push_back(i);
+                    batch.push_back(object_frames[i]);
+                }
+            }
+            if(!batch.empty()) {
+                std::vector<std::vector<stacktrace_frame>> groups;
+                if(detail::split_inline_groups(detail::resolve_frames(batch), batch.size(), groups)) {
+                    for(std::size_t i = 0; i < pending.size(); i++) {
+                        store(frames[pending[i]], std::move(groups[i]));
+                    }
+                } else {
+                    detail::log::warn("Unexpected frame count from symbol resolution, resolving frames one at a time");
+                }
+            }
+            std::vector<stacktrace_frame> trace;
+            trace.reserve(frames.size());
+            for(std::size_t i = 0; i < frames.size(); i++) {
+                const auto& entry = get_resolved(i);
+                trace.insert(trace.end(), entry.inlines.begin(), entry.inlines.end());
+                trace.push_back(entry.frame);
+            }
+            return stacktrace{std::move(trace)};
+        }
+    };
+
+    lazy_stacktrace::lazy_stacktrace() : pimpl(new impl()) {}
+
+    lazy_stacktrace::lazy_stacktrace(const raw_trace& trace) : pimpl(new impl(trace.frames)) {}
+
+    lazy_stacktrace::lazy_stacktrace(const object_trace& trace) : pimpl(new impl(trace.frames)) {}
+
+    lazy_stacktrace::~lazy_stacktrace() {
+        delete pimpl;
+    }
+
+    lazy_stacktrace::lazy_stacktrace(lazy_stacktrace&& other) noexcept : pimpl(other.pimpl) {
+        other.pimpl = nullptr;
+    }
+
+    lazy_stacktrace& lazy_stacktrace::operator=(lazy_stacktrace&& other) noexcept {
+        if(this != &other) {
+            delete pimpl;
+            pimpl = other.pimpl;
+            other.pimpl = nullptr;
+        }
+        return *this;
+    }
+
+    CPPTRACE_FORCE_NO_INLINE
+    lazy_stacktrace lazy_stacktrace::current(std::size_t skip) {
+        try { // try/catch can never be hit but it's needed to prevent TCO
+            return lazy_stacktrace(generate_raw_trace(skip + 1));
+        } catch(...) {
+            detail::log_and_maybe_propagate_exception(std::current_exception());
+            return lazy_stacktrace{};
+        }
+    }
+
+    CPPTRACE_FORCE_NO_INLINE
+    lazy_stacktrace lazy_stacktrace::current(std::size_t skip, std::size_t max_depth) {
+        try { // try/catch can never be hit but it's needed to prevent TCO
+            return lazy_stacktrace(generate_raw_trace(skip + 1, max_depth));
+        } catch(...) {
+            detail::log_and_maybe_propagate_exception(std::current_exception());
+            return lazy_stacktrace{};
+        }
+    }
+
+    std::size_t lazy_stacktrace::size() const {
+        return pimpl->size();
+    }
+
+    bool lazy_stacktrace::empty() const {
+        return size() == 0;
+    }
+
+    frame_ptr lazy_stacktrace::raw_address(std::size_t index) const {
+        try {
+            return pimpl->raw_address(index);
+        } catch(...) {
+            detail::log_and_maybe_propagate_exception(std::current_exception());
+            return 0;
+        }
+    }
+
+    const object_frame& lazy_stacktrace::object_info(std::size_t index) const {
+        try {
+            return pimpl->object_info(index);
+        } catch(...) {
+            detail::log_and_maybe_propagate_exception(std::current_exception());
+            static const object_frame empty{0, 0, ""};
+            return empty;
+        }
+    }
+
+    const std::string& lazy_stacktrace::symbol(std::size_t index) const {
+        try {
+            return pimpl->symbol(index);
+        } catch(...) {
+            detail::log_and_maybe_propagate_exception(std::current_exception());
+            static const std::string empty;
+            return empty;
+        }
+    }
+
+    const std::string& lazy_stacktrace::filename(std::size_t index) const {
+        return frame(index).filename;
+    }
+
+    nullable<std::uint32_t> lazy_stacktrace::line(std::size_t index) const {
+        return frame(index).line;
+    }
+
+    nullable<std::uint32_t> lazy_stacktrace::column(std::size_t index) const {
+        return frame(index).column;
+    }
+
+    const std::vector<stacktrace_frame>& lazy_stacktrace::inlines(std::size_t index) const {
+        try {
+            return pimpl->resolved(index).inlines;
+        } catch(...) {
+            detail::log_and_maybe_propagate_exception(std::current_exception());
+            static const std::vector<stacktrace_frame> empty;
+            return empty;
+        }
+    }
+
+    const stacktrace_frame& lazy_stacktrace::frame(std::size_t index) const {
+        try {
+            return pimpl->resolved(index).frame;
+        } catch(...) {
+            detail::log_and_maybe_propagate_exception(std::current_exception());
+            static const stacktrace_frame empty = detail::null_frame();
+            return empty;
+        }
+    }
+
+    stacktrace lazy_stacktrace::resolve() const {
+        try {
+            return pimpl->resolve();
+        } catch(...) {
+            detail::log_and_maybe_propagate_exception(std::current_exception());
+            return stacktrace{};
+        }
+    }
+}
+CPPTRACE_END_NAMESPACE
@@ -1,14 +1,20 @@
 #include <cpptrace/basic.hpp>
+#include <cpptrace/from_current.hpp>
 
 #include "options.hpp"
 
 #include <atomic>
+#include <cstddef>
 
 CPPTRACE_BEGIN_NAMESPACE
 namespace detail {
     std::atomic_bool absorb_trace_exceptions(true); // NOSONAR
     std::atomic_bool resolve_inlined_calls(true); // NOSONAR
     std::atomic<cache_mode> current_cache_mode(cache_mode::prioritize_speed); // NOSONAR
+    std::atomic<experimental::current_exception_trace_mode> current_exception_trace_mode( // NOSONAR
+        experimental::current_exception_trace_mode::full
+    );
+    std::atomic<std::size_t> current_exception_trace_max_depth(0); // NOSONAR
 
     bool should_absorb_trace_exceptions() {
         return absorb_trace_exceptions;
@@ -21,6 +27,14 @@ namespace detail {
     cache_mode get_cache_mode() {
         return current_cache_mode;
     }
+
+    experimental::current_exception_trace_mode get_current_exception_trace_mode() {
+        return current_exception_trace_mode;
+    }
+
+    std::size_t get_current_exception_trace_max_depth() {
+        return current_exception_trace_max_depth;
+    }
 }
 CPPTRACE_END_NAMESPACE
 
@@ -37,5 +51,10 @@ CPPTRACE_BEGIN_NAMESPACE
         void set_cache_mode(cache_mode mode) {
             detail::current_cache_mode = mode;
         }
+
+        void set_current_exception_trace_mode(current_exception_trace_mode mode, std::size_t max_depth) {
+            detail::current_exception_trace_max_depth = max_depth;
+            detail::current_exception_trace_mode = mode;
+        }
     }
 CPPTRACE_END_NAMESPACE
@@ -1,14 +1,19 @@
 #ifndef OPTIONS_HPP
 #define OPTIONS_HPP
 
+#include <cpptrace/from_current.hpp>
 #include <cpptrace/utils.hpp>
 
+#include <cstddef>
+
 CPPTRACE_BEGIN_NAMESPACE
 namespace detail {
     // exported for test purposes
     CPPTRACE_EXPORT bool should_absorb_trace_exceptions();
     bool should_resolve_inlined_calls();
     cache_mode get_cache_mode();
+    experimental::current_exception_trace_mode get_current_exception_trace_mode();
+    std::size_t get_current_exception_trace_max_depth();
 }
 CPPTRACE_END_NAMESPACE
 
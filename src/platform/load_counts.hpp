@@ -0,0 +1,47 @@
+#ifndef LOAD_COUNTS_HPP
+#define LOAD_COUNTS_HPP
+
+#include "platform/platform.hpp"
+
+#include <cstddef>
+
+#if IS_LINUX
+ #include <link.h>
+#endif
+
+CPPTRACE_BEGIN_NAMESPACE
+namespace detail {
+    // dl_iterate_phdr's counters of objects loaded and unloaded, these change whenever the set of loaded objects does
+    struct load_counts {
+        unsigned long long adds;
+        unsigned long long subs;
+        bool operator==(const load_counts& other) const {
+            return adds == other.adds && subs == other.subs;
+        }
+        bool operator!=(const load_counts& other) const {
+            return !(*this == other);
+        }
+    };
+
+    // Cheap, only the first object is visited. Always zero where the counters aren't available.
+    inline load_counts get_load_counts() {
+        load_counts counts{0, 0};
+        #if IS_LINUX
+        dl_iterate_phdr(
+            [] (dl_phdr_info* info, std::size_t size, void* data) {
+                if(size >= offsetof(dl_phdr_info, dlpi_subs) + sizeof(info->dlpi_subs)) {
+                    auto& counts = *static_cast<load_counts*>(data);
+                    counts.adds = info->dlpi_adds;
+                    counts.subs = info->dlpi_subs;
+                }
+                return 1;
+            },
+            &counts
+        );
+        #endif
+        return counts;
+    }
+}
+CPPTRACE_END_NAMESPACE
+
+#endif
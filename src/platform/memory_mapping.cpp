@@ -1,5 +1,6 @@
 #include "platform/memory_mapping.hpp"
 
+#include "platform/load_counts.hpp"
 #include "utils/optional.hpp"
 #include "utils/utils.hpp"
 
@@ -19,8 +20,13 @@
    #include <mach/mach_vm.h>
   #endif
  #else
-  #include <fstream>
-  #include <ios>
+  #include <cerrno>
+  #include <cstddef>
+  #include <cstring>
+  #include <mutex>
+  #include <vector>
+
+  #include <fcntl.h>
  #endif
 #endif
 
@@ -127,122 +133,224 @@ namespace detail {
     //      life of the smaps/maps walk, there will be some output for it.
     //
     //   https://www.kernel.org/doc/Documentation/filesystems/proc.txt
-    // Ideally we could do everything as a single read() call but I don't think that's practical, especially given that
-    // the kernel has limited buffers internally. While we shouldn't be modifying mapped memory while reading
-    // /proc/self/maps here, it's theoretically possible that we could allocate and that could go to the OS for more
-    // pages.
+    // We read the whole file up front into a buffer sized from the previous load, so usually this is a single read()
+    // call, and only parse it afterwards. That way nothing we do while parsing, e.g. allocating, can change the maps
+    // mid-read. A single read isn't guaranteed though, the kernel has limited buffers internally and will return short
+    // reads for large maps.
     // While reading this is inherently racy, as far as I can tell tears don't happen within a line but they can happen
     // between lines.
     // The code that writes /proc/pid/maps:
     // - https://github.com/torvalds/linux/blob/3d0ebc36b0b3e8486ceb6e08e8ae173aaa6d1221/fs/proc/task_mmu.c#L304-L365
+    // from_current support looks up protections once per CPPTRACE_CATCH type, mostly during static initialization, so
+    // the parsed region list is cached. The cache is refreshed when objects are loaded or unloaded and when a lookup
+    // misses, e.g. for memory mapped after the last load, and our own mprotect calls are applied to it directly.
 
-    struct address_range {
-        uintptr_t low;
-        uintptr_t high;
-        int perms;
-        bool operator<(const address_range& other) const {
-            return low < other.low;
-        }
-    };
+    void close_fd(int fd) {
+        close(fd);
+    }
 
-    // returns nullopt on eof
-    optional<address_range> read_map_entry(std::ifstream& stream) {
-        uintptr_t start;
-        uintptr_t stop;
-        stream>>start;
-        stream.ignore(1); // dash
-        stream>>stop;
-        if(stream.eof()) {
-            return nullopt;
+    // reads all of /proc/self/maps into buffer, growing it as needed, and returns the number of bytes read
+    std::size_t read_proc_self_maps(std::vector<char>& buffer) {
+        int fd = open("/proc/self/maps", O_RDONLY | O_CLOEXEC);
+        if(fd == -1) {
+            throw internal_error("Failed to open /proc/self/maps: {}", strerror(errno));
         }
-        if(stream.fail()) {
-            throw internal_error("Failure reading /proc/self/maps");
+        auto fd_guard = raii_wrap(fd, close_fd);
+        if(buffer.empty()) {
+            buffer.resize(16 * 1024);
         }
-        stream.ignore(1); // space
-        char r, w, x; // there's a private/shared flag after these but we don't need it
-        stream>>r>>w>>x;
-        if(stream.fail() || stream.eof()) {
+        std::size_t size = 0;
+        while(true) {
+            if(size == buffer.size()) {
+                buffer.resize(buffer.size() * 2);
+            }
+            auto count = read(fd, buffer.data() + size, buffer.size() - size);
+            if(count == 0) {
+                return size;
+            }
+            if(count < 0) {
+                if(errno == EINTR) {
+                    continue;
+                }
+                throw internal_error("Failure reading /proc/self/maps: {}", strerror(errno));
+            }
+            size += static_cast<std::size_t>(count);
+        }
+    }
+
+    // parses lowercase hex digits, the kernel writes addresses with %lx
+    bool parse_hex(const char*& it, const char* end, uintptr_t& out) {
+        const char* start = it;
+        uintptr_t value = 0;
+        for(; it != end; it++) {
+            unsigned digit;
+            if(*it >= '0' && *it <= '9') {
+                digit = *it - '0';
+            } else if(*it >= 'a' && *it <= 'f') {
+                digit = *it - 'a' + 10;
+            } else {
+                break;
+            }
+            value = value << 4 | digit;
+        }
+        out = value;
+        return it != start;
+    }
+
+    address_range parse_map_entry(const char*& it, const char* end) {
+        uintptr_t low;
+        uintptr_t high;
+        if(
+            !parse_hex(it, end, low)
+            || it == end || *it++ != '-'
+            || !parse_hex(it, end, high)
+            || it == end || *it++ != ' '
+            || end - it < 3 // there's a private/shared flag after rwx but we don't need it
+        ) {
             throw internal_error("Failure reading /proc/self/maps");
         }
         int perms = 0;
-        if(r == 'r') {
+        if(it[0] == 'r') {
             perms |= PROT_READ;
         }
-        if(w == 'w') {
+        if(it[1] == 'w') {
             perms |= PROT_WRITE;
         }
-        if(x == 'x') {
+        if(it[2] == 'x') {
             perms |= PROT_EXEC;
         }
-        stream.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-        return address_range{start, stop, perms};
+        auto newline = static_cast<const char*>(std::memchr(it, '\n', end - it));
+        it = newline ? newline + 1 : end;
+        return address_range{low, high, perms};
     }
 
-    // returns a vector or nullopt if a tear is detected
-    optional<std::vector<address_range>> try_load_mapped_region_info() {
-        std::ifstream stream("/proc/self/maps");
-        stream>>std::hex;
-        std::vector<address_range> ranges;
-        while(auto entry = read_map_entry(stream)) {
-            const auto& range = entry.unwrap();
+    // returns false if a tear is detected
+    bool try_load_mapped_region_info(std::vector<char>& buffer, std::vector<address_range>& ranges) {
+        auto size = read_proc_self_maps(buffer);
+        ranges.clear();
+        const char* it = buffer.data();
+        const char* end = it + size;
+        while(it != end) {
+            auto range = parse_map_entry(it, end);
             VERIFY(range.low <= range.high);
-            if(!ranges.empty()) {
-                const auto& last_range = ranges.back();
-                if(range.low < last_range.high) {
-                    return nullopt;
-                }
+            if(!ranges.empty() && range.low < ranges.back().high) {
+                return false;
             }
             ranges.push_back(range);
         }
-        return ranges;
+        return true;
     }
 
     // we can allocate during try_load_mapped_region_info, in theory that could cause a tear
-    optional<std::vector<address_range>> try_load_mapped_region_info_with_retries(int n) {
+    void load_mapped_region_info_with_retries(
+        std::vector<char>& buffer,
+        std::vector<address_range>& ranges,
+        int n
+    ) {
         VERIFY(n > 0);
         for(int i = 0; i < n; i++) {
-            if(auto info = try_load_mapped_region_info()) {
-                return info;
+            if(try_load_mapped_region_info(buffer, ranges)) {
+                return;
             }
         }
+        ranges.clear();
         throw internal_error("Couldn't successfully load /proc/self/maps after {} retries", n);
     }
 
-    const std::vector<address_range>& load_mapped_region_info() {
-        static std::vector<address_range> regions;
-        static bool has_loaded = false;
-        if(!has_loaded) {
-            has_loaded = true;
-            if(auto info = try_load_mapped_region_info_with_retries(2)) {
-                regions = std::move(info).unwrap();
+    void mapped_region_cache::reload() {
+        counts = get_load_counts();
+        loaded = false;
+        load_mapped_region_info_with_retries(buffer, regions, 2);
+        loaded = true;
+    }
+
+    optional<int> mapped_region_cache::find(uintptr_t address) const {
+        auto it = first_less_than_or_equal(
+            regions.begin(),
+            regions.end(),
+            address,
+            [](uintptr_t a, const address_range& b) {
+                return a < b.low;
             }
+        );
+        if(it == regions.end() || address >= it->high) {
+            return nullopt;
         }
-        return regions;
+        return it->perms;
     }
 
-    int get_page_protections(void* page) {
-        const auto& mapped_region_info = load_mapped_region_info();
+    void mapped_region_cache::set_protections(uintptr_t low, uintptr_t high, int perms) {
+        if(!loaded) {
+            return;
+        }
         auto it = first_less_than_or_equal(
-            mapped_region_info.begin(),
-            mapped_region_info.end(),
-            reinterpret_cast<uintptr_t>(page),
+            regions.begin(),
+            regions.end(),
+            low,
             [](uintptr_t a, const address_range& b) {
                 return a < b.low;
             }
         );
-        if(it == mapped_region_info.end()) {
-            throw internal_error(
-                "Failed to find mapping for {>16:0h} in /proc/self/maps",
-                reinterpret_cast<uintptr_t>(page)
-            );
+        if(it == regions.end() || low >= it->high) {
+            // not mapped when the cache was loaded, a lookup will miss and reload
+            return;
         }
-        return it->perms;
+        if(high > it->high) {
+            // spans multiple ranges, not worth splicing
+            loaded = false;
+            return;
+        }
+        if(it->perms == perms) {
+            return;
+        }
+        address_range before{it->low, low, it->perms};
+        address_range after{high, it->high, it->perms};
+        *it = address_range{low, high, perms};
+        if(after.low < after.high) {
+            it = regions.insert(it + 1, after) - 1;
+        }
+        if(before.low < before.high) {
+            regions.insert(it, before);
+        }
+    }
+
+    mapped_region_cache& get_mapped_region_cache() {
+        static mapped_region_cache cache;
+        return cache;
+    }
+
+    int get_page_protections(void* page) {
+        auto address = reinterpret_cast<uintptr_t>(page);
+        auto& cache = get_mapped_region_cache();
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        if(!cache.loaded || get_load_counts() != cache.counts) {
+            cache.reload();
+        }
+        auto perms = cache.find(address);
+        if(!perms) {
+            cache.reload();
+            perms = cache.find(address);
+        }
+        if(!perms) {
+            throw internal_error("Failed to find mapping for {>16:0h} in /proc/self/maps", address);
+        }
+        return perms.unwrap();
+    }
+
+    void note_page_protections(void* page, int page_size, int protections) {
+        auto address = reinterpret_cast<uintptr_t>(page);
+        auto& cache = get_mapped_region_cache();
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        cache.set_protections(address, address + page_size, protections);
     }
     #endif
     void mprotect_page(void* page, int page_size, int protections) {
         if(mprotect(page, page_size, protections) != 0) {
             throw internal_error("mprotect call failed: {}", strerror(errno));
         }
+        #if !IS_APPLE
+         note_page_protections(page, page_size, protections);
+        #endif
     }
     int mprotect_page_and_return_old_protections(void* page, int page_size, int protections) {
         auto old_protections = get_page_protections(page);
@@ -1,3 +1,6 @@
+#ifndef MEMORY_MAPPING_HPP
+#define MEMORY_MAPPING_HPP
+
 #include "utils/common.hpp"
 
 #ifndef _MSC_VER
@@ -9,6 +12,14 @@
  #include <windows.h>
 #else
  #include <sys/mman.h>
+ #if !IS_APPLE
+  #include <cstdint>
+  #include <mutex>
+  #include <vector>
+
+  #include "platform/load_counts.hpp"
+  #include "utils/optional.hpp"
+ #endif
 #endif
 
 CPPTRACE_BEGIN_NAMESPACE
@@ -24,7 +35,38 @@ namespace detail {
     int mprotect_page_and_return_old_protections(void* page, int page_size, int protections);
     void mprotect_page(void* page, int page_size, int protections);
     void* allocate_page(int page_size);
+
+    #if !IS_WINDOWS && !IS_APPLE
+    struct address_range {
+        uintptr_t low;
+        uintptr_t high;
+        int perms;
+        bool operator<(const address_range& other) const {
+            return low < other.low;
+        }
+    };
+
+    // Parses one line of /proc/self/maps, "low-high rwxp offset dev inode path", and advances it past the newline.
+    // Exported for test purposes.
+    CPPTRACE_EXPORT address_range parse_map_entry(const char*& it, const char* end);
+
+    // The parsed contents of /proc/self/maps, see memory_mapping.cpp. Exported for test purposes.
+    struct CPPTRACE_EXPORT mapped_region_cache {
+        std::mutex mutex;
+        std::vector<char> buffer;
+        std::vector<address_range> regions;
+        load_counts counts{0, 0};
+        bool loaded = false;
+
+        void reload();
+        optional<int> find(uintptr_t address) const;
+        // keeps the cached ranges in sync with our own mprotect calls
+        void set_protections(uintptr_t low, uintptr_t high, int perms);
+    };
+    #endif
 }
 CPPTRACE_END_NAMESPACE
 
 #endif
+
+#endif
@@ -0,0 +1,303 @@
+#include "platform/thread_capture.hpp"
+
+#include "logging.hpp"
+#include "platform/platform.hpp"
+#include "unwind/unwind.hpp"
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+
+#if IS_LINUX
+ #include <csignal>
+ #include <ctime>
+ #include <fcntl.h>
+ #include <sys/syscall.h>
+ #include <unistd.h>
+#endif
+
+CPPTRACE_BEGIN_NAMESPACE
+namespace detail {
+    thread_capture::thread_capture(std::size_t max_threads, std::size_t max_depth, int signal)
+        : threads(new captured_thread[max_threads]),
+          frame_storage(new frame_ptr[max_threads * max_depth]),
+          max_threads(max_threads),
+          max_depth(max_depth),
+          signal(signal) {
+        for(std::size_t i = 0; i < max_threads; i++) {
+            threads[i].frames = &frame_storage[i * max_depth];
+        }
+    }
+
+    void thread_capture::reset() {
+        for(std::size_t i = 0; i < max_threads; i++) {
+            threads[i].state.store(captured_thread::unused);
+            threads[i].depth = 0;
+            threads[i].name[0] = 0;
+        }
+        count = 0;
+        omitted = 0;
+    }
+
+#if IS_LINUX
+    std::atomic<thread_capture*> active_thread_capture{nullptr};
+    // number of capture signal handlers currently running, so a capture isn't reused out from under one of them
+    std::atomic<std::size_t> active_capture_handlers{0};
+    // bit n - 1 is set once the handler is installed for signal n
+    std::atomic<std::uint64_t> installed_capture_signals{0};
+
+    std::uint64_t capture_signal_bit(int signal) {
+        return signal > 0 && signal <= 64 ? std::uint64_t(1) << (signal - 1) : 0;
+    }
+
+    long current_thread_id() {
+        return syscall(SYS_gettid);
+    }
+
+    long monotonic_ms() {
+        timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return now.tv_sec * 1000 + now.tv_nsec / 1000000;
+    }
+
+    void sleep_briefly() {
+        timespec duration{0, 100000};
+        nanosleep(&duration, nullptr);
+    }
+
+    // Returns 0 for anything that isn't a thread id, e.g. . and ..
+    long parse_thread_id(const char* name) {
+        long value = 0;
+        for(; *name; name++) {
+            if(*name < '0' || *name > '9') {
+                return 0;
+            }
+            value = value * 10 + (*name - '0');
+        }
+        return value;
+    }
+
+    void read_thread_name(long thread_id, char* name, std::size_t size) {
+        name[0] = 0;
+        char path[64] = "/proc/self/task/";
+        std::size_t length = std::strlen(path);
+        char digits[20];
+        std::size_t n = 0;
+        do {
+            digits[n++] = static_cast<char>('0' + thread_id % 10);
+            thread_id /= 10;
+        } while(thread_id > 0);
+        while(n > 0) {
+            path[length++] = digits[--n];
+        }
+        std::memcpy(path + length, "/comm", sizeof("/comm"));
+        int fd = open(path, O_RDONLY | O_CLOEXEC);
+        if(fd < 0) {
+            return;
+        }
+        auto read_size = read(fd, name, size - 1);
+        close(fd);
+        if(read_size > 0) {
+            auto end = static_cast<std::size_t>(read_size);
+            if(name[end - 1] == '\n') {
+                end--;
+            }
+            name[end] = 0;
+        }
+    }
+
+    void thread_capture_signal_handler(int, siginfo_t*, void*) {
+        int saved_errno = errno;
+        active_capture_handlers.fetch_add(1);
+        auto capture = active_thread_capture.load();
+        if(capture) {
+            // skip this handler and the signal trampoline
+            capture->record_current_thread(2);
+        }
+        active_capture_handlers.fetch_sub(1);
+        errno = saved_errno;
+    }
+
+    int get_capture_signal(int signal) {
+        return signal != 0 ? signal : SIGRTMIN + 4;
+    }
+
+    bool install_thread_capture_handler(int signal) {
+        static std::mutex install_mutex;
+        std::lock_guard<std::mutex> lock(install_mutex);
+        auto bit = capture_signal_bit(signal);
+        if(bit == 0) {
+            return false;
+        }
+        if(installed_capture_signals.load() & bit) {
+            return true;
+        }
+        struct sigaction current;
+        if(sigaction(signal, nullptr, &current) != 0) {
+            return false;
+        }
+        if((current.sa_flags & SA_SIGINFO) || current.sa_handler != SIG_DFL) {
+            log::error("Signal {} is already in use, not using it to capture threads", signal);
+            return false;
+        }
+        struct sigaction action{};
+        action.sa_sigaction = thread_capture_signal_handler;
+        action.sa_flags = SA_SIGINFO | SA_RESTART;
+        sigemptyset(&action.sa_mask);
+        if(sigaction(signal, &action, nullptr) != 0) {
+            return false;
+        }
+        installed_capture_signals.fetch_or(bit);
+        return true;
+    }
+
+    void thread_capture::record_current_thread(std::size_t skip) {
+        auto self = current_thread_id();
+        for(std::size_t i = 0; i < max_threads; i++) {
+            auto& thread = threads[i];
+            if(thread.state.load(std::memory_order_acquire) != captured_thread::requested || thread.thread_id != self) {
+                continue;
+            }
+            int expected = captured_thread::requested;
+            if(thread.state.compare_exchange_strong(expected, captured_thread::capturing, std::memory_order_acquire)) {
+                thread.depth = safe_capture_frames(thread.frames, max_depth, skip + 1, max_depth);
+                thread.state.store(captured_thread::captured, std::memory_order_release);
+            }
+            return;
+        }
+    }
+
+    void thread_capture::request_thread(long thread_id) {
+        if(count == max_threads) {
+            omitted++;
+            return;
+        }
+        auto& thread = threads[count];
+        thread.thread_id = thread_id;
+        thread.depth = 0;
+        read_thread_name(thread_id, thread.name, sizeof(thread.name));
+        thread.state.store(captured_thread::requested, std::memory_order_release);
+        if(syscall(SYS_tgkill, getpid(), thread_id, signal) != 0) {
+            // the thread has exited since the task directory was read
+            thread.state.store(captured_thread::unused);
+            return;
+        }
+        count++;
+    }
+
+    void thread_capture::wait(long timeout_ms) {
+        auto deadline = monotonic_ms() + timeout_ms;
+        for(;;) {
+            bool pending = false;
+            for(std::size_t i = 0; i < count && !pending; i++) {
+                auto state = threads[i].state.load(std::memory_order_acquire);
+                pending = state == captured_thread::requested || state == captured_thread::capturing;
+            }
+            if(!pending || monotonic_ms() >= deadline) {
+                break;
+            }
+            sleep_briefly();
+        }
+        for(std::size_t i = 0; i < count; i++) {
+            int expected = captured_thread::requested;
+            if(!threads[i].state.compare_exchange_strong(expected, captured_thread::missed)) {
+                // a thread that has started capturing finishes quickly, unwinding is bounded by max_depth
+                while(threads[i].state.load(std::memory_order_acquire) == captured_thread::capturing) {
+                    sleep_briefly();
+                }
+            }
+        }
+    }
+
+    // a linux_dirent64, glibc doesn't declare it
+    struct task_entry {
+        std::uint64_t inode;
+        std::int64_t offset;
+        unsigned short record_length;
+        unsigned char type;
+        char name[1];
+    };
+
+    void thread_capture::record_calling_thread(std::size_t skip) {
+        reset();
+        auto self = current_thread_id();
+        auto& current = threads[0];
+        current.thread_id = self;
+        read_thread_name(self, current.name, sizeof(current.name));
+        current.depth = safe_capture_frames(current.frames, max_depth, skip + 1, max_depth);
+        current.state.store(captured_thread::captured);
+        count = 1;
+    }
+
+    bool thread_capture::capture_calling_thread(std::size_t skip) {
+        record_calling_thread(skip + 1);
+        return true;
+    }
+
+    bool thread_capture::capture(std::size_t skip, long timeout_ms) {
+        if(!(installed_capture_signals.load() & capture_signal_bit(signal))) {
+            return false;
+        }
+        thread_capture* expected = nullptr;
+        if(!active_thread_capture.compare_exchange_strong(expected, this)) {
+            return false;
+        }
+        record_calling_thread(skip + 1);
+        auto self = threads[0].thread_id;
+        int fd = open("/proc/self/task", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if(fd >= 0) {
+            alignas(task_entry) char buffer[1024];
+            long size;
+            while((size = syscall(SYS_getdents64, fd, buffer, sizeof(buffer))) > 0) {
+                for(long offset = 0; offset < size;) {
+                    const auto* entry = reinterpret_cast<const task_entry*>(buffer + offset);
+                    offset += entry->record_length;
+                    auto thread_id = parse_thread_id(entry->name);
+                    if(thread_id != 0 && thread_id != self) {
+                        request_thread(thread_id);
+                    }
+                }
+            }
+            close(fd);
+        }
+        wait(timeout_ms);
+        active_thread_capture.store(nullptr);
+        while(active_capture_handlers.load() != 0) {
+            sleep_briefly();
+        }
+        return true;
+    }
+#else
+    long current_thread_id() {
+        return 0;
+    }
+
+    int get_capture_signal(int signal) {
+        return signal;
+    }
+
+    bool install_thread_capture_handler(int) {
+        return false;
+    }
+
+    void thread_capture::record_current_thread(std::size_t) {}
+
+    void thread_capture::record_calling_thread(std::size_t) {}
+
+    void thread_capture::request_thread(long) {}
+
+    void thread_capture::wait(long) {}
+
+    bool thread_capture::capture(std::size_t, long) {
+        return false;
+    }
+
+    bool thread_capture::capture_calling_thread(std::size_t) {
+        return false;
+    }
+#endif
+}
+CPPTRACE_END_NAMESPACE
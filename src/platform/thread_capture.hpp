@@ -0,0 +1,83 @@
+#ifndef THREAD_CAPTURE_HPP
+#define THREAD_CAPTURE_HPP
+
+#include <cpptrace/basic.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+CPPTRACE_BEGIN_NAMESPACE
+namespace detail {
+    struct captured_thread {
+        enum capture_state : int { unused, requested, capturing, captured, missed };
+        std::atomic<int> state{unused};
+        long thread_id = 0;
+        // From /proc/self/task/<tid>/comm, null terminated
+        char name[16] = {};
+        frame_ptr* frames = nullptr;
+        std::size_t depth = 0;
+    };
+
+    // Stacks of every thread in the process, captured from a signal handler. All storage is allocated up front so a
+    // capture neither allocates nor locks. The calling thread records its own stack, every other thread is interrupted
+    // with tgkill and records its stack from a signal handler. Requires signal-safe unwinding for non-empty traces, see
+    // can_signal_safe_unwind(). Linux only.
+    class thread_capture {
+        std::unique_ptr<captured_thread[]> threads;
+        std::unique_ptr<frame_ptr[]> frame_storage;
+        std::size_t max_threads;
+        std::size_t max_depth;
+        // Sent to the other threads, install_thread_capture_handler must have been called for it
+        int signal;
+        std::size_t count = 0;
+        // Threads beyond max_threads, not captured
+        std::size_t omitted = 0;
+
+        void reset();
+        CPPTRACE_FORCE_NO_INLINE void record_calling_thread(std::size_t skip);
+        void request_thread(long thread_id);
+        void wait(long timeout_ms);
+
+    public:
+        thread_capture(std::size_t max_threads, std::size_t max_depth, int signal);
+
+        // Signal-safe. Threads that don't respond within the timeout, e.g. because they block the capture signal, are
+        // marked missed and have no frames. Returns false if capturing isn't supported or another capture is in
+        // progress. Frames of the calling thread are skipped as with safe_generate_raw_trace.
+        CPPTRACE_FORCE_NO_INLINE bool capture(std::size_t skip, long timeout_ms);
+
+        // Signal-safe. Captures only the calling thread, for when a full capture isn't possible because another one is
+        // in progress. Returns false if capturing isn't supported.
+        CPPTRACE_FORCE_NO_INLINE bool capture_calling_thread(std::size_t skip);
+
+        // Called from the capture signal handler
+        CPPTRACE_FORCE_NO_INLINE void record_current_thread(std::size_t skip);
+
+        std::size_t size() const {
+            return count;
+        }
+        std::size_t omitted_threads() const {
+            return omitted;
+        }
+        const captured_thread& operator[](std::size_t index) const {
+            return threads[index];
+        }
+        std::size_t depth_limit() const {
+            return max_depth;
+        }
+    };
+
+    // The capture signal to use for a configured one, 0 selects SIGRTMIN + 4. Not signal-safe.
+    int get_capture_signal(int signal);
+
+    // Installs the handler for a capture signal. Called before the first capture with that signal, not signal-safe.
+    // Fails without touching the signal if something else already handles it.
+    bool install_thread_capture_handler(int signal);
+
+    // Signal-safe
+    long current_thread_id();
+}
+CPPTRACE_END_NAMESPACE
+
+#endif
@@ -0,0 +1,295 @@
+#include <cpptrace/profiling.hpp>
+#include <cpptrace/trace_table.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "profiling/profiling.hpp"
+#include "logging.hpp"
+#include "unwind/unwind.hpp"
+#include "utils/error.hpp"
+#include "utils/utils.hpp"
+
+CPPTRACE_BEGIN_NAMESPACE
+namespace detail {
+    class allocation_recorder {
+        mutable std::mutex mutex;
+        // indexed by stack id
+        std::vector<experimental::allocation_site> sites;
+    public:
+        std::size_t interval = 512 * 1024;
+        std::size_t max_depth = 64;
+        experimental::trace_table table;
+
+        void record(std::vector<frame_ptr> frames, std::size_t size, std::size_t estimated_bytes) {
+            auto id = table.insert(frames.data(), frames.size());
+            if(id == nullable<experimental::stack_id>::null_value()) {
+                return;
+            }
+            std::unique_lock<std::mutex> lock(mutex);
+            if(id >= sites.size()) {
+                auto old_size = sites.size();
+                sites.resize(id + 1);
+                for(auto i = old_size; i < sites.size(); i++) {
+                    sites[i] = {static_cast<std::uint32_t>(i), 0, 0, 0};
+                }
+            }
+            auto& site = sites[id];
+            site.sampled_count++;
+            site.sampled_bytes += size;
+            site.estimated_bytes += estimated_bytes;
+        }
+
+        std::vector<experimental::allocation_site> get_sites() const {
+            std::vector<experimental::allocation_site> result;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                for(const auto& site : sites) {
+                    if(site.sampled_count != 0) {
+                        result.push_back(site);
+                    }
+                }
+            }
+            std::stable_sort(
+                result.begin(),
+                result.end(),
+                [] (const experimental::allocation_site& a, const experimental::allocation_site& b) {
+                    return a.estimated_bytes > b.estimated_bytes;
+                }
+            );
+            return result;
+        }
+
+        void clear() {
+            std::unique_lock<std::mutex> lock(mutex);
+            sites.clear();
+        }
+    };
+
+    std::atomic<allocation_recorder*> active_allocation_recorder{nullptr};
+    std::atomic<std::size_t> active_allocation_records{0};
+
+    struct allocation_sampling_state {
+        // bytes left before the next sample, negative when not yet initialized
+        std::int64_t bytes_until_sample = -1;
+        std::minstd_rand rng;
+        bool in_record = false;
+
+        allocation_sampling_state() : rng(std::hash<std::thread::id>{}(std::this_thread::get_id())) {}
+
+        std::int64_t next_interval(std::size_t interval) {
+            // exponentially distributed intervals make every byte equally likely to be sampled
+            std::exponential_distribution<double> distribution(1.0 / static_cast<double>(interval));
+            return static_cast<std::int64_t>(distribution(rng)) + 1;
+        }
+    };
+
+    allocation_sampling_state& get_allocation_sampling_state() {
+        static thread_local allocation_sampling_state state;
+        return state;
+    }
+
+    // Returns the estimated number of bytes the sample represents, or 0 if the allocation isn't sampled
+    std::size_t sample_allocation(allocation_sampling_state& state, std::size_t size, std::size_t interval) {
+        if(interval == 0) {
+            return size;
+        }
+        if(state.bytes_until_sample < 0) {
+            state.bytes_until_sample = state.next_interval(interval);
+        }
+        state.bytes_until_sample -= static_cast<std::int64_t>(size);
+        if(state.bytes_until_sample > 0) {
+            return 0;
+        }
+        state.bytes_until_sample = state.next_interval(interval);
+        // an allocation of this size is sampled with probability 1 - e^(-size/interval), scale by the inverse
+        double probability = 1 - std::exp(-static_cast<double>(size) / static_cast<double>(interval));
+        return static_cast<std::size_t>(static_cast<double>(size) / probability);
+    }
+}
+
+namespace experimental {
+    class allocation_profiler::impl {
+        std::unique_ptr<detail::allocation_recorder> recorder{new detail::allocation_recorder};
+        bool running = false;
+
+    public:
+        void sample_interval(std::size_t bytes) {
+            if(!running) {
+                recorder->interval = bytes;
+            }
+        }
+
+        void max_depth(std::size_t depth) {
+            if(!running) {
+                recorder->max_depth = std::max<std::size_t>(1, std::min(depth, detail::hard_max_frames));
+            }
+        }
+
+        bool start() {
+            if(running) {
+                return false;
+            }
+            detail::allocation_recorder* expected = nullptr;
+            if(!detail::active_allocation_recorder.compare_exchange_strong(expected, recorder.get())) {
+                return false;
+            }
+            running = true;
+            return true;
+        }
+
+        void stop() {
+            if(!running) {
+                return;
+            }
+            detail::active_allocation_recorder.store(nullptr);
+            while(detail::active_allocation_records.load() != 0) {
+                std::this_thread::yield();
+            }
+            running = false;
+        }
+
+        bool is_running() const {
+            return running;
+        }
+
+        void clear() {
+            recorder->clear();
+        }
+
+        std::vector<allocation_site> sites() const {
+            return recorder->get_sites();
+        }
+
+        const stacktrace& resolve(std::uint32_t stack_id) const {
+            return recorder->table.resolve(stack_id);
+        }
+
+        void write_folded_stacks(std::ostream& stream) const {
+            std::map<std::string, std::size_t> lines;
+            std::vector<std::string> names;
+            for(const auto& site : sites()) {
+                names.clear();
+                for(const auto& frame : resolve(site.stack_id).frames) {
+                    names.push_back(detail::folded_frame_name(frame));
+                }
+                lines[detail::join_folded_stack(names)] += site.estimated_bytes;
+            }
+            for(const auto& line : lines) {
+                stream << line.first << ' ' << line.second << '\n';
+            }
+        }
+
+        ~impl() {
+            stop();
+        }
+    };
+
+    allocation_profiler::allocation_profiler() : pimpl(new impl) {}
+
+    allocation_profiler::~allocation_profiler() {
+        delete pimpl;
+    }
+
+    allocation_profiler& allocation_profiler::sample_interval(std::size_t bytes) {
+        pimpl->sample_interval(bytes);
+        return *this;
+    }
+
+    allocation_profiler& allocation_profiler::max_depth(std::size_t depth) {
+        pimpl->max_depth(depth);
+        return *this;
+    }
+
+    bool allocation_profiler::start() {
+        return pimpl->start();
+    }
+
+    void allocation_profiler::stop() {
+        pimpl->stop();
+    }
+
+    bool allocation_profiler::is_running() const {
+        return pimpl->is_running();
+    }
+
+    void allocation_profiler::clear() {
+        pimpl->clear();
+    }
+
+    std::vector<allocation_site> allocation_profiler::sites() const {
+        try {
+            return pimpl->sites();
+        } catch(...) {
+            detail::log_and_maybe_propagate_exception(std::current_exception());
+            return {};
+        }
+    }
+
+    stacktrace allocation_profiler::resolve(std::uint32_t stack_id) const {
+        try {
+            return pimpl->resolve(stack_id);
+        } catch(...) {
+            detail::log_and_maybe_propagate_exception(std::current_exception());
+            return stacktrace{};
+        }
+    }
+
+    std::string allocation_profiler::folded_stacks() const {
+        std::ostringstream stream;
+        write_folded_stacks(stream);
+        return stream.str();
+    }
+
+    void allocation_profiler::write_folded_stacks(std::ostream& stream) const {
+        try {
+            pimpl->write_folded_stacks(stream);
+        } catch(...) {
+            detail::log_and_maybe_propagate_exception(std::current_exception());
+        }
+    }
+
+    CPPTRACE_FORCE_NO_INLINE
+    void record_allocation(std::size_t size) {
+        if(detail::active_allocation_recorder.load(std::memory_order_relaxed) == nullptr) {
+            return;
+        }
+        auto& state = detail::get_allocation_sampling_state();
+        // capturing a trace allocates, which may come right back here from an operator new hook
+        if(state.in_record) {
+            return;
+        }
+        state.in_record = true;
+        detail::active_allocation_records.fetch_add(1);
+        auto guard = detail::scope_exit([&] {
+            detail::active_allocation_records.fetch_sub(1);
+            state.in_record = false;
+        });
+        auto recorder = detail::active_allocation_recorder.load();
+        if(!recorder) {
+            return;
+        }
+        try {
+            auto estimated_bytes = detail::sample_allocation(state, size, recorder->interval);
+            if(estimated_bytes != 0) {
+                recorder->record(detail::capture_frames(1, recorder->max_depth), size, estimated_bytes);
+            }
+        } catch(...) {
+            detail::log_and_maybe_propagate_exception(std::current_exception());
+        }
+    }
+}
+CPPTRACE_END_NAMESPACE
@@ -0,0 +1,44 @@
+#ifndef PROFILING_HPP
+#define PROFILING_HPP
+
+#include <cpptrace/basic.hpp>
+#include <cpptrace/utils.hpp>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "utils/microfmt.hpp"
+#include "utils/utils.hpp"
+
+CPPTRACE_BEGIN_NAMESPACE
+namespace detail {
+    struct frame_vector_hash {
+        std::size_t operator()(const std::vector<frame_ptr>& frames) const {
+            return hash_frames(frames.data(), frames.size());
+        }
+    };
+
+    // Symbol is expected to already be demangled
+    inline std::string folded_frame_name(const stacktrace_frame& frame) {
+        if(frame.symbol.empty()) {
+            return microfmt::format("0x{:h}", frame.raw_address);
+        }
+        return prune_symbol(frame.symbol);
+    }
+
+    // Produces `root;caller;leaf` from names ordered leaf first
+    inline std::string join_folded_stack(const std::vector<std::string>& names) {
+        std::string line;
+        for(auto it = names.rbegin(); it != names.rend(); it++) {
+            if(!line.empty()) {
+                line += ';';
+            }
+            line += *it;
+        }
+        return line;
+    }
+}
+CPPTRACE_END_NAMESPACE
+
+#endif
@@ -0,0 +1,394 @@
+#include <cpptrace/profiling.hpp>
+#include <cpptrace/utils.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "platform/platform.hpp"
+#include "profiling/profiling.hpp"
+#include "demangle/demangle.hpp"
+#include "logging.hpp"
+#include "symbols/symbols.hpp"
+#include "unwind/unwind.hpp"
+#include "utils/error.hpp"
+#include "utils/microfmt.hpp"
+#include "utils/utils.hpp"
+
+#if !IS_WINDOWS
+ #include <cerrno>
+ #include <csignal>
+ #include <pthread.h>
+ #include <sys/time.h>
+#endif
+
+CPPTRACE_BEGIN_NAMESPACE
+namespace detail {
+    // Fixed-capacity buffer written from the SIGPROF handler. Writers claim a slot with an atomic counter and only
+    // write it if it has been drained, otherwise the sample is dropped. The drain thread scans all slots, so slots
+    // completing out of order isn't a problem.
+    class sample_buffer {
+        enum slot_state : int { empty, writing, ready };
+        struct slot {
+            std::atomic<int> state{empty};
+            std::size_t depth = 0;
+        };
+        std::unique_ptr<slot[]> slots;
+        std::unique_ptr<frame_ptr[]> frames;
+        std::size_t capacity;
+        std::size_t max_depth;
+        std::atomic<std::size_t> write_index{0};
+    public:
+        std::atomic<std::size_t> dropped{0};
+
+        sample_buffer(std::size_t capacity, std::size_t max_depth)
+            : slots(new slot[capacity]),
+              frames(new frame_ptr[capacity * max_depth]),
+              capacity(capacity),
+              max_depth(max_depth) {}
+
+        // Signal safe
+        CPPTRACE_FORCE_NO_INLINE void record_sample(std::size_t skip) {
+            auto index = write_index.fetch_add(1, std::memory_order_relaxed) % capacity;
+            auto& target = slots[index];
+            int expected = empty;
+            if(target.state.compare_exchange_strong(expected, writing, std::memory_order_acquire)) {
+                target.depth = safe_capture_frames(&frames[index * max_depth], max_depth, skip + 1, max_depth);
+                target.state.store(ready, std::memory_order_release);
+            } else {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        template<typename F>
+        void drain(F callback) {
+            for(std::size_t i = 0; i < capacity; i++) {
+                if(slots[i].state.load(std::memory_order_acquire) == ready) {
+                    callback(&frames[i * max_depth], slots[i].depth);
+                    slots[i].state.store(empty, std::memory_order_release);
+                }
+            }
+        }
+    };
+
+    std::atomic<sample_buffer*> active_sample_buffer{nullptr};
+    // number of signal handlers currently running, so the buffer isn't freed out from under one of them
+    std::atomic<std::size_t> active_signal_handlers{0};
+
+    #if !IS_WINDOWS
+     void profiler_signal_handler(int, siginfo_t*, void*) {
+         int saved_errno = errno;
+         active_signal_handlers.fetch_add(1);
+         auto buffer = active_sample_buffer.load();
+         if(buffer) {
+             // skip this handler and the signal trampoline
+             buffer->record_sample(2);
+         }
+         active_signal_handlers.fetch_sub(1);
+         errno = saved_errno;
+     }
+    #endif
+}
+
+namespace experimental {
+    class sampling_profiler::impl {
+        unsigned hz = 100;
+        std::size_t depth = 64;
+        std::size_t capacity = 1024;
+
+        std::unique_ptr<detail::sample_buffer> buffer;
+        std::thread drain_thread;
+        std::mutex drain_mutex;
+        std::condition_variable drain_cv;
+        bool stopping = false;
+        #if !IS_WINDOWS
+         struct sigaction previous_action;
+        #endif
+
+        mutable std::mutex data_mutex;
+        std::size_t total_samples = 0;
+        std::size_t total_dropped = 0;
+        std::unordered_map<std::vector<frame_ptr>, std::size_t, detail::frame_vector_hash> stacks;
+        // names for each address, innermost inlined call first
+        std::unordered_map<frame_ptr, std::vector<std::string>> symbols;
+
+    public:
+        void frequency(unsigned value) {
+            hz = std::max(1u, std::min(value, 1000000u));
+        }
+        void max_depth(std::size_t value) {
+            depth = std::max<std::size_t>(1, std::min(value, detail::hard_max_frames));
+        }
+        void buffer_size(std::size_t value) {
+            capacity = std::max<std::size_t>(1, value);
+        }
+
+        bool is_running() const {
+            return buffer != nullptr;
+        }
+
+        #if IS_WINDOWS
+         bool start() {
+             return false;
+         }
+         void stop() {}
+        #else
+         bool start() {
+             if(buffer || !detail::has_safe_unwind()) {
+                 return false;
+             }
+             std::unique_ptr<detail::sample_buffer> new_buffer(new detail::sample_buffer(capacity, depth));
+             detail::sample_buffer* expected = nullptr;
+             if(!detail::active_sample_buffer.compare_exchange_strong(expected, new_buffer.get())) {
+                 return false;
+             }
+             struct sigaction action{};
+             action.sa_sigaction = detail::profiler_signal_handler;
+             action.sa_flags = SA_SIGINFO | SA_RESTART;
+             sigemptyset(&action.sa_mask);
+             if(sigaction(SIGPROF, &action, &previous_action) != 0) {
+                 detail::active_sample_buffer.store(nullptr);
+                 return false;
+             }
+             buffer = std::move(new_buffer);
+             stopping = false;
+             drain_thread = std::thread([this] { drain_loop(); });
+             struct itimerval timer{};
+             auto period = 1000000 / hz;
+             timer.it_interval.tv_sec = static_cast<decltype(timer.it_interval.tv_sec)>(period / 1000000);
+             timer.it_interval.tv_usec = static_cast<decltype(timer.it_interval.tv_usec)>(period % 1000000);
+             timer.it_value = timer.it_interval;
+             if(setitimer(ITIMER_PROF, &timer, nullptr) != 0) {
+                 stop();
+                 return false;
+             }
+             return true;
+         }
+
+         void stop() {
+             if(!buffer) {
+                 return;
+             }
+             struct itimerval timer{};
+             setitimer(ITIMER_PROF, &timer, nullptr);
+             detail::active_sample_buffer.store(nullptr);
+             while(detail::active_signal_handlers.load() != 0) {
+                 std::this_thread::yield();
+             }
+             // A SIGPROF may still be pending and restoring the default action directly would terminate the process.
+             // Ignoring the signal first discards anything pending.
+             if(previous_action.sa_handler == SIG_DFL) {
+                 struct sigaction ignore{};
+                 ignore.sa_handler = SIG_IGN;
+                 sigemptyset(&ignore.sa_mask);
+                 sigaction(SIGPROF, &ignore, nullptr);
+             }
+             sigaction(SIGPROF, &previous_action, nullptr);
+             {
+                 std::unique_lock<std::mutex> lock(drain_mutex);
+                 stopping = true;
+             }
+             drain_cv.notify_one();
+             drain_thread.join();
+             drain();
+             buffer.reset();
+         }
+        #endif
+
+        void clear() {
+            std::unique_lock<std::mutex> lock(data_mutex);
+            total_samples = 0;
+            total_dropped = 0;
+            stacks.clear();
+        }
+
+        std::size_t sample_count() const {
+            std::unique_lock<std::mutex> lock(data_mutex);
+            return total_samples;
+        }
+
+        std::size_t dropped_samples() const {
+            std::unique_lock<std::mutex> lock(data_mutex);
+            return total_dropped;
+        }
+
+        void write_folded_stacks(std::ostream& stream) {
+            std::unique_lock<std::mutex> lock(data_mutex);
+            resolve_new_addresses();
+            // different addresses in the same function produce the same line
+            std::map<std::string, std::size_t> lines;
+            std::vector<std::string> names;
+            for(const auto& entry : stacks) {
+                // stacks are stored leaf first
+                names.clear();
+                for(auto frame : entry.first) {
+                    const auto& frame_names = symbols[frame];
+                    names.insert(names.end(), frame_names.begin(), frame_names.end());
+                }
+                lines[detail::join_folded_stack(names)] += entry.second;
+            }
+            for(const auto& line : lines) {
+                stream << line.first << ' ' << line.second << '\n';
+            }
+        }
+
+        ~impl() {
+            try {
+                stop();
+            } catch(...) {
+                // never propagate out of the destructor, even when trace exceptions aren't absorbed
+                detail::log::error("Unhandled exception while stopping the sampling profiler");
+            }
+        }
+
+    private:
+        void drain_loop() {
+            #if !IS_WINDOWS
+             // don't sample the drain thread
+             sigset_t set;
+             sigemptyset(&set);
+             sigaddset(&set, SIGPROF);
+             pthread_sigmask(SIG_BLOCK, &set, nullptr);
+            #endif
+            std::unique_lock<std::mutex> lock(drain_mutex);
+            while(!stopping) {
+                drain_cv.wait_for(lock, std::chrono::milliseconds(50));
+                lock.unlock();
+                drain();
+                lock.lock();
+            }
+        }
+
+        void drain() {
+            try {
+                std::unique_lock<std::mutex> lock(data_mutex);
+                std::vector<frame_ptr> frames;
+                buffer->drain([&] (const frame_ptr* sample, std::size_t size) {
+                    frames.assign(sample, sample + size);
+                    stacks[frames]++;
+                    total_samples++;
+                });
+                total_dropped += buffer->dropped.exchange(0, std::memory_order_relaxed);
+                resolve_new_addresses();
+            } catch(...) {
+                detail::log_and_maybe_propagate_exception(std::current_exception());
+            }
+        }
+
+        // called with data_mutex held
+        void resolve_new_addresses() {
+            std::vector<frame_ptr> addresses;
+            for(const auto& entry : stacks) {
+                for(auto frame : entry.first) {
+                    if(symbols.find(frame) == symbols.end()) {
+                        symbols[frame];
+                        addresses.push_back(frame);
+                    }
+                }
+            }
+            if(addresses.empty()) {
+                return;
+            }
+            auto resolved = detail::resolve_frames(addresses);
+            // inlined calls are placed before the frame they're inlined into
+            std::vector<std::vector<std::string>> groups;
+            std::vector<std::string> group;
+            for(auto& frame : resolved) {
+                frame.symbol = detail::demangle(frame.symbol, true);
+                group.push_back(detail::folded_frame_name(frame));
+                if(!frame.is_inline) {
+                    groups.push_back(std::move(group));
+                    group.clear();
+                }
+            }
+            for(std::size_t i = 0; i < addresses.size(); i++) {
+                if(groups.size() == addresses.size()) {
+                    symbols[addresses[i]] = std::move(groups[i]);
+                } else {
+                    symbols[addresses[i]] = {microfmt::format("0x{:h}", addresses[i])};
+                }
+            }
+        }
+    };
+
+    sampling_profiler::sampling_profiler() : pimpl(new impl) {}
+
+    sampling_profiler::~sampling_profiler() {
+        delete pimpl;
+    }
+
+    sampling_profiler& sampling_profiler::frequency(unsigned hz) {
+        pimpl->frequency(hz);
+        return *this;
+    }
+
+    sampling_profiler& sampling_profiler::max_depth(std::size_t depth) {
+        pimpl->max_depth(depth);
+        return *this;
+    }
+
+    sampling_profiler& sampling_profiler::buffer_size(std::size_t samples) {
+        pimpl->buffer_size(samples);
+        return *this;
+    }
+
+    bool sampling_profiler::start() {
+        try {
+            return pimpl->start();
+        } catch(...) {
+            detail::log_and_maybe_propagate_exception(std::current_exception());
+            return false;
+        }
+    }
+
+    void sampling_profiler::stop() {
+        try {
+            pimpl->stop();
+        } catch(...) {
+            detail::log_and_maybe_propagate_exception(std::current_exception());
+        }
+    }
+
+    bool sampling_profiler::is_running() const {
+        return pimpl->is_running();
+    }
+
+    std::size_t sampling_profiler::sample_count() const {
+        return pimpl->sample_count();
+    }
+
+    std::size_t sampling_profiler::dropped_samples() const {
+        return pimpl->dropped_samples();
+    }
+
+    void sampling_profiler::clear() {
+        pimpl->clear();
+    }
+
+    std::string sampling_profiler::folded_stacks() const {
+        std::ostringstream stream;
+        write_folded_stacks(stream);
+        return stream.str();
+    }
+
+    void sampling_profiler::write_folded_stacks(std::ostream& stream) const {
+        try {
+            pimpl->write_folded_stacks(stream);
+        } catch(...) {
+            detail::log_and_maybe_propagate_exception(std::current_exception());
+        }
+    }
+}
+CPPTRACE_END_NAMESPACE
@@ -0,0 +1,71 @@
+#include <cpptrace/basic.hpp>
+
+#include "binary/safe_dl.hpp"
+#include "utils/safe_writer.hpp"
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+
+CPPTRACE_BEGIN_NAMESPACE
+namespace detail {
+    void safe_print_object_frame(
+        safe_writer& writer,
+        std::size_t index,
+        const safe_object_frame& frame,
+        experimental::safe_symbol_lookup lookup,
+        void* context
+    ) {
+        writer.put('#');
+        writer.write_decimal(index);
+        writer.write(" 0x");
+        writer.write_hex(frame.raw_address, 2 * sizeof(frame_ptr));
+        char symbol[512];
+        if(lookup && lookup(frame, symbol, sizeof(symbol), context)) {
+            symbol[sizeof(symbol) - 1] = 0;
+            writer.write(" in ");
+            writer.write(symbol);
+        }
+        if(frame.object_path[0] != 0) {
+            writer.write(" at ");
+            writer.write(frame.object_path, strnlen(frame.object_path, sizeof(frame.object_path)));
+            writer.write("+0x");
+            writer.write_hex(frame.address_relative_to_object_start);
+            unsigned char build_id[64];
+            auto build_id_size = get_safe_build_id(frame.raw_address, build_id, sizeof(build_id));
+            if(build_id_size != 0) {
+                writer.write(" (build-id ");
+                for(std::size_t i = 0; i < build_id_size && i < sizeof(build_id); i++) {
+                    writer.write_hex(build_id[i], 2);
+                }
+                writer.put(')');
+            }
+        }
+        writer.put('\n');
+    }
+}
+
+namespace experimental {
+    void safe_print_object_trace(
+        int fd,
+        const safe_object_frame* frames,
+        std::size_t count,
+        safe_symbol_lookup lookup,
+        void* context
+    ) {
+        // don't clobber errno for the code the signal interrupted
+        auto saved_errno = errno;
+        {
+            detail::safe_writer writer(fd);
+            writer.write("Stack trace (most recent call first):\n");
+            if(count == 0) {
+                writer.write("<empty trace>\n");
+            }
+            for(std::size_t i = 0; i < count; i++) {
+                detail::safe_print_object_frame(writer, i, frames[i], lookup, context);
+            }
+        }
+        errno = saved_errno;
+    }
+}
+CPPTRACE_END_NAMESPACE
@@ -0,0 +1,361 @@
+#include "serialization.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "binary/elf.hpp"
+#include "binary/object.hpp"
+#include "demangle/demangle.hpp"
+#include "logging.hpp"
+#include "platform/platform.hpp"
+#include "symbols/symbols.hpp"
+#include "utils/error.hpp"
+#include "utils/utils.hpp"
+#include "utils/varint.hpp"
+
+CPPTRACE_BEGIN_NAMESPACE
+namespace detail {
+    constexpr char serialized_trace_magic[4] = {'C', 'P', 'T', 'R'};
+    constexpr std::size_t serialized_trace_header_size = sizeof(serialized_trace_magic) + 1;
+
+    std::vector<std::uint8_t> get_build_id(const std::string& object_path) {
+        #if IS_LINUX
+         auto object = open_elf_cached(object_path);
+         if(object) {
+             auto build_id = object.unwrap_value()->get_build_id();
+             if(build_id) {
+                 return build_id.unwrap_value();
+             }
+         }
+        #else
+         (void)object_path;
+        #endif
+        return {};
+    }
+
+    class trace_encoder {
+        std::vector<std::uint8_t> out;
+    public:
+        void write_varint(std::uint64_t value) {
+            std::uint8_t buffer[max_varint_size];
+            out.insert(out.end(), buffer, buffer + encode_varint(value, buffer));
+        }
+
+        void write_bytes(const void* data, std::size_t size) {
+            auto bytes = static_cast<const std::uint8_t*>(data);
+            out.insert(out.end(), bytes, bytes + size);
+        }
+
+        std::vector<std::uint8_t> encode(const std::vector<object_frame>& frames) {
+            struct module_info {
+                const std::string* path;
+                frame_ptr load_bias;
+            };
+            std::vector<module_info> modules;
+            std::unordered_map<std::string, std::size_t> module_indices;
+            // 0 means no module, otherwise the module index + 1
+            std::vector<std::size_t> frame_modules;
+            frame_modules.reserve(frames.size());
+            for(const auto& frame : frames) {
+                if(frame.object_path.empty()) {
+                    frame_modules.push_back(0);
+                    continue;
+                }
+                auto res = module_indices.emplace(frame.object_path, modules.size());
+                if(res.second) {
+                    modules.push_back({&frame.object_path, frame.raw_address - frame.object_address});
+                }
+                frame_modules.push_back(res.first->second + 1);
+            }
+            write_bytes(serialized_trace_magic, sizeof(serialized_trace_magic));
+            out.push_back(experimental::serialized_trace_version);
+            write_varint(modules.size());
+            for(const auto& module : modules) {
+                write_varint(module.path->size());
+                write_bytes(module.path->data(), module.path->size());
+                auto build_id = get_build_id(*module.path);
+                write_varint(build_id.size());
+                write_bytes(build_id.data(), build_id.size());
+                write_varint(module.load_bias);
+            }
+            write_varint(frames.size());
+            std::size_t previous_module = 0;
+            std::uint64_t previous_address = 0;
+            for(std::size_t i = 0; i < frames.size(); i++) {
+                auto module = frame_modules[i];
+                write_varint(module);
+                if(module == 0) {
+                    write_varint(frames[i].raw_address);
+                } else {
+                    std::uint64_t address = frames[i].object_address;
+                    if(module == previous_module) {
+                        write_varint(zigzag_encode(static_cast<std::int64_t>(address - previous_address)));
+                    } else {
+                        write_varint(address);
+                    }
+                    previous_address = address;
+                }
+                previous_module = module;
+            }
+            return std::move(out);
+        }
+    };
+
+    std::vector<std::uint8_t> serialize_object_frames(const std::vector<object_frame>& frames) {
+        return trace_encoder{}.encode(frames);
+    }
+
+    std::vector<object_frame> deserialize_object_frames(
+        const experimental::serialized_trace_view& view,
+        const std::function<std::string(const experimental::serialized_module&)>& locate
+    ) {
+        std::vector<std::string> paths;
+        paths.reserve(view.module_count());
+        for(std::size_t i = 0; i < view.module_count(); i++) {
+            auto module = view.module(i);
+            auto path = locate ? locate(module) : module.get_path();
+            if(!path.empty() && module.build_id_length != 0) {
+                auto local_build_id = get_build_id(path);
+                if(
+                    !local_build_id.empty()
+                    && (
+                        local_build_id.size() != module.build_id_length
+                        || !std::equal(local_build_id.begin(), local_build_id.end(), module.build_id)
+                    )
+                ) {
+                    log::warn("Build id mismatch for {}, not resolving its frames", path);
+                    path.clear();
+                }
+            }
+            paths.push_back(std::move(path));
+        }
+        std::vector<object_frame> frames;
+        frames.reserve(view.frame_count());
+        auto cursor = view.frames();
+        experimental::serialized_frame frame;
+        while(cursor.next(frame)) {
+            frames.push_back({
+                frame.raw_address,
+                frame.object_address,
+                frame.module_index.has_value() ? paths[frame.module_index.value()] : ""
+            });
+        }
+        return frames;
+    }
+}
+
+namespace experimental {
+    std::vector<std::uint8_t> serialize_trace(const raw_trace& trace) {
+        try {
+            return detail::serialize_object_frames(detail::get_frames_object_info(trace.frames));
+        } catch(...) {
+            detail::log_and_maybe_propagate_exception(std::current_exception());
+            return {};
+        }
+    }
+
+    std::vector<std::uint8_t> serialize_trace(const object_trace& trace) {
+        try {
+            return detail::serialize_object_frames(trace.frames);
+        } catch(...) {
+            detail::log_and_maybe_propagate_exception(std::current_exception());
+            return {};
+        }
+    }
+
+    bool serialized_trace_view::parse(const void* buffer, std::size_t length) {
+        *this = serialized_trace_view{};
+        auto bytes = static_cast<const std::uint8_t*>(buffer);
+        if(
+            length < detail::serialized_trace_header_size
+            || std::memcmp(bytes, detail::serialized_trace_magic, sizeof(detail::serialized_trace_magic)) != 0
+            || bytes[sizeof(detail::serialized_trace_magic)] != serialized_trace_version
+        ) {
+            return false;
+        }
+        std::size_t offset = detail::serialized_trace_header_size;
+        std::uint64_t module_count = 0;
+        if(!detail::decode_varint(bytes, length, offset, module_count)) {
+            return false;
+        }
+        // each entry takes at least three bytes, bound the count before reserving
+        if(module_count > (length - offset) / 3) {
+            return false;
+        }
+        std::vector<std::size_t> offsets;
+        offsets.reserve(detail::to<std::size_t>(module_count));
+        for(std::uint64_t i = 0; i < module_count; i++) {
+            offsets.push_back(offset);
+            // path, build id, load bias
+            std::uint64_t value = 0;
+            for(int field = 0; field < 2; field++) {
+                if(!detail::decode_varint(bytes, length, offset, value) || value > length - offset) {
+                    return false;
+                }
+                offset += detail::to<std::size_t>(value);
+            }
+            if(!detail::decode_varint(bytes, length, offset, value)) {
+                return false;
+            }
+        }
+        std::uint64_t frame_count = 0;
+        if(!detail::decode_varint(bytes, length, offset, frame_count)) {
+            return false;
+        }
+        auto frames_start = offset;
+        for(std::uint64_t i = 0; i < frame_count; i++) {
+            std::uint64_t module = 0;
+            std::uint64_t address = 0;
+            if(
+                !detail::decode_varint(bytes, length, offset, module)
+                || module > module_count
+                || !detail::decode_varint(bytes, length, offset, address)
+            ) {
+                return false;
+            }
+        }
+        if(offset != length) {
+            return false;
+        }
+        data = bytes;
+        size = length;
+        n_modules = detail::to<std::size_t>(module_count);
+        n_frames = detail::to<std::size_t>(frame_count);
+        module_offsets = std::move(offsets);
+        frames_offset = frames_start;
+        return true;
+    }
+
+    std::size_t serialized_trace_view::module_count() const {
+        return n_modules;
+    }
+
+    serialized_module serialized_trace_view::module(std::size_t index) const {
+        serialized_module module{};
+        if(index >= n_modules) {
+            return module;
+        }
+        // the buffer has already been validated, decoding can only fail if the view was modified
+        std::size_t offset = module_offsets[index];
+        std::uint64_t path_length = 0;
+        std::uint64_t build_id_length = 0;
+        std::uint64_t load_bias = 0;
+        if(!detail::decode_varint(data, size, offset, path_length)) {
+            return module;
+        }
+        auto path_offset = offset;
+        offset += detail::to<std::size_t>(path_length);
+        if(!detail::decode_varint(data, size, offset, build_id_length)) {
+            return module;
+        }
+        auto build_id_offset = offset;
+        offset += detail::to<std::size_t>(build_id_length);
+        if(!detail::decode_varint(data, size, offset, load_bias)) {
+            return module;
+        }
+        module.path = reinterpret_cast<const char*>(data + path_offset);
+        module.path_length = detail::to<std::size_t>(path_length);
+        module.build_id = data + build_id_offset;
+        module.build_id_length = detail::to<std::size_t>(build_id_length);
+        module.load_bias = detail::to<frame_ptr>(load_bias);
+        return module;
+    }
+
+    std::size_t serialized_trace_view::frame_count() const {
+        return n_frames;
+    }
+
+    serialized_trace_view::frame_cursor::frame_cursor(const serialized_trace_view* view)
+        : view(view), offset(view->frames_offset), remaining(view->n_frames) {}
+
+    bool serialized_trace_view::frame_cursor::next(serialized_frame& frame) {
+        if(remaining == 0) {
+            return false;
+        }
+        remaining--;
+        std::uint64_t module = 0;
+        std::uint64_t value = 0;
+        if(
+            !detail::decode_varint(view->data, view->size, offset, module)
+            || !detail::decode_varint(view->data, view->size, offset, value)
+            || module > view->n_modules
+        ) {
+            // only possible if the view wasn't parsed successfully
+            remaining = 0;
+            return false;
+        }
+        if(module == 0) {
+            frame.module_index = nullable<std::uint32_t>::null();
+            frame.object_address = 0;
+            frame.raw_address = detail::to<frame_ptr>(value);
+        } else {
+            if(module == previous_module) {
+                value = previous_address + static_cast<std::uint64_t>(detail::zigzag_decode(value));
+            } else {
+                previous_load_bias = view->module(detail::to<std::size_t>(module - 1)).load_bias;
+            }
+            frame.module_index = static_cast<std::uint32_t>(module - 1);
+            frame.object_address = detail::to<frame_ptr>(value);
+            frame.raw_address = frame.object_address + previous_load_bias;
+            previous_address = value;
+        }
+        previous_module = module;
+        return true;
+    }
+
+    serialized_trace_view::frame_cursor serialized_trace_view::frames() const {
+        return frame_cursor(this);
+    }
+
+    object_trace serialized_trace_view::to_object_trace() const {
+        std::vector<std::string> paths;
+        paths.reserve(n_modules);
+        for(std::size_t i = 0; i < n_modules; i++) {
+            paths.push_back(module(i).get_path());
+        }
+        object_trace trace;
+        trace.frames.reserve(n_frames);
+        auto cursor = frames();
+        serialized_frame frame;
+        while(cursor.next(frame)) {
+            trace.frames.push_back({
+                frame.raw_address,
+                frame.object_address,
+                frame.module_index.has_value() ? paths[frame.module_index.value()] : ""
+            });
+        }
+        return trace;
+    }
+
+    stacktrace resolve_serialized(const void* buffer, std::size_t length) {
+        return resolve_serialized(buffer, length, nullptr);
+    }
+
+    stacktrace resolve_serialized(
+        const void* buffer,
+        std::size_t length,
+        const std::function<std::string(const serialized_module&)>& locate
+    ) {
+        try {
+            serialized_trace_view view;
+            if(!view.parse(buffer, length)) {
+                throw detail::internal_error("Invalid serialized trace");
+            }
+            auto trace = detail::resolve_frames(detail::deserialize_object_frames(view, locate));
+            for(auto& resolved_frame : trace) {
+                resolved_frame.symbol = detail::demangle(resolved_frame.symbol, true);
+            }
+            return {std::move(trace)};
+        } catch(...) {
+            detail::log_and_maybe_propagate_exception(std::current_exception());
+            return stacktrace{};
+        }
+    }
+}
+CPPTRACE_END_NAMESPACE
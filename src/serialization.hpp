@@ -0,0 +1,27 @@
+#ifndef SERIALIZATION_HPP
+#define SERIALIZATION_HPP
+
+#include <cpptrace/basic.hpp>
+#include <cpptrace/serialization.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+CPPTRACE_BEGIN_NAMESPACE
+namespace detail {
+    // Empty if the object doesn't have a build id or it couldn't be read
+    std::vector<std::uint8_t> get_build_id(const std::string& object_path);
+
+    std::vector<std::uint8_t> serialize_object_frames(const std::vector<object_frame>& frames);
+
+    // Maps the view's frames to local objects, frames in objects with a mismatched build id get an empty object path
+    std::vector<object_frame> deserialize_object_frames(
+        const experimental::serialized_trace_view& view,
+        const std::function<std::string(const experimental::serialized_module&)>& locate
+    );
+}
+CPPTRACE_END_NAMESPACE
+
+#endif
@@ -10,6 +10,7 @@
 
 #include "utils/common.hpp"
 #include "utils/microfmt.hpp"
+#include "utils/stats.hpp"
 #include "utils/utils.hpp"
 
 CPPTRACE_BEGIN_NAMESPACE
@@ -93,6 +94,7 @@ namespace detail {
         static std::unordered_map<std::string, const snippet_manager> snippet_managers;
         std::unique_lock<std::mutex> lock(snippet_manager_mutex);
         auto it = snippet_managers.find(path);
+        record_cache_access(stat_cache::snippet, it != snippet_managers.end());
         if(it == snippet_managers.end()) {
             return snippet_managers.insert({path, snippet_manager(path)}).first->second;
         } else {
@@ -192,6 +194,7 @@ namespace detail {
         std::size_t context_size,
         bool color
     ) {
+        stage_timer timer(stat_stage::snippets);
         const auto context_res = get_lines(path, target_line, context_size);
         if(!context_res) {
             return "";
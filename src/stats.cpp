@@ -0,0 +1,81 @@
+#include <cpptrace/stats.hpp>
+
+#include "utils/stats.hpp"
+#include "utils/error.hpp"
+
+#include <cstddef>
+
+CPPTRACE_BEGIN_NAMESPACE
+namespace detail {
+    #ifdef CPPTRACE_STATS
+     stage_counter stage_counters[static_cast<std::size_t>(stat_stage::count)];
+     cache_counter cache_counters[static_cast<std::size_t>(stat_cache::count)];
+
+     experimental::stage_stats load_stage(stat_stage stage) {
+         const auto& counter = stage_counters[static_cast<std::size_t>(stage)];
+         return {counter.count.load(std::memory_order_relaxed), counter.nanoseconds.load(std::memory_order_relaxed)};
+     }
+
+     experimental::cache_stats load_cache(stat_cache cache) {
+         const auto& counter = cache_counters[static_cast<std::size_t>(cache)];
+         return {counter.hits.load(std::memory_order_relaxed), counter.misses.load(std::memory_order_relaxed)};
+     }
+
+     experimental::stats get_stats() {
+         return {
+             true,
+             load_stage(stat_stage::unwinding),
+             load_stage(stat_stage::object_lookup),
+             load_stage(stat_stage::resolver_construction),
+             load_stage(stat_stage::cu_lookup),
+             load_stage(stat_stage::line_tables),
+             load_stage(stat_stage::inline_walk),
+             load_stage(stat_stage::demangling),
+             load_stage(stat_stage::formatting),
+             load_stage(stat_stage::snippets),
+             load_cache(stat_cache::demangle),
+             load_cache(stat_cache::object),
+             load_cache(stat_cache::resolver),
+             load_cache(stat_cache::line_table),
+             load_cache(stat_cache::snippet)
+         };
+     }
+
+     void reset_stats() {
+         for(auto& counter : stage_counters) {
+             counter.count.store(0, std::memory_order_relaxed);
+             counter.nanoseconds.store(0, std::memory_order_relaxed);
+         }
+         for(auto& counter : cache_counters) {
+             counter.hits.store(0, std::memory_order_relaxed);
+             counter.misses.store(0, std::memory_order_relaxed);
+         }
+     }
+    #else
+     experimental::stats get_stats() {
+         return {};
+     }
+
+     void reset_stats() {}
+    #endif
+}
+
+namespace experimental {
+    stats get_stats() {
+        try {
+            return detail::get_stats();
+        } catch(...) {
+            detail::log_and_maybe_propagate_exception(std::current_exception());
+            return {};
+        }
+    }
+
+    void reset_stats() {
+        try {
+            detail::reset_stats();
+        } catch(...) {
+            detail::log_and_maybe_propagate_exception(std::current_exception());
+        }
+    }
+}
+CPPTRACE_END_NAMESPACE
@@ -0,0 +1,192 @@
+#include <cpptrace/symbolication.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "logging.hpp"
+#include "platform/platform.hpp"
+#include "serialization.hpp"
+#include "symbolication/protocol.hpp"
+#include "symbols/symbols.hpp"
+#include "utils/error.hpp"
+#include "utils/optional.hpp"
+
+#if IS_LINUX || IS_APPLE
+ #include <sys/socket.h>
+ #include <sys/un.h>
+ #include <unistd.h>
+#endif
+
+CPPTRACE_BEGIN_NAMESPACE
+namespace detail {
+namespace remote {
+    std::atomic_bool client_enabled(false); // NOSONAR
+
+    #if IS_LINUX || IS_APPLE
+     // Cold resolution of a large binary can take a while
+     constexpr int client_timeout_seconds = 30;
+     // Don't retry an unreachable server on every trace
+     constexpr auto client_retry_interval = std::chrono::seconds(1);
+
+     // Idle connections beyond this are closed rather than kept for reuse
+     constexpr std::size_t client_max_idle_connections = 4;
+
+     // Each request checks out a persistent connection, or opens a new one, so a slow server only stalls the threads
+     // waiting on it. The mutex is held only while checking connections in and out.
+     class symbolication_client {
+         std::mutex mutex;
+         std::string socket_path;
+         // bumped when the path changes so connections to the old server aren't returned to the pool
+         std::uint64_t generation = 0;
+         std::vector<int> idle_connections;
+         std::chrono::steady_clock::time_point retry_after;
+
+         void close_idle_connections() {
+             for(auto fd : idle_connections) {
+                 close(fd);
+             }
+             idle_connections.clear();
+         }
+
+         static int connect(const std::string& path) {
+             sockaddr_un address;
+             if(!symbolication::make_address(path, address)) {
+                 log::error("Invalid symbolication server socket path {}", path);
+                 return -1;
+             }
+             int fd = symbolication::open_socket();
+             if(fd == -1) {
+                 return -1;
+             }
+             if(
+                 !symbolication::set_timeout(fd, client_timeout_seconds)
+                 || ::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == -1
+             ) {
+                 close(fd);
+                 return -1;
+             }
+             return fd;
+         }
+
+         static bool exchange(int fd, const std::vector<std::uint8_t>& request, std::vector<std::uint8_t>& response) {
+             return symbolication::send_message(fd, request) && symbolication::receive_message(fd, response);
+         }
+
+         void check_in(int fd, std::uint64_t fd_generation) {
+             std::unique_lock<std::mutex> lock(mutex);
+             if(fd_generation == generation && idle_connections.size() < client_max_idle_connections) {
+                 idle_connections.push_back(fd);
+             } else {
+                 close(fd);
+             }
+         }
+
+     public:
+         ~symbolication_client() {
+             close_idle_connections();
+         }
+
+         void set_socket_path(const std::string& path) {
+             std::unique_lock<std::mutex> lock(mutex);
+             close_idle_connections();
+             socket_path = path;
+             generation++;
+             retry_after = {};
+         }
+
+         optional<std::vector<stacktrace_frame>> resolve_frames(const std::vector<object_frame>& frames) {
+             auto request = serialize_object_frames(frames);
+             std::string path;
+             std::uint64_t fd_generation = 0;
+             int fd = -1;
+             {
+                 std::unique_lock<std::mutex> lock(mutex);
+                 if(socket_path.empty() || std::chrono::steady_clock::now() < retry_after) {
+                     return nullopt;
+                 }
+                 path = socket_path;
+                 fd_generation = generation;
+                 if(!idle_connections.empty()) {
+                     fd = idle_connections.back();
+                     idle_connections.pop_back();
+                 }
+             }
+             // the server may have closed an idle persistent connection, so retry once on a fresh one
+             for(int attempt = 0; attempt < 2; attempt++) {
+                 bool fresh = fd == -1;
+                 if(fresh && (fd = connect(path)) == -1) {
+                     break;
+                 }
+                 std::vector<std::uint8_t> response;
+                 if(exchange(fd, request, response)) {
+                     check_in(fd, fd_generation);
+                     std::vector<stacktrace_frame> trace;
+                     std::size_t n_physical = 0;
+                     bool ok = symbolication::decode_response(response, trace);
+                     for(const auto& frame : trace) {
+                         n_physical += frame.is_inline ? 0 : 1;
+                     }
+                     if(!ok || n_physical != frames.size()) {
+                         log::warn("Symbolication server failed to resolve frames, resolving locally");
+                         return nullopt;
+                     }
+                     return trace;
+                 }
+                 close(fd);
+                 fd = -1;
+                 if(fresh) {
+                     break;
+                 }
+             }
+             log::warn("Couldn't reach symbolication server at {}, resolving locally", path);
+             std::unique_lock<std::mutex> lock(mutex);
+             if(fd_generation == generation) {
+                 retry_after = std::chrono::steady_clock::now() + client_retry_interval;
+             }
+             return nullopt;
+         }
+     };
+
+     symbolication_client& get_client() {
+         static symbolication_client client;
+         return client;
+     }
+    #endif
+
+    bool enabled() {
+        return client_enabled.load(std::memory_order_relaxed);
+    }
+
+    optional<std::vector<stacktrace_frame>> resolve_frames(const std::vector<object_frame>& frames) {
+        #if IS_LINUX || IS_APPLE
+         return get_client().resolve_frames(frames);
+        #else
+         (void)frames;
+         return nullopt;
+        #endif
+    }
+}
+}
+
+namespace experimental {
+    void set_symbolication_server(const std::string& socket_path) {
+        try {
+            #if IS_LINUX || IS_APPLE
+             detail::remote::get_client().set_socket_path(socket_path);
+             detail::remote::client_enabled = !socket_path.empty();
+            #else
+             if(!socket_path.empty()) {
+                 throw detail::internal_error("Symbolication servers aren't supported on this platform");
+             }
+            #endif
+        } catch(...) {
+            detail::log_and_maybe_propagate_exception(std::current_exception());
+        }
+    }
+}
+CPPTRACE_END_NAMESPACE
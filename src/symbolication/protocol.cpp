@@ -0,0 +1,237 @@
+#include "symbolication/protocol.hpp"
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "utils/utils.hpp"
+#include "utils/varint.hpp"
+
+#if IS_LINUX || IS_APPLE
+ #include <fcntl.h>
+ #include <sys/socket.h>
+ #include <sys/time.h>
+ #include <sys/un.h>
+ #include <unistd.h>
+#endif
+
+CPPTRACE_BEGIN_NAMESPACE
+namespace detail {
+namespace symbolication {
+    namespace {
+        void write_varint(std::vector<std::uint8_t>& out, std::uint64_t value) {
+            std::uint8_t buffer[max_varint_size];
+            out.insert(out.end(), buffer, buffer + encode_varint(value, buffer));
+        }
+
+        void write_string(std::vector<std::uint8_t>& out, const std::string& str) {
+            write_varint(out, str.size());
+            out.insert(out.end(), str.begin(), str.end());
+        }
+
+        // 0 means null, otherwise the value + 1
+        std::uint64_t encode_nullable(nullable<std::uint32_t> value) {
+            return value.has_value() ? std::uint64_t(value.value()) + 1 : 0;
+        }
+
+        bool decode_nullable(std::uint64_t raw, nullable<std::uint32_t>& value) {
+            if(raw > std::uint64_t(nullable<std::uint32_t>::null_value())) {
+                return false;
+            }
+            value = raw == 0 ? nullable<std::uint32_t>::null() : nullable<std::uint32_t>{to<std::uint32_t>(raw - 1)};
+            return true;
+        }
+
+        bool read_string(const std::vector<std::uint8_t>& message, std::size_t& offset, std::string& str) {
+            std::uint64_t length;
+            if(
+                !decode_varint(message.data(), message.size(), offset, length)
+                || length > message.size() - offset
+            ) {
+                return false;
+            }
+            auto begin = message.begin() + to<std::ptrdiff_t>(offset);
+            str.assign(begin, begin + to<std::ptrdiff_t>(length));
+            offset += to<std::size_t>(length);
+            return true;
+        }
+    }
+
+    std::vector<std::uint8_t> encode_response(const std::vector<stacktrace_frame>& frames) {
+        std::vector<std::uint8_t> out;
+        out.push_back(static_cast<std::uint8_t>(response_status::ok));
+        write_varint(out, frames.size());
+        for(const auto& frame : frames) {
+            write_varint(out, frame.raw_address);
+            write_varint(out, frame.object_address);
+            write_varint(out, encode_nullable(frame.line));
+            write_varint(out, encode_nullable(frame.column));
+            write_string(out, frame.filename);
+            write_string(out, frame.symbol);
+            out.push_back(frame.is_inline ? 1 : 0);
+        }
+        return out;
+    }
+
+    std::vector<std::uint8_t> encode_error_response() {
+        return {static_cast<std::uint8_t>(response_status::error)};
+    }
+
+    bool decode_response(const std::vector<std::uint8_t>& message, std::vector<stacktrace_frame>& frames) {
+        frames.clear();
+        if(message.empty() || message[0] != static_cast<std::uint8_t>(response_status::ok)) {
+            return false;
+        }
+        std::size_t offset = 1;
+        std::uint64_t count;
+        // every frame takes at least 7 bytes, reject absurd counts before reserving
+        if(!decode_varint(message.data(), message.size(), offset, count) || count > message.size() / 7) {
+            return false;
+        }
+        frames.reserve(to<std::size_t>(count));
+        for(std::uint64_t i = 0; i < count; i++) {
+            stacktrace_frame frame;
+            std::uint64_t raw_address;
+            std::uint64_t object_address;
+            std::uint64_t line;
+            std::uint64_t column;
+            if(
+                !decode_varint(message.data(), message.size(), offset, raw_address)
+                || !decode_varint(message.data(), message.size(), offset, object_address)
+                || !decode_varint(message.data(), message.size(), offset, line)
+                || !decode_varint(message.data(), message.size(), offset, column)
+                || !decode_nullable(line, frame.line)
+                || !decode_nullable(column, frame.column)
+                || !read_string(message, offset, frame.filename)
+                || !read_string(message, offset, frame.symbol)
+                || offset >= message.size()
+            ) {
+                frames.clear();
+                return false;
+            }
+            frame.raw_address = to<frame_ptr>(raw_address);
+            frame.object_address = to<frame_ptr>(object_address);
+            frame.is_inline = message[offset++] != 0;
+            frames.push_back(std::move(frame));
+        }
+        if(offset != message.size()) {
+            frames.clear();
+            return false;
+        }
+        return true;
+    }
+
+    #if IS_LINUX || IS_APPLE
+     int open_socket() {
+         #if IS_LINUX
+          return socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+         #else
+          int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+          if(fd == -1) {
+              return -1;
+          }
+          int on = 1;
+          if(
+              fcntl(fd, F_SETFD, FD_CLOEXEC) == -1
+              || setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on)) == -1
+          ) {
+              close(fd);
+              return -1;
+          }
+          return fd;
+         #endif
+     }
+
+     bool make_address(const std::string& path, sockaddr_un& address) {
+         std::memset(&address, 0, sizeof(address));
+         address.sun_family = AF_UNIX;
+         if(path.empty() || path.size() >= sizeof(address.sun_path)) {
+             return false;
+         }
+         std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+         return true;
+     }
+
+     bool set_timeout(int fd, int seconds) {
+         timeval timeout{};
+         timeout.tv_sec = seconds;
+         return setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)) == 0
+             && setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout)) == 0;
+     }
+
+     namespace {
+         bool send_all(int fd, const std::uint8_t* data, std::size_t size) {
+             #if IS_LINUX
+              constexpr int flags = MSG_NOSIGNAL;
+             #else
+              constexpr int flags = 0;
+             #endif
+             while(size > 0) {
+                 auto sent = send(fd, data, size, flags);
+                 if(sent < 0) {
+                     if(errno == EINTR) {
+                         continue;
+                     }
+                     return false;
+                 }
+                 data += sent;
+                 size -= to<std::size_t>(sent);
+             }
+             return true;
+         }
+
+         bool receive_all(int fd, std::uint8_t* data, std::size_t size) {
+             while(size > 0) {
+                 auto received = recv(fd, data, size, 0);
+                 if(received < 0) {
+                     if(errno == EINTR) {
+                         continue;
+                     }
+                     return false;
+                 }
+                 if(received == 0) {
+                     return false;
+                 }
+                 data += received;
+                 size -= to<std::size_t>(received);
+             }
+             return true;
+         }
+     }
+
+     bool send_message(int fd, const std::vector<std::uint8_t>& message) {
+         if(message.size() > max_message_size) {
+             return false;
+         }
+         auto size = to<std::uint32_t>(message.size());
+         std::uint8_t header[4] = {
+             static_cast<std::uint8_t>(size),
+             static_cast<std::uint8_t>(size >> 8),
+             static_cast<std::uint8_t>(size >> 16),
+             static_cast<std::uint8_t>(size >> 24)
+         };
+         return send_all(fd, header, sizeof(header)) && send_all(fd, message.data(), message.size());
+     }
+
+     bool receive_message(int fd, std::vector<std::uint8_t>& message) {
+         std::uint8_t header[4];
+         if(!receive_all(fd, header, sizeof(header))) {
+             return false;
+         }
+         std::uint32_t size = std::uint32_t(header[0])
+             | std::uint32_t(header[1]) << 8
+             | std::uint32_t(header[2]) << 16
+             | std::uint32_t(header[3]) << 24;
+         if(size > max_message_size) {
+             return false;
+         }
+         message.resize(size);
+         return receive_all(fd, message.data(), message.size());
+     }
+    #endif
+}
+}
+CPPTRACE_END_NAMESPACE
@@ -0,0 +1,49 @@
+#ifndef SYMBOLICATION_PROTOCOL_HPP
+#define SYMBOLICATION_PROTOCOL_HPP
+
+#include <cpptrace/basic.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "platform/platform.hpp"
+
+#if IS_LINUX || IS_APPLE
+ #include <sys/socket.h>
+ #include <sys/un.h>
+#endif
+
+CPPTRACE_BEGIN_NAMESPACE
+namespace detail {
+namespace symbolication {
+    // Both requests and responses are framed as a 32-bit little endian length followed by the payload. A request is a
+    // serialized trace, see experimental::serialize_trace. A response is a status byte followed, on success, by the
+    // resolved frames.
+    constexpr std::uint32_t max_message_size = 64 * 1024 * 1024;
+
+    enum class response_status : std::uint8_t {
+        ok = 0,
+        error = 1,
+    };
+
+    std::vector<std::uint8_t> encode_response(const std::vector<stacktrace_frame>& frames);
+    std::vector<std::uint8_t> encode_error_response();
+    // Returns false if the response is malformed or the server reported an error
+    bool decode_response(const std::vector<std::uint8_t>& message, std::vector<stacktrace_frame>& frames);
+
+    #if IS_LINUX || IS_APPLE
+     // Returns -1 on failure, the socket is close-on-exec and won't raise SIGPIPE
+     int open_socket();
+     bool make_address(const std::string& path, sockaddr_un& address);
+     bool set_timeout(int fd, int seconds);
+     // Both return false on any error, including the peer closing the connection
+     bool send_message(int fd, const std::vector<std::uint8_t>& message);
+     bool receive_message(int fd, std::vector<std::uint8_t>& message);
+    #endif
+}
+}
+CPPTRACE_END_NAMESPACE
+
+#endif
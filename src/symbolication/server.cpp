@@ -0,0 +1,277 @@
+#include <cpptrace/symbolication.hpp>
+#include <cpptrace/serialization.hpp>
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <list>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "logging.hpp"
+#include "platform/platform.hpp"
+#include "serialization.hpp"
+#include "symbolication/protocol.hpp"
+#include "symbols/symbols.hpp"
+#include "utils/error.hpp"
+
+#if IS_LINUX || IS_APPLE
+ #include <fcntl.h>
+ #include <poll.h>
+ #include <sys/socket.h>
+ #include <sys/stat.h>
+ #include <sys/un.h>
+ #include <unistd.h>
+#endif
+
+CPPTRACE_BEGIN_NAMESPACE
+namespace experimental {
+    #if IS_LINUX || IS_APPLE
+     class symbolication_server::impl {
+         struct connection {
+             int fd;
+             std::atomic_bool done{false};
+             std::thread thread;
+         };
+
+         std::string socket_path;
+         int listen_fd = -1;
+         int wake_pipe[2] = {-1, -1};
+         std::atomic<std::size_t> requests{0};
+         std::mutex connections_mutex;
+         std::list<connection> connections;
+
+         std::vector<std::uint8_t> handle_request(const std::vector<std::uint8_t>& request) {
+             try {
+                 serialized_trace_view view;
+                 if(!view.parse(request.data(), request.size())) {
+                     detail::log::warn("Symbolication server received a malformed request");
+                     return detail::symbolication::encode_error_response();
+                 }
+                 // the request's frames must never be sent back to a server, including this one
+                 auto frames = detail::resolve_frames_locally(detail::deserialize_object_frames(view, nullptr));
+                 return detail::symbolication::encode_response(frames);
+             } catch(const std::exception& e) {
+                 detail::log::error("Symbolication server failed to resolve request: {}", e.what());
+                 return detail::symbolication::encode_error_response();
+             }
+         }
+
+         void serve_connection(connection& conn) {
+             std::vector<std::uint8_t> request;
+             while(detail::symbolication::receive_message(conn.fd, request)) {
+                 auto response = handle_request(request);
+                 requests++;
+                 if(!detail::symbolication::send_message(conn.fd, response)) {
+                     break;
+                 }
+             }
+             conn.done = true;
+         }
+
+         // Joins connections whose client has disconnected, or all connections if stopping
+         void reap_connections(bool all) {
+             std::unique_lock<std::mutex> lock(connections_mutex);
+             for(auto it = connections.begin(); it != connections.end();) {
+                 if(all) {
+                     shutdown(it->fd, SHUT_RDWR);
+                 }
+                 if(all || it->done) {
+                     it->thread.join();
+                     close(it->fd);
+                     it = connections.erase(it);
+                 } else {
+                     it++;
+                 }
+             }
+         }
+
+         void accept_connection() {
+             int fd = accept(listen_fd, nullptr, nullptr);
+             if(fd == -1) {
+                 if(errno != EINTR && errno != EAGAIN && errno != ECONNABORTED) {
+                     detail::log::error("Symbolication server failed to accept a connection: {}", strerror(errno));
+                 }
+                 return;
+             }
+             fcntl(fd, F_SETFD, FD_CLOEXEC);
+             #if IS_APPLE
+              int on = 1;
+              setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+             #endif
+             std::unique_lock<std::mutex> lock(connections_mutex);
+             connections.emplace_back();
+             auto& conn = connections.back();
+             conn.fd = fd;
+             conn.thread = std::thread([this, &conn] { serve_connection(conn); });
+         }
+
+         // Whether something accepts connections on the socket, as opposed to a stale socket file
+         static bool is_live_socket(const sockaddr_un& address) {
+             int fd = detail::symbolication::open_socket();
+             if(fd == -1) {
+                 return false;
+             }
+             bool live = connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0
+                 || errno != ECONNREFUSED;
+             close(fd);
+             return live;
+         }
+
+     public:
+         explicit impl(std::string path) : socket_path(std::move(path)) {
+             if(pipe(wake_pipe) == -1) {
+                 throw detail::internal_error("pipe failed: {}", strerror(errno));
+             }
+             fcntl(wake_pipe[0], F_SETFD, FD_CLOEXEC);
+             fcntl(wake_pipe[1], F_SETFD, FD_CLOEXEC);
+             fcntl(wake_pipe[1], F_SETFL, O_NONBLOCK);
+         }
+
+         ~impl() {
+             reap_connections(true);
+             if(listen_fd != -1) {
+                 close(listen_fd);
+                 unlink(socket_path.c_str());
+             }
+             close(wake_pipe[0]);
+             close(wake_pipe[1]);
+         }
+
+         impl(const impl&) = delete;
+         impl& operator=(const impl&) = delete;
+
+         bool listen() {
+             sockaddr_un address;
+             if(!detail::symbolication::make_address(socket_path, address)) {
+                 throw detail::internal_error("Invalid socket path {}", socket_path);
+             }
+             // only remove a stale socket, never some other file or a socket a live server is listening on
+             struct stat st;
+             if(lstat(socket_path.c_str(), &st) == 0 && S_ISSOCK(st.st_mode)) {
+                 if(is_live_socket(address)) {
+                     throw detail::internal_error("A server is already listening on {}", socket_path);
+                 }
+                 unlink(socket_path.c_str());
+             }
+             listen_fd = detail::symbolication::open_socket();
+             if(listen_fd == -1) {
+                 throw detail::internal_error("socket failed: {}", strerror(errno));
+             }
+             // Clients can make the server open and parse any object path, so only the owner may connect. Connections
+             // are refused until listen(), so restricting the mode between bind and listen leaves no window.
+             bool bound = bind(listen_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0;
+             if(
+                 !bound
+                 || chmod(socket_path.c_str(), S_IRUSR | S_IWUSR) == -1
+                 || ::listen(listen_fd, SOMAXCONN) == -1
+             ) {
+                 auto error = errno;
+                 close(listen_fd);
+                 listen_fd = -1;
+                 if(bound) {
+                     unlink(socket_path.c_str());
+                 }
+                 throw detail::internal_error("Failed to listen on {}: {}", socket_path, strerror(error));
+             }
+             return true;
+         }
+
+         void serve() {
+             if(listen_fd == -1) {
+                 throw detail::internal_error("symbolication_server::serve called before listen");
+             }
+             pollfd fds[2] = {
+                 {listen_fd, POLLIN, 0},
+                 {wake_pipe[0], POLLIN, 0}
+             };
+             while(true) {
+                 if(poll(fds, 2, -1) == -1) {
+                     if(errno == EINTR) {
+                         continue;
+                     }
+                     throw detail::internal_error("poll failed: {}", strerror(errno));
+                 }
+                 if(fds[1].revents) {
+                     char c;
+                     while(read(wake_pipe[0], &c, 1) == -1 && errno == EINTR) {}
+                     break;
+                 }
+                 if(fds[0].revents) {
+                     reap_connections(false);
+                     accept_connection();
+                 }
+             }
+             reap_connections(true);
+             close(listen_fd);
+             listen_fd = -1;
+             unlink(socket_path.c_str());
+         }
+
+         void stop() {
+             int saved_errno = errno;
+             char c = 0;
+             // the pipe is non-blocking, if it's full a stop is already pending
+             (void)!write(wake_pipe[1], &c, 1);
+             errno = saved_errno;
+         }
+
+         std::size_t requests_served() const {
+             return requests.load();
+         }
+     };
+    #else
+     class symbolication_server::impl {
+     public:
+         explicit impl(const std::string&) {}
+
+         bool listen() {
+             throw detail::internal_error("Symbolication servers aren't supported on this platform");
+         }
+
+         void serve() {}
+
+         void stop() {}
+
+         std::size_t requests_served() const {
+             return 0;
+         }
+     };
+    #endif
+
+    symbolication_server::symbolication_server(const std::string& socket_path) : pimpl(new impl(socket_path)) {}
+
+    symbolication_server::~symbolication_server() {
+        delete pimpl;
+    }
+
+    bool symbolication_server::listen() {
+        try {
+            return pimpl->listen();
+        } catch(...) {
+            detail::log_and_maybe_propagate_exception(std::current_exception());
+            return false;
+        }
+    }
+
+    void symbolication_server::serve() {
+        try {
+            pimpl->serve();
+        } catch(...) {
+            detail::log_and_maybe_propagate_exception(std::current_exception());
+        }
+    }
+
+    void symbolication_server::stop() {
+        pimpl->stop();
+    }
+
+    std::size_t symbolication_server::requests_served() const {
+        return pimpl->requests_served();
+    }
+}
+CPPTRACE_END_NAMESPACE
@@ -9,6 +9,7 @@
 #include "symbols/symbols.hpp"
 #include "utils/common.hpp"
 #include "utils/error.hpp"
+#include "utils/stats.hpp"
 #include "utils/utils.hpp"
 #include "utils/lru_cache.hpp"
 #include "platform/path.hpp"
@@ -440,6 +441,7 @@ namespace libdwarf {
             ASSERT(die.get_tag() == DW_TAG_subprogram);
             const auto name = subprogram_symbol(die, dwversion);
             if(should_resolve_inlined_calls()) {
+                stage_timer timer(stat_stage::inline_walk);
                 get_inlines_info(cu_die, die, pc, dwversion, inlines);
             }
             return name;
@@ -597,6 +599,7 @@ namespace libdwarf {
         optional<line_table_info&> get_line_table(const die_object& cu_die) {
             auto off = cu_die.get_global_offset();
             auto res = line_tables.maybe_get(off);
+            record_cache_access(stat_cache::line_table, res.has_value());
             if(res) {
                 return res;
             } else {
@@ -679,6 +682,7 @@ namespace libdwarf {
             if(skeleton) {
                 return skeleton.unwrap().resolver.retrieve_line_info(skeleton.unwrap().cu_die, pc, frame);
             }
+            stage_timer timer(stat_stage::line_tables);
             auto table_info_opt = get_line_table(cu_die);
             if(!table_info_opt) {
                 return; // failing silently for now
@@ -800,6 +804,7 @@ namespace libdwarf {
         // - Otherwise a CU cache is built up and CUs are looked up in the map
         CPPTRACE_FORCE_NO_INLINE_FOR_PROFILING
         optional<cu_info> lookup_cu(Dwarf_Addr pc) {
+            stage_timer timer(stat_stage::cu_lookup);
             // Check for .debug_aranges for fast lookup
             if(aranges && !skeleton) { // don't bother under split dwarf
                 // Try to find pc in aranges
@@ -0,0 +1,275 @@
+#include <cpptrace/basic.hpp>
+#include <cpptrace/utils.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "logging.hpp"
+#include "symbols/symbols.hpp"
+#include "utils/common.hpp"
+#include "utils/error.hpp"
+#include "utils/lru_cache.hpp"
+#include "utils/microfmt.hpp"
+#include "utils/optional.hpp"
+
+CPPTRACE_BEGIN_NAMESPACE
+namespace detail {
+namespace chain {
+    using experimental::symbol_source;
+
+    // Inlined frames, most recent first, followed by the frame for the actual address
+    using frame_group = std::vector<stacktrace_frame>;
+
+    constexpr std::size_t max_cached_frames = 64 * 1024;
+
+    struct chain_config {
+        std::vector<symbol_source> stages;
+        bool require_line_info;
+    };
+
+    std::atomic_bool chain_enabled(false); // NOSONAR
+    std::mutex chain_mutex;
+    std::shared_ptr<const chain_config> current_chain; // protected by chain_mutex
+
+    std::shared_ptr<const chain_config> get_chain() {
+        std::lock_guard<std::mutex> lock(chain_mutex);
+        return current_chain;
+    }
+
+    class frame_cache {
+        std::mutex mutex;
+        lru_cache<std::string, frame_group> cache{max_cached_frames};
+
+        static std::string key(const object_frame& frame) {
+            return microfmt::format("{}@{:h}", frame.object_path, frame.object_address);
+        }
+    public:
+        bool lookup(const object_frame& frame, frame_group& group) {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto entry = cache.maybe_get(key(frame));
+            if(!entry) {
+                return false;
+            }
+            group = entry.unwrap();
+            return true;
+        }
+
+        void store(const object_frame& frame, const frame_group& group) {
+            std::lock_guard<std::mutex> lock(mutex);
+            cache.set(key(frame), group);
+        }
+
+        void clear() {
+            std::lock_guard<std::mutex> lock(mutex);
+            cache = lru_cache<std::string, frame_group>(max_cached_frames);
+        }
+    };
+
+    frame_cache& get_frame_cache() {
+        static frame_cache cache;
+        return cache;
+    }
+
+    std::vector<frame_ptr> raw_addresses(const std::vector<object_frame>& frames) {
+        std::vector<frame_ptr> addresses;
+        addresses.reserve(frames.size());
+        for(const auto& frame : frames) {
+            addresses.push_back(frame.raw_address);
+        }
+        return addresses;
+    }
+
+    std::vector<stacktrace_frame> resolve_with_symbol_table(const std::vector<object_frame>& frames) {
+        auto names = lookup_symbol_table_names(frames);
+        std::vector<stacktrace_frame> trace(frames.size(), null_frame());
+        for(std::size_t i = 0; i < frames.size(); i++) {
+            trace[i].symbol = std::move(names[i]);
+        }
+        return trace;
+    }
+
+    // Returns a flattened trace, or nullopt if the back-end isn't available
+    optional<std::vector<stacktrace_frame>> run_stage(symbol_source source, const std::vector<object_frame>& frames) {
+        switch(source) {
+            case symbol_source::server:
+                return remote::resolve_frames(frames);
+            case symbol_source::symbol_table:
+                return resolve_with_symbol_table(frames);
+            case symbol_source::libdwarf:
+                #ifdef CPPTRACE_GET_SYMBOLS_WITH_LIBDWARF
+                 return libdwarf::resolve_frames(frames);
+                #else
+                 break;
+                #endif
+            case symbol_source::libbacktrace:
+                #ifdef CPPTRACE_GET_SYMBOLS_WITH_LIBBACKTRACE
+                 return libbacktrace::resolve_frames(raw_addresses(frames));
+                #else
+                 break;
+                #endif
+            case symbol_source::addr2line:
+                #ifdef CPPTRACE_GET_SYMBOLS_WITH_ADDR2LINE
+                 return addr2line::resolve_frames(frames);
+                #else
+                 break;
+                #endif
+            case symbol_source::libdl:
+                #ifdef CPPTRACE_GET_SYMBOLS_WITH_LIBDL
+                 return libdl::resolve_frames(raw_addresses(frames));
+                #else
+                 break;
+                #endif
+            case symbol_source::dbghelp:
+                #ifdef CPPTRACE_GET_SYMBOLS_WITH_DBGHELP
+                 return dbghelp::resolve_frames(raw_addresses(frames));
+                #else
+                 break;
+                #endif
+            case symbol_source::cache:
+                break;
+        }
+        return nullopt;
+    }
+
+    bool has_line(const stacktrace_frame& frame) {
+        return frame.line.has_value() && frame.line.value() != 0;
+    }
+
+    bool is_resolved(const frame_group& group, bool require_line_info) {
+        const auto& frame = group.back();
+        return !frame.symbol.empty() && (!require_line_info || has_line(frame));
+    }
+
+    // Fills in whatever the group is missing from a later stage's result
+    void merge(frame_group& group, frame_group&& update) {
+        auto& frame = group.back();
+        auto& new_frame = update.back();
+        if(frame.symbol.empty() && !has_line(frame)) {
+            auto raw_address = frame.raw_address;
+            auto object_address = frame.object_address;
+            group = std::move(update);
+            group.back().raw_address = raw_address;
+            group.back().object_address = object_address;
+            return;
+        }
+        if(frame.symbol.empty()) {
+            frame.symbol = std::move(new_frame.symbol);
+        }
+        if(!has_line(frame) && has_line(new_frame)) {
+            frame.filename = std::move(new_frame.filename);
+            frame.line = new_frame.line;
+            frame.column = new_frame.column;
+            // inline information is only meaningful alongside the line information it came with
+            if(group.size() == 1 && update.size() > 1) {
+                update.back() = std::move(frame);
+                group = std::move(update);
+            }
+        }
+    }
+
+    bool enabled() {
+        return chain_enabled.load(std::memory_order_relaxed);
+    }
+
+    std::vector<stacktrace_frame> resolve_frames(const std::vector<object_frame>& frames) {
+        auto config = get_chain();
+        if(!config) {
+            return resolve_frames_locally(frames);
+        }
+        std::vector<frame_group> groups(frames.size());
+        std::vector<std::size_t> pending;
+        pending.reserve(frames.size());
+        for(std::size_t i = 0; i < frames.size(); i++) {
+            auto frame = null_frame();
+            frame.raw_address = frames[i].raw_address;
+            frame.object_address = frames[i].object_address;
+            groups[i].push_back(std::move(frame));
+            pending.push_back(i);
+        }
+        bool use_cache = false;
+        std::vector<bool> from_cache(frames.size(), false);
+        std::vector<object_frame> batch;
+        std::vector<frame_group> results;
+        for(auto stage : config->stages) {
+            if(pending.empty()) {
+                break;
+            }
+            if(stage == symbol_source::cache) {
+                use_cache = true;
+                for(auto i : pending) {
+                    from_cache[i] = get_frame_cache().lookup(frames[i], groups[i]);
+                    // the object may have been loaded at a different address since
+                    groups[i].back().raw_address = frames[i].raw_address;
+                }
+            } else {
+                batch.clear();
+                for(auto i : pending) {
+                    batch.push_back(frames[i]);
+                }
+                try {
+                    auto trace = run_stage(stage, batch);
+                    if(!trace) {
+                        continue;
+                    }
+                    if(!split_inline_groups(std::move(trace).unwrap(), batch.size(), results)) {
+                        throw internal_error("Symbol resolution stage returned an unexpected number of frames");
+                    }
+                } catch(...) { // NOSONAR
+                    detail::log_and_maybe_propagate_exception(std::current_exception());
+                    continue;
+                }
+                for(std::size_t j = 0; j < pending.size(); j++) {
+                    merge(groups[pending[j]], std::move(results[j]));
+                }
+            }
+            std::size_t kept = 0;
+            for(auto i : pending) {
+                if(!from_cache[i] && !is_resolved(groups[i], config->require_line_info)) {
+                    pending[kept++] = i;
+                }
+            }
+            pending.resize(kept);
+        }
+        std::vector<stacktrace_frame> trace;
+        trace.reserve(frames.size());
+        for(std::size_t i = 0; i < frames.size(); i++) {
+            auto& group = groups[i];
+            if(group.back().filename.empty() && !has_line(group.back())) {
+                group.back().filename = frames[i].object_path;
+            }
+            // unresolved frames are cached too so they aren't retried on every trace
+            if(use_cache && !from_cache[i] && !frames[i].object_path.empty()) {
+                get_frame_cache().store(frames[i], group);
+            }
+            trace.insert(trace.end(), std::make_move_iterator(group.begin()), std::make_move_iterator(group.end()));
+        }
+        return trace;
+    }
+}
+}
+
+namespace experimental {
+    void set_symbol_resolution_chain(const std::vector<symbol_source>& chain, bool require_line_info) {
+        std::shared_ptr<const detail::chain::chain_config> config;
+        if(!chain.empty()) {
+            config = std::make_shared<const detail::chain::chain_config>(
+                detail::chain::chain_config{chain, require_line_info}
+            );
+        }
+        {
+            std::lock_guard<std::mutex> lock(detail::chain::chain_mutex);
+            detail::chain::current_chain = std::move(config);
+            detail::chain::chain_enabled = !chain.empty();
+        }
+        // cached results depend on the chain that produced them
+        detail::chain::get_frame_cache().clear();
+    }
+}
+CPPTRACE_END_NAMESPACE
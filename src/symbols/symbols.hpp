@@ -3,12 +3,16 @@
 
 #include <cpptrace/basic.hpp>
 
+#include <cstddef>
 #include <functional>
 #include <string>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include "platform/platform.hpp"
+#include "utils/optional.hpp"
+
 CPPTRACE_BEGIN_NAMESPACE
 namespace detail {
     using collated_vec = std::vector<
@@ -49,7 +53,14 @@ namespace detail {
     #endif
     #ifdef CPPTRACE_GET_SYMBOLS_WITH_ADDR2LINE
     namespace addr2line {
-        std::vector<stacktrace_frame> resolve_frames(const std::vector<object_frame>& frames);
+        // exported for test purposes
+        CPPTRACE_EXPORT std::vector<stacktrace_frame> resolve_frames(const std::vector<object_frame>& frames);
+        #if IS_LINUX || IS_APPLE
+         // Process id of the pooled addr2line process for the object, -1 if there isn't one. Exported for test purposes.
+         CPPTRACE_EXPORT long pooled_process_id(const std::string& object_path);
+         // Returns the previous limit. Exported for test purposes.
+         CPPTRACE_EXPORT std::size_t set_max_pooled_processes(std::size_t count);
+        #endif
     }
     #endif
     #ifdef CPPTRACE_GET_SYMBOLS_WITH_DBGHELP
@@ -64,8 +75,38 @@ namespace detail {
     }
     #endif
 
+    // Client for an out-of-process symbolication server, see experimental::set_symbolication_server
+    namespace remote {
+        bool enabled();
+        // Returns nullopt if the server couldn't be reached or failed, the caller should fall back to resolving
+        // locally
+        optional<std::vector<stacktrace_frame>> resolve_frames(const std::vector<object_frame>& frames);
+    }
+
+    // Runtime configured resolution, see experimental::set_symbol_resolution_chain
+    namespace chain {
+        bool enabled();
+        std::vector<stacktrace_frame> resolve_frames(const std::vector<object_frame>& frames);
+    }
+
+    // Names of the symbols covering each frame, from the objects' symbol tables. Debug info isn't touched. Frames
+    // without an object or a covering symbol get an empty name.
+    std::vector<std::string> lookup_symbol_table_names(const std::vector<object_frame>& frames);
+
+    // Splits a flattened trace back into one group per input frame, inlined frames first followed by the frame for the
+    // actual address. Returns false if the counts don't line up.
+    bool split_inline_groups(
+        std::vector<stacktrace_frame>&& trace,
+        std::size_t count,
+        std::vector<std::vector<stacktrace_frame>>& groups
+    );
+
+    // Resolve frames with the configured resolution chain or out-of-process server, falling back to the in-process backend
     std::vector<stacktrace_frame> resolve_frames(const std::vector<object_frame>& frames);
     std::vector<stacktrace_frame> resolve_frames(const std::vector<frame_ptr>& frames);
+    // Always resolve with the in-process backend
+    std::vector<stacktrace_frame> resolve_frames_locally(const std::vector<object_frame>& frames);
+    std::vector<stacktrace_frame> resolve_frames_locally(const std::vector<frame_ptr>& frames);
 }
 CPPTRACE_END_NAMESPACE
 
@@ -4,11 +4,15 @@
 #include "cpptrace/forward.hpp"
 #include "symbols/symbols.hpp"
 
+#include <string>
 #include <vector>
 #include <unordered_map>
 
 #include "utils/error.hpp"
+#include "binary/elf.hpp"
+#include "binary/mach-o.hpp"
 #include "binary/object.hpp"
+#include "platform/platform.hpp"
 
 CPPTRACE_BEGIN_NAMESPACE
 namespace detail {
@@ -44,6 +48,44 @@ namespace detail {
         return collate_frames<collated_vec_with_inlines>(frames, trace);
     }
 
+    std::vector<std::string> lookup_symbol_table_names(const std::vector<object_frame>& frames) {
+        std::vector<std::string> names(frames.size());
+        #if IS_LINUX || IS_APPLE
+         for(std::size_t i = 0; i < frames.size(); i++) {
+             if(frames[i].object_path.empty()) {
+                 continue;
+             }
+             #if IS_LINUX
+              auto object = open_elf_cached(frames[i].object_path);
+             #else
+              auto object = open_mach_o_cached(frames[i].object_path);
+             #endif
+             if(object) {
+                 names[i] = object.unwrap_value()->lookup_symbol(frames[i].object_address).value_or("");
+             }
+         }
+        #endif
+        return names;
+    }
+
+    bool split_inline_groups(
+        std::vector<stacktrace_frame>&& trace,
+        std::size_t count,
+        std::vector<std::vector<stacktrace_frame>>& groups
+    ) {
+        groups.clear();
+        groups.reserve(count);
+        std::vector<stacktrace_frame> group;
+        for(auto& frame : trace) {
+            group.push_back(std::move(frame));
+            if(!group.back().is_inline) {
+                groups.push_back(std::move(group));
+                group.clear();
+            }
+        }
+        return group.empty() && groups.size() == count;
+    }
+
     /*
      *
      *
@@ -87,6 +129,32 @@ namespace detail {
     // TODO: Symbol resolution code should probably handle when object addresses are 0
 
     std::vector<stacktrace_frame> resolve_frames(const std::vector<object_frame>& frames) {
+        if(chain::enabled()) {
+            return chain::resolve_frames(frames);
+        }
+        if(remote::enabled()) {
+            auto trace = remote::resolve_frames(frames);
+            if(trace) {
+                return std::move(trace).unwrap();
+            }
+        }
+        return resolve_frames_locally(frames);
+    }
+
+    std::vector<stacktrace_frame> resolve_frames(const std::vector<frame_ptr>& frames) {
+        if(chain::enabled()) {
+            return chain::resolve_frames(get_frames_object_info(frames));
+        }
+        if(remote::enabled()) {
+            auto trace = remote::resolve_frames(get_frames_object_info(frames));
+            if(trace) {
+                return std::move(trace).unwrap();
+            }
+        }
+        return resolve_frames_locally(frames);
+    }
+
+    std::vector<stacktrace_frame> resolve_frames_locally(const std::vector<object_frame>& frames) {
         #if defined(CPPTRACE_GET_SYMBOLS_WITH_LIBDWARF) && defined(CPPTRACE_GET_SYMBOLS_WITH_DBGHELP)
          std::vector<stacktrace_frame> trace = libdwarf::resolve_frames(frames);
          fill_blanks(trace, dbghelp::resolve_frames);
@@ -122,7 +190,7 @@ namespace detail {
         #endif
     }
 
-    std::vector<stacktrace_frame> resolve_frames(const std::vector<frame_ptr>& frames) {
+    std::vector<stacktrace_frame> resolve_frames_locally(const std::vector<frame_ptr>& frames) {
         #if defined(CPPTRACE_GET_SYMBOLS_WITH_LIBDWARF) \
             || defined(CPPTRACE_GET_SYMBOLS_WITH_ADDR2LINE)
          auto dlframes = get_frames_object_info(frames);
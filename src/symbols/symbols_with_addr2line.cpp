@@ -4,11 +4,18 @@
 #include "symbols/symbols.hpp"
 #include "utils/common.hpp"
 #include "utils/microfmt.hpp"
+#include "utils/lru_cache.hpp"
 #include "utils/utils.hpp"
 
+#include <algorithm>
+#include <cerrno>
 #include <cstdint>
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
 #include <functional>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <unordered_map>
@@ -16,9 +23,19 @@
 #include <vector>
 
 #if IS_LINUX || IS_APPLE
+ #include <fcntl.h>
+ #include <poll.h>
+ #include <signal.h>
+ #include <spawn.h>
  #include <unistd.h>
+ #include <sys/socket.h>
  #include <sys/types.h>
  #include <sys/wait.h>
+ #if IS_APPLE
+  #include <crt_externs.h>
+ #else
+  extern char** environ;
+ #endif
 #endif
 
 #include "binary/object.hpp"
@@ -27,7 +44,30 @@
 CPPTRACE_BEGIN_NAMESPACE
 namespace detail {
 namespace addr2line {
+    // The addresses to resolve in one object, the result is one line of output per address or an error
+    struct addr2line_batch {
+        const std::string* object_path;
+        std::vector<frame_ptr> addresses;
+        std::vector<std::string> lines;
+        std::exception_ptr error;
+    };
+
     #if IS_LINUX || IS_APPLE
+    #if !IS_APPLE
+     constexpr const char* addr2line_name = "addr2line";
+    #else
+     constexpr const char* addr2line_name = "atos";
+    #endif
+    #ifndef CPPTRACE_ADDR2LINE_SEARCH_SYSTEM_PATH
+     #ifndef CPPTRACE_ADDR2LINE_PATH
+      #error "CPPTRACE_ADDR2LINE_PATH must be defined if CPPTRACE_ADDR2LINE_SEARCH_SYSTEM_PATH is not"
+     #endif
+    #endif
+    // How long to wait on output from addr2line before assuming it's hung
+    constexpr int addr2line_timeout_ms = 30000;
+    // Upper bound on the number of idle addr2line processes kept around
+    constexpr std::size_t max_addr2line_processes = 32;
+
     bool has_addr2line() {
         static std::mutex mutex;
         static bool has_addr2line = false;
@@ -35,113 +75,449 @@ namespace addr2line {
         std::lock_guard<std::mutex> lock(mutex);
         if(!checked) {
             checked = true;
-            // Detects if addr2line exists by trying to invoke addr2line --help
-            constexpr int magic = 42;
-            const pid_t pid = fork();
-            if(pid == -1) { return false; }
-            if(pid == 0) { // child
-                close(STDOUT_FILENO);
-                close(STDERR_FILENO); // atos --help writes to stderr
-                #ifdef CPPTRACE_ADDR2LINE_SEARCH_SYSTEM_PATH
-                #if !IS_APPLE
-                execlp("addr2line", "addr2line", "--help", nullptr);
-                #else
-                execlp("atos", "atos", "--help", nullptr);
-                #endif
-                #else
-                #ifndef CPPTRACE_ADDR2LINE_PATH
-                #error "CPPTRACE_ADDR2LINE_PATH must be defined if CPPTRACE_ADDR2LINE_SEARCH_SYSTEM_PATH is not"
-                #endif
-                execl(CPPTRACE_ADDR2LINE_PATH, CPPTRACE_ADDR2LINE_PATH, "--help", nullptr);
-                #endif
-                _exit(magic);
-            }
-            int status;
-            waitpid(pid, &status, 0);
-            has_addr2line = WEXITSTATUS(status) == 0;
+            // Look for the binary instead of invoking it, forking a large process isn't cheap
+            #ifdef CPPTRACE_ADDR2LINE_SEARCH_SYSTEM_PATH
+             const char* path = std::getenv("PATH");
+             if(path) {
+                 for(const auto& dir : split(path, ":")) {
+                     auto candidate = (dir.empty() ? std::string(".") : dir) + "/" + addr2line_name;
+                     if(access(candidate.c_str(), X_OK) == 0) {
+                         has_addr2line = true;
+                         break;
+                     }
+                 }
+             }
+            #else
+             has_addr2line = access(CPPTRACE_ADDR2LINE_PATH, X_OK) == 0;
+            #endif
         }
         return has_addr2line;
     }
 
-    struct pipe_ends {
-        int read;
-        int write;
-    };
+    char** get_environment() {
+        #if IS_APPLE
+         return *_NSGetEnviron();
+        #else
+         return environ;
+        #endif
+    }
+
+    void set_cloexec(int fd) {
+        fcntl(fd, F_SETFD, FD_CLOEXEC);
+    }
 
-    struct pipe_t {
-        union {
-            pipe_ends end;
-            int data[2];
-        };
+    // posix_spawn wrapper, glibc and macos implement it with vfork semantics so the parent's page tables aren't copied
+    // which matters for large processes
+    class spawn_file_actions {
+        posix_spawn_file_actions_t actions;
+    public:
+        spawn_file_actions() {
+            if(posix_spawn_file_actions_init(&actions) != 0) {
+                throw internal_error("posix_spawn_file_actions_init failed");
+            }
+        }
+        ~spawn_file_actions() {
+            posix_spawn_file_actions_destroy(&actions);
+        }
+        spawn_file_actions(const spawn_file_actions&) = delete;
+        spawn_file_actions& operator=(const spawn_file_actions&) = delete;
+        posix_spawn_file_actions_t* get() {
+            return &actions;
+        }
     };
-    static_assert(sizeof(pipe_t) == 2 * sizeof(int), "Unexpected struct packing");
-
-    std::string resolve_addresses(const std::string& addresses, const std::string& executable) {
-        pipe_t output_pipe;
-        pipe_t input_pipe;
-        if(pipe(output_pipe.data) != 0 || pipe(input_pipe.data) != 0) {
-            throw internal_error("call to pipe failed: {}", errno);
-        }
-        const pid_t pid = fork();
-        if(pid == -1) { return ""; } // error? TODO: Diagnostic
-        if(pid == 0) { // child
-            dup2(output_pipe.end.write, STDOUT_FILENO);
-            dup2(input_pipe.end.read, STDIN_FILENO);
-            close(output_pipe.end.read);
-            close(output_pipe.end.write);
-            close(input_pipe.end.read);
-            close(input_pipe.end.write);
-            close(STDERR_FILENO); // TODO: Might be worth conditionally enabling or piping
-            #ifdef CPPTRACE_ADDR2LINE_SEARCH_SYSTEM_PATH
+
+    std::vector<std::string> addr2line_arguments(const std::string& object_path) {
+        #ifdef CPPTRACE_ADDR2LINE_SEARCH_SYSTEM_PATH
+         std::string program = addr2line_name;
+        #else
+         std::string program = CPPTRACE_ADDR2LINE_PATH;
+        #endif
+        #if !IS_APPLE
+         return {program, "-e", object_path, "-f", "-C", "-p", "-a"};
+        #else
+         return {program, "-o", object_path, "-fullPath"};
+        #endif
+    }
+
+    // A long-lived addr2line process for one object. Addresses are written to its stdin and it responds with one line
+    // per address. GNU addr2line flushes its output after every address so the process can be reused across traces.
+    // A request is driven by run_requests so requests to several processes can be in flight at once.
+    class addr2line_process {
+        pid_t pid = -1;
+        // the parent process, a child that inherits this process after fork mustn't kill it
+        pid_t owner = -1;
+        // a socket rather than a pipe so writing to a dead process fails with EPIPE instead of raising SIGPIPE
+        int input = -1;
+        int output = -1;
+        // output read past the last complete line
+        std::string pending;
+        // in-flight request
+        std::vector<frame_ptr> addresses;
+        std::string request;
+        std::size_t written = 0;
+        bool close_input = false;
+        std::vector<std::string> lines;
+
+        void add_line(std::string line) {
+            if(lines.size() == addresses.size()) {
+                throw internal_error("Unexpected extra addr2line output: {}", line);
+            }
             #if !IS_APPLE
-            execlp("addr2line", "addr2line", "-e", executable.c_str(), "-f", "-C", "-p", nullptr);
-            #else
-            execlp("atos", "atos", "-o", executable.c_str(), "-fullPath", nullptr);
+             // -a prefixes each response with the address it's for, "0x0000000000001234: "
+             auto address = addresses[lines.size()];
+             auto colon = line.find(": ");
+             if(
+                 colon == std::string::npos
+                 || line.compare(0, 2, "0x") != 0
+                 || std::strtoull(line.c_str() + 2, nullptr, 16) != address
+             ) {
+                 throw internal_error("Unexpected addr2line output for address {:h}: {}", address, line);
+             }
+             line.erase(0, colon + 2);
             #endif
-            #else
-            #ifndef CPPTRACE_ADDR2LINE_PATH
-            #error "CPPTRACE_ADDR2LINE_PATH must be defined if CPPTRACE_ADDR2LINE_SEARCH_SYSTEM_PATH is not"
+            lines.push_back(std::move(line));
+        }
+
+    public:
+        std::mutex mutex;
+
+        explicit addr2line_process(const std::string& object_path) {
+            int input_sockets[2];
+            int output_pipe[2];
+            if(socketpair(AF_UNIX, SOCK_STREAM, 0, input_sockets) != 0) {
+                throw internal_error("call to socketpair failed: {}", strerror(errno));
+            }
+            if(pipe(output_pipe) != 0) {
+                close(input_sockets[0]);
+                close(input_sockets[1]);
+                throw internal_error("call to pipe failed: {}", strerror(errno));
+            }
+            auto cleanup = raii_wrap(0, [&](int) {
+                close(input_sockets[1]);
+                close(output_pipe[1]);
+            });
+            // so other addr2line processes don't inherit these, dup2 clears the flag for the child's stdin/stdout
+            for(int fd : {input_sockets[0], input_sockets[1], output_pipe[0], output_pipe[1]}) {
+                set_cloexec(fd);
+            }
+            input = input_sockets[0];
+            output = output_pipe[0];
+            #if IS_APPLE
+             int on = 1;
+             setsockopt(input, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
             #endif
-            #if !IS_APPLE
-            execl(
-                CPPTRACE_ADDR2LINE_PATH,
-                CPPTRACE_ADDR2LINE_PATH,
-                "-e",
-                executable.c_str(),
-                "-f",
-                "-C",
-                "-p",
-                nullptr
-            );
+            spawn_file_actions actions;
+            if(
+                posix_spawn_file_actions_adddup2(actions.get(), input_sockets[1], STDIN_FILENO) != 0
+                || posix_spawn_file_actions_adddup2(actions.get(), output_pipe[1], STDOUT_FILENO) != 0
+                // TODO: Might be worth conditionally enabling or piping
+                || posix_spawn_file_actions_addclose(actions.get(), STDERR_FILENO) != 0
+            ) {
+                close(input);
+                close(output);
+                throw internal_error("Failed to set up posix_spawn file actions");
+            }
+            auto arguments = addr2line_arguments(object_path);
+            std::vector<char*> argv;
+            for(auto& argument : arguments) {
+                argv.push_back(&argument[0]);
+            }
+            argv.push_back(nullptr);
+            #ifdef CPPTRACE_ADDR2LINE_SEARCH_SYSTEM_PATH
+             auto error = posix_spawnp(&pid, argv[0], actions.get(), nullptr, argv.data(), get_environment());
             #else
-            execl(
-                CPPTRACE_ADDR2LINE_PATH,
-                CPPTRACE_ADDR2LINE_PATH,
-                "-o", executable.c_str(),
-                "-fullPath",
-                nullptr
-            );
+             auto error = posix_spawn(&pid, argv[0], actions.get(), nullptr, argv.data(), get_environment());
             #endif
+            if(error != 0) {
+                close(input);
+                close(output);
+                throw internal_error("Failed to spawn {}: {}", argv[0], strerror(error));
+            }
+            owner = getpid();
+        }
+
+        ~addr2line_process() {
+            close(input);
+            close(output);
+            if(owner == getpid()) {
+                kill(pid, SIGKILL);
+                waitpid(pid, nullptr, 0);
+            }
+        }
+
+        addr2line_process(const addr2line_process&) = delete;
+        addr2line_process& operator=(const addr2line_process&) = delete;
+
+        // Starts a request. If close_input is set the process's stdin is closed after the request, for one-off
+        // processes that only produce output once their input ends.
+        void submit(std::vector<frame_ptr> request_addresses, bool close_after) {
+            addresses = std::move(request_addresses);
+            request.clear();
+            for(auto address : addresses) {
+                request += microfmt::format("{:h}\n", address);
+            }
+            written = 0;
+            close_input = close_after;
+            lines.clear();
+            lines.reserve(addresses.size());
+        }
+
+        pid_t process_id() const {
+            return pid;
+        }
+
+        int input_fd() const {
+            return input;
+        }
+
+        int output_fd() const {
+            return output;
+        }
+
+        bool wants_write() const {
+            return written < request.size();
+        }
+
+        bool done() const {
+            return !wants_write() && lines.size() == addresses.size();
+        }
+
+        // Both of these throw if the process died or its output got out of sync, after which the process must not be
+        // reused
+        void on_writable() {
+            #if IS_LINUX
+             constexpr int flags = MSG_NOSIGNAL | MSG_DONTWAIT;
+            #else
+             constexpr int flags = MSG_DONTWAIT;
             #endif
-            _exit(1); // TODO: Diagnostic?
+            auto res = send(input, request.data() + written, request.size() - written, flags);
+            if(res < 0) {
+                if(errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK) {
+                    return;
+                }
+                throw internal_error("write to addr2line failed: {}", strerror(errno));
+            }
+            written += to<std::size_t>(res);
+            if(!wants_write() && close_input) {
+                shutdown(input, SHUT_WR);
+            }
         }
-        if(write(input_pipe.end.write, addresses.data(), addresses.size()) == -1) {
-            throw internal_error("call to write failed: {}", errno);
+
+        void on_readable() {
+            char buffer[4096];
+            auto count = read(output, buffer, sizeof(buffer));
+            if(count < 0) {
+                if(errno == EINTR || errno == EAGAIN) {
+                    return;
+                }
+                throw internal_error("read from addr2line failed: {}", strerror(errno));
+            }
+            if(count == 0) {
+                throw internal_error("addr2line exited unexpectedly");
+            }
+            pending.append(buffer, to<std::size_t>(count));
+            std::size_t start = 0;
+            std::size_t newline;
+            while((newline = pending.find('\n', start)) != std::string::npos) {
+                add_line(pending.substr(start, newline - start));
+                start = newline + 1;
+            }
+            pending.erase(0, start);
         }
-        close(input_pipe.end.read);
-        close(input_pipe.end.write);
-        close(output_pipe.end.write);
-        std::string output;
-        constexpr int buffer_size = 4096;
-        char buffer[buffer_size];
-        std::size_t count = 0;
-        while((count = read(output_pipe.end.read, buffer, buffer_size)) > 0) {
-            output.insert(output.end(), buffer, buffer + count);
+
+        std::vector<std::string> take_lines() {
+            return std::move(lines);
+        }
+    };
+
+    struct addr2line_request {
+        addr2line_process* process;
+        std::exception_ptr error;
+    };
+
+    // Drives submitted requests to completion. All processes work concurrently and their input and output are
+    // interleaved so a process can't block on a full pipe. A failure only affects its own request.
+    void run_requests(std::vector<addr2line_request>& requests) {
+        std::vector<addr2line_request*> active;
+        for(auto& request : requests) {
+            if(request.process->done()) {
+                continue;
+            }
+            active.push_back(&request);
+        }
+        std::vector<pollfd> fds;
+        while(!active.empty()) {
+            fds.clear();
+            for(auto request : active) {
+                auto process = request->process;
+                // negative fds are ignored by poll
+                fds.push_back({process->wants_write() ? process->input_fd() : -1, POLLOUT, 0});
+                fds.push_back({process->output_fd(), POLLIN, 0});
+            }
+            auto ready = poll(fds.data(), to<nfds_t>(fds.size()), addr2line_timeout_ms);
+            if(ready < 0 && errno == EINTR) {
+                continue;
+            }
+            if(ready <= 0) {
+                for(auto request : active) {
+                    request->error = std::make_exception_ptr(internal_error("Timed out waiting for addr2line"));
+                }
+                return;
+            }
+            std::size_t kept = 0;
+            for(std::size_t i = 0; i < active.size(); i++) {
+                auto request = active[i];
+                try {
+                    if(fds[2 * i].revents && request->process->wants_write()) {
+                        request->process->on_writable();
+                    }
+                    if(fds[2 * i + 1].revents) {
+                        request->process->on_readable();
+                    }
+                    if(request->process->done()) {
+                        continue;
+                    }
+                } catch(...) {
+                    request->error = std::current_exception();
+                    continue;
+                }
+                active[kept++] = request;
+            }
+            active.resize(kept);
+        }
+    }
+
+    class addr2line_pool {
+        std::mutex mutex;
+        pid_t owner = getpid();
+        std::size_t limit = max_addr2line_processes;
+        lru_cache<std::string, std::shared_ptr<addr2line_process>> processes{max_addr2line_processes};
+    public:
+        std::shared_ptr<addr2line_process> get(const std::string& object_path) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if(owner != getpid()) {
+                // we're in a forked child, the pooled processes are the parent's
+                owner = getpid();
+                processes = lru_cache<std::string, std::shared_ptr<addr2line_process>>(limit);
+            }
+            auto existing = processes.maybe_get(object_path);
+            if(existing && existing.unwrap()) {
+                return existing.unwrap();
+            }
+            auto process = std::make_shared<addr2line_process>(object_path);
+            processes.set(object_path, process);
+            return process;
+        }
+
+        void discard(const std::string& object_path, const std::shared_ptr<addr2line_process>& process) {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto existing = processes.maybe_get(object_path);
+            if(existing && existing.unwrap() == process) {
+                existing.unwrap().reset();
+            }
+        }
+
+        long process_id(const std::string& object_path) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if(owner != getpid()) {
+                return -1;
+            }
+            auto existing = processes.maybe_peek(object_path);
+            if(existing && existing.unwrap()) {
+                return existing.unwrap()->process_id();
+            }
+            return -1;
+        }
+
+        std::size_t set_limit(std::size_t count) {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto previous = limit;
+            limit = std::max<std::size_t>(1, count);
+            processes.set_max_size(limit);
+            return previous;
+        }
+    };
+
+    addr2line_pool& get_addr2line_pool() {
+        static addr2line_pool pool;
+        return pool;
+    }
+
+    long pooled_process_id(const std::string& object_path) {
+        return get_addr2line_pool().process_id(object_path);
+    }
+
+    std::size_t set_max_pooled_processes(std::size_t count) {
+        return get_addr2line_pool().set_limit(count);
+    }
+
+    void resolve_batches(std::vector<addr2line_batch>& batches) {
+        // atos doesn't reliably flush per address and prioritize_memory shouldn't keep processes around, in those
+        // cases use one-off processes and close their input to get the output
+        #if IS_APPLE
+         constexpr bool pooled = false;
+        #else
+         const bool pooled = get_cache_mode() != cache_mode::prioritize_memory;
+        #endif
+        // sorted so that concurrent callers lock pooled processes in the same order
+        std::sort(batches.begin(), batches.end(), [](const addr2line_batch& a, const addr2line_batch& b) {
+            return *a.object_path < *b.object_path;
+        });
+        std::vector<std::shared_ptr<addr2line_process>> processes(batches.size());
+        std::vector<std::unique_lock<std::mutex>> locks;
+        std::vector<addr2line_request> requests;
+        std::vector<std::size_t> request_batches;
+        for(std::size_t i = 0; i < batches.size(); i++) {
+            try {
+                if(pooled) {
+                    processes[i] = get_addr2line_pool().get(*batches[i].object_path);
+                    locks.emplace_back(processes[i]->mutex);
+                } else {
+                    processes[i] = std::make_shared<addr2line_process>(*batches[i].object_path);
+                }
+                processes[i]->submit(batches[i].addresses, !pooled);
+                requests.push_back({processes[i].get(), nullptr});
+                request_batches.push_back(i);
+            } catch(...) {
+                batches[i].error = std::current_exception();
+            }
+        }
+        run_requests(requests);
+        // output has to be taken before unlocking, another caller's submit() would discard it
+        for(std::size_t i = 0; i < requests.size(); i++) {
+            if(!requests[i].error) {
+                batches[request_batches[i]].lines = processes[request_batches[i]]->take_lines();
+            }
+        }
+        locks.clear();
+        for(std::size_t i = 0; i < requests.size(); i++) {
+            auto& batch = batches[request_batches[i]];
+            auto& process = processes[request_batches[i]];
+            if(!requests[i].error) {
+                continue;
+            }
+            if(!pooled) {
+                batch.error = requests[i].error;
+                continue;
+            }
+            // a pooled process may have crashed or been killed since it was last used, restart it once
+            get_addr2line_pool().discard(*batch.object_path, process);
+            try {
+                auto fresh = get_addr2line_pool().get(*batch.object_path);
+                std::unique_lock<std::mutex> lock(fresh->mutex);
+                fresh->submit(batch.addresses, false);
+                std::vector<addr2line_request> retry{{fresh.get(), nullptr}};
+                run_requests(retry);
+                if(retry[0].error) {
+                    get_addr2line_pool().discard(*batch.object_path, fresh);
+                    batch.error = retry[0].error;
+                } else {
+                    batch.lines = fresh->take_lines();
+                }
+            } catch(...) {
+                batch.error = std::current_exception();
+            }
         }
-        // TODO: check status from addr2line?
-        waitpid(pid, nullptr, 0);
-        close(output_pipe.end.read);
-        return output;
     }
     #elif IS_WINDOWS
     bool has_addr2line() {
@@ -167,7 +543,11 @@ namespace addr2line {
         return has_addr2line;
     }
 
-    std::string resolve_addresses(const std::string& addresses, const std::string& executable) {
+    std::vector<std::string> resolve_addresses(const std::vector<frame_ptr>& address_list, const std::string& executable) {
+        std::string addresses;
+        for(auto address : address_list) {
+            addresses += microfmt::format("{:h} ", address);
+        }
         // TODO: Popen is a hack. Implement properly with CreateProcess and pipes later.
         ///fprintf(stderr, ("addr2line -e " + executable + " -fCp " + addresses + "\n").c_str());
         #ifdef CPPTRACE_ADDR2LINE_SEARCH_SYSTEM_PATH
@@ -190,7 +570,17 @@ namespace addr2line {
         }
         pclose(p);
         ///fprintf(stderr, "%s\n", output.c_str());
-        return output;
+        return split(trim(output), "\n");
+    }
+
+    void resolve_batches(std::vector<addr2line_batch>& batches) {
+        for(auto& batch : batches) {
+            try {
+                batch.lines = resolve_addresses(batch.addresses, *batch.object_path);
+            } catch(...) {
+                batch.error = std::current_exception();
+            }
+        }
     }
     #endif
 
@@ -284,36 +674,36 @@ namespace addr2line {
         }
         if(has_addr2line()) {
             const auto entries = collate_frames(frames, trace);
+            std::vector<addr2line_batch> batches;
             for(const auto& entry : entries) {
+                const auto& object_name = entry.first;
+                const auto& entries_vec = entry.second;
+                // You may ask why it'd ever happen that there could be an empty entries_vec array, if there're
+                // no addresses why would get_addr2line_targets do anything? The reason is because if things in
+                // get_addr2line_targets fail it will silently skip. This is partly an optimization but also an
+                // assertion below will fail if addr2line is given an empty input.
+                if(object_name.empty() || entries_vec.empty()) {
+                    continue;
+                }
+                addr2line_batch batch;
+                batch.object_path = &object_name;
+                batch.addresses.reserve(entries_vec.size());
+                for(const auto& pair : entries_vec) {
+                    batch.addresses.push_back(pair.first.get().object_address);
+                }
+                batches.push_back(std::move(batch));
+            }
+            // objects are resolved concurrently
+            resolve_batches(batches);
+            for(const auto& batch : batches) {
                 try {
-                    const auto& object_name = entry.first;
-                    if(object_name.empty()) {
-                        continue;
-                    }
-                    const auto& entries_vec = entry.second;
-                    // You may ask why it'd ever happen that there could be an empty entries_vec array, if there're
-                    // no addresses why would get_addr2line_targets do anything? The reason is because if things in
-                    // get_addr2line_targets fail it will silently skip. This is partly an optimization but also an
-                    // assertion below will fail if addr2line is given an empty input.
-                    if(entries_vec.empty()) {
-                        continue;
-                    }
-                    std::string address_input;
-                    for(const auto& pair : entries_vec) {
-                        address_input += microfmt::format(
-                            "{:h}{}",
-                            pair.first.get().object_address,
-                        #if !IS_WINDOWS
-                            '\n'
-                        #else
-                            ' '
-                        #endif
-                        );
+                    if(batch.error) {
+                        std::rethrow_exception(batch.error);
                     }
-                    auto output = split(trim(resolve_addresses(address_input, object_name)), "\n");
-                    VERIFY(output.size() == entries_vec.size());
-                    for(std::size_t i = 0; i < output.size(); i++) {
-                        update_trace(output[i], i, entries_vec);
+                    const auto& entries_vec = entries.at(*batch.object_path);
+                    VERIFY(batch.lines.size() == entries_vec.size());
+                    for(std::size_t i = 0; i < batch.lines.size(); i++) {
+                        update_trace(batch.lines[i], i, entries_vec);
                     }
                 } catch(...) { // NOSONAR
                     detail::log_and_maybe_propagate_exception(std::current_exception());
@@ -9,9 +9,12 @@
 
 #include <cstdint>
 #include <cstdio>
+#include <iterator>
 #include <memory>
 #include <mutex>
 #include <stdexcept>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #ifdef CPPTRACE_BACKTRACE_PATH
@@ -23,20 +26,21 @@
 CPPTRACE_BEGIN_NAMESPACE
 namespace detail {
 namespace libbacktrace {
-    int full_callback(void* data, std::uintptr_t address, const char* file, int line, const char* symbol) {
-        stacktrace_frame& frame = *static_cast<stacktrace_frame*>(data);
-        frame.raw_address = address;
-        frame.line = line;
+    // backtrace_pcinfo calls the callback once per function in the inline chain, innermost first, and last for the
+    // function that actually contains the address
+    int full_callback(void* data, std::uintptr_t, const char* file, int line, const char* symbol) {
+        auto& chain = *static_cast<std::vector<stacktrace_frame>*>(data);
+        stacktrace_frame frame = null_frame();
+        frame.line = static_cast<std::uint32_t>(line);
         frame.filename = file ? file : "";
         frame.symbol = symbol ? symbol : "";
+        frame.is_inline = true;
+        chain.push_back(std::move(frame));
         return 0;
     }
 
-    void syminfo_callback(void* data, std::uintptr_t address, const char* symbol, std::uintptr_t, std::uintptr_t) {
+    void syminfo_callback(void* data, std::uintptr_t, const char* symbol, std::uintptr_t, std::uintptr_t) {
         stacktrace_frame& frame = *static_cast<stacktrace_frame*>(data);
-        frame.raw_address = address;
-        frame.line = 0;
-        frame.filename = "";
         frame.symbol = symbol ? symbol : "";
     }
 
@@ -63,40 +67,57 @@ namespace libbacktrace {
         return state;
     }
 
-    // TODO: Handle backtrace_pcinfo calling the callback multiple times on inlined functions
-    stacktrace_frame resolve_frame(const frame_ptr addr) {
+    frame_with_inlines resolve_frame(backtrace_state* state, const frame_ptr addr) {
+        frame_with_inlines result{null_frame(), {}};
+        result.frame.raw_address = addr;
         try {
-            stacktrace_frame frame = null_frame();
-            frame.raw_address = addr;
-            backtrace_pcinfo(
-                get_backtrace_state(),
-                addr,
-                full_callback,
-                error_callback,
-                &frame
-            );
-            if(frame.symbol.empty()) {
+            std::vector<stacktrace_frame> chain;
+            backtrace_pcinfo(state, addr, full_callback, error_callback, &chain);
+            if(!chain.empty()) {
+                auto& frame = result.frame;
+                frame.line = chain.back().line;
+                frame.filename = std::move(chain.back().filename);
+                frame.symbol = std::move(chain.back().symbol);
+                chain.pop_back();
+                if(should_resolve_inlined_calls()) {
+                    // stored outermost first, as the libdwarf backend does
+                    result.inlines.assign(
+                        std::make_move_iterator(chain.rbegin()),
+                        std::make_move_iterator(chain.rend())
+                    );
+                } else if(!chain.empty()) {
+                    // without inline frames report the innermost location
+                    frame.line = chain.front().line;
+                    frame.filename = std::move(chain.front().filename);
+                }
+            }
+            if(result.frame.symbol.empty()) {
                 // fallback, try to at least recover the symbol name with backtrace_syminfo
-                backtrace_syminfo(
-                    get_backtrace_state(),
-                    addr,
-                    syminfo_callback,
-                    error_callback,
-                    &frame
-                );
+                backtrace_syminfo(state, addr, syminfo_callback, error_callback, &result.frame);
             }
-            return frame;
         } catch(...) { // NOSONAR
             detail::log_and_maybe_propagate_exception(std::current_exception());
-            return null_frame();
         }
+        return result;
     }
 
+    // Each distinct address is only looked up once, e.g. for recursion or a batch of many traces
     std::vector<stacktrace_frame> resolve_frames(const std::vector<frame_ptr>& frames) {
+        backtrace_state* state = get_backtrace_state();
+        std::unordered_map<frame_ptr, frame_with_inlines> resolved;
+        resolved.reserve(frames.size());
+        for(const auto frame : frames) {
+            if(resolved.find(frame) == resolved.end()) {
+                resolved.emplace(frame, resolve_frame(state, frame));
+            }
+        }
         std::vector<stacktrace_frame> trace;
         trace.reserve(frames.size());
         for(const auto frame : frames) {
-            trace.push_back(resolve_frame(frame));
+            const auto& entry = resolved.at(frame);
+            // most recent call first
+            trace.insert(trace.end(), entry.inlines.rbegin(), entry.inlines.rend());
+            trace.push_back(entry.frame);
         }
         return trace;
     }
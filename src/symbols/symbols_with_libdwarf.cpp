@@ -6,6 +6,7 @@
 
 #include "dwarf/resolver.hpp"
 #include "utils/common.hpp"
+#include "utils/stats.hpp"
 #include "utils/utils.hpp"
 #include "binary/elf.hpp"
 #include "binary/mach-o.hpp"
@@ -22,6 +23,7 @@ CPPTRACE_BEGIN_NAMESPACE
 namespace detail {
 namespace libdwarf {
     std::unique_ptr<symbol_resolver> get_resolver_for_object(const std::string& object_path) {
+        stage_timer timer(stat_stage::resolver_construction);
         #if IS_APPLE
         // Check if dSYM exist, if not fallback to debug map
         if(!directory_exists(object_path + ".dSYM")) {
@@ -36,6 +38,7 @@ namespace libdwarf {
         // cache resolvers since objects are likely to be traced more than once
         static std::unordered_map<std::string, std::unique_ptr<symbol_resolver>> resolver_map;
         auto it = resolver_map.find(object_name);
+        record_cache_access(stat_cache::resolver, it != resolver_map.end());
         if(it != resolver_map.end()) {
             return it->second.get();
         } else {
@@ -0,0 +1,292 @@
+#include <cpptrace/thread_dump.hpp>
+#include <cpptrace/formatting.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "demangle/demangle.hpp"
+#include "logging.hpp"
+#include "platform/platform.hpp"
+#include "platform/thread_capture.hpp"
+#include "symbols/symbols.hpp"
+#include "unwind/unwind.hpp"
+#include "utils/error.hpp"
+#include "utils/microfmt.hpp"
+#include "utils/utils.hpp"
+
+#if IS_LINUX
+ #include <csignal>
+ #include <fcntl.h>
+ #include <pthread.h>
+ #include <unistd.h>
+#endif
+
+CPPTRACE_BEGIN_NAMESPACE
+namespace detail {
+    // Resolves every distinct address once. Idle threads tend to share nearly all of their frames, so this is much less
+    // work than resolving each thread's trace separately.
+    std::vector<stacktrace> resolve_thread_stacks(const thread_capture& capture) {
+        std::vector<frame_ptr> addresses;
+        std::unordered_map<frame_ptr, std::size_t> indices;
+        for(std::size_t i = 0; i < capture.size(); i++) {
+            const auto& thread = capture[i];
+            for(std::size_t j = 0; j < thread.depth; j++) {
+                if(indices.emplace(thread.frames[j], addresses.size()).second) {
+                    addresses.push_back(thread.frames[j]);
+                }
+            }
+        }
+        auto resolved = resolve_frames(addresses);
+        // inlined calls are placed before the frame they're inlined into
+        std::vector<std::vector<stacktrace_frame>> groups;
+        std::vector<stacktrace_frame> group;
+        for(auto& frame : resolved) {
+            frame.symbol = demangle(frame.symbol, true);
+            bool is_inline = frame.is_inline;
+            group.push_back(std::move(frame));
+            if(!is_inline) {
+                groups.push_back(std::move(group));
+                group.clear();
+            }
+        }
+        bool grouped = groups.size() == addresses.size();
+        std::vector<stacktrace> traces(capture.size());
+        for(std::size_t i = 0; i < capture.size(); i++) {
+            const auto& thread = capture[i];
+            auto& frames = traces[i].frames;
+            if(grouped) {
+                for(std::size_t j = 0; j < thread.depth; j++) {
+                    const auto& frame_group = groups[indices[thread.frames[j]]];
+                    frames.insert(frames.end(), frame_group.begin(), frame_group.end());
+                }
+            } else {
+                frames = resolve_frames(std::vector<frame_ptr>(thread.frames, thread.frames + thread.depth));
+                for(auto& frame : frames) {
+                    frame.symbol = demangle(frame.symbol, true);
+                }
+            }
+        }
+        return traces;
+    }
+
+    std::mutex thread_dump_mutex;
+
+    CPPTRACE_FORCE_NO_INLINE
+    std::vector<experimental::thread_trace> dump_all_threads(
+        const experimental::thread_dump_options& options,
+        std::size_t skip
+    ) {
+        std::lock_guard<std::mutex> lock(thread_dump_mutex);
+        auto signal = get_capture_signal(options.capture_signal);
+        if(options.max_depth == 0 || !install_thread_capture_handler(signal)) {
+            return {};
+        }
+        thread_capture capture(
+            std::max<std::size_t>(1, options.max_threads),
+            std::min(options.max_depth, hard_max_frames),
+            signal
+        );
+        if(!capture.capture(skip + 1, options.timeout_ms)) {
+            return {};
+        }
+        auto traces = resolve_thread_stacks(capture);
+        std::vector<experimental::thread_trace> threads;
+        threads.reserve(capture.size());
+        for(std::size_t i = 0; i < capture.size(); i++) {
+            const auto& thread = capture[i];
+            threads.push_back({
+                static_cast<std::uint64_t>(thread.thread_id),
+                thread.name,
+                thread.state.load() == captured_thread::missed,
+                std::move(traces[i])
+            });
+        }
+        return threads;
+    }
+
+    std::string thread_dump_to_string(const std::vector<experimental::thread_trace>& threads, bool color) {
+        auto formatter = cpptrace::formatter{}.header("");
+        std::string output;
+        for(const auto& thread : threads) {
+            output += microfmt::format("Thread {} \"{}\"", thread.thread_id, thread.name);
+            if(thread.missed) {
+                output += " (didn't respond in time)";
+            }
+            output += ":\n";
+            output += formatter.format(thread.trace, color);
+            output += "\n\n";
+        }
+        return output;
+    }
+
+#if IS_LINUX
+    struct thread_dump_handler {
+        int output_fd;
+        experimental::thread_dump_options options;
+        int wake_pipe[2];
+        std::thread thread;
+        struct sigaction previous_action;
+    };
+
+    std::mutex thread_dump_handler_mutex;
+    std::unique_ptr<thread_dump_handler> active_thread_dump_handler;
+    std::atomic<int> thread_dump_wake_fd{-1};
+    // number of SIGQUIT handlers currently running, so the pipe isn't closed out from under one of them
+    std::atomic<std::size_t> active_thread_dump_signals{0};
+
+    void write_wake_byte(int fd, char byte) {
+        while(write(fd, &byte, 1) < 0 && errno == EINTR) {}
+    }
+
+    void thread_dump_signal_handler(int) {
+        int saved_errno = errno;
+        active_thread_dump_signals.fetch_add(1);
+        int fd = thread_dump_wake_fd.load();
+        if(fd != -1) {
+            write_wake_byte(fd, 'd');
+        }
+        active_thread_dump_signals.fetch_sub(1);
+        errno = saved_errno;
+    }
+
+    void write_all(int fd, const std::string& data) {
+        std::size_t written = 0;
+        while(written < data.size()) {
+            auto res = write(fd, data.data() + written, data.size() - written);
+            if(res < 0) {
+                if(errno == EINTR) {
+                    continue;
+                }
+                return;
+            }
+            written += static_cast<std::size_t>(res);
+        }
+    }
+
+    void thread_dump_loop(const thread_dump_handler& handler) {
+        pthread_setname_np(pthread_self(), "cpptrace-dump");
+        for(;;) {
+            char byte;
+            auto res = read(handler.wake_pipe[0], &byte, 1);
+            if(res < 0 && errno == EINTR) {
+                continue;
+            }
+            if(res <= 0 || byte == 'q') {
+                return;
+            }
+            try {
+                write_all(handler.output_fd, detail::thread_dump_to_string(detail::dump_all_threads(handler.options, 0), false));
+            } catch(...) {
+                log_and_maybe_propagate_exception(std::current_exception());
+            }
+        }
+    }
+
+    void uninstall_thread_dump_handler_locked() {
+        if(!active_thread_dump_handler) {
+            return;
+        }
+        auto& handler = *active_thread_dump_handler;
+        sigaction(SIGQUIT, &handler.previous_action, nullptr);
+        thread_dump_wake_fd.store(-1);
+        while(active_thread_dump_signals.load() != 0) {
+            std::this_thread::yield();
+        }
+        // dumps already requested are written first
+        write_wake_byte(handler.wake_pipe[1], 'q');
+        handler.thread.join();
+        close(handler.wake_pipe[0]);
+        close(handler.wake_pipe[1]);
+        active_thread_dump_handler.reset();
+    }
+
+    bool install_thread_dump_handler(int fd, const experimental::thread_dump_options& options) {
+        std::lock_guard<std::mutex> lock(thread_dump_handler_mutex);
+        uninstall_thread_dump_handler_locked();
+        if(!install_thread_capture_handler(get_capture_signal(options.capture_signal))) {
+            return false;
+        }
+        std::unique_ptr<thread_dump_handler> handler(new thread_dump_handler{});
+        handler->output_fd = fd;
+        handler->options = options;
+        if(pipe2(handler->wake_pipe, O_CLOEXEC) != 0) {
+            return false;
+        }
+        // the signal handler mustn't block if requests pile up faster than dumps are written
+        fcntl(handler->wake_pipe[1], F_SETFL, O_NONBLOCK);
+        struct sigaction action{};
+        action.sa_handler = thread_dump_signal_handler;
+        action.sa_flags = SA_RESTART;
+        sigemptyset(&action.sa_mask);
+        if(sigaction(SIGQUIT, &action, &handler->previous_action) != 0) {
+            close(handler->wake_pipe[0]);
+            close(handler->wake_pipe[1]);
+            return false;
+        }
+        thread_dump_wake_fd.store(handler->wake_pipe[1]);
+        handler->thread = std::thread(thread_dump_loop, std::cref(*handler));
+        active_thread_dump_handler = std::move(handler);
+        return true;
+    }
+
+    void uninstall_thread_dump_handler() {
+        std::lock_guard<std::mutex> lock(thread_dump_handler_mutex);
+        uninstall_thread_dump_handler_locked();
+    }
+#else
+    bool install_thread_dump_handler(int, const experimental::thread_dump_options&) {
+        return false;
+    }
+
+    void uninstall_thread_dump_handler() {}
+#endif
+}
+
+namespace experimental {
+    CPPTRACE_FORCE_NO_INLINE
+    std::vector<thread_trace> dump_all_threads(const thread_dump_options& options) {
+        try {
+            return detail::dump_all_threads(options, 1);
+        } catch(...) {
+            detail::log_and_maybe_propagate_exception(std::current_exception());
+            return {};
+        }
+    }
+
+    std::string thread_dump_to_string(const std::vector<thread_trace>& threads, bool color) {
+        try {
+            return detail::thread_dump_to_string(threads, color);
+        } catch(...) {
+            detail::log_and_maybe_propagate_exception(std::current_exception());
+            return "";
+        }
+    }
+
+    bool install_thread_dump_handler(int fd, const thread_dump_options& options) {
+        try {
+            return detail::install_thread_dump_handler(fd, options);
+        } catch(...) {
+            detail::log_and_maybe_propagate_exception(std::current_exception());
+            return false;
+        }
+    }
+
+    void uninstall_thread_dump_handler() {
+        try {
+            detail::uninstall_thread_dump_handler();
+        } catch(...) {
+            detail::log_and_maybe_propagate_exception(std::current_exception());
+        }
+    }
+}
+CPPTRACE_END_NAMESPACE
@@ -0,0 +1,311 @@
+#include <cpptrace/trace_table.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "logging.hpp"
+#include "utils/error.hpp"
+#include "utils/utils.hpp"
+
+CPPTRACE_BEGIN_NAMESPACE
+namespace detail {
+    // Nodes are immutable once published other than the lazily computed resolution results
+    struct trace_table_node {
+        std::size_t hash;
+        experimental::stack_id id;
+        std::size_t count;
+        const trace_table_node* next;
+        mutable std::atomic<stacktrace*> resolved{nullptr};
+        mutable std::atomic<std::string*> formatted{nullptr};
+        const frame_ptr* frames;
+
+        bool matches(std::size_t other_hash, const frame_ptr* other_frames, std::size_t other_count) const {
+            return hash == other_hash
+                && count == other_count
+                && std::equal(frames, frames + count, other_frames);
+        }
+    };
+
+    // Bump allocator, only used with the table's insert lock held
+    class trace_table_arena {
+        static constexpr std::size_t chunk_size = 64 * 1024;
+        std::vector<std::unique_ptr<char[]>> chunks;
+        char* current = nullptr;
+        std::size_t remaining = 0;
+    public:
+        void* allocate(std::size_t size) {
+            constexpr auto alignment = alignof(std::max_align_t);
+            size = (size + alignment - 1) & ~(alignment - 1);
+            if(size > remaining) {
+                auto new_size = std::max(size, chunk_size);
+                chunks.emplace_back(new char[new_size]);
+                current = chunks.back().get();
+                remaining = new_size;
+            }
+            void* ptr = current;
+            current += size;
+            remaining -= size;
+            return ptr;
+        }
+    };
+
+    // Maps ids to nodes. Segment i holds 2^i * base_size entries so segments never need to be reallocated.
+    class trace_table_directory {
+        static constexpr unsigned base_bits = 10;
+        static constexpr std::size_t n_segments = 33 - base_bits;
+        std::atomic<std::atomic<const trace_table_node*>*> segments[n_segments];
+
+        static void locate(experimental::stack_id id, std::size_t& segment, std::size_t& offset) {
+            std::uint64_t value = std::uint64_t(id) + (std::uint64_t(1) << base_bits);
+            unsigned top_bit = base_bits;
+            while(value >> (top_bit + 1)) {
+                top_bit++;
+            }
+            segment = top_bit - base_bits;
+            offset = static_cast<experimental::stack_id>(value - (std::uint64_t(1) << top_bit));
+        }
+    public:
+        trace_table_directory() {
+            for(auto& segment : segments) {
+                segment.store(nullptr, std::memory_order_relaxed);
+            }
+        }
+        ~trace_table_directory() {
+            for(auto& segment : segments) {
+                delete[] segment.load(std::memory_order_relaxed);
+            }
+        }
+        trace_table_directory(const trace_table_directory&) = delete;
+        trace_table_directory& operator=(const trace_table_directory&) = delete;
+
+        // Must be called with the table's insert lock held
+        void set(experimental::stack_id id, const trace_table_node* node) {
+            std::size_t segment;
+            std::size_t offset;
+            locate(id, segment, offset);
+            auto entries = segments[segment].load(std::memory_order_relaxed);
+            if(!entries) {
+                std::size_t segment_size = std::size_t(1) << (segment + base_bits);
+                entries = new std::atomic<const trace_table_node*>[segment_size];
+                for(std::size_t i = 0; i < segment_size; i++) {
+                    entries[i].store(nullptr, std::memory_order_relaxed);
+                }
+                segments[segment].store(entries, std::memory_order_release);
+            }
+            entries[offset].store(node, std::memory_order_release);
+        }
+
+        const trace_table_node* get(experimental::stack_id id) const {
+            std::size_t segment;
+            std::size_t offset;
+            locate(id, segment, offset);
+            auto entries = segments[segment].load(std::memory_order_acquire);
+            if(!entries) {
+                return nullptr;
+            }
+            return entries[offset].load(std::memory_order_acquire);
+        }
+    };
+}
+
+namespace experimental {
+    class trace_table::impl {
+        std::unique_ptr<std::atomic<const detail::trace_table_node*>[]> buckets;
+        std::size_t bucket_mask;
+        detail::trace_table_directory directory;
+        std::atomic<std::size_t> count{0};
+        std::mutex insert_mutex;
+        detail::trace_table_arena arena;
+
+        const detail::trace_table_node* find_node(
+            std::size_t hash,
+            const frame_ptr* frames,
+            std::size_t frame_count
+        ) const {
+            auto node = buckets[hash & bucket_mask].load(std::memory_order_acquire);
+            while(node) {
+                if(node->matches(hash, frames, frame_count)) {
+                    return node;
+                }
+                node = node->next;
+            }
+            return nullptr;
+        }
+
+        const detail::trace_table_node& get_node(stack_id id) const {
+            if(id >= count.load(std::memory_order_acquire)) {
+                throw detail::internal_error("Invalid stack id {}", id);
+            }
+            auto node = directory.get(id);
+            ASSERT(node != nullptr);
+            return *node;
+        }
+
+    public:
+        explicit impl(std::size_t bucket_count) {
+            std::size_t size = 1;
+            while(size < bucket_count) {
+                size <<= 1;
+            }
+            buckets = std::unique_ptr<std::atomic<const detail::trace_table_node*>[]>(
+                new std::atomic<const detail::trace_table_node*>[size]
+            );
+            for(std::size_t i = 0; i < size; i++) {
+                buckets[i].store(nullptr, std::memory_order_relaxed);
+            }
+            bucket_mask = size - 1;
+        }
+
+        ~impl() {
+            auto n = count.load();
+            for(std::size_t i = 0; i < n; i++) {
+                auto node = directory.get(static_cast<stack_id>(i));
+                delete node->resolved.load();
+                delete node->formatted.load();
+                node->~trace_table_node();
+            }
+        }
+
+        stack_id insert(const frame_ptr* frames, std::size_t frame_count) {
+            auto hash = detail::hash_frames(frames, frame_count);
+            if(auto node = find_node(hash, frames, frame_count)) {
+                return node->id;
+            }
+            std::unique_lock<std::mutex> lock(insert_mutex);
+            // another thread may have inserted the stack while we were waiting
+            if(auto node = find_node(hash, frames, frame_count)) {
+                return node->id;
+            }
+            auto id = count.load(std::memory_order_relaxed);
+            if(id >= nullable<stack_id>::null_value()) {
+                throw detail::internal_error("trace_table is full");
+            }
+            auto frames_copy = static_cast<frame_ptr*>(arena.allocate(sizeof(frame_ptr) * frame_count));
+            if(frame_count) {
+                std::memcpy(frames_copy, frames, sizeof(frame_ptr) * frame_count);
+            }
+            auto& bucket = buckets[hash & bucket_mask];
+            auto node = new (arena.allocate(sizeof(detail::trace_table_node))) detail::trace_table_node;
+            node->hash = hash;
+            node->id = static_cast<stack_id>(id);
+            node->count = frame_count;
+            node->next = bucket.load(std::memory_order_relaxed);
+            node->frames = frames_copy;
+            directory.set(node->id, node);
+            count.store(id + 1, std::memory_order_release);
+            bucket.store(node, std::memory_order_release);
+            return node->id;
+        }
+
+        nullable<stack_id> find(const frame_ptr* frames, std::size_t frame_count) const {
+            auto node = find_node(detail::hash_frames(frames, frame_count), frames, frame_count);
+            if(node) {
+                return node->id;
+            }
+            return nullable<stack_id>::null();
+        }
+
+        raw_trace get(stack_id id) const {
+            auto& node = get_node(id);
+            return raw_trace{std::vector<frame_ptr>(node.frames, node.frames + node.count)};
+        }
+
+        const stacktrace& resolve(stack_id id) const {
+            auto& node = get_node(id);
+            auto resolved = node.resolved.load(std::memory_order_acquire);
+            if(resolved) {
+                return *resolved;
+            }
+            // concurrent first calls may both resolve, only one result is kept
+            std::unique_ptr<stacktrace> trace(new stacktrace(get(id).resolve()));
+            if(node.resolved.compare_exchange_strong(resolved, trace.get(), std::memory_order_acq_rel)) {
+                return *trace.release();
+            }
+            return *resolved;
+        }
+
+        const std::string& to_string(stack_id id) const {
+            auto& node = get_node(id);
+            auto formatted = node.formatted.load(std::memory_order_acquire);
+            if(formatted) {
+                return *formatted;
+            }
+            std::unique_ptr<std::string> str(new std::string(resolve(id).to_string()));
+            if(node.formatted.compare_exchange_strong(formatted, str.get(), std::memory_order_acq_rel)) {
+                return *str.release();
+            }
+            return *formatted;
+        }
+
+        std::size_t size() const {
+            return count.load(std::memory_order_acquire);
+        }
+    };
+
+    trace_table::trace_table() : trace_table(4096) {}
+
+    trace_table::trace_table(std::size_t buckets) : pimpl(new impl(std::max<std::size_t>(buckets, 1))) {}
+
+    trace_table::~trace_table() {
+        delete pimpl;
+    }
+
+    stack_id trace_table::insert(const raw_trace& trace) {
+        return insert(trace.frames.data(), trace.frames.size());
+    }
+
+    stack_id trace_table::insert(const frame_ptr* frames, std::size_t count) {
+        try {
+            return pimpl->insert(frames, count);
+        } catch(...) {
+            detail::log_and_maybe_propagate_exception(std::current_exception());
+            return nullable<stack_id>::null_value();
+        }
+    }
+
+    nullable<stack_id> trace_table::find(const frame_ptr* frames, std::size_t count) const {
+        return pimpl->find(frames, count);
+    }
+
+    raw_trace trace_table::get(stack_id id) const {
+        try {
+            return pimpl->get(id);
+        } catch(...) {
+            detail::log_and_maybe_propagate_exception(std::current_exception());
+            return raw_trace{};
+        }
+    }
+
+    const stacktrace& trace_table::resolve(stack_id id) const {
+        try {
+            return pimpl->resolve(id);
+        } catch(...) {
+            detail::log_and_maybe_propagate_exception(std::current_exception());
+            static const stacktrace empty;
+            return empty;
+        }
+    }
+
+    const std::string& trace_table::to_string(stack_id id) const {
+        try {
+            return pimpl->to_string(id);
+        } catch(...) {
+            detail::log_and_maybe_propagate_exception(std::current_exception());
+            static const std::string empty;
+            return empty;
+        }
+    }
+
+    std::size_t trace_table::size() const {
+        return pimpl->size();
+    }
+}
+CPPTRACE_END_NAMESPACE
@@ -3,6 +3,7 @@
 #include <cpptrace/basic.hpp>
 #include "unwind/unwind.hpp"
 #include "utils/common.hpp"
+#include "utils/stats.hpp"
 #include "utils/utils.hpp"
 #include "platform/dbghelp_utils.hpp"
 
@@ -29,6 +30,7 @@ namespace detail {
         std::size_t max_depth,
         EXCEPTION_POINTERS* exception_pointers
     ) {
+        stage_timer timer(stat_stage::unwinding);
         // https://jpassing.com/2008/03/12/walking-the-stack-of-the-current-thread/
 
         // Get current thread context
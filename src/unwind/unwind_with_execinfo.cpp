@@ -2,6 +2,7 @@
 
 #include "unwind/unwind.hpp"
 #include "utils/common.hpp"
+#include "utils/stats.hpp"
 #include "utils/utils.hpp"
 
 #include <algorithm>
@@ -15,6 +16,7 @@ CPPTRACE_BEGIN_NAMESPACE
 namespace detail {
     CPPTRACE_FORCE_NO_INLINE
     std::vector<frame_ptr> capture_frames(std::size_t skip, std::size_t max_depth) {
+        stage_timer timer(stat_stage::unwinding);
         skip++;
         std::vector<void*> addrs(skip + std::min(hard_max_frames, max_depth), nullptr);
         // thread safe
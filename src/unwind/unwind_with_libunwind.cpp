@@ -3,6 +3,7 @@
 #include "unwind/unwind.hpp"
 #include "utils/common.hpp"
 #include "utils/error.hpp"
+#include "utils/stats.hpp"
 #include "utils/utils.hpp"
 
 #include <algorithm>
@@ -16,6 +17,7 @@ CPPTRACE_BEGIN_NAMESPACE
 namespace detail {
     CPPTRACE_FORCE_NO_INLINE
     std::vector<frame_ptr> capture_frames(std::size_t skip, std::size_t max_depth) {
+        stage_timer timer(stat_stage::unwinding);
         skip++;
         std::vector<frame_ptr> frames;
         unw_context_t context;
@@ -3,6 +3,7 @@
 #include "unwind/unwind.hpp"
 #include "utils/common.hpp"
 #include "utils/error.hpp"
+#include "utils/stats.hpp"
 #include "utils/utils.hpp"
 
 #include <algorithm>
@@ -54,6 +55,7 @@ namespace detail {
 
     CPPTRACE_FORCE_NO_INLINE
     std::vector<frame_ptr> capture_frames(std::size_t skip, std::size_t max_depth) {
+        stage_timer timer(stat_stage::unwinding);
         std::vector<frame_ptr> frames;
         unwind_state state{skip + 1, max_depth, frames};
         _Unwind_Backtrace(unwind_callback, &state); // presumably thread-safe
@@ -66,7 +66,7 @@ namespace detail {
     template<typename... Args>
     void nullfn(Args&&...);
 
-    #define PHONY_USE(...) (static_cast<decltype(nullfn(__VA_ARGS__))>(0))
+    #define PHONY_USE(...) (static_cast<decltype(::cpptrace::detail::nullfn(__VA_ARGS__))>(0))
 
     // Work around a compiler warning
     template<typename T>
@@ -62,6 +62,16 @@ namespace detail {
             }
         }
 
+        // Doesn't count as a use
+        optional<const V&> maybe_peek(const K& key) const {
+            auto it = map.find(key);
+            if(it == map.end()) {
+                return nullopt;
+            } else {
+                return it->second->value;
+            }
+        }
+
         void set(const K& key, V value) {
             auto it = map.find(key);
             if(it == map.end()) {
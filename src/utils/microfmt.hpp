@@ -8,13 +8,12 @@
 #include <iostream>
 #include <iterator>
 #include <string>
+#include <type_traits>
 #if ((defined(_MSVC_LANG) && _MSVC_LANG >= 201703L) || __cplusplus >= 201703L)
  #include <string_view>
 #endif
-#ifdef _MSC_VER
- #include <intrin.h>
-#endif
 
+#include "utils/output_sink.hpp"
 #include "utils/string_view.hpp"
 
 // https://github.com/jeremy-rifkin/microfmt
@@ -23,27 +22,6 @@
 CPPTRACE_BEGIN_NAMESPACE
 namespace microfmt {
     namespace detail {
-        inline std::uint64_t clz(std::uint64_t value) {
-            #ifdef _MSC_VER
-             unsigned long out = 0;
-             #ifdef _WIN64
-              _BitScanReverse64(&out, value);
-             #else
-              if(_BitScanReverse(&out, std::uint32_t(value >> 32))) {
-                  return 63 - int(out + 32);
-              }
-              _BitScanReverse(&out, std::uint32_t(value));
-             #endif
-             return 63 - out;
-            #else
-             return __builtin_clzll(value);
-            #endif
-        }
-
-        template<typename U, typename V> U to(V v) {
-            return static_cast<U>(v); // A way to cast to U without "warning: useless cast to type"
-        }
-
         enum class alignment { left, right };
 
         struct format_options {
@@ -69,35 +47,36 @@ namespace microfmt {
             }
         }
 
+        // Enough for a 64-bit number in binary plus a sign
+        constexpr std::size_t max_number_length = 65;
+
+        // Numbers are written backwards into the end of a buffer, these return the first character written
         template<int shift, int mask>
-        std::string to_string(std::uint64_t value, const char* digits = "0123456789abcdef") {
-            if(value == 0) {
-                return "0";
-            } else {
-                // digits = floor(1 + log_base(x))
-                // log_base(x) = log_2(x) / log_2(base)
-                // log_2(x) == 63 - clz(x)
-                // 1 + (63 - clz(value)) / (63 - clz(1 << shift))
-                // 63 - clz(1 << shift) is the same as shift
-                auto n_digits = to<std::size_t>(1 + (63 - clz(value)) / shift);
-                std::string number;
-                number.resize(n_digits);
-                std::size_t i = n_digits - 1;
-                while(value > 0) {
-                    number[i--] = digits[value & mask];
-                    value >>= shift;
-                }
-                return number;
-            }
+        char* write_number(std::uint64_t value, char* end, const char* digits = "0123456789abcdef") {
+            char* begin = end;
+            do {
+                *--begin = digits[value & mask];
+                value >>= shift;
+            } while(value > 0);
+            return begin;
+        }
+
+        inline char* write_decimal(std::uint64_t value, char* end) {
+            char* begin = end;
+            do {
+                *--begin = static_cast<char>('0' + value % 10);
+                value /= 10;
+            } while(value > 0);
+            return begin;
         }
 
-        inline std::string to_string(std::uint64_t value, const format_options& options) {
+        inline char* write_number(std::uint64_t value, const format_options& options, char* end) {
             switch(options.base) {
-                case 'H': return to_string<4, 0xf>(value, "0123456789ABCDEF");
-                case 'h': return to_string<4, 0xf>(value);
-                case 'o': return to_string<3, 0x7>(value);
-                case 'b': return to_string<1, 0x1>(value);
-                default: return std::to_string(value); // failure: decimal
+                case 'H': return write_number<4, 0xf>(value, end, "0123456789ABCDEF");
+                case 'h': return write_number<4, 0xf>(value, end);
+                case 'o': return write_number<3, 0x7>(value, end);
+                case 'b': return write_number<1, 0x1>(value, end);
+                default: return write_decimal(value, end); // failure: decimal
             }
         }
 
@@ -162,20 +141,24 @@ namespace microfmt {
                         break;
                     case value_type::int64_value:
                         {
-                            std::string str;
-                            std::int64_t val = int64_value;
-                            if(val < 0) {
-                                str += '-';
-                                val *= -1;
+                            char buffer[max_number_length];
+                            auto end = buffer + max_number_length;
+                            // negate as unsigned, negating the minimum value as signed would overflow
+                            auto magnitude = int64_value < 0
+                                ? 0 - static_cast<std::uint64_t>(int64_value)
+                                : static_cast<std::uint64_t>(int64_value);
+                            auto begin = write_number(magnitude, options, end);
+                            if(int64_value < 0) {
+                                *--begin = '-';
                             }
-                            str += to_string(static_cast<std::uint64_t>(val), options);
-                            do_write(out, str.begin(), str.end(), options);
+                            do_write(out, begin, end, options);
                         }
                         break;
                     case value_type::uint64_value:
                         {
-                            std::string str = to_string(uint64_value, options);
-                            do_write(out, str.begin(), str.end(), options);
+                            char buffer[max_number_length];
+                            auto end = buffer + max_number_length;
+                            do_write(out, write_number(uint64_value, options, end), end, options);
                         }
                         break;
                     case value_type::string_value:
@@ -291,7 +274,12 @@ namespace microfmt {
         return str;
     }
 
-    template<typename S, typename... Args>
+    template<
+        typename S,
+        typename... Args,
+        // sinks derived from output_sink would otherwise bind here as the format string
+        typename std::enable_if<!std::is_base_of<cpptrace::detail::output_sink, S>::value, int>::type = 0
+    >
     void print(const S& fmt, Args&&... args) {
         detail::format(std::ostream_iterator<char>(detail::get_cout()), fmt, {args...});
     }
@@ -301,6 +289,11 @@ namespace microfmt {
         detail::format(std::ostream_iterator<char>(ostream), fmt, {args...});
     }
 
+    template<typename S, typename... Args>
+    void print(cpptrace::detail::output_sink& sink, const S& fmt, Args&&... args) {
+        detail::format(sink.out(), fmt, {args...});
+    }
+
     template<typename S, typename... Args>
     void print(std::FILE* stream, const S& fmt, Args&&... args) {
         auto str = format(fmt, args...);
@@ -0,0 +1,144 @@
+#ifndef OUTPUT_SINK_HPP
+#define OUTPUT_SINK_HPP
+
+#include <cpptrace/forward.hpp>
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <ostream>
+
+#include "utils/string_view.hpp"
+
+CPPTRACE_BEGIN_NAMESPACE
+namespace detail {
+    // Buffered output for the formatter. Writes collect in a fixed-size buffer that's part of the sink, usually on the
+    // stack, and reach the destination one buffer at a time. Derived sinks provide the destination and must flush in
+    // their destructors.
+    class output_sink {
+        char* buffer;
+        std::size_t capacity;
+        std::size_t used = 0;
+
+    protected:
+        output_sink(char* buffer, std::size_t capacity) : buffer(buffer), capacity(capacity) {}
+        ~output_sink() = default;
+
+        virtual void write_out(const char* data, std::size_t size) = 0;
+
+    public:
+        output_sink(const output_sink&) = delete;
+        output_sink& operator=(const output_sink&) = delete;
+
+        void put(char c) {
+            if(used == capacity) {
+                flush();
+            }
+            buffer[used++] = c;
+        }
+
+        void write(const char* data, std::size_t size) {
+            if(size > capacity - used) {
+                flush();
+                if(size >= capacity) {
+                    write_out(data, size);
+                    return;
+                }
+            }
+            std::memcpy(buffer + used, data, size);
+            used += size;
+        }
+
+        void write(string_view str) {
+            write(str.data(), str.size());
+        }
+
+        void flush() {
+            if(used != 0) {
+                write_out(buffer, used);
+                used = 0;
+            }
+        }
+
+        // Output iterator for microfmt
+        class iterator {
+            output_sink* sink;
+        public:
+            using iterator_category = std::output_iterator_tag;
+            using value_type = void;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = void;
+
+            explicit iterator(output_sink& sink) : sink(&sink) {}
+            iterator& operator=(char c) {
+                sink->put(c);
+                return *this;
+            }
+            iterator& operator*() {
+                return *this;
+            }
+            iterator& operator++() {
+                return *this;
+            }
+            iterator& operator++(int) {
+                return *this;
+            }
+        };
+
+        iterator out() {
+            return iterator(*this);
+        }
+    };
+
+    constexpr std::size_t output_sink_buffer_size = 4096;
+
+    class string_sink final : public output_sink {
+        std::string& string;
+        char storage[output_sink_buffer_size];
+
+        void write_out(const char* data, std::size_t size) override {
+            string.append(data, size);
+        }
+
+    public:
+        explicit string_sink(std::string& string) : output_sink(storage, sizeof(storage)), string(string) {}
+        ~string_sink() {
+            flush();
+        }
+    };
+
+    class ostream_sink final : public output_sink {
+        std::ostream& stream;
+        char storage[output_sink_buffer_size];
+
+        void write_out(const char* data, std::size_t size) override {
+            stream.write(data, static_cast<std::streamsize>(size));
+        }
+
+    public:
+        explicit ostream_sink(std::ostream& stream) : output_sink(storage, sizeof(storage)), stream(stream) {}
+        ~ostream_sink() {
+            flush();
+        }
+    };
+
+    class file_sink final : public output_sink {
+        std::FILE* file;
+        char storage[output_sink_buffer_size];
+
+        void write_out(const char* data, std::size_t size) override {
+            std::fwrite(data, 1, size, file);
+        }
+
+    public:
+        explicit file_sink(std::FILE* file) : output_sink(storage, sizeof(storage)), file(file) {}
+        ~file_sink() {
+            flush();
+        }
+    };
+}
+CPPTRACE_END_NAMESPACE
+
+#endif
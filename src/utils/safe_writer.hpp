@@ -0,0 +1,105 @@
+#ifndef SAFE_WRITER_HPP
+#define SAFE_WRITER_HPP
+
+#include <cpptrace/forward.hpp>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "platform/platform.hpp"
+
+#if IS_WINDOWS
+ #include <io.h>
+#else
+ #include <unistd.h>
+#endif
+
+CPPTRACE_BEGIN_NAMESPACE
+namespace detail {
+    // Output for signal handlers: a small fixed buffer drained with write(2), nothing here allocates or locks
+    class safe_writer {
+        int fd;
+        char buffer[256];
+        std::size_t used = 0;
+
+        void write_out(const char* data, std::size_t size) {
+            while(size > 0) {
+                #if IS_WINDOWS
+                 auto written = _write(fd, data, static_cast<unsigned>(size));
+                #else
+                 auto written = ::write(fd, data, size);
+                #endif
+                if(written < 0) {
+                    if(errno == EINTR) {
+                        continue;
+                    }
+                    return;
+                }
+                data += written;
+                size -= static_cast<std::size_t>(written);
+            }
+        }
+
+    public:
+        explicit safe_writer(int fd) : fd(fd) {}
+        ~safe_writer() {
+            flush();
+        }
+        safe_writer(const safe_writer&) = delete;
+        safe_writer& operator=(const safe_writer&) = delete;
+
+        void flush() {
+            write_out(buffer, used);
+            used = 0;
+        }
+
+        void put(char c) {
+            if(used == sizeof(buffer)) {
+                flush();
+            }
+            buffer[used++] = c;
+        }
+
+        void write(const char* str, std::size_t size) {
+            for(std::size_t i = 0; i < size; i++) {
+                put(str[i]);
+            }
+        }
+
+        void write(const char* str) {
+            write(str, std::strlen(str));
+        }
+
+        void write_hex(std::uintptr_t value, std::size_t min_digits = 0) {
+            char digits[2 * sizeof(value)];
+            std::size_t n = 0;
+            do {
+                digits[n++] = "0123456789abcdef"[value & 0xf];
+                value >>= 4;
+            } while(value > 0);
+            for(; n < min_digits && n < sizeof(digits); n++) {
+                digits[n] = '0';
+            }
+            while(n > 0) {
+                put(digits[--n]);
+            }
+        }
+
+        void write_decimal(std::size_t value) {
+            char digits[20];
+            std::size_t n = 0;
+            do {
+                digits[n++] = static_cast<char>('0' + value % 10);
+                value /= 10;
+            } while(value > 0);
+            while(n > 0) {
+                put(digits[--n]);
+            }
+        }
+    };
+}
+CPPTRACE_END_NAMESPACE
+
+#endif
@@ -0,0 +1,88 @@
+#ifndef STATS_HPP
+#define STATS_HPP
+
+#include <cpptrace/forward.hpp>
+
+#include <cstddef>
+
+#ifdef CPPTRACE_STATS
+ #include <atomic>
+ #include <chrono>
+ #include <cstdint>
+#endif
+
+CPPTRACE_BEGIN_NAMESPACE
+namespace detail {
+    enum class stat_stage {
+        unwinding,
+        object_lookup,
+        resolver_construction,
+        cu_lookup,
+        line_tables,
+        inline_walk,
+        demangling,
+        formatting,
+        snippets,
+        count
+    };
+
+    enum class stat_cache {
+        demangle,
+        object,
+        resolver,
+        line_table,
+        snippet,
+        count
+    };
+
+    #ifdef CPPTRACE_STATS
+     struct stage_counter {
+         std::atomic<std::uint64_t> count{0};
+         std::atomic<std::uint64_t> nanoseconds{0};
+     };
+
+     struct cache_counter {
+         std::atomic<std::uint64_t> hits{0};
+         std::atomic<std::uint64_t> misses{0};
+     };
+
+     extern stage_counter stage_counters[static_cast<std::size_t>(stat_stage::count)];
+     extern cache_counter cache_counters[static_cast<std::size_t>(stat_cache::count)];
+
+     // Adds the time from construction to destruction to a stage
+     class stage_timer {
+         stat_stage stage;
+         std::chrono::steady_clock::time_point start;
+     public:
+         explicit stage_timer(stat_stage stage) : stage(stage), start(std::chrono::steady_clock::now()) {}
+         ~stage_timer() {
+             auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                 std::chrono::steady_clock::now() - start
+             ).count();
+             auto& counter = stage_counters[static_cast<std::size_t>(stage)];
+             counter.count.fetch_add(1, std::memory_order_relaxed);
+             counter.nanoseconds.fetch_add(static_cast<std::uint64_t>(elapsed), std::memory_order_relaxed);
+         }
+         stage_timer(const stage_timer&) = delete;
+         stage_timer& operator=(const stage_timer&) = delete;
+     };
+
+     inline void record_cache_access(stat_cache cache, bool hit) {
+         auto& counter = cache_counters[static_cast<std::size_t>(cache)];
+         (hit ? counter.hits : counter.misses).fetch_add(1, std::memory_order_relaxed);
+     }
+    #else
+     // Without CPPTRACE_STATS these compile away entirely
+     class stage_timer {
+     public:
+         explicit stage_timer(stat_stage) {}
+         stage_timer(const stage_timer&) = delete;
+         stage_timer& operator=(const stage_timer&) = delete;
+     };
+
+     inline void record_cache_access(stat_cache, bool) {}
+    #endif
+}
+CPPTRACE_END_NAMESPACE
+
+#endif
@@ -6,6 +6,7 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <functional>
 #include <memory>
 #include <string>
 #include <type_traits>
@@ -304,6 +305,14 @@ namespace detail {
         return std::unique_ptr<T>(new T(std::forward<T>(arg)));
     }
 
+    inline std::size_t hash_frames(const frame_ptr* frames, std::size_t count) {
+        std::size_t hash = count;
+        for(std::size_t i = 0; i < count; i++) {
+            hash ^= std::hash<frame_ptr>{}(frames[i]) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+        }
+        return hash;
+    }
+
     template<typename T>
     class maybe_owned {
         std::unique_ptr<T> owned;
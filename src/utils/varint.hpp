@@ -0,0 +1,49 @@
+#ifndef VARINT_HPP
+#define VARINT_HPP
+
+#include <cpptrace/forward.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+CPPTRACE_BEGIN_NAMESPACE
+namespace detail {
+    constexpr std::size_t max_varint_size = 10;
+
+    // LEB128, returns the number of bytes written
+    inline std::size_t encode_varint(std::uint64_t value, std::uint8_t* out) {
+        std::size_t i = 0;
+        while(value >= 0x80) {
+            out[i++] = static_cast<std::uint8_t>(value | 0x80);
+            value >>= 7;
+        }
+        out[i++] = static_cast<std::uint8_t>(value);
+        return i;
+    }
+
+    // Bounds checked, advances offset on success
+    inline bool decode_varint(const std::uint8_t* data, std::size_t size, std::size_t& offset, std::uint64_t& value) {
+        std::uint64_t result = 0;
+        for(std::size_t i = 0; i < max_varint_size && offset + i < size; i++) {
+            auto byte = data[offset + i];
+            result |= std::uint64_t(byte & 0x7f) << (7 * i);
+            if(!(byte & 0x80)) {
+                offset += i + 1;
+                value = result;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    inline std::uint64_t zigzag_encode(std::int64_t value) {
+        return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+    }
+
+    inline std::int64_t zigzag_decode(std::uint64_t value) {
+        return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+    }
+}
+CPPTRACE_END_NAMESPACE
+
+#endif
@@ -101,4 +101,15 @@ TEST(LruCacheTest, Touch) {
     EXPECT_EQ(cache.maybe_get(0).unwrap(), 50);
 }
 
+TEST(LruCacheTest, PeekDoesNotTouch) {
+    lru_cache<int, int> cache(2);
+    cache.insert(1, 10);
+    cache.insert(2, 20);
+    EXPECT_EQ(cache.maybe_peek(1).unwrap(), 10);
+    EXPECT_FALSE(cache.maybe_peek(3).has_value());
+    cache.insert(3, 30);
+    EXPECT_FALSE(cache.maybe_peek(1).has_value());
+    EXPECT_EQ(cache.maybe_peek(2).unwrap(), 20);
+}
+
 }
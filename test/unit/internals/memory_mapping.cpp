@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+#include <gtest/gtest-matchers.h>
+#include <gmock/gmock.h>
+#include <gmock/gmock-matchers.h>
+
+#include <cstdint>
+#include <cstring>
+#include <tuple>
+#include <vector>
+
+#include "platform/memory_mapping.hpp"
+#include "utils/error.hpp"
+
+#ifdef __linux__
+
+using cpptrace::detail::address_range;
+using cpptrace::detail::mapped_region_cache;
+using cpptrace::detail::parse_map_entry;
+
+namespace {
+
+using region = std::tuple<std::uintptr_t, std::uintptr_t, int>;
+
+std::vector<region> regions_of(const mapped_region_cache& cache) {
+    std::vector<region> regions;
+    for(const auto& range : cache.regions) {
+        regions.emplace_back(range.low, range.high, range.perms);
+    }
+    return regions;
+}
+
+TEST(MemoryMapping, ParseMapEntry) {
+    const char maps[] =
+        "55d0c0a00000-55d0c0a21000 r-xp 00000000 08:01 1234                       /usr/bin/program\n"
+        "7f3a1c000000-7f3a1c021000 rw-p 00000000 00:00 0 \n"
+        "7ffc8e5f0000-7ffc8e611000 ---p 00000000 00:00 0                          [stack]";
+    const char* it = maps;
+    const char* end = maps + std::strlen(maps);
+    auto first = parse_map_entry(it, end);
+    EXPECT_EQ(first.low, 0x55d0c0a00000);
+    EXPECT_EQ(first.high, 0x55d0c0a21000);
+    EXPECT_EQ(first.perms, PROT_READ | PROT_EXEC);
+    EXPECT_EQ(*it, '7');
+    auto second = parse_map_entry(it, end);
+    EXPECT_EQ(second.low, 0x7f3a1c000000);
+    EXPECT_EQ(second.high, 0x7f3a1c021000);
+    EXPECT_EQ(second.perms, PROT_READ | PROT_WRITE);
+    // the last line doesn't need a newline
+    auto third = parse_map_entry(it, end);
+    EXPECT_EQ(third.low, 0x7ffc8e5f0000);
+    EXPECT_EQ(third.high, 0x7ffc8e611000);
+    EXPECT_EQ(third.perms, 0);
+    EXPECT_EQ(it, end);
+}
+
+TEST(MemoryMapping, ParseMalformedMapEntry) {
+    for(const char* line : {"", "55d0c0a00000 r-xp", "55d0c0a00000-55d0c0a21000", "55d0c0a00000-55d0c0a21000 r"}) {
+        const char* it = line;
+        EXPECT_THROW(parse_map_entry(it, line + std::strlen(line)), cpptrace::detail::internal_error) << line;
+    }
+}
+
+class MappedRegionCacheTest : public testing::Test {
+protected:
+    mapped_region_cache cache;
+
+    void SetUp() override {
+        cache.regions = {
+            address_range{0x1000, 0x5000, PROT_READ},
+            address_range{0x5000, 0x8000, PROT_READ | PROT_WRITE}
+        };
+        cache.loaded = true;
+    }
+};
+
+TEST_F(MappedRegionCacheTest, SplitIntoThree) {
+    cache.set_protections(0x2000, 0x3000, PROT_READ | PROT_WRITE);
+    EXPECT_THAT(
+        regions_of(cache),
+        testing::ElementsAre(
+            region{0x1000, 0x2000, PROT_READ},
+            region{0x2000, 0x3000, PROT_READ | PROT_WRITE},
+            region{0x3000, 0x5000, PROT_READ},
+            region{0x5000, 0x8000, PROT_READ | PROT_WRITE}
+        )
+    );
+    EXPECT_EQ(cache.find(0x1fff).unwrap(), PROT_READ);
+    EXPECT_EQ(cache.find(0x2800).unwrap(), PROT_READ | PROT_WRITE);
+    EXPECT_EQ(cache.find(0x3000).unwrap(), PROT_READ);
+    EXPECT_TRUE(cache.loaded);
+}
+
+TEST_F(MappedRegionCacheTest, SplitAtEdges) {
+    cache.set_protections(0x1000, 0x2000, PROT_NONE);
+    cache.set_protections(0x7000, 0x8000, PROT_READ);
+    EXPECT_THAT(
+        regions_of(cache),
+        testing::ElementsAre(
+            region{0x1000, 0x2000, PROT_NONE},
+            region{0x2000, 0x5000, PROT_READ},
+            region{0x5000, 0x7000, PROT_READ | PROT_WRITE},
+            region{0x7000, 0x8000, PROT_READ}
+        )
+    );
+}
+
+TEST_F(MappedRegionCacheTest, WholeRangeAndUnchanged) {
+    auto before = regions_of(cache);
+    cache.set_protections(0x2000, 0x3000, PROT_READ);
+    EXPECT_EQ(regions_of(cache), before);
+    cache.set_protections(0x5000, 0x8000, PROT_READ);
+    EXPECT_THAT(
+        regions_of(cache),
+        testing::ElementsAre(region{0x1000, 0x5000, PROT_READ}, region{0x5000, 0x8000, PROT_READ})
+    );
+}
+
+TEST_F(MappedRegionCacheTest, UnmappedAndSpanning) {
+    auto before = regions_of(cache);
+    // not in the cache, left for a lookup to miss and reload
+    cache.set_protections(0x9000, 0xa000, PROT_READ);
+    EXPECT_EQ(regions_of(cache), before);
+    EXPECT_TRUE(cache.loaded);
+    // crosses into the next range, the cache is invalidated instead
+    cache.set_protections(0x4000, 0x6000, PROT_NONE);
+    EXPECT_FALSE(cache.loaded);
+}
+
+}
+
+#endif
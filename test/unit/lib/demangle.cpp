@@ -0,0 +1,155 @@
+#include <gtest/gtest.h>
+#include <gtest/gtest-matchers.h>
+#include <gmock/gmock.h>
+#include <gmock/gmock-matchers.h>
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+
+#ifdef TEST_MODULE
+import cpptrace;
+#else
+#include <cpptrace/utils.hpp>
+#endif
+
+namespace {
+
+// Itanium ABI names
+#ifndef _MSC_VER
+
+TEST(DemangleTests, Basic) {
+    EXPECT_EQ(cpptrace::demangle("_ZN3foo3barEv"), "foo::bar()");
+    EXPECT_EQ(cpptrace::demangle("_ZN3foo3barEv"), "foo::bar()");
+    EXPECT_EQ(cpptrace::demangle("not a mangled name"), "not a mangled name");
+}
+
+TEST(DemangleTests, IntoBuffer) {
+    char buffer[64];
+    EXPECT_EQ(cpptrace::experimental::demangle_into("_ZN3foo3barEi", buffer, sizeof(buffer)), 13);
+    EXPECT_STREQ(buffer, "foo::bar(int)");
+    // cached the second time around
+    std::memset(buffer, 0, sizeof(buffer));
+    EXPECT_EQ(cpptrace::experimental::demangle_into("_ZN3foo3barEi", buffer, sizeof(buffer)), 13);
+    EXPECT_STREQ(buffer, "foo::bar(int)");
+}
+
+TEST(DemangleTests, IntoBufferTruncates) {
+    char buffer[4] = {'x', 'x', 'x', 'x'};
+    EXPECT_EQ(cpptrace::experimental::demangle_into("_ZN3foo3barEv", buffer, sizeof(buffer)), 10);
+    EXPECT_STREQ(buffer, "foo");
+    EXPECT_EQ(cpptrace::experimental::demangle_into("_ZN3foo3barEv", buffer, 0), 10);
+    EXPECT_STREQ(buffer, "foo");
+}
+
+TEST(DemangleTests, CacheCanBeDisabled) {
+    cpptrace::experimental::set_demangle_cache_size(0);
+    EXPECT_EQ(cpptrace::demangle("_ZN3foo3bazEv"), "foo::baz()");
+    char buffer[64];
+    EXPECT_EQ(cpptrace::experimental::demangle_into("_ZN3foo3bazEv", buffer, sizeof(buffer)), 10);
+    EXPECT_STREQ(buffer, "foo::baz()");
+    // tiny budgets just mean nothing fits
+    cpptrace::experimental::set_demangle_cache_size(16);
+    EXPECT_EQ(cpptrace::demangle("_ZN3foo3bazEv"), "foo::baz()");
+    EXPECT_EQ(cpptrace::demangle("_ZN3foo3bazEv"), "foo::baz()");
+    cpptrace::experimental::set_demangle_cache_size(cpptrace::experimental::default_demangle_cache_size);
+}
+
+#endif
+
+// The built-in demangler is available everywhere
+
+std::string demangle_signal_safe(
+    const char* name,
+    cpptrace::experimental::demangle_mode mode = cpptrace::experimental::demangle_mode::full
+) {
+    char buffer[512];
+    auto length = cpptrace::experimental::demangle_signal_safe(name, buffer, sizeof(buffer), mode);
+    EXPECT_EQ(length, std::strlen(buffer));
+    return buffer;
+}
+
+std::string prune_signal_safe(const char* name) {
+    return demangle_signal_safe(name, cpptrace::experimental::demangle_mode::pruned);
+}
+
+TEST(DemangleSignalSafeTests, Basic) {
+    EXPECT_EQ(demangle_signal_safe("_ZN3foo3barEv"), "foo::bar()");
+    EXPECT_EQ(demangle_signal_safe("__ZN3foo3barEv"), "foo::bar()");
+    EXPECT_EQ(demangle_signal_safe("_Z1fPFviE"), "f(void (*)(int))");
+    EXPECT_EQ(demangle_signal_safe("_Z1fRA10_i"), "f(int (&) [10])");
+    EXPECT_EQ(demangle_signal_safe("_ZN12_GLOBAL__N_13fooEv"), "(anonymous namespace)::foo()");
+    EXPECT_EQ(demangle_signal_safe("_ZN3FooIiE3barEv.cold"), "Foo<int>::bar() (.cold)");
+    EXPECT_EQ(demangle_signal_safe("_ZTV3Foo"), "vtable for Foo");
+    EXPECT_EQ(demangle_signal_safe("Pi"), "int*");
+}
+
+TEST(DemangleSignalSafeTests, Templates) {
+    EXPECT_EQ(demangle_signal_safe("_Z1fIJidEEvDpT_"), "void f<int, double>(int, double)");
+    EXPECT_EQ(demangle_signal_safe("_ZN1AcvT_IiEEv"), "A::operator int<int>()");
+    EXPECT_EQ(demangle_signal_safe("_Z1fIiEDTcl1gfp_EET_"), "decltype(g(fp)) f<int>(int)");
+    EXPECT_EQ(
+        demangle_signal_safe("_ZNSt6vectorIS_IiSaIiEESaIS1_EE9push_backERKS1_"),
+        "std::vector<std::vector<int, std::allocator<int> >, std::allocator<std::vector<int, std::allocator<int> > > >"
+        "::push_back(std::vector<int, std::allocator<int> > const&)"
+    );
+    EXPECT_EQ(
+        demangle_signal_safe("_ZNSsC1Ev"),
+        "std::basic_string<char, std::char_traits<char>, std::allocator<char> >::basic_string()"
+    );
+    EXPECT_EQ(
+        demangle_signal_safe("_ZNSt8ios_base7failureB5cxx11D1Ev"),
+        "std::ios_base::failure[abi:cxx11]::~failure()"
+    );
+}
+
+TEST(DemangleSignalSafeTests, Lambdas) {
+    EXPECT_EQ(
+        demangle_signal_safe("_ZZ4mainENKUlT_E_clIiEEDaS_"),
+        "auto main::'lambda'(auto)::operator()<int>(auto) const"
+    );
+    EXPECT_EQ(demangle_signal_safe("_ZZN1N1fEvENUlvE_clEv"), "N::f()::'lambda'()::operator()()");
+}
+
+TEST(DemangleSignalSafeTests, Pruned) {
+    EXPECT_EQ(prune_signal_safe("_ZN3foo3barEv"), "foo::bar");
+    EXPECT_EQ(prune_signal_safe("_Z1fIJidEEvDpT_"), "f");
+    EXPECT_EQ(prune_signal_safe("_ZN3FooIiE3barEv.cold"), "Foo::bar");
+    EXPECT_EQ(prune_signal_safe("_ZN1SIiEC2Ev"), "S::S");
+    EXPECT_EQ(prune_signal_safe("_ZNSsC1Ev"), "std::basic_string::basic_string");
+    EXPECT_EQ(prune_signal_safe("_ZZ4mainENKUlT_E_clIiEEDaS_"), "main::<lambda>::operator()");
+    EXPECT_EQ(prune_signal_safe("_ZN1AcvT_IiEEv"), "A::operator int");
+    EXPECT_EQ(prune_signal_safe("_ZTv0_n24_N3Foo3barEv"), "Foo::bar");
+    EXPECT_EQ(prune_signal_safe("_ZNSt8ios_base7failureB5cxx11D1Ev"), "std::ios_base::failure::~failure");
+}
+
+TEST(DemangleSignalSafeTests, Truncation) {
+    char buffer[4] = {'x', 'x', 'x', 'x'};
+    EXPECT_EQ(cpptrace::experimental::demangle_signal_safe("_ZN3foo3barEv", buffer, sizeof(buffer)), 10);
+    EXPECT_STREQ(buffer, "foo");
+    EXPECT_EQ(cpptrace::experimental::demangle_signal_safe("_ZN3foo3barEv", nullptr, 0), 10);
+}
+
+TEST(DemangleSignalSafeTests, Failure) {
+    char buffer[64] = "x";
+    EXPECT_EQ(cpptrace::experimental::demangle_signal_safe("not a mangled name", buffer, sizeof(buffer)), 0);
+    EXPECT_STREQ(buffer, "");
+    EXPECT_EQ(cpptrace::experimental::demangle_signal_safe("_ZN3foo3bar", buffer, sizeof(buffer)), 0);
+    // too little scratch space
+    alignas(std::max_align_t) char scratch[64];
+    EXPECT_EQ(
+        cpptrace::experimental::demangle_signal_safe(
+            "_ZNSt6vectorIS_IiSaIiEESaIS1_EE9push_backERKS1_",
+            buffer,
+            sizeof(buffer),
+            scratch,
+            sizeof(scratch)
+        ),
+        0
+    );
+    // deeply nested names don't overflow the stack
+    std::string deep = "_Z1f" + std::string(100000, 'P') + "i";
+    EXPECT_EQ(cpptrace::experimental::demangle_signal_safe(deep.c_str(), buffer, sizeof(buffer)), 0);
+}
+
+}
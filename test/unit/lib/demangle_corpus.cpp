@@ -0,0 +1,376 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <string>
+
+#ifdef TEST_MODULE
+import cpptrace;
+#else
+#include <cpptrace/utils.hpp>
+#endif
+
+// Table-driven tests for the built-in demangler. The names cover the productions exercised by LLVM's demangler test
+// corpus (see the test case links in src/prune_symbol.cpp) and the expected output is llvm-cxxfilt 14's. For a larger
+// comparison over the symbols of real binaries see tools/demangle_compare.
+
+namespace {
+
+struct demangle_case {
+    const char* mangled;
+    const char* expected;
+};
+
+const demangle_case llvm_cases[] = {
+    {"_Z1A", "A"},
+    {"_Z1Av", "A()"},
+    {"_Z1A1B1C", "A(B, C)"},
+    {"_Z4testI1A1BE1Cv", "C test<A, B>()"},
+    {"_Z4testI1A1BET0_T_S3_", "B test<A, B>(A, A)"},
+    {"_ZN1SgtEi", "S::operator>(int)"},
+    {"_ZrsI1QEiT_", "int operator>><Q>(Q)"},
+    {"_Z1fv", "f()"},
+    {"_Z1fi", "f(int)"},
+    {"_Z3foo3bar", "foo(bar)"},
+    {"_Zrm1XS_", "operator%(X, X)"},
+    {"_ZplR1XS0_", "operator+(X&, X&)"},
+    {"_ZlsRK1XS1_", "operator<<(X const&, X const&)"},
+    {"_ZN3FooIA4_iE3barE", "Foo<int [4]>::bar"},
+    {"_Z1fIiEvi", "void f<int>(int)"},
+    {"_Z5firstIiEvS_", "void first<int>(first)"},
+    {"_Z1fIiEvT_", "void f<int>(int)"},
+    {"_Z3fooIidEvi", "void foo<int, double>(int)"},
+    {"_ZN1N1fIiEEvT_", "void N::f<int>(int)"},
+    {"_ZN1N2N21fIiEEvT_", "void N::N2::f<int>(int)"},
+    {"_Z3absILi11EEvv", "void abs<11>()"},
+    {"_ZN1AIfEcvT_IiEEv", "A<float>::operator int<int>()"},
+    {"_Z1fPFvvEM1SFvvE", "f(void (*)(), void (S::*)())"},
+    {"_ZN1N1TIiiE2mfES0_IddE", "N::T<int, int>::mf(N::T<double, double>)"},
+    {"_ZZN1N1fEiE1p", "N::f(int)::p"},
+    {"_ZZN1N1fEiEs", "N::f(int)::string literal"},
+    {"_Z1fPFPA1_ivE", "f(int (* (*)()) [1])"},
+    {"_ZNSt9exceptionD1Ev", "std::exception::~exception()"},
+    {"_ZNSt9exceptionD0Ev", "std::exception::~exception()"},
+    {"_ZNSt9exceptionD2Ev", "std::exception::~exception()"},
+    {"_ZN1AC1Ev", "A::A()"},
+    {"_ZN1AC2ERKS_", "A::A(A const&)"},
+    {"_ZN1AC1EOS_", "A::A(A&&)"},
+    {"_ZNK1A3fooEv", "A::foo() const"},
+    {"_ZNV1A3fooEv", "A::foo() volatile"},
+    {"_ZNVK1A3fooEv", "A::foo() const volatile"},
+    {"_ZNR1A3fooEv", "A::foo() &"},
+    {"_ZNO1A3fooEv", "A::foo() &&"},
+    {"_ZNKR1A3fooEv", "A::foo() const &"},
+    {"_ZN1A3fooEPKcz", "A::foo(char const*, ...)"},
+    {"_Z1fPKPVi", "f(int volatile* const*)"},
+    {"_Z1fRKi", "f(int const&)"},
+    {"_Z1fOi", "f(int&&)"},
+    {"_Z1fPi", "f(int*)"},
+    {"_Z1fRA10_i", "f(int (&) [10])"},
+    {"_Z1fPA10_A20_i", "f(int (*) [10][20])"},
+    {"_Z1fM1AKFvvE", "f(void (A::*)() const)"},
+    {"_Z1fM1Ai", "f(int A::*)"},
+    {"_Z1fM1AFivE", "f(int (A::*)())"},
+    {"_Z1fPM1AFivE", "f(int (A::**)())"},
+    {"_Z1fPFivE", "f(int (*)())"},
+    {"_Z1fPFvPFivEE", "f(void (*)(int (*)()))"},
+    {"_Z1fDn", "f(std::nullptr_t)"},
+    {"_Z1fDv4_f", "f(float vector[4])"},
+    {"_Z1fCf", "f(float complex)"},
+    {"_Z1fGd", "f(double imaginary)"},
+    {"_Z1fU8__vectori", "f(int __vector)"},
+    {"_Z1fx", "f(long long)"},
+    {"_Z1fy", "f(unsigned long long)"},
+    {"_Z1fn", "f(__int128)"},
+    {"_Z1fo", "f(unsigned __int128)"},
+    {"_Z1fe", "f(long double)"},
+    {"_Z1fg", "f(__float128)"},
+    {"_Z1fDh", "f(half)"},
+    {"_Z1fDF16_", "f(_Float16)"},
+    {"_Z1fDs", "f(char16_t)"},
+    {"_Z1fDi", "f(char32_t)"},
+    {"_Z1fDu", "f(char8_t)"},
+    {"_Z1fw", "f(wchar_t)"},
+    {"_Z1fa", "f(signed char)"},
+    {"_Z1fh", "f(unsigned char)"},
+    {"_Z1fs", "f(short)"},
+    {"_Z1ft", "f(unsigned short)"},
+    {"_Z1fj", "f(unsigned int)"},
+    {"_Z1fl", "f(long)"},
+    {"_Z1fm", "f(unsigned long)"},
+    {"_Z1fb", "f(bool)"},
+    {"_Z1fc", "f(char)"},
+    {"_Z1ff", "f(float)"},
+    {"_Z1fd", "f(double)"},
+    {"_ZN12_GLOBAL__N_13fooEv", "(anonymous namespace)::foo()"},
+    {"_ZN12_GLOBAL__N_11AC1Ev", "(anonymous namespace)::A::A()"},
+    {"_ZTV1A", "vtable for A"},
+    {"_ZTT1A", "VTT for A"},
+    {"_ZTI1A", "typeinfo for A"},
+    {"_ZTS1A", "typeinfo name for A"},
+    {"_ZTIi", "typeinfo for int"},
+    {"_ZTSPKc", "typeinfo name for char const*"},
+    {"_ZThn8_N1C1fEv", "non-virtual thunk to C::f()"},
+    {"_ZTv0_n24_N1C1fEv", "virtual thunk to C::f()"},
+    {"_ZTch0_h8_N1C1fEv", "covariant return thunk to C::f()"},
+    {"_ZGVZ1fvE1x", "guard variable for f()::x"},
+    {"_ZGVN1N1xE", "guard variable for N::x"},
+    {"_ZGR1x_", "reference temporary for x"},
+    {"_ZTC1D0_1B", "construction vtable for B-in-D"},
+    {"_ZTH1x", "thread-local initialization routine for x"},
+    {"_ZTW1x", "thread-local wrapper routine for x"},
+    {"_ZN1N1xE", "N::x"},
+    {"_ZZ1fvE1x", "f()::x"},
+    {"_ZZ1fvE1x_0", "f()::x"},
+    {"_ZZ1fvE1x_1", "f()::x"},
+    {"_ZZ1fvEN1A1gEv", "f()::A::g()"},
+    {"_ZZ4mainENKUlvE_clEv", "main::'lambda'()::operator()() const"},
+    {"_ZZ4mainENKUliE_clEi", "main::'lambda'(int)::operator()(int) const"},
+    {"_ZZ4mainENKUlvE0_clEv", "main::'lambda0'()::operator()() const"},
+    {"_ZZ4mainENKUlT_E_clIiEEDaS_", "auto main::'lambda'(auto)::operator()<int>(auto) const"},
+    {"_ZZ4mainENKUlPKcE_clES0_", "main::'lambda'(char const*)::operator()(char const*) const"},
+    {"_ZN1AUt_E", "A::'unnamed'"},
+    {"_ZN1AUt0_E", "A::'unnamed0'"},
+    {"_ZNSt6vectorIiSaIiEE9push_backERKi", "std::vector<int, std::allocator<int> >::push_back(int const&)"},
+    {"_ZNSt6vectorIiSaIiEE9push_backEOi", "std::vector<int, std::allocator<int> >::push_back(int&&)"},
+    {
+        "_ZNSt6vectorIiSaIiEE12emplace_backIJiEEERiDpOT_",
+        "int& std::vector<int, std::allocator<int> >::emplace_back<int>(int&&)",
+    },
+    {"_ZNSt10unique_ptrIiSt14default_deleteIiEED2Ev", "std::unique_ptr<int, std::default_delete<int> >::~unique_ptr()"},
+    {
+        "_ZNSt3mapIiiSt4lessIiESaISt4pairIKiiEEEixERS3_",
+        "std::map<int, int, std::less<int>, std::allocator<std::pair<int const, int> > >::operator[](int const&)",
+    },
+    {"_ZNSs4_Rep10_M_destroyERKSaIcE", "std::string::_Rep::_M_destroy(std::allocator<char> const&)"},
+    {"_ZNKSs4sizeEv", "std::string::size() const"},
+    {"_ZNSaIcED1Ev", "std::allocator<char>::~allocator()"},
+    {"_ZNSiD0Ev", "std::basic_istream<char, std::char_traits<char> >::~basic_istream()"},
+    {"_ZNSoD0Ev", "std::basic_ostream<char, std::char_traits<char> >::~basic_ostream()"},
+    {"_ZNSdD0Ev", "std::basic_iostream<char, std::char_traits<char> >::~basic_iostream()"},
+    {"_ZSt4cout", "std::cout"},
+    {
+        "_ZSt4endlIcSt11char_traitsIcEERSt13basic_ostreamIT_T0_ES6_",
+        "std::basic_ostream<char, std::char_traits<char> >& std::endl<char, std::char_traits<char> >(std::"
+        "basic_ostream<char, std::char_traits<char> >&)",
+    },
+    {
+        "_ZStlsISt11char_traitsIcEERSt13basic_ostreamIcT_ES5_PKc",
+        "std::basic_ostream<char, std::char_traits<char> >& std::operator<<<std::char_traits<char> >(std::"
+        "basic_ostream<char, std::char_traits<char> >&, char const*)",
+    },
+    {
+        "_ZNSt7__cxx1112basic_stringIcSt11char_traitsIcESaIcEEC1EPKcRKS3_",
+        "std::__cxx11::basic_string<char, std::char_traits<char>, std::allocator<char> >::basic_string(char const*, "
+        "std::allocator<char> const&)",
+    },
+    {
+        "_ZNKSt7__cxx1112basic_stringIcSt11char_traitsIcESaIcEE5c_strEv",
+        "std::__cxx11::basic_string<char, std::char_traits<char>, std::allocator<char> >::c_str() const",
+    },
+    {"_ZN9__gnu_cxx13new_allocatorIcED2Ev", "__gnu_cxx::new_allocator<char>::~new_allocator()"},
+    {"_Z1fIJidEEvDpT_", "void f<int, double>(int, double)"},
+    {"_Z1fIJEEvDpT_", "void f<>()"},
+    {"_Z1fIJiEEvDpOT_", "void f<int>(int&&)"},
+    {"_Z1fIiEDTcl1gfp_EET_", "decltype(g(fp)) f<int>(int)"},
+    {"_Z1fIiEDTplfp_fp_ET_", "decltype((fp) + (fp)) f<int>(int)"},
+    {"_Z1fIiEDTcvT_fp_ES0_", "decltype((int)(fp)) f<int>(int)"},
+    {"_Z1fIiEDTstT_ES0_", "decltype(sizeof (int)) f<int>(int)"},
+    {"_Z1fIiEDTszfp_ET_", "decltype(sizeof (fp)) f<int>(int)"},
+    {"_Z1fIiEDTatT_ES0_", "decltype(alignof (int)) f<int>(int)"},
+    {"_Z1fIiEDTaafp_fp_ET_", "decltype((fp) && (fp)) f<int>(int)"},
+    {"_Z1fIiEDTdtfp_1xET_", "decltype(fp.x) f<int>(int)"},
+    {"_Z1fIiEDTptfp_1xET_", "decltype(fp->x) f<int>(int)"},
+    {"_Z1fIiEDTixfp_Li0EET_", "decltype((fp)[0]) f<int>(int)"},
+    {"_Z1fIiEDTqufp_fp_fp_ET_", "decltype((fp) ? (fp) : (fp)) f<int>(int)"},
+    {"_Z1fIiEDTngfp_ET_", "decltype(-(fp)) f<int>(int)"},
+    {"_Z1fIiEDTadfp_ET_", "decltype(&(fp)) f<int>(int)"},
+    {"_Z1fIiEDTdefp_ET_", "decltype(*(fp)) f<int>(int)"},
+    {"_Z1fIiEDTppfp_ET_", "decltype((fp)++) f<int>(int)"},
+    {"_Z1fIiEDTpp_fp_ET_", "decltype(++(fp)) f<int>(int)"},
+    {"_Z1fIiEDTtwfp_ET_", "decltype(throw fp) f<int>(int)"},
+    {"_Z1fIiEDTtrET_", "decltype(throw) f<int>(int)"},
+    {"_Z1fIiEDTscT_fp_ES0_", "decltype(static_cast<int>(fp)) f<int>(int)"},
+    {"_Z1fIiEDTdcT_fp_ES0_", "decltype(dynamic_cast<int>(fp)) f<int>(int)"},
+    {"_Z1fIiEDTrcT_fp_ES0_", "decltype(reinterpret_cast<int>(fp)) f<int>(int)"},
+    {"_Z1fIiEDTccT_fp_ES0_", "decltype(const_cast<int>(fp)) f<int>(int)"},
+    {"_Z1fIiEDTtiT_ES0_", "decltype(typeid (int)) f<int>(int)"},
+    {"_Z1fIiEDTtefp_ES0_", "decltype(typeid (fp)) f<int>(decltype(typeid (fp)))"},
+    {"_Z1fIiEDTnxfp_ET_", "decltype(noexcept (fp)) f<int>(int)"},
+    {"_Z1fIiEDTsZT_ES0_", "decltype(sizeof...(int...)) f<int>(decltype(sizeof...(int...)))"},
+    {"_Z1fILi1EEvv", "void f<1>()"},
+    {"_Z1fILin1EEvv", "void f<-1>()"},
+    {"_Z1fILb1EEvv", "void f<true>()"},
+    {"_Z1fILb0EEvv", "void f<false>()"},
+    {"_Z1fILc65EEvv", "void f<(char)65>()"},
+    {"_Z1fILj1EEvv", "void f<1u>()"},
+    {"_Z1fILl1EEvv", "void f<1l>()"},
+    {"_Z1fILm1EEvv", "void f<1ul>()"},
+    {"_Z1fILx1EEvv", "void f<1ll>()"},
+    {"_Z1fILy1EEvv", "void f<1ull>()"},
+    {"_Z1fIL_Z1gvEEvv", "void f<g()>()"},
+    {"_Z1fIXadL_Z1gvEEEvv", "void f<&(g())>()"},
+    {"_Z1fILPv0EEvv", "void f<(void*)0>()"},
+    {"_Z1fI1AIiEEvT_", "void f<A<int> >(A<int>)"},
+    {"_ZN1AIiE1BIfE1fEv", "A<int>::B<float>::f()"},
+    {"_ZN1AIiE1fIfEEvT_", "void A<int>::f<float>(float)"},
+    {"_ZN1A1fIiEET_S1_", "int A::f<int>(int)"},
+    {"_ZNK1AIiE1fIfEET_S2_", "float A<int>::f<float>(float) const"},
+    {"_ZN1AcvPiEv", "A::operator int*()"},
+    {"_ZN1AcvT_IiEEv", "A::operator int<int>()"},
+    {"_ZN1AnwEm", "A::operator new(unsigned long)"},
+    {"_ZN1AnaEm", "A::operator new[](unsigned long)"},
+    {"_ZN1AdlEPv", "A::operator delete(void*)"},
+    {"_ZN1AdaEPv", "A::operator delete[](void*)"},
+    {"_ZN1AclEv", "A::operator()()"},
+    {"_ZN1AixEi", "A::operator[](int)"},
+    {"_ZN1AptEv", "A::operator->()"},
+    {"_ZN1AaSERKS_", "A::operator=(A const&)"},
+    {"_ZN1ApLERKS_", "A::operator+=(A const&)"},
+    {"_ZN1AmIERKS_", "A::operator-=(A const&)"},
+    {"_ZN1AmLERKS_", "A::operator*=(A const&)"},
+    {"_ZN1AdVERKS_", "A::operator/=(A const&)"},
+    {"_ZN1ArMERKS_", "A::operator%=(A const&)"},
+    {"_ZN1AaNERKS_", "A::operator&=(A const&)"},
+    {"_ZN1AoRERKS_", "A::operator|=(A const&)"},
+    {"_ZN1AeOERKS_", "A::operator^=(A const&)"},
+    {"_ZN1AlSEi", "A::operator<<=(int)"},
+    {"_ZN1ArSEi", "A::operator>>=(int)"},
+    {"_ZN1AeqERKS_", "A::operator==(A const&)"},
+    {"_ZN1AneERKS_", "A::operator!=(A const&)"},
+    {"_ZN1AltERKS_", "A::operator<(A const&)"},
+    {"_ZN1AgtERKS_", "A::operator>(A const&)"},
+    {"_ZN1AleERKS_", "A::operator<=(A const&)"},
+    {"_ZN1AgeERKS_", "A::operator>=(A const&)"},
+    {"_ZN1AssERKS_", "A::operator<=>(A const&)"},
+    {"_ZN1AntEv", "A::operator!()"},
+    {"_ZN1AaaERKS_", "A::operator&&(A const&)"},
+    {"_ZN1AooERKS_", "A::operator||(A const&)"},
+    {"_ZN1AppEv", "A::operator++()"},
+    {"_ZN1AppEi", "A::operator++(int)"},
+    {"_ZN1AmmEv", "A::operator--()"},
+    {"_ZN1AcmERKS_", "A::operator,(A const&)"},
+    {"_ZN1ApmEv", "A::operator->*()"},
+    {"_ZN1AcoEv", "A::operator~()"},
+    {"_ZN1AngEv", "A::operator-()"},
+    {"_ZN1ApsEv", "A::operator+()"},
+    {"_ZN1AadEv", "A::operator&()"},
+    {"_ZN1AdeEv", "A::operator*()"},
+    {"_Zli2_xy", "operator\"\" _x(unsigned long long)"},
+    {"_ZN1A1fB5cxx11Ev", "A::f[abi:cxx11]()"},
+    {"_ZN1AB5cxx111fEv", "A[abi:cxx11]::f()"},
+    {"_Z1fB3fooB3barv", "f[abi:foo][abi:bar]()"},
+    {"_ZN3FooIiE3barEv.cold", "Foo<int>::bar() (.cold)"},
+    {"_ZN3FooIiE3barEv.cold.1", "Foo<int>::bar() (.cold.1)"},
+    {"_Z3fooi.isra.0", "foo(int) (.isra.0)"},
+    {"_Z3fooi.constprop.0", "foo(int) (.constprop.0)"},
+    {"_Z3fooi.part.0", "foo(int) (.part.0)"},
+    {"_Z1fIiEvT_PFvS0_E", "void f<int>(int, void (*)(int))"},
+    {"_Z1fILi3EEvRAT__i", "void f<3>(int (&) [3])"},
+    {"_Z1fPU3AS1i", "f(int AS1*)"},
+    {"_Z1fPU11__unalignedi", "f(int __unaligned*)"},
+    {"_Z1fPrKi", "f(int const restrict*)"},
+    {"_Z1fFvvE", "f(void ())"},
+    {"_Z1fDoFivE", "f(int () noexcept)"},
+    {"_Z1fPDoFivE", "f(int (*)() noexcept)"},
+    {"_Z1fPDwiEFivE", "f(int (*)() throw(int))"},
+    {"_Z1fPKFivE", "f(int (*)() const)"},
+    {"_Z1fPFivREFivOE", "f(int (*)() &, int () &&)"},
+    {"_ZNKR4llvm5ArrayIiE4sizeEv", "llvm::Array<int>::size() const &"},
+    {
+        "_ZN4llvm5APInt7udivremERKS0_S2_RS0_S3_",
+        "llvm::APInt::udivrem(llvm::APInt const&, llvm::APInt const&, llvm::APInt&, llvm::APInt&)",
+    },
+    {
+        "_ZNSt3__112basic_stringIcNS_11char_traitsIcEENS_9allocatorIcEEEC2ERKS5_",
+        "std::__1::basic_string<char, std::__1::char_traits<char>, std::__1::allocator<char> >::basic_string(std::__1::"
+        "basic_string<char, std::__1::char_traits<char>, std::__1::allocator<char> > const&)",
+    },
+    {
+        "_ZNSt3__16vectorIiNS_9allocatorIiEEE9push_backERKi",
+        "std::__1::vector<int, std::__1::allocator<int> >::push_back(int const&)",
+    },
+    {"_ZNKSt3__14__fs10filesystem4path10__filenameEv", "std::__1::__fs::filesystem::path::__filename() const"},
+    {"_ZSt9terminatev", "std::terminate()"},
+    {"_ZSt17__throw_bad_allocv", "std::__throw_bad_alloc()"},
+    {"_Znwm", "operator new(unsigned long)"},
+    {"_Znam", "operator new[](unsigned long)"},
+    {"_ZdlPv", "operator delete(void*)"},
+    {"_ZdlPvm", "operator delete(void*, unsigned long)"},
+    {"_ZdaPv", "operator delete[](void*)"},
+    {"_ZnwmRKSt9nothrow_t", "operator new(unsigned long, std::nothrow_t const&)"},
+    {"_ZnwmSt11align_val_t", "operator new(unsigned long, std::align_val_t)"},
+    {"_ZdlPvSt11align_val_t", "operator delete(void*, std::align_val_t)"},
+    {"_ZTVN10__cxxabiv117__class_type_infoE", "vtable for __cxxabiv1::__class_type_info"},
+    {"_ZTVN10__cxxabiv120__si_class_type_infoE", "vtable for __cxxabiv1::__si_class_type_info"},
+    {"_ZN10__cxxabiv119__foreign_exceptionD1Ev", "__cxxabiv1::__foreign_exception::~__foreign_exception()"},
+    {"_Z1fIJEJiEEvDpT_DpT0_", "void f<int>(int)"},
+    {"_Z1fIiJfdEEvT_DpT0_", "void f<int, float, double>(int, float, double)"},
+    {"_Z1fIiEvN1AIT_E1BE", "void f<int>(A<int>::B)"},
+    {"_Z1fIiEvNT_1BE", "void f<int>(int::B)"},
+    {"_Z1fIiEvNT_1B1CE", "void f<int>(int::B::C)"},
+    {"_Z1fIiEvNT_1BIiEE", "void f<int>(int::B<int>)"},
+    {"_Z1fIiEvN1AIT_E1BIiEE", "void f<int>(A<int>::B<int>)"},
+    {"_Z1gIiEvPFT_vE", "void g<int>(int (*)())"},
+    {"_Z1fSt6vectorIiSaIiEE", "f(std::vector<int, std::allocator<int> >)"},
+    {"_Z1fSsSs", "f(std::string, std::string)"},
+    {"_Z1fSaIcE", "f(std::allocator<char>)"},
+    {"_Z1fSi", "f(std::istream)"},
+    {"_Z1fSo", "f(std::ostream)"},
+    {"_Z1fSd", "f(std::iostream)"},
+    {"_Z1fSt8ios_base", "f(std::ios_base)"},
+    {"_Z1fNSt3__16vectorIiEE", "f(std::__1::vector<int>)"},
+    {"_ZN1N1fINS_1AEEEvT_", "void N::f<N::A>(N::A)"},
+    {"_ZN1N1AIJiEE1fEv", "N::A<int>::f()"},
+    {"_ZN1AIJLi1ELi2EEE1fEv", "A<1, 2>::f()"},
+    {"_ZN1AIJiEE1fIJfEEEvDpT_", "void A<int>::f<float>(float)"},
+    {"_ZNK3FooclIiEEDaT_", "auto Foo::operator()<int>(int) const"},
+    {"_Z1fIiEvDTfp_E", "void f<int>(decltype(fp))"},
+    {"_Z3fooILi2EEvRAplT_Li1E_i", "void foo<2>(int (&) [(2) + (1)])"},
+    {"_Z1fIiEvPDTclL_Z1gvEEE", "void f<int>(decltype(g()())*)"},
+    {"_ZN1S1fIiEEDTcldtdefpT1xEEv", "decltype(*(this).x()) S::f<int>()"},
+    {"_Z1fIiEDTcmfp_fp_ET_", "decltype((fp) , (fp)) f<int>(int)"},
+};
+
+// Productions the built-in demangler doesn't support: new and delete expressions, fold expressions, and floating point
+// literals. Names using them are reported as not demangleable. The expected output is llvm-cxxfilt's, for when support
+// is added.
+const demangle_case unsupported_cases[] = {
+    {"_Z1fIiEDTgsnw_T_EEv", "decltype(new int) f<int>()"},
+    {"_Z1fIiEDTnw_T_EEv", "decltype(new int) f<int>()"},
+    {"_Z1fIiEDTnw_T_piEEv", "decltype(new int) f<int>()"},
+    {"_Z1fIiEDTna_T_EEv", "decltype(new[] int) f<int>()"},
+    {"_Z1fIPiEDTdlfp_ET_", "decltype(deletefp) f<int*>(int*)"},
+    {"_Z1fIPiEDTdafp_ET_", "decltype(delete[] fp) f<int*>(int*)"},
+    {"_Z1fIPiEDTgsdlfp_ET_", "decltype(::deletefp) f<int*>(int*)"},
+    {"_Z1fIJiEEDTflplfp_EDpT_", "decltype((... + (fp...))) f<int>(int)"},
+    {"_Z1fIJiEEDTfrplfp_EDpT_", "decltype(((fp...) + ...)) f<int>(int)"},
+    {"_Z1fIJiEEDTfLplLi0Efp_EDpT_", "decltype((0 + ... + (fp...))) f<int>(int)"},
+    {"_Z1fIJiEEDTfRplfp_Li0EEDpT_", "decltype(((fp...) + ... + 0)) f<int>(int)"},
+    {"_Z1fILf3f800000EEvv", "void f<0x1p+0f>()"},
+    {"_Z1fILd3ff0000000000000EEvv", "void f<0x1p+0>()"},
+    {"_Z1fILe3fff8000000000000000EEvv", "void f<0x8p-3L>()"},
+    {"_Z1fIiEvDTplLf3f800000Efp_E", "void f<int>(decltype((0x1p+0f) + (fp)))"},
+};
+
+std::string demangle_builtin(const char* name) {
+    char buffer[1024];
+    auto length = cpptrace::experimental::demangle_signal_safe(name, buffer, sizeof(buffer));
+    EXPECT_LT(length, sizeof(buffer)) << name;
+    return buffer;
+}
+
+TEST(DemangleCorpusTests, MatchesLlvm) {
+    for(const auto& test_case : llvm_cases) {
+        EXPECT_EQ(demangle_builtin(test_case.mangled), test_case.expected) << test_case.mangled;
+    }
+}
+
+TEST(DemangleCorpusTests, UnsupportedProductions) {
+    for(const auto& test_case : unsupported_cases) {
+        EXPECT_EQ(demangle_builtin(test_case.mangled), "")
+            << test_case.mangled << " is now supported, move it to llvm_cases with expected output "
+            << test_case.expected;
+    }
+}
+
+}
@@ -3,15 +3,20 @@
 #include <gmock/gmock.h>
 #include <gmock/gmock-matchers.h>
 
+#include "demangle/demangle.hpp"
 #include "utils/microfmt.hpp"
 #include "utils/utils.hpp"
 
 #include <cstdint>
+#include <cstdio>
+#include <sstream>
+#include <string>
 
 #ifdef TEST_MODULE
 import cpptrace;
 #else
 #include <cpptrace/formatting.hpp>
+#include <cpptrace/utils.hpp>
 #endif
 
 using cpptrace::detail::split;
@@ -532,6 +537,111 @@ TEST(FormatterTest, PrettySymbols) {
     );
 }
 
+TEST(FormatterTest, RewrittenSymbolsAreCached) {
+    cpptrace::stacktrace trace;
+    trace.frames.push_back({0x1, 0x1001, {20}, {30}, "foo.cpp", "ns::S<std::vector<int, std::allocator<int> > >::foo(int)", false});
+    auto pruned_formatter = cpptrace::formatter{}
+        .symbols(cpptrace::formatter::symbol_mode::pruned);
+    auto pretty_formatter = cpptrace::formatter{}
+        .symbols(cpptrace::formatter::symbol_mode::pretty);
+    auto check_output = [&] {
+        EXPECT_THAT(
+            split(pruned_formatter.format(trace), "\n"),
+            ElementsAre(
+                "Stack trace (most recent call first):",
+                "#0 0x" ADDR_PREFIX "00000001 in ns::S::foo at foo.cpp:20:30"
+            )
+        );
+        EXPECT_THAT(
+            split(pretty_formatter.format(trace), "\n"),
+            ElementsAre(
+                "Stack trace (most recent call first):",
+                "#0 0x" ADDR_PREFIX "00000001 in ns::S<std::vector<int>>::foo(int) at foo.cpp:20:30"
+            )
+        );
+    };
+    // the pruned and pretty forms of a symbol are cached separately, only the first print rewrites them
+    auto misses = cpptrace::detail::demangle_cache_misses();
+    check_output();
+    EXPECT_EQ(cpptrace::detail::demangle_cache_misses(), misses + 2);
+    check_output();
+    EXPECT_EQ(cpptrace::detail::demangle_cache_misses(), misses + 2);
+    cpptrace::experimental::set_demangle_cache_size(0);
+    EXPECT_THAT(
+        split(pretty_formatter.format(trace), "\n"),
+        ElementsAre(
+            "Stack trace (most recent call first):",
+            "#0 0x" ADDR_PREFIX "00000001 in ns::S<std::vector<int>>::foo(int) at foo.cpp:20:30"
+        )
+    );
+    cpptrace::experimental::set_demangle_cache_size(cpptrace::experimental::default_demangle_cache_size);
+}
+
+TEST(FormatterTest, PrintMatchesFormat) {
+    auto formatter = cpptrace::formatter{}
+        .header("Stack trace:")
+        .symbols(cpptrace::formatter::symbol_mode::pretty);
+    cpptrace::stacktrace trace;
+    // enough frames to go through the output buffer a few times
+    for(std::uintptr_t i = 0; i < 500; i++) {
+        trace.frames.push_back({i, 0x1000 + i, {20}, {30}, "foo.cpp", "foo(std::vector<int, std::allocator<int> >)", false});
+    }
+    auto expected = formatter.format(trace) + "\n";
+    std::ostringstream oss;
+    formatter.print(oss, trace);
+    EXPECT_EQ(oss.str(), expected);
+    std::FILE* file = std::tmpfile();
+    ASSERT_NE(file, nullptr);
+    formatter.print(file, trace);
+    std::string contents(expected.size() + 1, '\0');
+    std::rewind(file);
+    contents.resize(std::fread(&contents[0], 1, contents.size(), file));
+    std::fclose(file);
+    EXPECT_EQ(contents, expected);
+}
+
+TEST(FormatterTest, PrettifySymbol) {
+    EXPECT_EQ(
+        cpptrace::prettify_symbol("std::vector<int, std::allocator<int> >::push_back(int const&)"),
+        "std::vector<int>::push_back(int const&)"
+    );
+    EXPECT_EQ(
+        cpptrace::prettify_symbol("std::unique_ptr<foo, std::default_delete<foo> >::~unique_ptr()"),
+        "std::unique_ptr<foo>::~unique_ptr()"
+    );
+    EXPECT_EQ(
+        cpptrace::prettify_symbol(
+            "std::map<int, std::vector<int, std::allocator<int> >, std::less<int>, "
+            "std::allocator<std::pair<int const, std::vector<int, std::allocator<int> > > > >::clear()"
+        ),
+        "std::map<int, std::vector<int>, std::less<int>>::clear()"
+    );
+    EXPECT_EQ(
+        cpptrace::prettify_symbol(
+            "void __cdecl `anonymous namespace'::foo(class std::vector<int,class std::allocator<int> > const &)"
+        ),
+        "void __cdecl (anonymous namespace)::foo(std::vector<int> const &)"
+    );
+    EXPECT_EQ(
+        cpptrace::prettify_symbol(
+            "class std::basic_string<char,struct std::char_traits<char>,class std::allocator<char> > __cdecl bar(void)"
+        ),
+        "std::string __cdecl bar(void)"
+    );
+    EXPECT_EQ(
+        cpptrace::prettify_symbol("foo(std::basic_string_view<char, std::char_traits<char> >)"),
+        "foo(std::string_view)"
+    );
+    // only char strings have aliases
+    EXPECT_EQ(
+        cpptrace::prettify_symbol(
+            "foo(std::basic_string<char16_t, std::char_traits<char16_t>, std::allocator<char16_t> >)"
+        ),
+        "foo(std::basic_string<char16_t, std::char_traits<char16_t>>)"
+    );
+    EXPECT_EQ(cpptrace::prettify_symbol("a<b<c> >::operator>>(int)"), "a<b<c>>::operator>>(int)");
+}
+
 TEST(FormatterTest, PrunedSymbols) {
     auto normal_formatter = cpptrace::formatter{}
         .symbols(cpptrace::formatter::symbol_mode::full);
@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+#include <gtest/gtest-matchers.h>
+#include <gmock/gmock.h>
+#include <gmock/gmock-matchers.h>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "common.hpp"
+
+#ifdef TEST_MODULE
+import cpptrace;
+#else
+#include <cpptrace/cpptrace.hpp>
+#endif
+
+// addr2line processes are only pooled on linux, atos is run once per request
+#if defined(CPPTRACE_GET_SYMBOLS_WITH_ADDR2LINE) && defined(__linux__)
+#include "symbols/symbols.hpp"
+
+#include <csignal>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using cpptrace::detail::addr2line::pooled_process_id;
+using cpptrace::detail::addr2line::set_max_pooled_processes;
+
+namespace {
+
+CPPTRACE_FORCE_NO_INLINE cpptrace::object_frame addr2line_capture() {
+    auto trace = cpptrace::generate_object_trace();
+    EXPECT_FALSE(trace.frames.empty());
+    return trace.frames.empty() ? cpptrace::object_frame{} : trace.frames[0];
+}
+
+std::vector<cpptrace::stacktrace_frame> resolve_with_addr2line(const cpptrace::object_frame& frame) {
+    return cpptrace::detail::addr2line::resolve_frames({frame});
+}
+
+// Restores the pool limit when the test ends
+class pool_limit_guard {
+    std::size_t previous;
+public:
+    explicit pool_limit_guard(std::size_t limit) : previous(set_max_pooled_processes(limit)) {}
+    ~pool_limit_guard() {
+        set_max_pooled_processes(previous);
+    }
+    pool_limit_guard(const pool_limit_guard&) = delete;
+    pool_limit_guard& operator=(const pool_limit_guard&) = delete;
+};
+
+// Symlinks to the object so each one gets its own pooled process
+class object_alias {
+    std::string alias;
+public:
+    object_alias(const std::string& object_path, int index)
+        : alias("/tmp/cpptrace-addr2line-" + std::to_string(getpid()) + "-" + std::to_string(index)) {
+        unlink(alias.c_str());
+        EXPECT_EQ(symlink(object_path.c_str(), alias.c_str()), 0);
+    }
+    ~object_alias() {
+        unlink(alias.c_str());
+    }
+    object_alias(const object_alias&) = delete;
+    object_alias& operator=(const object_alias&) = delete;
+    const std::string& path() const {
+        return alias;
+    }
+    cpptrace::object_frame frame(const cpptrace::object_frame& original) const {
+        return {original.raw_address, original.object_address, alias};
+    }
+};
+
+TEST(Addr2line, RestartsKilledProcess) {
+    auto frame = addr2line_capture();
+    auto first = resolve_with_addr2line(frame);
+    ASSERT_EQ(first.size(), 1);
+    #ifndef CPPTRACE_BUILD_NO_SYMBOLS
+    EXPECT_THAT(first[0].symbol, testing::HasSubstr("addr2line_capture"));
+    #endif
+    auto pid = pooled_process_id(frame.object_path);
+    ASSERT_NE(pid, -1);
+    ASSERT_EQ(kill(static_cast<pid_t>(pid), SIGKILL), 0);
+    auto second = resolve_with_addr2line(frame);
+    EXPECT_EQ(second, first);
+    auto restarted = pooled_process_id(frame.object_path);
+    EXPECT_NE(restarted, -1);
+    EXPECT_NE(restarted, pid);
+}
+
+TEST(Addr2line, EvictsLeastRecentlyUsedProcess) {
+    auto frame = addr2line_capture();
+    auto expected = resolve_with_addr2line(frame);
+    ASSERT_EQ(expected.size(), 1);
+    pool_limit_guard limit(2);
+    object_alias a(frame.object_path, 0);
+    object_alias b(frame.object_path, 1);
+    object_alias c(frame.object_path, 2);
+    resolve_with_addr2line(a.frame(frame));
+    resolve_with_addr2line(b.frame(frame));
+    auto a_pid = pooled_process_id(a.path());
+    auto b_pid = pooled_process_id(b.path());
+    ASSERT_NE(a_pid, -1);
+    ASSERT_NE(b_pid, -1);
+    // a becomes the most recently used, so c evicts b
+    resolve_with_addr2line(a.frame(frame));
+    auto resolved = resolve_with_addr2line(c.frame(frame));
+    ASSERT_EQ(resolved.size(), 1);
+    EXPECT_EQ(resolved[0].symbol, expected[0].symbol);
+    EXPECT_EQ(resolved[0].line, expected[0].line);
+    EXPECT_EQ(pooled_process_id(a.path()), a_pid);
+    EXPECT_EQ(pooled_process_id(b.path()), -1);
+    EXPECT_NE(pooled_process_id(c.path()), -1);
+    // the evicted process has been killed and reaped
+    EXPECT_EQ(kill(static_cast<pid_t>(b_pid), 0), -1);
+}
+
+TEST(Addr2line, ForkedChildUsesItsOwnProcesses) {
+    auto frame = addr2line_capture();
+    auto expected = resolve_with_addr2line(frame);
+    auto parent_pid = pooled_process_id(frame.object_path);
+    ASSERT_NE(parent_pid, -1);
+    auto child = fork();
+    ASSERT_NE(child, -1);
+    if(child == 0) {
+        // the parent's processes aren't visible or used in the child
+        bool ok = pooled_process_id(frame.object_path) == -1;
+        ok = ok && resolve_with_addr2line(frame) == expected;
+        ok = ok && pooled_process_id(frame.object_path) != parent_pid;
+        _exit(ok ? 0 : 1);
+    }
+    int status = 0;
+    ASSERT_EQ(waitpid(child, &status, 0), child);
+    ASSERT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(WEXITSTATUS(status), 0);
+    // the child didn't kill the parent's process
+    EXPECT_EQ(pooled_process_id(frame.object_path), parent_pid);
+    EXPECT_EQ(resolve_with_addr2line(frame), expected);
+}
+
+}
+#endif
@@ -0,0 +1,240 @@
+#include <gtest/gtest.h>
+#include <gtest/gtest-matchers.h>
+#include <gmock/gmock.h>
+#include <gmock/gmock-matchers.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common.hpp"
+
+#ifdef TEST_MODULE
+import cpptrace;
+#else
+#include <cpptrace/cpptrace.hpp>
+#include <cpptrace/crash_reporting.hpp>
+#include <cpptrace/thread_dump.hpp>
+#endif
+
+#ifdef __linux__
+#include <csignal>
+#include <pthread.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+std::atomic<int> crash_workers_ready{0};
+
+void crash_worker() {
+    pthread_setname_np(pthread_self(), "crash-worker");
+    crash_workers_ready++;
+    for(;;) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+}
+
+CPPTRACE_FORCE_NO_INLINE void crash_reporting_crash() {
+    raise(SIGSEGV);
+}
+
+// Runs in a child process, never returns
+void crash_with_reporter(const std::string& path) {
+    if(!cpptrace::experimental::install_crash_reporter(path)) {
+        _exit(1);
+    }
+    std::thread(crash_worker).detach();
+    std::thread(crash_worker).detach();
+    while(crash_workers_ready.load() != 2) {
+        std::this_thread::yield();
+    }
+    crash_reporting_crash();
+    _exit(2);
+}
+
+// Runs in a child process, never returns. Crashes while a thread dump is waiting on a thread that doesn't respond.
+void crash_during_thread_dump(const std::string& path) {
+    if(!cpptrace::experimental::install_crash_reporter(path)) {
+        _exit(1);
+    }
+    std::thread([] {
+        sigset_t mask;
+        sigemptyset(&mask);
+        sigaddset(&mask, SIGRTMIN + 4);
+        pthread_sigmask(SIG_BLOCK, &mask, nullptr);
+        crash_worker();
+    }).detach();
+    std::thread([] {
+        cpptrace::experimental::thread_dump_options options;
+        options.timeout_ms = 60000;
+        cpptrace::experimental::dump_all_threads(options);
+    }).detach();
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    crash_reporting_crash();
+    _exit(2);
+}
+
+std::vector<char> read_file(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::vector<char>{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+}
+
+TEST(CrashReporting, AllThreads) {
+    char path[] = "/tmp/cpptrace_crash_report_XXXXXX";
+    int fd = mkstemp(path);
+    ASSERT_NE(fd, -1);
+    close(fd);
+    auto pid = fork();
+    ASSERT_NE(pid, -1);
+    if(pid == 0) {
+        crash_with_reporter(path);
+    }
+    int status;
+    ASSERT_EQ(waitpid(pid, &status, 0), pid);
+    ASSERT_TRUE(WIFSIGNALED(status)) << "exit status " << WEXITSTATUS(status);
+    EXPECT_EQ(WTERMSIG(status), SIGSEGV);
+    auto contents = read_file(path);
+    std::remove(path);
+    cpptrace::experimental::crash_report report;
+    ASSERT_TRUE(cpptrace::experimental::parse_crash_report(contents.data(), contents.size(), report));
+    EXPECT_EQ(report.signal, SIGSEGV);
+    EXPECT_EQ(report.process_id, static_cast<std::uint64_t>(pid));
+    EXPECT_EQ(report.omitted_threads, 0);
+    ASSERT_EQ(report.threads.size(), 3);
+    EXPECT_TRUE(report.threads[0].crashed);
+    EXPECT_EQ(report.threads[0].thread_id, static_cast<std::uint64_t>(pid));
+    for(std::size_t i = 1; i < report.threads.size(); i++) {
+        EXPECT_FALSE(report.threads[i].crashed);
+        EXPECT_FALSE(report.threads[i].missed);
+        EXPECT_EQ(report.threads[i].name, "crash-worker");
+    }
+    if(cpptrace::can_signal_safe_unwind()) {
+        auto trace = report.threads[0].trace.resolve();
+        ASSERT_FALSE(trace.frames.empty());
+        bool found = false;
+        for(const auto& frame : trace.frames) {
+            found = found || frame.symbol.find("crash_reporting_crash") != std::string::npos;
+        }
+        EXPECT_TRUE(found) << trace.to_string();
+        EXPECT_FALSE(report.threads[1].trace.frames.empty());
+    }
+}
+
+TEST(CrashReporting, DuringThreadDump) {
+    char path[] = "/tmp/cpptrace_crash_report_XXXXXX";
+    int fd = mkstemp(path);
+    ASSERT_NE(fd, -1);
+    close(fd);
+    auto pid = fork();
+    ASSERT_NE(pid, -1);
+    if(pid == 0) {
+        crash_during_thread_dump(path);
+    }
+    int status;
+    ASSERT_EQ(waitpid(pid, &status, 0), pid);
+    ASSERT_TRUE(WIFSIGNALED(status)) << "exit status " << WEXITSTATUS(status);
+    auto contents = read_file(path);
+    std::remove(path);
+    cpptrace::experimental::crash_report report;
+    ASSERT_TRUE(cpptrace::experimental::parse_crash_report(contents.data(), contents.size(), report));
+    EXPECT_EQ(report.signal, SIGSEGV);
+    // the other threads can't be captured while the dump is in progress, the crashing thread still is
+    ASSERT_EQ(report.threads.size(), 1);
+    EXPECT_TRUE(report.threads[0].crashed);
+    EXPECT_EQ(report.threads[0].thread_id, static_cast<std::uint64_t>(pid));
+    if(cpptrace::can_signal_safe_unwind()) {
+        EXPECT_FALSE(report.threads[0].trace.frames.empty());
+    }
+}
+
+std::atomic<int> previous_handler_calls{0};
+
+// Runs in a child process, never returns. The previous handler lets the process continue after each crash.
+void crash_twice_with_returning_handler(const std::string& first_path, const std::string& second_path) {
+    struct sigaction action{};
+    action.sa_handler = [] (int) { previous_handler_calls++; };
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGSEGV, &action, nullptr);
+    if(!cpptrace::experimental::install_crash_reporter(first_path)) {
+        _exit(1);
+    }
+    crash_reporting_crash();
+    if(previous_handler_calls.load() != 1) {
+        _exit(2);
+    }
+    // the handlers were put back after the first crash, installing again must really install them
+    if(!cpptrace::experimental::install_crash_reporter(second_path)) {
+        _exit(3);
+    }
+    crash_reporting_crash();
+    _exit(previous_handler_calls.load() == 2 ? 0 : 4);
+}
+
+TEST(CrashReporting, ReinstallAfterCrash) {
+    char first_path[] = "/tmp/cpptrace_crash_report_XXXXXX";
+    char second_path[] = "/tmp/cpptrace_crash_report_XXXXXX";
+    int fd = mkstemp(first_path);
+    ASSERT_NE(fd, -1);
+    close(fd);
+    fd = mkstemp(second_path);
+    ASSERT_NE(fd, -1);
+    close(fd);
+    auto pid = fork();
+    ASSERT_NE(pid, -1);
+    if(pid == 0) {
+        crash_twice_with_returning_handler(first_path, second_path);
+    }
+    int status;
+    ASSERT_EQ(waitpid(pid, &status, 0), pid);
+    ASSERT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(WEXITSTATUS(status), 0);
+    for(const char* path : {first_path, second_path}) {
+        auto contents = read_file(path);
+        std::remove(path);
+        cpptrace::experimental::crash_report report;
+        ASSERT_TRUE(cpptrace::experimental::parse_crash_report(contents.data(), contents.size(), report)) << path;
+        EXPECT_EQ(report.signal, SIGSEGV);
+        ASSERT_FALSE(report.threads.empty());
+        EXPECT_TRUE(report.threads[0].crashed);
+    }
+}
+
+TEST(CrashReporting, CaptureSignalInUse) {
+    int signal = SIGRTMIN + 6;
+    struct sigaction action{};
+    action.sa_handler = [] (int) {};
+    sigemptyset(&action.sa_mask);
+    struct sigaction previous;
+    ASSERT_EQ(sigaction(signal, &action, &previous), 0);
+    cpptrace::experimental::crash_reporter_options options;
+    options.capture_signal = signal;
+    EXPECT_FALSE(cpptrace::experimental::install_crash_reporter("/tmp/cpptrace_unused_crash_report", options));
+    // the existing handler is left alone
+    struct sigaction current;
+    ASSERT_EQ(sigaction(signal, nullptr, &current), 0);
+    EXPECT_EQ(current.sa_handler, action.sa_handler);
+    sigaction(signal, &previous, nullptr);
+}
+
+TEST(CrashReporting, InvalidReport) {
+    cpptrace::experimental::crash_report report;
+    EXPECT_FALSE(cpptrace::experimental::parse_crash_report("CPCR", 4, report));
+    EXPECT_FALSE(cpptrace::experimental::parse_crash_report("not a crash report", 18, report));
+    // a valid header followed by a truncated module table
+    const unsigned char truncated[] = {'C', 'P', 'C', 'R', 1, 11, 1, 0, 1, 5, 'a'};
+    EXPECT_FALSE(cpptrace::experimental::parse_crash_report(truncated, sizeof(truncated), report));
+    const unsigned char empty[] = {'C', 'P', 'C', 'R', 1, 11, 1, 0, 0, 0};
+    ASSERT_TRUE(cpptrace::experimental::parse_crash_report(empty, sizeof(empty), report));
+    EXPECT_EQ(report.signal, 11);
+    EXPECT_TRUE(report.threads.empty());
+}
+
+}
+#endif
@@ -182,6 +182,75 @@ TEST(FromCurrent, NonThrowingPath) {
     does_reach_end = true;
 }
 
+TEST(FromCurrent, BoundedTrace) {
+    auto guard = cpptrace::detail::scope_exit([] {
+        cpptrace::experimental::set_current_exception_trace_mode(
+            cpptrace::experimental::current_exception_trace_mode::full
+        );
+    });
+    cpptrace::experimental::set_current_exception_trace_mode(
+        cpptrace::experimental::current_exception_trace_mode::bounded,
+        8
+    );
+    std::vector<int> line_numbers;
+    bool does_enter_catch = false;
+    CPPTRACE_TRY {
+        static volatile int tco_guard = stacktrace_from_current_1(line_numbers);
+        (void)tco_guard;
+    } CPPTRACE_CATCH(const std::exception& e) {
+        does_enter_catch = true;
+        EXPECT_EQ(e.what(), std::string("foobar"));
+        EXPECT_FALSE(cpptrace::current_exception_was_rethrown());
+        const auto& raw_trace = cpptrace::raw_trace_from_current_exception();
+        EXPECT_LE(raw_trace.frames.size(), 8);
+        auto trace = raw_trace.resolve();
+        auto it = std::find_if(
+            trace.frames.begin(),
+            trace.frames.end(),
+            [](const cpptrace::stacktrace_frame& frame) {
+                return frame.symbol.find("stacktrace_from_current_3") != std::string::npos;
+            }
+        );
+        EXPECT_NE(it, trace.frames.end()) << trace;
+    }
+    EXPECT_TRUE(does_enter_catch);
+    // a zero depth captures nothing but still catches
+    cpptrace::experimental::set_current_exception_trace_mode(
+        cpptrace::experimental::current_exception_trace_mode::bounded,
+        0
+    );
+    does_enter_catch = false;
+    CPPTRACE_TRY {
+        static volatile int tco_guard = stacktrace_from_current_1(line_numbers);
+        (void)tco_guard;
+    } CPPTRACE_CATCH(const std::exception&) {
+        does_enter_catch = true;
+        EXPECT_TRUE(cpptrace::raw_trace_from_current_exception().empty());
+    }
+    EXPECT_TRUE(does_enter_catch);
+    // switching back replaces the deferred trace
+    cpptrace::experimental::set_current_exception_trace_mode(
+        cpptrace::experimental::current_exception_trace_mode::full
+    );
+    does_enter_catch = false;
+    CPPTRACE_TRY {
+        static volatile int tco_guard = stacktrace_from_current_1(line_numbers);
+        (void)tco_guard;
+    } CPPTRACE_CATCH(const std::exception&) {
+        does_enter_catch = true;
+        const auto& trace = cpptrace::from_current_exception();
+        auto it = std::find_if(
+            trace.frames.begin(),
+            trace.frames.end(),
+            [](const cpptrace::stacktrace_frame& frame) {
+                return frame.symbol.find("FromCurrent_BoundedTrace_Test::TestBody") != std::string::npos;
+            }
+        );
+        EXPECT_NE(it, trace.frames.end()) << trace;
+    }
+    EXPECT_TRUE(does_enter_catch);
+}
+
 #ifdef _MSC_VER
 
 CPPTRACE_FORCE_NO_INLINE
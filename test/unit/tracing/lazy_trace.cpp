@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+#include <gtest/gtest-matchers.h>
+#include <gmock/gmock.h>
+#include <gmock/gmock-matchers.h>
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "common.hpp"
+
+#ifdef TEST_MODULE
+import cpptrace;
+#else
+#include <cpptrace/cpptrace.hpp>
+#include <cpptrace/lazy_trace.hpp>
+#endif
+
+using cpptrace::experimental::lazy_stacktrace;
+using testing::HasSubstr;
+
+namespace {
+
+CPPTRACE_FORCE_NO_INLINE cpptrace::raw_trace lazy_trace_capture() {
+    return cpptrace::generate_raw_trace();
+}
+
+class LazyTrace : public testing::Test {
+protected:
+    void TearDown() override {
+        cpptrace::experimental::set_symbol_resolution_chain({});
+    }
+};
+
+TEST_F(LazyTrace, MatchesStacktrace) {
+    auto trace = lazy_trace_capture();
+    auto expected = trace.resolve();
+    lazy_stacktrace lazy(trace);
+    ASSERT_EQ(lazy.size(), trace.frames.size());
+    ASSERT_FALSE(lazy.empty());
+    EXPECT_EQ(lazy.raw_address(0), trace.frames[0]);
+    EXPECT_THAT(lazy.symbol(0), HasSubstr("lazy_trace_capture"));
+    EXPECT_EQ(lazy.line(0), expected.frames[0].line);
+    EXPECT_EQ(lazy.filename(0), expected.frames[0].filename);
+    EXPECT_EQ(lazy.resolve().frames, expected.frames);
+    // repeated accesses return the cached results
+    EXPECT_EQ(&lazy.symbol(0), &lazy.symbol(0));
+    EXPECT_EQ(&lazy.frame(0), &lazy.frame(0));
+}
+
+TEST_F(LazyTrace, SymbolsDontNeedLineInformation) {
+    auto trace = lazy_trace_capture();
+    // with no usable resolution back-end only the symbol tables can name frames
+    cpptrace::experimental::set_symbol_resolution_chain({cpptrace::experimental::symbol_source::server});
+    lazy_stacktrace lazy(trace);
+    ASSERT_FALSE(lazy.empty());
+    EXPECT_THAT(lazy.symbol(0), HasSubstr("lazy_trace_capture"));
+    EXPECT_FALSE(lazy.line(0).has_value());
+    EXPECT_TRUE(lazy.inlines(0).empty());
+}
+
+TEST_F(LazyTrace, Current) {
+    auto lazy = lazy_stacktrace::current();
+    ASSERT_FALSE(lazy.empty());
+    EXPECT_THAT(lazy.symbol(0), HasSubstr("LazyTrace_Current_Test::TestBody"));
+    auto moved = std::move(lazy);
+    EXPECT_THAT(moved.symbol(0), HasSubstr("LazyTrace_Current_Test::TestBody"));
+}
+
+}
@@ -1,4 +1,8 @@
+#include <atomic>
+#include <cstddef>
 #include <random>
+#include <string>
+#include <thread>
 #include <vector>
 
 #include <gtest/gtest.h>
@@ -7,6 +11,7 @@
 #include <gmock/gmock-matchers.h>
 
 #include "common.hpp"
+#include "binary/safe_dl.hpp"
 
 #ifdef TEST_MODULE
 import cpptrace;
@@ -117,3 +122,154 @@ TEST(ObjectTrace, Resolution) {
     object_resolve_1(line_numbers);
 }
 #endif
+
+
+TEST(ObjectTrace, SafeModuleFrames) {
+    if(!cpptrace::can_get_safe_object_frame()) {
+        GTEST_SKIP() << "safe object frames aren't supported";
+    }
+    auto trace = cpptrace::generate_raw_trace();
+    ASSERT_FALSE(trace.frames.empty());
+    std::vector<cpptrace::experimental::safe_module_frame> frames(trace.frames.size());
+    std::vector<cpptrace::experimental::safe_module> modules(trace.frames.size());
+    auto module_count = cpptrace::experimental::get_safe_module_frames(
+        trace.frames.data(),
+        trace.frames.size(),
+        frames.data(),
+        modules.data(),
+        modules.size()
+    );
+    ASSERT_GE(module_count, 1);
+    // each object shows up once
+    for(std::size_t i = 0; i < module_count; i++) {
+        for(std::size_t j = i + 1; j < module_count; j++) {
+            EXPECT_NE(modules[i].base, modules[j].base);
+        }
+    }
+    EXPECT_EQ(frames[0].module, 0);
+    EXPECT_THAT(modules[0].path, testing::HasSubstr("unittest"));
+    for(std::size_t i = 0; i < frames.size(); i++) {
+        cpptrace::safe_object_frame safe_frame;
+        cpptrace::get_safe_object_frame(trace.frames[i], &safe_frame);
+        auto expected = safe_frame.resolve();
+        auto actual = frames[i].resolve(modules.data());
+        EXPECT_EQ(actual.raw_address, expected.raw_address);
+        EXPECT_EQ(actual.object_address, expected.object_address);
+        EXPECT_EQ(actual.object_path, expected.object_path);
+    }
+}
+
+TEST(ObjectTrace, SafeModuleFramesFullModuleTable) {
+    if(!cpptrace::can_get_safe_object_frame()) {
+        GTEST_SKIP() << "safe object frames aren't supported";
+    }
+    auto trace = cpptrace::generate_raw_trace();
+    ASSERT_FALSE(trace.frames.empty());
+    std::vector<cpptrace::experimental::safe_module_frame> frames(trace.frames.size());
+    cpptrace::experimental::safe_module module;
+    auto module_count = cpptrace::experimental::get_safe_module_frames(
+        trace.frames.data(),
+        trace.frames.size(),
+        frames.data(),
+        &module,
+        1
+    );
+    ASSERT_EQ(module_count, 1);
+    for(const auto& frame : frames) {
+        if(frame.module != cpptrace::experimental::no_safe_module) {
+            EXPECT_EQ(frame.module, 0);
+        } else {
+            EXPECT_EQ(frame.resolve(&module).object_path, "");
+        }
+    }
+}
+
+TEST(ObjectTrace, SafeModuleFramesSameBase) {
+    if(!cpptrace::can_get_safe_object_frame()) {
+        GTEST_SKIP() << "safe object frames aren't supported";
+    }
+    auto trace = cpptrace::generate_raw_trace();
+    ASSERT_FALSE(trace.frames.empty());
+    std::vector<cpptrace::experimental::safe_module_frame> frames(trace.frames.size());
+    std::vector<cpptrace::experimental::safe_module> modules(trace.frames.size() + 1);
+    ASSERT_EQ(
+        cpptrace::experimental::get_safe_module_frames(trace.frames.data(), 1, frames.data(), modules.data(), 1),
+        1
+    );
+    // a different object that happens to have the same load bias, e.g. two objects with a bias of 0
+    modules[0] = {modules[0].base, "other", &modules};
+    auto module_count = cpptrace::detail::get_safe_module_frames(
+        trace.frames.data(),
+        trace.frames.size(),
+        frames.data(),
+        modules.data(),
+        1,
+        modules.size()
+    );
+    ASSERT_GE(module_count, 2);
+    EXPECT_EQ(frames[0].module, 1);
+    EXPECT_EQ(modules[1].base, modules[0].base);
+    EXPECT_THAT(modules[1].path, testing::HasSubstr("unittest"));
+}
+
+TEST(ObjectTrace, SafeModuleFramesWithStalledExecutablePathReader) {
+    if(!cpptrace::can_get_safe_object_frame()) {
+        GTEST_SKIP() << "safe object frames aren't supported";
+    }
+    auto trace = cpptrace::generate_raw_trace();
+    ASSERT_FALSE(trace.frames.empty());
+    // e.g. a thread interrupted by a signal while it was reading the path
+    cpptrace::detail::reset_cached_executable_path(1);
+    std::vector<cpptrace::experimental::safe_module_frame> frames(trace.frames.size());
+    std::vector<cpptrace::experimental::safe_module> modules(trace.frames.size());
+    cpptrace::experimental::get_safe_module_frames(
+        trace.frames.data(),
+        trace.frames.size(),
+        frames.data(),
+        modules.data(),
+        modules.size()
+    );
+    EXPECT_EQ(frames[0].module, 0);
+    EXPECT_THAT(modules[0].path, testing::HasSubstr("unittest"));
+    cpptrace::safe_object_frame safe_frame;
+    cpptrace::get_safe_object_frame(trace.frames[0], &safe_frame);
+    EXPECT_THAT(safe_frame.object_path, testing::HasSubstr("unittest"));
+}
+
+TEST(ObjectTrace, SafeModuleFramesWhileCachingExecutablePath) {
+    if(!cpptrace::can_get_safe_object_frame()) {
+        GTEST_SKIP() << "safe object frames aren't supported";
+    }
+    auto trace = cpptrace::generate_raw_trace();
+    ASSERT_FALSE(trace.frames.empty());
+    constexpr int thread_count = 4;
+    std::atomic<int> missing{0};
+    for(int round = 0; round < 50; round++) {
+        // every thread races to be the one reading the path, none of them may come up empty
+        cpptrace::detail::reset_cached_executable_path(0);
+        std::atomic<int> waiting{thread_count};
+        std::vector<std::thread> threads;
+        for(int i = 0; i < thread_count; i++) {
+            threads.emplace_back([&] {
+                std::vector<cpptrace::experimental::safe_module_frame> frames(trace.frames.size());
+                std::vector<cpptrace::experimental::safe_module> modules(trace.frames.size());
+                waiting--;
+                while(waiting.load() != 0) {}
+                cpptrace::experimental::get_safe_module_frames(
+                    trace.frames.data(),
+                    trace.frames.size(),
+                    frames.data(),
+                    modules.data(),
+                    modules.size()
+                );
+                if(frames[0].module != 0 || std::string(modules[0].path).find("unittest") == std::string::npos) {
+                    missing++;
+                }
+            });
+        }
+        for(auto& thread : threads) {
+            thread.join();
+        }
+    }
+    EXPECT_EQ(missing.load(), 0);
+}
@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+#include <gtest/gtest-matchers.h>
+#include <gmock/gmock.h>
+#include <gmock/gmock-matchers.h>
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+
+#include "common.hpp"
+#include "utils/utils.hpp"
+
+#ifdef TEST_MODULE
+import cpptrace;
+#else
+#include <cpptrace/cpptrace.hpp>
+#include <cpptrace/profiling.hpp>
+#endif
+
+#ifndef _WIN32
+#include <csignal>
+#endif
+
+using cpptrace::detail::split;
+
+namespace {
+
+volatile std::size_t profiling_sink = 0;
+
+CPPTRACE_FORCE_NO_INLINE void profiling_hot_function(std::chrono::milliseconds duration) {
+    auto start = std::chrono::steady_clock::now();
+    while(std::chrono::steady_clock::now() - start < duration) {
+        for(std::size_t i = 0; i < 10000; i++) {
+            profiling_sink = profiling_sink + i;
+        }
+    }
+}
+
+TEST(SamplingProfiler, ProfilesHotFunction) {
+    if(!cpptrace::can_signal_safe_unwind()) {
+        GTEST_SKIP() << "signal-safe unwinding isn't supported";
+    }
+    cpptrace::experimental::sampling_profiler profiler;
+    profiler.frequency(1000);
+    ASSERT_TRUE(profiler.start());
+    EXPECT_TRUE(profiler.is_running());
+    EXPECT_FALSE(cpptrace::experimental::sampling_profiler{}.start());
+    profiling_hot_function(std::chrono::milliseconds(500));
+    profiler.stop();
+    EXPECT_FALSE(profiler.is_running());
+    #ifndef _WIN32
+    struct sigaction action{};
+    ASSERT_EQ(sigaction(SIGPROF, nullptr, &action), 0);
+    EXPECT_EQ(action.sa_handler, SIG_DFL);
+    #endif
+    ASSERT_GT(profiler.sample_count(), 0);
+    std::size_t total = 0;
+    std::size_t hot = 0;
+    for(const auto& line : split(profiler.folded_stacks(), "\n")) {
+        if(line.empty()) {
+            continue;
+        }
+        auto count = std::stoull(line.substr(line.rfind(' ') + 1));
+        total += count;
+        if(line.find("profiling_hot_function") != std::string::npos) {
+            hot += count;
+        }
+    }
+    EXPECT_EQ(total, profiler.sample_count());
+    EXPECT_GT(hot, total / 2);
+    profiler.clear();
+    EXPECT_EQ(profiler.sample_count(), 0);
+    EXPECT_EQ(profiler.folded_stacks(), "");
+}
+
+}
+
+namespace {
+
+// volatile so optimized builds don't unroll the loops, every allocation must come from the same call site
+volatile int small_allocations = 10;
+volatile int large_allocations = 3;
+
+CPPTRACE_FORCE_NO_INLINE void allocation_site_small() {
+    for(int i = 0; i < small_allocations; i++) {
+        cpptrace::experimental::record_allocation(100);
+    }
+}
+
+CPPTRACE_FORCE_NO_INLINE void allocation_site_large() {
+    for(int i = 0; i < large_allocations; i++) {
+        cpptrace::experimental::record_allocation(1000);
+    }
+}
+
+TEST(AllocationProfiler, AggregatesByStack) {
+    cpptrace::experimental::allocation_profiler profiler;
+    profiler.sample_interval(0);
+    ASSERT_TRUE(profiler.start());
+    EXPECT_FALSE(cpptrace::experimental::allocation_profiler{}.start());
+    allocation_site_small();
+    allocation_site_large();
+    profiler.stop();
+    allocation_site_large();
+    auto sites = profiler.sites();
+    ASSERT_EQ(sites.size(), 2);
+    EXPECT_NE(sites[0].stack_id, sites[1].stack_id);
+    EXPECT_EQ(sites[0].sampled_count, 3);
+    EXPECT_EQ(sites[0].sampled_bytes, 3000);
+    EXPECT_EQ(sites[0].estimated_bytes, 3000);
+    EXPECT_EQ(sites[1].sampled_count, 10);
+    EXPECT_EQ(sites[1].sampled_bytes, 1000);
+    EXPECT_EQ(sites[1].estimated_bytes, 1000);
+    #ifndef CPPTRACE_BUILD_NO_SYMBOLS
+    auto trace = profiler.resolve(sites[0].stack_id);
+    ASSERT_FALSE(trace.frames.empty());
+    EXPECT_THAT(trace.frames[0].symbol, testing::HasSubstr("allocation_site_large"));
+    EXPECT_THAT(profiler.folded_stacks(), testing::HasSubstr("allocation_site_small 1000\n"));
+    #endif
+    profiler.clear();
+    EXPECT_TRUE(profiler.sites().empty());
+}
+
+TEST(AllocationProfiler, SampledEstimate) {
+    cpptrace::experimental::allocation_profiler profiler;
+    profiler.sample_interval(4096);
+    ASSERT_TRUE(profiler.start());
+    for(int i = 0; i < 100000; i++) {
+        cpptrace::experimental::record_allocation(64);
+    }
+    profiler.stop();
+    auto sites = profiler.sites();
+    ASSERT_EQ(sites.size(), 1);
+    EXPECT_LT(sites[0].sampled_count, 100000 / 10);
+    EXPECT_GT(sites[0].estimated_bytes, 6400000 * 8 / 10);
+    EXPECT_LT(sites[0].estimated_bytes, 6400000 * 12 / 10);
+}
+
+}
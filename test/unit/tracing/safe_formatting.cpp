@@ -0,0 +1,202 @@
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <gtest/gtest-matchers.h>
+#include <gmock/gmock.h>
+#include <gmock/gmock-matchers.h>
+
+#include "common.hpp"
+#include "utils/utils.hpp"
+
+#ifdef TEST_MODULE
+import cpptrace;
+#else
+#include <cpptrace/cpptrace.hpp>
+#endif
+
+#ifndef _WIN32
+#include <unistd.h>
+
+namespace {
+    // Runs fn with the write end of a pipe and returns everything written to it
+    template<typename F>
+    std::string capture_fd_output(F fn) {
+        int fds[2];
+        if(pipe(fds) != 0) {
+            ADD_FAILURE() << "pipe failed";
+            return "";
+        }
+        fn(fds[1]);
+        close(fds[1]);
+        std::string output;
+        char buffer[4096];
+        ssize_t n;
+        while((n = read(fds[0], buffer, sizeof(buffer))) > 0) {
+            output.append(buffer, static_cast<std::size_t>(n));
+        }
+        close(fds[0]);
+        return output;
+    }
+
+    std::vector<cpptrace::safe_object_frame> get_safe_frames() {
+        auto trace = cpptrace::generate_raw_trace();
+        std::vector<cpptrace::safe_object_frame> frames(trace.frames.size());
+        for(std::size_t i = 0; i < trace.frames.size(); i++) {
+            cpptrace::get_safe_object_frame(trace.frames[i], &frames[i]);
+        }
+        return frames;
+    }
+
+    bool test_lookup(const cpptrace::safe_object_frame&, char* buffer, std::size_t size, void* context) {
+        auto name = static_cast<const char*>(context);
+        if(size <= std::strlen(name)) {
+            return false;
+        }
+        std::strcpy(buffer, name);
+        return true;
+    }
+}
+
+TEST(SafeFormatting, Empty) {
+    auto output = capture_fd_output([] (int fd) {
+        cpptrace::experimental::safe_print_object_trace(fd, nullptr, 0);
+    });
+    EXPECT_EQ(output, "Stack trace (most recent call first):\n<empty trace>\n");
+}
+
+TEST(SafeFormatting, ObjectFrames) {
+    if(!cpptrace::can_get_safe_object_frame()) {
+        GTEST_SKIP() << "safe object frames aren't supported";
+    }
+    auto frames = get_safe_frames();
+    ASSERT_FALSE(frames.empty());
+    auto output = capture_fd_output([&frames] (int fd) {
+        cpptrace::experimental::safe_print_object_trace(fd, frames.data(), frames.size());
+    });
+    auto lines = cpptrace::detail::split(output, "\n");
+    // header, one line per frame, and the empty string after the last newline
+    ASSERT_EQ(lines.size(), frames.size() + 2);
+    EXPECT_EQ(lines[0], "Stack trace (most recent call first):");
+    EXPECT_THAT(lines[1], testing::StartsWith("#0 0x"));
+    EXPECT_THAT(lines[1], testing::HasSubstr("unittest+0x"));
+    #ifdef __linux__
+    EXPECT_THAT(lines[1], testing::ContainsRegex("\\(build-id [0-9a-f]+\\)$"));
+    #endif
+    EXPECT_EQ(lines.back(), "");
+}
+
+TEST(SafeFormatting, SymbolLookup) {
+    if(!cpptrace::can_get_safe_object_frame()) {
+        GTEST_SKIP() << "safe object frames aren't supported";
+    }
+    auto frames = get_safe_frames();
+    ASSERT_FALSE(frames.empty());
+    char name[] = "some_function()";
+    auto output = capture_fd_output([&frames, &name] (int fd) {
+        cpptrace::experimental::safe_print_object_trace(fd, frames.data(), 1, test_lookup, name);
+    });
+    auto lines = cpptrace::detail::split(output, "\n");
+    ASSERT_EQ(lines.size(), 3);
+    EXPECT_THAT(lines[1], testing::ContainsRegex("^#0 0x[0-9a-f]+ in some_function\\(\\) at .*unittest\\+0x"));
+}
+
+CPPTRACE_FORCE_NO_INLINE void safe_symbol_table_target() {
+    static volatile int lto_guard; lto_guard = lto_guard + 1;
+}
+
+TEST(SafeSymbolTable, Lookup) {
+    #ifndef __linux__
+    GTEST_SKIP() << "the safe symbol table is only supported on linux";
+    #endif
+    ASSERT_TRUE(cpptrace::experimental::build_safe_symbol_table());
+    // building again is a no-op while nothing has been loaded or unloaded
+    ASSERT_TRUE(cpptrace::experimental::build_safe_symbol_table());
+    auto address = reinterpret_cast<cpptrace::frame_ptr>(&safe_symbol_table_target);
+    char buffer[256];
+    ASSERT_TRUE(cpptrace::experimental::lookup_safe_symbol(address + 1, buffer, sizeof(buffer)));
+    EXPECT_STREQ(buffer, "safe_symbol_table_target()");
+    // truncated to the buffer
+    ASSERT_TRUE(cpptrace::experimental::lookup_safe_symbol(address, buffer, 5));
+    EXPECT_STREQ(buffer, "safe");
+    EXPECT_FALSE(cpptrace::experimental::lookup_safe_symbol(0, buffer, sizeof(buffer)));
+    cpptrace::experimental::clear_safe_symbol_table();
+    EXPECT_FALSE(cpptrace::experimental::lookup_safe_symbol(address, buffer, sizeof(buffer)));
+}
+
+int safe_symbol_table_data[16] = { 1 };
+
+TEST(SafeSymbolTable, OnlyFunctions) {
+    #ifndef __linux__
+    GTEST_SKIP() << "the safe symbol table is only supported on linux";
+    #endif
+    ASSERT_TRUE(cpptrace::experimental::build_safe_symbol_table());
+    char buffer[256];
+    auto data = reinterpret_cast<cpptrace::frame_ptr>(&safe_symbol_table_data[1]);
+    EXPECT_FALSE(cpptrace::experimental::lookup_safe_symbol(data, buffer, sizeof(buffer)));
+    auto address = reinterpret_cast<cpptrace::frame_ptr>(&safe_symbol_table_target);
+    EXPECT_TRUE(cpptrace::experimental::lookup_safe_symbol(address, buffer, sizeof(buffer)));
+    cpptrace::experimental::clear_safe_symbol_table();
+}
+
+TEST(SafeSymbolTable, LookupsDuringRebuild) {
+    #ifndef __linux__
+    GTEST_SKIP() << "the safe symbol table is only supported on linux";
+    #endif
+    ASSERT_TRUE(cpptrace::experimental::build_safe_symbol_table());
+    auto address = reinterpret_cast<cpptrace::frame_ptr>(&safe_symbol_table_target);
+    std::atomic<bool> done{false};
+    std::atomic<std::size_t> mismatches{0};
+    std::vector<std::thread> readers;
+    for(int i = 0; i < 4; i++) {
+        readers.emplace_back([&] {
+            char buffer[256];
+            while(!done.load()) {
+                // the table may be missing between clearing and rebuilding, but never wrong
+                if(
+                    cpptrace::experimental::lookup_safe_symbol(address, buffer, sizeof(buffer))
+                    && std::strcmp(buffer, "safe_symbol_table_target()") != 0
+                ) {
+                    mismatches++;
+                }
+            }
+        });
+    }
+    // publishing must not be held up by readers that keep starting lookups
+    for(int i = 0; i < 3; i++) {
+        cpptrace::experimental::clear_safe_symbol_table();
+        ASSERT_TRUE(cpptrace::experimental::build_safe_symbol_table());
+    }
+    done = true;
+    for(auto& reader : readers) {
+        reader.join();
+    }
+    EXPECT_EQ(mismatches.load(), 0);
+    cpptrace::experimental::clear_safe_symbol_table();
+}
+
+TEST(SafeSymbolTable, PrintObjectTrace) {
+    if(!cpptrace::can_get_safe_object_frame()) {
+        GTEST_SKIP() << "safe object frames aren't supported";
+    }
+    ASSERT_TRUE(cpptrace::experimental::build_safe_symbol_table());
+    auto frames = get_safe_frames();
+    ASSERT_FALSE(frames.empty());
+    auto output = capture_fd_output([&frames] (int fd) {
+        cpptrace::experimental::safe_print_object_trace(
+            fd,
+            frames.data(),
+            1,
+            cpptrace::experimental::safe_symbol_table_lookup
+        );
+    });
+    cpptrace::experimental::clear_safe_symbol_table();
+    auto lines = cpptrace::detail::split(output, "\n");
+    ASSERT_EQ(lines.size(), 3);
+    EXPECT_THAT(lines[1], testing::ContainsRegex("^#0 0x[0-9a-f]+ in .*get_safe_frames.* at .*unittest\\+0x"));
+}
+#endif
@@ -0,0 +1,158 @@
+#include <gtest/gtest.h>
+#include <gtest/gtest-matchers.h>
+#include <gmock/gmock.h>
+#include <gmock/gmock-matchers.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "common.hpp"
+
+#ifdef TEST_MODULE
+import cpptrace;
+#else
+#include <cpptrace/cpptrace.hpp>
+#include <cpptrace/serialization.hpp>
+#endif
+
+namespace {
+
+CPPTRACE_FORCE_NO_INLINE cpptrace::raw_trace serialization_capture() {
+    return cpptrace::generate_raw_trace();
+}
+
+TEST(Serialization, RoundTrip) {
+    auto trace = serialization_capture();
+    auto object_trace = trace.resolve_object_trace();
+    auto serialized = cpptrace::experimental::serialize_trace(trace);
+    EXPECT_EQ(serialized, cpptrace::experimental::serialize_trace(object_trace));
+    cpptrace::experimental::serialized_trace_view view;
+    ASSERT_TRUE(view.parse(serialized.data(), serialized.size()));
+    ASSERT_EQ(view.frame_count(), trace.frames.size());
+    ASSERT_GT(view.module_count(), 0);
+    auto main_module = view.module(0);
+    EXPECT_EQ(main_module.get_path(), object_trace.frames[0].object_path);
+    EXPECT_EQ(main_module.load_bias, object_trace.frames[0].raw_address - object_trace.frames[0].object_address);
+    auto decoded = view.to_object_trace();
+    ASSERT_EQ(decoded.frames.size(), object_trace.frames.size());
+    for(std::size_t i = 0; i < decoded.frames.size(); i++) {
+        EXPECT_EQ(decoded.frames[i].raw_address, object_trace.frames[i].raw_address);
+        EXPECT_EQ(decoded.frames[i].object_address, object_trace.frames[i].object_address);
+        EXPECT_EQ(decoded.frames[i].object_path, object_trace.frames[i].object_path);
+    }
+    // module paths are stored once rather than per frame
+    std::size_t text_size = 0;
+    for(const auto& frame : object_trace.frames) {
+        text_size += frame.object_path.size() + 2 * sizeof(cpptrace::frame_ptr);
+    }
+    EXPECT_LT(serialized.size() * 2, text_size);
+}
+
+TEST(Serialization, Deltas) {
+    cpptrace::object_trace trace;
+    trace.frames.push_back({0x7000, 0x2000, "a.so"});
+    trace.frames.push_back({0x6000, 0x1000, "a.so"});
+    trace.frames.push_back({0x13000, 0x3000, "b.so"});
+    trace.frames.push_back({0x6500, 0x1500, "a.so"});
+    trace.frames.push_back({0x1234, 0, ""});
+    auto serialized = cpptrace::experimental::serialize_trace(trace);
+    cpptrace::experimental::serialized_trace_view view;
+    ASSERT_TRUE(view.parse(serialized.data(), serialized.size()));
+    ASSERT_EQ(view.module_count(), 2);
+    EXPECT_EQ(view.module(0).get_path(), "a.so");
+    EXPECT_EQ(view.module(0).load_bias, 0x5000);
+    EXPECT_EQ(view.module(0).build_id_length, 0);
+    EXPECT_EQ(view.module(1).get_path(), "b.so");
+    EXPECT_EQ(view.module(1).load_bias, 0x10000);
+    std::vector<cpptrace::experimental::serialized_frame> frames;
+    auto cursor = view.frames();
+    cpptrace::experimental::serialized_frame frame;
+    while(cursor.next(frame)) {
+        frames.push_back(frame);
+    }
+    ASSERT_EQ(frames.size(), 5);
+    EXPECT_EQ(frames[1].module_index.value(), 0);
+    EXPECT_EQ(frames[1].object_address, 0x1000);
+    EXPECT_EQ(frames[1].raw_address, 0x6000);
+    EXPECT_EQ(frames[2].module_index.value(), 1);
+    EXPECT_EQ(frames[2].raw_address, 0x13000);
+    EXPECT_EQ(frames[3].object_address, 0x1500);
+    EXPECT_EQ(frames[3].raw_address, 0x6500);
+    EXPECT_FALSE(frames[4].module_index.has_value());
+    EXPECT_EQ(frames[4].raw_address, 0x1234);
+}
+
+TEST(Serialization, ModuleLookup) {
+    cpptrace::object_trace trace;
+    for(std::size_t i = 0; i < 200; i++) {
+        // alternate between modules so the cursor changes module on every frame
+        auto module = (i * 7) % 100;
+        trace.frames.push_back({
+            0x100000 * (module + 1) + i,
+            i,
+            "module_" + std::to_string(module) + ".so"
+        });
+    }
+    auto serialized = cpptrace::experimental::serialize_trace(trace);
+    cpptrace::experimental::serialized_trace_view view;
+    ASSERT_TRUE(view.parse(serialized.data(), serialized.size()));
+    ASSERT_EQ(view.module_count(), 100);
+    for(std::size_t i = view.module_count(); i-- > 0;) {
+        auto module = view.module(i);
+        auto expected = trace.frames[i];
+        EXPECT_EQ(module.get_path(), expected.object_path);
+        EXPECT_EQ(module.load_bias, expected.raw_address - expected.object_address);
+    }
+    EXPECT_EQ(view.module(view.module_count()).path_length, 0);
+    auto decoded = view.to_object_trace();
+    ASSERT_EQ(decoded.frames.size(), trace.frames.size());
+    for(std::size_t i = 0; i < decoded.frames.size(); i++) {
+        EXPECT_EQ(decoded.frames[i].raw_address, trace.frames[i].raw_address);
+        EXPECT_EQ(decoded.frames[i].object_path, trace.frames[i].object_path);
+    }
+}
+
+TEST(Serialization, RejectsMalformed) {
+    auto serialized = cpptrace::experimental::serialize_trace(serialization_capture());
+    cpptrace::experimental::serialized_trace_view view;
+    for(std::size_t i = 0; i < serialized.size(); i++) {
+        EXPECT_FALSE(view.parse(serialized.data(), i)) << i;
+    }
+    auto extended = serialized;
+    extended.push_back(0);
+    EXPECT_FALSE(view.parse(extended.data(), extended.size()));
+    auto wrong_version = serialized;
+    wrong_version[4]++;
+    EXPECT_FALSE(view.parse(wrong_version.data(), wrong_version.size()));
+    EXPECT_EQ(view.frame_count(), 0);
+}
+
+#ifndef CPPTRACE_BUILD_NO_SYMBOLS
+TEST(Serialization, Resolve) {
+    auto trace = serialization_capture();
+    auto serialized = cpptrace::experimental::serialize_trace(trace);
+    auto resolved = cpptrace::experimental::resolve_serialized(serialized.data(), serialized.size());
+    auto expected = trace.resolve();
+    ASSERT_EQ(resolved.frames.size(), expected.frames.size());
+    EXPECT_THAT(resolved.frames[0].symbol, testing::HasSubstr("serialization_capture"));
+    for(std::size_t i = 0; i < resolved.frames.size(); i++) {
+        EXPECT_EQ(resolved.frames[i].symbol, expected.frames[i].symbol);
+        EXPECT_EQ(resolved.frames[i].raw_address, expected.frames[i].raw_address);
+    }
+    bool called = false;
+    auto relocated = cpptrace::experimental::resolve_serialized(
+        serialized.data(),
+        serialized.size(),
+        [&] (const cpptrace::experimental::serialized_module& module) {
+            called = true;
+            return module.get_path();
+        }
+    );
+    EXPECT_TRUE(called);
+    EXPECT_EQ(relocated.frames.size(), resolved.frames.size());
+}
+#endif
+
+}
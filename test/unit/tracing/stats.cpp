@@ -0,0 +1,45 @@
+#include <gtest/gtest.h>
+#include <gtest/gtest-matchers.h>
+#include <gmock/gmock.h>
+#include <gmock/gmock-matchers.h>
+
+#include <string>
+
+#include "common.hpp"
+
+#ifdef TEST_MODULE
+import cpptrace;
+#else
+#include <cpptrace/cpptrace.hpp>
+#include <cpptrace/stats.hpp>
+#endif
+
+namespace {
+
+TEST(Stats, Counters) {
+    cpptrace::experimental::reset_stats();
+    auto trace = cpptrace::generate_trace();
+    auto str = trace.to_string();
+    cpptrace::demangle("_Z3fooi");
+    cpptrace::demangle("_Z3fooi");
+    auto stats = cpptrace::experimental::get_stats();
+    if(!stats.enabled) {
+        EXPECT_EQ(stats.unwinding.count, 0);
+        EXPECT_EQ(stats.formatting.count, 0);
+        EXPECT_EQ(stats.demangle_cache.hits, 0);
+        return;
+    }
+    EXPECT_GE(stats.unwinding.count, 1);
+    EXPECT_GE(stats.object_lookup.count, 1);
+    EXPECT_GE(stats.demangling.count, 2);
+    EXPECT_GE(stats.demangle_cache.hits, 1);
+    EXPECT_GE(stats.formatting.count, 1);
+    EXPECT_GT(stats.formatting.nanoseconds, 0);
+    cpptrace::experimental::reset_stats();
+    stats = cpptrace::experimental::get_stats();
+    EXPECT_EQ(stats.unwinding.count, 0);
+    EXPECT_EQ(stats.formatting.nanoseconds, 0);
+    EXPECT_EQ(stats.demangle_cache.hits, 0);
+}
+
+}
@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+#include <gtest/gtest-matchers.h>
+#include <gmock/gmock.h>
+#include <gmock/gmock-matchers.h>
+
+#include <string>
+#include <vector>
+
+#include "common.hpp"
+
+#ifdef TEST_MODULE
+import cpptrace;
+#else
+#include <cpptrace/cpptrace.hpp>
+#endif
+
+using cpptrace::experimental::symbol_source;
+using testing::HasSubstr;
+
+namespace {
+
+CPPTRACE_FORCE_NO_INLINE cpptrace::raw_trace symbol_chain_capture() {
+    return cpptrace::generate_raw_trace();
+}
+
+class SymbolChain : public testing::Test {
+protected:
+    void TearDown() override {
+        cpptrace::experimental::set_symbol_resolution_chain({});
+    }
+};
+
+// Every back-end is listed, the ones that weren't compiled in are skipped
+const std::vector<symbol_source> all_backends = {
+    symbol_source::libdwarf,
+    symbol_source::dbghelp,
+    symbol_source::libbacktrace,
+    symbol_source::addr2line,
+    symbol_source::libdl
+};
+
+TEST_F(SymbolChain, MatchesDefaultResolution) {
+    auto trace = symbol_chain_capture();
+    auto expected = trace.resolve();
+    std::vector<symbol_source> chain{symbol_source::cache, symbol_source::symbol_table};
+    chain.insert(chain.end(), all_backends.begin(), all_backends.end());
+    cpptrace::experimental::set_symbol_resolution_chain(chain);
+    auto resolved = trace.resolve();
+    ASSERT_FALSE(resolved.frames.empty());
+    EXPECT_THAT(resolved.frames[0].symbol, HasSubstr("symbol_chain_capture"));
+    ASSERT_EQ(resolved.frames.size(), expected.frames.size());
+    for(std::size_t i = 0; i < resolved.frames.size(); i++) {
+        if(expected.frames[i].line.has_value() && expected.frames[i].line.value() != 0) {
+            EXPECT_EQ(resolved.frames[i].line, expected.frames[i].line);
+        }
+    }
+    // the second resolution is answered from the cache
+    auto cached = trace.resolve();
+    EXPECT_EQ(cached.frames, resolved.frames);
+}
+
+TEST_F(SymbolChain, CheapStagesAnswerFirst) {
+    auto trace = symbol_chain_capture();
+    // with symbol names being enough, the symbol table answers and the back-ends never see the frame
+    std::vector<symbol_source> chain{symbol_source::symbol_table};
+    chain.insert(chain.end(), all_backends.begin(), all_backends.end());
+    cpptrace::experimental::set_symbol_resolution_chain(chain, false);
+    auto resolved = trace.resolve();
+    ASSERT_FALSE(resolved.frames.empty());
+    EXPECT_THAT(resolved.frames[0].symbol, HasSubstr("symbol_chain_capture"));
+    EXPECT_FALSE(resolved.frames[0].line.has_value());
+}
+
+TEST_F(SymbolChain, UnavailableStagesAreSkipped) {
+    auto trace = symbol_chain_capture();
+    cpptrace::experimental::set_symbol_resolution_chain({symbol_source::server});
+    auto resolved = trace.resolve();
+    ASSERT_EQ(resolved.frames.size(), trace.frames.size());
+    for(std::size_t i = 0; i < trace.frames.size(); i++) {
+        EXPECT_EQ(resolved.frames[i].raw_address, trace.frames[i]);
+        EXPECT_TRUE(resolved.frames[i].symbol.empty());
+    }
+}
+
+}
@@ -0,0 +1,167 @@
+#include <gtest/gtest.h>
+#include <gtest/gtest-matchers.h>
+#include <gmock/gmock.h>
+#include <gmock/gmock-matchers.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common.hpp"
+
+#ifdef TEST_MODULE
+import cpptrace;
+#else
+#include <cpptrace/cpptrace.hpp>
+#include <cpptrace/serialization.hpp>
+#include <cpptrace/symbolication.hpp>
+#endif
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+std::string test_socket_path(const char* name) {
+    return "/tmp/cpptrace-" + std::string(name) + "-" + std::to_string(getpid()) + ".sock";
+}
+
+CPPTRACE_FORCE_NO_INLINE cpptrace::raw_trace symbolication_capture() {
+    return cpptrace::generate_raw_trace();
+}
+
+class running_server {
+    cpptrace::experimental::symbolication_server server;
+    std::thread thread;
+public:
+    explicit running_server(const std::string& path) : server(path) {
+        EXPECT_TRUE(server.listen());
+        thread = std::thread([this] { server.serve(); });
+    }
+    ~running_server() {
+        server.stop();
+        thread.join();
+    }
+    std::size_t requests_served() const {
+        return server.requests_served();
+    }
+};
+
+// Minimal client speaking the wire protocol directly: a 32-bit little endian length followed by the payload
+class stand_in_client {
+    int fd;
+public:
+    explicit stand_in_client(const std::string& path) : fd(socket(AF_UNIX, SOCK_STREAM, 0)) {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+        EXPECT_EQ(connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)), 0);
+    }
+    ~stand_in_client() {
+        close(fd);
+    }
+    std::vector<std::uint8_t> exchange(const std::vector<std::uint8_t>& request) {
+        auto size = static_cast<std::uint32_t>(request.size());
+        std::uint8_t header[4] = {
+            std::uint8_t(size), std::uint8_t(size >> 8), std::uint8_t(size >> 16), std::uint8_t(size >> 24)
+        };
+        EXPECT_EQ(send(fd, header, 4, 0), 4);
+        EXPECT_EQ(send(fd, request.data(), request.size(), 0), static_cast<ssize_t>(request.size()));
+        EXPECT_EQ(recv(fd, header, 4, MSG_WAITALL), 4);
+        size = std::uint32_t(header[0]) | std::uint32_t(header[1]) << 8
+            | std::uint32_t(header[2]) << 16 | std::uint32_t(header[3]) << 24;
+        std::vector<std::uint8_t> response(size);
+        EXPECT_EQ(recv(fd, response.data(), response.size(), MSG_WAITALL), static_cast<ssize_t>(size));
+        return response;
+    }
+};
+
+TEST(SymbolicationServer, ResolvesRemotely) {
+    auto path = test_socket_path("symbolication");
+    auto trace = symbolication_capture();
+    auto local = trace.resolve();
+    running_server server(path);
+    cpptrace::experimental::set_symbolication_server(path);
+    auto remote = trace.resolve();
+    auto remote_again = trace.resolve();
+    cpptrace::experimental::set_symbolication_server("");
+    EXPECT_EQ(server.requests_served(), 2);
+    ASSERT_EQ(remote.frames.size(), local.frames.size());
+    for(std::size_t i = 0; i < local.frames.size(); i++) {
+        EXPECT_EQ(remote.frames[i], local.frames[i]);
+        EXPECT_EQ(remote.frames[i].is_inline, local.frames[i].is_inline);
+    }
+    EXPECT_EQ(remote_again.frames, remote.frames);
+}
+
+TEST(SymbolicationServer, StandInClient) {
+    auto path = test_socket_path("symbolication-client");
+    running_server server(path);
+    stand_in_client client(path);
+    auto response = client.exchange(cpptrace::experimental::serialize_trace(symbolication_capture()));
+    ASSERT_FALSE(response.empty());
+    EXPECT_EQ(response[0], 0);
+    response = client.exchange({1, 2, 3});
+    EXPECT_EQ(response, std::vector<std::uint8_t>{1});
+    // the connection stays usable after an error
+    response = client.exchange(cpptrace::experimental::serialize_trace(cpptrace::raw_trace{}));
+    EXPECT_EQ(response, (std::vector<std::uint8_t>{0, 0}));
+    EXPECT_EQ(server.requests_served(), 3);
+}
+
+TEST(SymbolicationServer, ConcurrentClients) {
+    auto path = test_socket_path("symbolication-concurrent");
+    auto trace = symbolication_capture();
+    auto local = trace.resolve();
+    running_server server(path);
+    cpptrace::experimental::set_symbolication_server(path);
+    std::vector<std::thread> threads;
+    std::vector<cpptrace::stacktrace> results(4);
+    for(std::size_t i = 0; i < results.size(); i++) {
+        threads.emplace_back([&, i] {
+            for(int j = 0; j < 5; j++) {
+                results[i] = trace.resolve();
+            }
+        });
+    }
+    for(auto& thread : threads) {
+        thread.join();
+    }
+    cpptrace::experimental::set_symbolication_server("");
+    EXPECT_EQ(server.requests_served(), 20);
+    for(const auto& result : results) {
+        EXPECT_EQ(result.frames, local.frames);
+    }
+}
+
+TEST(SymbolicationServer, SocketIsPrivateAndNotStolen) {
+    auto path = test_socket_path("symbolication-private");
+    running_server server(path);
+    struct stat st;
+    ASSERT_EQ(stat(path.c_str(), &st), 0);
+    EXPECT_EQ(st.st_mode & 0777, 0600);
+    cpptrace::experimental::symbolication_server second(path);
+    EXPECT_ANY_THROW(second.listen());
+    // the live server keeps its socket
+    stand_in_client client(path);
+    auto response = client.exchange(cpptrace::experimental::serialize_trace(cpptrace::raw_trace{}));
+    EXPECT_EQ(response, (std::vector<std::uint8_t>{0, 0}));
+}
+
+TEST(SymbolicationServer, FallsBackWhenUnreachable) {
+    auto trace = symbolication_capture();
+    auto local = trace.resolve();
+    cpptrace::experimental::set_symbolication_server(test_socket_path("symbolication-missing"));
+    auto fallback = trace.resolve();
+    cpptrace::experimental::set_symbolication_server("");
+    EXPECT_EQ(fallback.frames, local.frames);
+}
+
+}
+#endif
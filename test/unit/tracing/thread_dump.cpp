@@ -0,0 +1,165 @@
+#include <gtest/gtest.h>
+#include <gtest/gtest-matchers.h>
+#include <gmock/gmock.h>
+#include <gmock/gmock-matchers.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common.hpp"
+
+#ifdef TEST_MODULE
+import cpptrace;
+#else
+#include <cpptrace/cpptrace.hpp>
+#include <cpptrace/thread_dump.hpp>
+#endif
+
+#ifdef __linux__
+#include <csignal>
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+
+// A few idle threads
+class parked_workers {
+    std::atomic<bool> done{false};
+    std::mutex mutex;
+    std::vector<std::uint64_t> ids;
+    std::vector<std::thread> threads;
+
+    CPPTRACE_FORCE_NO_INLINE void thread_dump_worker() {
+        pthread_setname_np(pthread_self(), "dump-worker");
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            ids.push_back(static_cast<std::uint64_t>(syscall(SYS_gettid)));
+        }
+        while(!done) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+public:
+    explicit parked_workers(std::size_t count) {
+        for(std::size_t i = 0; i < count; i++) {
+            threads.emplace_back([this] { thread_dump_worker(); });
+        }
+        while(thread_ids().size() != count) {
+            std::this_thread::yield();
+        }
+    }
+
+    ~parked_workers() {
+        done = true;
+        for(auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    std::vector<std::uint64_t> thread_ids() {
+        std::unique_lock<std::mutex> lock(mutex);
+        return ids;
+    }
+};
+
+TEST(ThreadDump, AllThreads) {
+    parked_workers workers(4);
+    auto threads = cpptrace::experimental::dump_all_threads();
+    ASSERT_FALSE(threads.empty());
+    EXPECT_EQ(threads[0].thread_id, static_cast<std::uint64_t>(syscall(SYS_gettid)));
+    for(auto id : workers.thread_ids()) {
+        auto it = std::find_if(
+            threads.begin(),
+            threads.end(),
+            [id] (const cpptrace::experimental::thread_trace& thread) { return thread.thread_id == id; }
+        );
+        ASSERT_NE(it, threads.end()) << "thread " << id << " is missing from the dump";
+        EXPECT_EQ(it->name, "dump-worker");
+        EXPECT_FALSE(it->missed);
+        if(cpptrace::can_signal_safe_unwind()) {
+            bool found = false;
+            for(const auto& frame : it->trace.frames) {
+                found = found || frame.symbol.find("thread_dump_worker") != std::string::npos;
+            }
+            EXPECT_TRUE(found) << it->trace.to_string();
+        }
+    }
+    if(cpptrace::can_signal_safe_unwind()) {
+        ASSERT_FALSE(threads[0].trace.frames.empty());
+        EXPECT_THAT(threads[0].trace.frames[0].symbol, testing::HasSubstr("ThreadDump_AllThreads_Test::TestBody"));
+    }
+}
+
+TEST(ThreadDump, CaptureSignal) {
+    parked_workers workers(2);
+    int in_use = SIGRTMIN + 6;
+    struct sigaction action{};
+    action.sa_handler = [] (int) {};
+    sigemptyset(&action.sa_mask);
+    struct sigaction previous;
+    ASSERT_EQ(sigaction(in_use, &action, &previous), 0);
+    cpptrace::experimental::thread_dump_options options;
+    options.capture_signal = in_use;
+    EXPECT_TRUE(cpptrace::experimental::dump_all_threads(options).empty());
+    struct sigaction current;
+    ASSERT_EQ(sigaction(in_use, nullptr, &current), 0);
+    EXPECT_EQ(current.sa_handler, action.sa_handler);
+    sigaction(in_use, &previous, nullptr);
+    options.capture_signal = SIGRTMIN + 7;
+    auto threads = cpptrace::experimental::dump_all_threads(options);
+    ASSERT_FALSE(threads.empty());
+    for(auto id : workers.thread_ids()) {
+        auto it = std::find_if(
+            threads.begin(),
+            threads.end(),
+            [id] (const cpptrace::experimental::thread_trace& thread) { return thread.thread_id == id; }
+        );
+        ASSERT_NE(it, threads.end()) << "thread " << id << " is missing from the dump";
+        EXPECT_FALSE(it->missed);
+    }
+}
+
+TEST(ThreadDump, ToString) {
+    std::vector<cpptrace::experimental::thread_trace> threads;
+    threads.push_back({12, "main", false, cpptrace::stacktrace{}});
+    threads.push_back({13, "worker", true, cpptrace::stacktrace{}});
+    EXPECT_EQ(
+        cpptrace::experimental::thread_dump_to_string(threads),
+        "Thread 12 \"main\":\n<empty trace>\n\n"
+        "Thread 13 \"worker\" (didn't respond in time):\n<empty trace>\n\n"
+    );
+}
+
+TEST(ThreadDump, SignalHandler) {
+    parked_workers workers(2);
+    char path[] = "/tmp/cpptrace_thread_dump_XXXXXX";
+    int fd = mkstemp(path);
+    ASSERT_NE(fd, -1);
+    ASSERT_TRUE(cpptrace::experimental::install_thread_dump_handler(fd));
+    raise(SIGQUIT);
+    // pending dumps are written before the handler is removed
+    cpptrace::experimental::uninstall_thread_dump_handler();
+    close(fd);
+    std::ifstream file(path);
+    std::string output{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    std::remove(path);
+    EXPECT_THAT(output, testing::StartsWith("Thread "));
+    EXPECT_THAT(output, testing::HasSubstr("\"cpptrace-dump\""));
+    for(auto id : workers.thread_ids()) {
+        EXPECT_THAT(output, testing::HasSubstr("Thread " + std::to_string(id) + " \"dump-worker\":\n"));
+    }
+}
+
+}
+#endif
@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+#include <gtest/gtest-matchers.h>
+#include <gmock/gmock.h>
+#include <gmock/gmock-matchers.h>
+
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include "common.hpp"
+
+#ifdef TEST_MODULE
+import cpptrace;
+#else
+#include <cpptrace/cpptrace.hpp>
+#include <cpptrace/trace_table.hpp>
+#endif
+
+namespace {
+
+CPPTRACE_FORCE_NO_INLINE cpptrace::raw_trace trace_table_capture() {
+    return cpptrace::generate_raw_trace();
+}
+
+std::vector<cpptrace::frame_ptr> make_stack(std::size_t i) {
+    return {0x1000 + i, 0x2000, 0x3000 + i % 7};
+}
+
+TEST(TraceTable, Deduplicates) {
+    cpptrace::experimental::trace_table table;
+    std::vector<cpptrace::raw_trace> traces;
+    // volatile so optimized builds don't unroll the loop, both traces must come from the same call site
+    volatile int count = 2;
+    for(int i = 0; i < count; i++) {
+        traces.push_back(trace_table_capture());
+    }
+    auto a = table.insert(traces[0]);
+    auto b = table.insert(traces[1]);
+    auto c = table.insert(cpptrace::generate_raw_trace());
+    EXPECT_EQ(a, 0);
+    EXPECT_EQ(a, b);
+    EXPECT_EQ(c, 1);
+    EXPECT_EQ(table.size(), 2);
+    EXPECT_EQ(table.get(a).frames, traces[0].frames);
+    EXPECT_EQ(table.find(traces[0].frames.data(), traces[0].frames.size()).value(), a);
+    auto missing = make_stack(0);
+    EXPECT_FALSE(table.find(missing.data(), missing.size()).has_value());
+    EXPECT_EQ(table.insert(nullptr, 0), 2);
+    EXPECT_TRUE(table.get(2).frames.empty());
+}
+
+TEST(TraceTable, CachesResolution) {
+    cpptrace::experimental::trace_table table;
+    auto id = table.insert(trace_table_capture());
+    const auto& first = table.resolve(id);
+    const auto& second = table.resolve(id);
+    EXPECT_EQ(&first, &second);
+    EXPECT_EQ(first.frames.size(), table.get(id).resolve().frames.size());
+    #ifndef CPPTRACE_BUILD_NO_SYMBOLS
+    ASSERT_FALSE(first.frames.empty());
+    EXPECT_THAT(first.frames[0].symbol, testing::HasSubstr("trace_table_capture"));
+    #endif
+    EXPECT_EQ(&table.to_string(id), &table.to_string(id));
+    EXPECT_EQ(table.to_string(id), first.to_string());
+}
+
+TEST(TraceTable, ManyStacks) {
+    cpptrace::experimental::trace_table table(16);
+    const std::size_t count = 5000;
+    for(std::size_t i = 0; i < count; i++) {
+        auto stack = make_stack(i);
+        ASSERT_EQ(table.insert(stack.data(), stack.size()), i);
+    }
+    EXPECT_EQ(table.size(), count);
+    for(std::size_t i = 0; i < count; i++) {
+        ASSERT_EQ(table.get(static_cast<cpptrace::experimental::stack_id>(i)).frames, make_stack(i));
+    }
+}
+
+TEST(TraceTable, Concurrent) {
+    cpptrace::experimental::trace_table table;
+    const std::size_t count = 2000;
+    const std::size_t n_threads = 4;
+    std::vector<std::vector<cpptrace::experimental::stack_id>> ids(n_threads);
+    std::vector<std::thread> threads;
+    for(std::size_t t = 0; t < n_threads; t++) {
+        threads.emplace_back([&, t] {
+            for(std::size_t i = 0; i < count; i++) {
+                // threads walk the stacks in different orders
+                auto stack = make_stack((i * (t + 1)) % count);
+                ids[t].push_back(table.insert(stack.data(), stack.size()));
+            }
+        });
+    }
+    for(auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(table.size(), count);
+    for(std::size_t t = 0; t < n_threads; t++) {
+        for(std::size_t i = 0; i < count; i++) {
+            ASSERT_EQ(table.get(ids[t][i]).frames, make_stack((i * (t + 1)) % count));
+        }
+    }
+}
+
+}
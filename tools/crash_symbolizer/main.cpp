@@ -0,0 +1,99 @@
+#include <lyra/lyra.hpp>
+#include <fmt/format.h>
+#include <fmt/std.h>
+#include <fmt/ostream.h>
+#include <cpptrace/cpptrace.hpp>
+#include <cpptrace/crash_reporting.hpp>
+#include <cpptrace/formatting.hpp>
+#include <cpptrace/from_current.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+template<> struct fmt::formatter<lyra::cli> : ostream_formatter {};
+
+struct options {
+    bool show_help = false;
+    std::filesystem::path path;
+    bool addresses_only = false;
+};
+
+void print_thread(const options& opts, const cpptrace::experimental::crash_report_thread& thread) {
+    fmt::print("Thread {}", thread.thread_id);
+    if(!thread.name.empty()) {
+        fmt::print(" \"{}\"", thread.name);
+    }
+    if(thread.crashed) {
+        fmt::print(" (crashed)");
+    }
+    fmt::println(":");
+    if(thread.missed) {
+        fmt::println("<didn't respond in time>");
+        return;
+    }
+    if(opts.addresses_only) {
+        for(const auto& frame : thread.trace.frames) {
+            fmt::println("{}+0x{:x}", frame.object_path, frame.object_address);
+        }
+        if(thread.trace.frames.empty()) {
+            fmt::println("<empty trace>");
+        }
+    } else {
+        cpptrace::formatter{}.header("").print(thread.trace.resolve());
+    }
+    fmt::println("");
+}
+
+int crash_symbolizer(int argc, char** argv) {
+    options opts;
+    auto cli = lyra::cli()
+        | lyra::help(opts.show_help)
+        | lyra::opt(opts.addresses_only)["--addresses"]("print object-relative addresses without resolving them")
+        | lyra::arg(opts.path, "report path")("crash report written by the crash reporter").required();
+    if(auto result = cli.parse({ argc, argv }); !result) {
+        fmt::println(stderr, "Error in command line: {}", result.message());
+        fmt::println("{}", cli);
+        return 1;
+    }
+    if(opts.show_help) {
+        fmt::println("{}", cli);
+        return 0;
+    }
+    std::ifstream file(opts.path, std::ios::binary);
+    if(!file) {
+        fmt::println(stderr, "Error: Couldn't open {}", opts.path);
+        return 1;
+    }
+    std::vector<char> buffer{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    cpptrace::experimental::crash_report report;
+    if(!cpptrace::experimental::parse_crash_report(buffer.data(), buffer.size(), report)) {
+        fmt::println(stderr, "Error: {} isn't a valid crash report", opts.path);
+        return 1;
+    }
+    fmt::println("Process {} received signal {} ({})", report.process_id, report.signal, strsignal(report.signal));
+    fmt::println("");
+    for(const auto& thread : report.threads) {
+        print_thread(opts, thread);
+    }
+    if(report.omitted_threads != 0) {
+        fmt::println("{} more threads weren't captured", report.omitted_threads);
+    }
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    int ret = 0;
+    CPPTRACE_TRY {
+        ret = crash_symbolizer(argc, argv);
+    } CPPTRACE_CATCH(const std::exception& e) {
+        fmt::println(stderr, "Caught exception {}: {}", cpptrace::demangle(typeid(e).name()), e.what());
+        cpptrace::from_current_exception().print();
+        ret = 1;
+    }
+    return ret;
+}
@@ -0,0 +1,123 @@
+#include <lyra/lyra.hpp>
+#include <fmt/format.h>
+#include <fmt/ostream.h>
+#include <cpptrace/cpptrace.hpp>
+#include <cpptrace/from_current.hpp>
+#include <cpptrace/utils.hpp>
+
+#include <cstddef>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Compares the built-in demangler against a reference demangler's output, e.g.:
+//   nm --defined-only /usr/lib/llvm-14/lib/libLLVM-14.so | awk '$3 ~ /^_Z/ { print $3 }' | sort -u > names.txt
+//   llvm-cxxfilt < names.txt > expected.txt
+//   demangle_compare names.txt expected.txt
+//   demangle_compare --pruned names.txt expected.txt
+// In pruned mode the reference output is passed through prune_symbol before comparing.
+
+template<> struct fmt::formatter<lyra::cli> : ostream_formatter {};
+
+struct options {
+    bool show_help = false;
+    bool pruned = false;
+    bool quiet = false;
+    std::string names_path;
+    std::string expected_path;
+};
+
+std::vector<std::string> read_lines(const std::string& path) {
+    std::ifstream file(path);
+    if(!file) {
+        throw std::runtime_error(fmt::format("Couldn't open {}", path));
+    }
+    std::vector<std::string> lines;
+    std::string line;
+    while(std::getline(file, line)) {
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+int demangle_compare(int argc, char** argv) {
+    options opts;
+    auto cli = lyra::cli()
+        | lyra::help(opts.show_help)
+        | lyra::opt(opts.pruned)["--pruned"]("compare demangle_mode::pruned against prune_symbol of the reference")
+        | lyra::opt(opts.quiet)["--quiet"]("only print the summary")
+        | lyra::arg(opts.names_path, "names")("mangled names, one per line").required()
+        | lyra::arg(opts.expected_path, "expected")("reference demangler output, one line per name").required();
+    if(auto result = cli.parse({ argc, argv }); !result) {
+        fmt::println(stderr, "Error in command line: {}", result.message());
+        fmt::println("{}", cli);
+        return 1;
+    }
+    if(opts.show_help) {
+        fmt::println("{}", cli);
+        return 0;
+    }
+    auto names = read_lines(opts.names_path);
+    auto expected = read_lines(opts.expected_path);
+    if(names.size() != expected.size()) {
+        fmt::println(stderr, "Error: {} names but {} reference lines", names.size(), expected.size());
+        return 1;
+    }
+    auto mode = opts.pruned
+        ? cpptrace::experimental::demangle_mode::pruned
+        : cpptrace::experimental::demangle_mode::full;
+    std::vector<char> buffer(64 * 1024);
+    std::size_t identical = 0;
+    std::size_t different = 0;
+    std::size_t failed = 0;
+    std::size_t skipped = 0;
+    for(std::size_t i = 0; i < names.size(); i++) {
+        // names the reference couldn't demangle either
+        if(expected[i] == names[i]) {
+            skipped++;
+            continue;
+        }
+        auto reference = opts.pruned ? cpptrace::prune_symbol(expected[i]) : expected[i];
+        auto length = cpptrace::experimental::demangle_signal_safe(
+            names[i].c_str(),
+            buffer.data(),
+            buffer.size(),
+            mode
+        );
+        if(length == 0) {
+            failed++;
+            if(!opts.quiet) {
+                fmt::println("failed    {}", names[i]);
+            }
+        } else if(reference == buffer.data()) {
+            identical++;
+        } else {
+            different++;
+            if(!opts.quiet) {
+                fmt::println("different {}\n  expected: {}\n  actual:   {}", names[i], reference, buffer.data());
+            }
+        }
+    }
+    fmt::println(
+        "{} of {} identical, {} different, {} not demangled, {} skipped",
+        identical,
+        identical + different + failed,
+        different,
+        failed,
+        skipped
+    );
+    return different == 0 && failed == 0 ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    int ret = 0;
+    CPPTRACE_TRY {
+        ret = demangle_compare(argc, argv);
+    } CPPTRACE_CATCH(const std::exception& e) {
+        fmt::println(stderr, "Caught exception {}: {}", cpptrace::demangle(typeid(e).name()), e.what());
+        cpptrace::from_current_exception().print();
+        ret = 1;
+    }
+    return ret;
+}
@@ -0,0 +1,72 @@
+#include <lyra/lyra.hpp>
+#include <fmt/format.h>
+#include <fmt/ostream.h>
+#include <cpptrace/cpptrace.hpp>
+#include <cpptrace/from_current.hpp>
+#include <cpptrace/symbolication.hpp>
+
+#include <csignal>
+#include <string>
+
+template<> struct fmt::formatter<lyra::cli> : ostream_formatter {};
+
+struct options {
+    bool show_help = false;
+    bool verbose = false;
+    std::string socket_path;
+};
+
+cpptrace::experimental::symbolication_server* active_server = nullptr;
+
+void handle_stop_signal(int) {
+    if(active_server) {
+        active_server->stop();
+    }
+}
+
+int symbolication_server(int argc, char** argv) {
+    options opts;
+    auto cli = lyra::cli()
+        | lyra::help(opts.show_help)
+        | lyra::opt(opts.verbose)["--verbose"]("log resolution warnings and errors")
+        | lyra::arg(opts.socket_path, "socket path")("unix domain socket to listen on").required();
+    if(auto result = cli.parse({ argc, argv }); !result) {
+        fmt::println(stderr, "Error in command line: {}", result.message());
+        fmt::println("{}", cli);
+        return 1;
+    }
+    if(opts.show_help) {
+        fmt::println("{}", cli);
+        return 0;
+    }
+    if(opts.verbose) {
+        cpptrace::use_default_stderr_logger();
+    }
+    // keep everything loaded between requests, that's the point of the server
+    cpptrace::experimental::set_cache_mode(cpptrace::cache_mode::prioritize_speed);
+    cpptrace::experimental::symbolication_server server(opts.socket_path);
+    if(!server.listen()) {
+        fmt::println(stderr, "Error: Couldn't listen on {}", opts.socket_path);
+        return 1;
+    }
+    active_server = &server;
+    std::signal(SIGINT, handle_stop_signal);
+    std::signal(SIGTERM, handle_stop_signal);
+    fmt::println("Listening on {}", opts.socket_path);
+    server.serve();
+    active_server = nullptr;
+    fmt::println("Served {} requests", server.requests_served());
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    int ret = 0;
+    CPPTRACE_TRY {
+        ret = symbolication_server(argc, argv);
+    } CPPTRACE_CATCH(const std::exception& e) {
+        fmt::println(stderr, "Caught exception {}: {}", cpptrace::demangle(typeid(e).name()), e.what());
+        cpptrace::from_current_exception().print();
+        ret = 1;
+    }
+    return ret;
+}